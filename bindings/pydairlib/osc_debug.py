@@ -0,0 +1,138 @@
+"""Decoder of the compact OSC debug stream written by OscDebugRecorder.
+
+The recorder publishes an lcmt_osc_debug_schema on <channel>_SCHEMA and
+batches of quantized, delta encoded samples (lcmt_osc_debug_batch) on
+<channel>_BATCH. This module reconstructs, per tracking data, the time and the
+fields of lcmt_osc_tracking_data (y, y_des, error_y, ...) as numpy arrays.
+"""
+import argparse
+
+import lcm
+import matplotlib.pyplot as plt
+import numpy as np
+
+import dairlib
+
+
+def read_varints(data):
+    """Decodes a byte string of zigzag LEB128 varints."""
+    values = []
+    value = 0
+    shift = 0
+    for byte in bytearray(data):
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if not byte & 0x80:
+            values.append((value >> 1) ^ -(value & 1))
+            value = 0
+            shift = 0
+    if shift != 0:
+        raise ValueError("Truncated lcmt_osc_debug_batch")
+    return values
+
+
+def decode_batch(batch, sample_size, resolution):
+    """Returns the utimes (num_samples) and the samples
+    (num_samples x sample_size) of an lcmt_osc_debug_batch. The first column
+    is the fsm state."""
+    varints = np.array(read_varints(batch.data), dtype=np.int64)
+    if varints.size != batch.num_samples * (sample_size + 1):
+        raise ValueError("Malformed lcmt_osc_debug_batch")
+    deltas = varints.reshape(batch.num_samples, sample_size + 1)
+    utimes = batch.first_utime + np.cumsum(deltas[:, 0])
+    samples = np.cumsum(deltas[:, 1:], axis=0).astype(float)
+    samples[:, 1:] *= resolution
+    return utimes, samples
+
+
+class OscDebugDecoder:
+    """Accumulates schema and batch messages (in any order, batches are kept
+    until their schema is received) and reconstructs the signals."""
+
+    def __init__(self):
+        self.schemas = {}
+        self.pending = []
+        self.utimes = {}
+        self.samples = {}
+
+    def add_schema(self, schema):
+        self.schemas[schema.schema_id] = schema
+
+    def add_batch(self, batch):
+        self.pending.append(batch)
+
+    def signals(self):
+        """Returns {tracking data name: {"t", "fsm_state", field: array}},
+        with the fields of shape (num_samples, y_dim)."""
+        remaining = []
+        for batch in self.pending:
+            schema = self.schemas.get(batch.schema_id)
+            if schema is None:
+                remaining.append(batch)
+                continue
+            name = schema.names[batch.stream_index]
+            y_dim = schema.y_dims[batch.stream_index]
+            utimes, samples = decode_batch(
+                batch, 1 + schema.num_fields * y_dim, schema.resolution)
+            self.utimes.setdefault(name, []).append(utimes)
+            self.samples.setdefault(name, []).append(samples)
+        self.pending = remaining
+
+        field_names = None
+        y_dims = {}
+        for schema in self.schemas.values():
+            field_names = schema.field_names
+            y_dims.update(zip(schema.names, schema.y_dims))
+
+        signals = {}
+        for name in self.utimes:
+            utimes = np.concatenate(self.utimes[name])
+            samples = np.concatenate(self.samples[name])
+            order = np.argsort(utimes, kind="stable")
+            utimes = utimes[order]
+            samples = samples[order]
+            signal = {"t": utimes * 1e-6,
+                      "fsm_state": samples[:, 0].astype(int)}
+            y_dim = y_dims[name]
+            for i, field in enumerate(field_names):
+                signal[field] = samples[:, 1 + i * y_dim:1 + (i + 1) * y_dim]
+            signals[name] = signal
+        return signals
+
+
+def load_osc_debug_log(filename, channel="OSC_DEBUG"):
+    """Reconstructs the signals of an LCM log (see OscDebugDecoder.signals)."""
+    decoder = OscDebugDecoder()
+    log = lcm.EventLog(filename, "r")
+    for event in log:
+        if event.channel == channel + "_SCHEMA":
+            decoder.add_schema(
+                dairlib.lcmt_osc_debug_schema.decode(event.data))
+        elif event.channel == channel + "_BATCH":
+            decoder.add_batch(dairlib.lcmt_osc_debug_batch.decode(event.data))
+    return decoder.signals()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Plots the compact OSC debug stream of an LCM log")
+    parser.add_argument("log", help="LCM log file")
+    parser.add_argument("--channel", default="OSC_DEBUG")
+    parser.add_argument("--fields", default="y,y_des",
+                        help="Comma separated fields to plot")
+    args = parser.parse_args()
+
+    signals = load_osc_debug_log(args.log, args.channel)
+    fields = args.fields.split(",")
+    for name, signal in signals.items():
+        plt.figure(name)
+        for field in fields:
+            plt.plot(signal["t"], signal[field], ".", markersize=2)
+        plt.legend(["%s[%d]" % (field, i) for field in fields
+                    for i in range(signal[field].shape[1])])
+        plt.xlabel("t (s)")
+    plt.show()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,2 @@
+# Importing everything in this directory to this package
+from .controllers import *
@@ -0,0 +1,52 @@
+#include <pybind11/eigen.h>
+#include <pybind11/pybind11.h>
+
+#include "systems/controllers/affine_controller.h"
+
+namespace py = pybind11;
+
+namespace dairlib {
+namespace pydairlib {
+
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using systems::AffineBatchEvaluator;
+
+PYBIND11_MODULE(controllers, m) {
+  m.doc() = "Bindings for //systems/controllers";
+
+  // States are passed as Eigen::Ref, so column-major (Fortran order) float64
+  // arrays, e.g. from np.asfortranarray, are used without a copy. The GIL is
+  // released while evaluating.
+  py::class_<AffineBatchEvaluator>(m, "AffineBatchEvaluator")
+      .def(py::init<const MatrixXd&, const VectorXd&, const VectorXd&>(),
+           py::arg("K"), py::arg("E"), py::arg("desired_state"))
+      .def(py::init<const VectorXd&, int, int>(), py::arg("params"),
+           py::arg("num_states"), py::arg("num_efforts"),
+           "Parameters in the AffineParams layout, [K; E; desired_state]")
+      .def("num_states", &AffineBatchEvaluator::num_states)
+      .def("num_efforts", &AffineBatchEvaluator::num_efforts)
+      .def("Eval",
+           py::overload_cast<const Eigen::Ref<const MatrixXd>&>(
+               &AffineBatchEvaluator::Eval, py::const_),
+           py::arg("states"), py::call_guard<py::gil_scoped_release>(),
+           "Efforts (num_efforts x N) of the states (num_states x N)")
+      .def("EvalTimestamped", &AffineBatchEvaluator::EvalTimestamped,
+           py::arg("timestamped_states"),
+           py::call_guard<py::gil_scoped_release>(),
+           "Efforts and timestamps (num_efforts + 1 x N) of the states and "
+           "timestamps (num_states + 1 x N)");
+
+  m.def(
+      "LinearBatchEvaluator",
+      [](const MatrixXd& K, const VectorXd& desired_state) {
+        return AffineBatchEvaluator(K, VectorXd::Zero(K.rows()),
+                                    desired_state);
+      },
+      py::arg("K"), py::arg("desired_state"),
+      "Batch evaluator of the law of a LinearController, "
+      "u = K (desired_state - x)");
+}
+
+}  // namespace pydairlib
+}  // namespace dairlib
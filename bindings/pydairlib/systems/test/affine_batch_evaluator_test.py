@@ -0,0 +1,41 @@
+from pydairlib.systems import AffineBatchEvaluator, LinearBatchEvaluator
+import numpy as np
+import time
+
+# Batch evaluation of an affine law, without a diagram
+def main():
+    num_states = 45
+    num_efforts = 10
+    num_samples = 1000000
+
+    K = np.random.rand(num_efforts, num_states)
+    E = np.random.rand(num_efforts)
+    x_des = np.random.rand(num_states)
+    states = np.asfortranarray(np.random.rand(num_states, num_samples))
+
+    evaluator = AffineBatchEvaluator(K, E, x_des)
+    start = time.time()
+    efforts = evaluator.Eval(states)
+    elapsed = time.time() - start
+    print("Evaluated %d states in %f s" % (num_samples, elapsed))
+
+    expected = K.dot(x_des[:, None] - states) + E[:, None]
+    assert np.allclose(efforts, expected)
+
+    # Same law from the AffineParams layout
+    params = np.concatenate((K.flatten(order='F'), E, x_des))
+    from_params = AffineBatchEvaluator(params, num_states, num_efforts)
+    assert np.allclose(from_params.Eval(states[:, :100]), efforts[:, :100])
+
+    # Timestamps are passed through
+    timestamps = np.linspace(0, 1, 100)
+    timestamped = from_params.EvalTimestamped(
+        np.vstack((states[:, :100], timestamps)))
+    assert np.allclose(timestamped[-1, :], timestamps)
+
+    linear = LinearBatchEvaluator(K, x_des)
+    assert np.allclose(linear.Eval(states[:, :100]),
+                       expected[:, :100] - E[:, None])
+
+if __name__ == "__main__":
+    main()
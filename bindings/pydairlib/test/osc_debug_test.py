@@ -0,0 +1,120 @@
+import os
+import tempfile
+
+import lcm
+import numpy as np
+
+import dairlib
+from pydairlib.osc_debug import (OscDebugDecoder, decode_batch,
+                                 load_osc_debug_log, read_varints)
+
+# A batch recorded by OscDebugRecorder: the data written by
+# EncodeOscDebugSamples for UTIMES and VALUES, with a resolution of 1e-6
+RESOLUTION = 1e-6
+RECORDED_DATA = (
+    b"\x00\x00\x80\x89\x7a\xbf\x96\xb1\x02\x80\xa8\xd6\xb9\x07\xa0\xc2\x1e"
+    b"\xe8\x07\x02\xd0\x0f\x00\x80\x89\x7a\xa0\xc2\x1e\xe8\x07\x00\x8f\xa7"
+    b"\xf5\x07\xc0\x9a\xe0\x61\xff\xb0\xd0\xba\x07\xcf\xa5\x4c\xa0\x9c\x01"
+    b"\x04\xc0\x8e\xfb\x06\xff\x83\xaf\x5f\x81\x89\x0f\x90\xc5\xf7\x03")
+UTIMES = np.array([1000, 1500, 2000, 12000])
+# fsm state, y (2) and y_des (2). The NaN was recorded as 0.
+VALUES = np.array([[0, 1.0, -2.5, 1e3, 0.25],
+                   [1, 1.001, -2.5, 1e3 + 1, 0.5],
+                   [1, -7.3, 100, 0, -0.125],
+                   [3, 0, 0, -0.12345678, 4]])
+
+
+def make_schema():
+    schema = dairlib.lcmt_osc_debug_schema()
+    schema.utime = 12000
+    schema.schema_id = 42
+    schema.resolution = RESOLUTION
+    schema.num_streams = 1
+    schema.names = ["com"]
+    schema.y_dims = [2]
+    schema.decimations = [1]
+    schema.num_fields = 2
+    schema.field_names = ["y", "y_des"]
+    return schema
+
+
+def make_batch():
+    batch = dairlib.lcmt_osc_debug_batch()
+    batch.utime = 12000
+    batch.schema_id = 42
+    batch.stream_index = 0
+    batch.num_samples = 4
+    batch.first_utime = 1000
+    batch.dropped_samples = 0
+    batch.num_bytes = len(RECORDED_DATA)
+    batch.data = RECORDED_DATA
+    return batch
+
+
+def check_signals(signals):
+    assert list(signals.keys()) == ["com"]
+    com = signals["com"]
+    assert np.allclose(com["t"], UTIMES * 1e-6)
+    assert np.array_equal(com["fsm_state"], VALUES[:, 0].astype(int))
+    assert com["y"].shape == (4, 2)
+    assert np.allclose(com["y"], VALUES[:, 1:3], atol=RESOLUTION / 2)
+    assert np.allclose(com["y_des"], VALUES[:, 3:5], atol=RESOLUTION / 2)
+
+
+def test_read_varints():
+    assert read_varints(b"\x00\x01\x02\x7e\x7f\x80\x01\xd8\x04") == \
+        [0, -1, 1, 63, -64, 64, 300]
+    try:
+        read_varints(b"\x02\x80")
+        assert False, "Truncated varint not detected"
+    except ValueError:
+        pass
+
+
+def test_decode_batch():
+    utimes, samples = decode_batch(make_batch(), 5, RESOLUTION)
+    assert np.array_equal(utimes, UTIMES)
+    assert np.array_equal(samples[:, 0], VALUES[:, 0])
+    assert np.allclose(samples, VALUES, atol=RESOLUTION / 2)
+
+    malformed = make_batch()
+    malformed.num_samples = 5
+    try:
+        decode_batch(malformed, 5, RESOLUTION)
+        assert False, "Malformed batch not detected"
+    except ValueError:
+        pass
+
+
+def test_decoder():
+    # Batches received before their schema are kept
+    decoder = OscDebugDecoder()
+    decoder.add_batch(make_batch())
+    assert decoder.signals() == {}
+    decoder.add_schema(make_schema())
+    check_signals(decoder.signals())
+
+
+def test_log():
+    # Round trip through the lcm encoding and a log file
+    directory = tempfile.mkdtemp()
+    filename = os.path.join(directory, "osc_debug.log")
+    log = lcm.EventLog(filename, "w", overwrite=True)
+    log.write_event(12000, "OSC_DEBUG_SCHEMA", make_schema().encode())
+    log.write_event(12000, "OSC_DEBUG_BATCH", make_batch().encode())
+    log.write_event(12000, "OTHER_BATCH", make_batch().encode())
+    log.close()
+    check_signals(load_osc_debug_log(filename))
+    os.remove(filename)
+    os.rmdir(directory)
+
+
+def main():
+    test_read_varints()
+    test_decode_batch()
+    test_decoder()
+    test_log()
+
+
+if __name__ == "__main__":
+    main()
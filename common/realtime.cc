@@ -0,0 +1,281 @@
+#include "common/realtime.h"
+
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include "drake/common/drake_assert.h"
+#include "drake/common/text_logging.h"
+
+namespace dairlib {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+struct RegisteredThread {
+  string name;
+  pthread_t handle;
+  RealtimeOptions options;
+};
+
+std::mutex registry_mutex;
+vector<RegisteredThread> registry;
+bool memory_locked = false;
+long previous_minor_faults = 0;
+long previous_major_faults = 0;
+
+// Removes the calling thread from the registry when it exits
+struct ThreadRegistration {
+  ~ThreadRegistration() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto it = registry.begin(); it != registry.end(); ++it) {
+      if (pthread_equal(it->handle, pthread_self())) {
+        registry.erase(it);
+        break;
+      }
+    }
+  }
+};
+
+// Touches the pages of a stack frame of the given size, so that the stack of
+// the thread is mapped (and locked with MCL_FUTURE) before it is needed
+__attribute__((noinline)) void PrefaultStack(size_t bytes) {
+  volatile char* stack = static_cast<volatile char*>(alloca(bytes));
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  for (size_t i = 0; i < bytes; i += page_size) {
+    stack[i] = 0;
+  }
+}
+
+vector<int> GetCpus(pthread_t handle) {
+  vector<int> cpus;
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (pthread_getaffinity_np(handle, sizeof(cpu_set), &cpu_set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &cpu_set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  return cpus;
+}
+
+string ToString(const vector<int>& cpus) {
+  std::stringstream stream;
+  for (size_t i = 0; i < cpus.size(); i++) {
+    stream << (i > 0 ? "," : "") << cpus[i];
+  }
+  return stream.str();
+}
+
+// Status of a thread, and whether it matches the requested options
+string ThreadStatus(const RegisteredThread& thread) {
+  int policy;
+  sched_param param;
+  pthread_getschedparam(thread.handle, &policy, &param);
+  const vector<int> cpus = GetCpus(thread.handle);
+
+  bool ok = true;
+  if (thread.options.priority > 0) {
+    ok = ok && policy == SCHED_FIFO &&
+         param.sched_priority == thread.options.priority;
+  }
+  if (!thread.options.cpus.empty()) {
+    ok = ok && cpus == thread.options.cpus;
+  }
+  std::stringstream stream;
+  stream << thread.name << ": "
+         << (policy == SCHED_FIFO ? "SCHED_FIFO"
+                                  : policy == SCHED_RR ? "SCHED_RR" : "other")
+         << " priority " << param.sched_priority << ", cpus "
+         << ToString(cpus) << (ok ? "" : " (NOT AS REQUESTED)");
+  return stream.str();
+}
+
+// VmLck of /proc/self/status, in kB
+long LockedMemoryKb() {
+  std::ifstream status("/proc/self/status");
+  string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmLck:") == 0) {
+      return std::stol(line.substr(6));
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+vector<int> ParseCpuList(const string& cpus) {
+  vector<int> list;
+  std::stringstream stream(cpus);
+  string entry;
+  while (std::getline(stream, entry, ',')) {
+    try {
+      size_t end;
+      const int first = std::stoi(entry, &end);
+      int last = first;
+      if (end < entry.size()) {
+        if (entry[end] != '-') {
+          throw std::invalid_argument(entry);
+        }
+        const string rest = entry.substr(end + 1);
+        last = std::stoi(rest, &end);
+        if (end < rest.size()) {
+          throw std::invalid_argument(entry);
+        }
+      }
+      if (first < 0 || last < first) {
+        throw std::invalid_argument(entry);
+      }
+      for (int cpu = first; cpu <= last; cpu++) {
+        list.push_back(cpu);
+      }
+    } catch (const std::logic_error&) {
+      throw std::runtime_error("Malformed cpu list: " + cpus);
+    }
+  }
+  return list;
+}
+
+bool LockProcessMemory(size_t prefault_heap_bytes) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  if (memory_locked) return true;
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+    drake::log()->warn("Could not lock the memory: {}", std::strerror(errno));
+    return false;
+  }
+  // Freed memory stays in the heap instead of being returned with munmap or
+  // trimmed, so that it doesn't fault again when reallocated
+  mallopt(M_TRIM_THRESHOLD, -1);
+  mallopt(M_MMAP_MAX, 0);
+  if (prefault_heap_bytes > 0) {
+    char* heap = static_cast<char*>(malloc(prefault_heap_bytes));
+    if (heap != nullptr) {
+      const size_t page_size = sysconf(_SC_PAGESIZE);
+      for (size_t i = 0; i < prefault_heap_bytes; i += page_size) {
+        heap[i] = 0;
+      }
+      free(heap);
+    }
+  }
+  memory_locked = true;
+  return true;
+}
+
+bool SetupRealtimeThread(const string& name, const RealtimeOptions& options) {
+  bool ok = true;
+  if (options.lock_memory) {
+    ok = LockProcessMemory(options.prefault_heap_bytes) && ok;
+  }
+  if (!options.cpus.empty()) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : options.cpus) {
+      CPU_SET(cpu, &cpu_set);
+    }
+    const int error =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (error != 0) {
+      drake::log()->warn("Could not pin {} to cpus {}: {}", name,
+                         ToString(options.cpus), std::strerror(error));
+      ok = false;
+    }
+  }
+  if (options.priority > 0) {
+    sched_param param;
+    param.sched_priority = options.priority;
+    const int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (error != 0) {
+      drake::log()->warn(
+          "Could not set SCHED_FIFO priority {} for {}: {} (this needs "
+          "CAP_SYS_NICE or an rtprio limit in /etc/security/limits.conf)",
+          options.priority, name, std::strerror(error));
+      ok = false;
+    }
+  }
+  if (options.prefault_stack_bytes > 0) {
+    PrefaultStack(options.prefault_stack_bytes);
+  }
+
+  static thread_local ThreadRegistration registration;
+  RegisteredThread thread{name, pthread_self(), options};
+  std::sort(thread.options.cpus.begin(), thread.options.cpus.end());
+  thread.options.cpus.erase(
+      std::unique(thread.options.cpus.begin(), thread.options.cpus.end()),
+      thread.options.cpus.end());
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto it = std::find_if(registry.begin(), registry.end(), [](const auto& t) {
+      return pthread_equal(t.handle, pthread_self());
+    });
+    if (it != registry.end()) {
+      *it = thread;
+    } else {
+      registry.push_back(thread);
+    }
+  }
+  drake::log()->info("{}", ThreadStatus(thread));
+  return ok;
+}
+
+string RealtimeReport() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  std::stringstream report;
+  for (const auto& thread : registry) {
+    report << ThreadStatus(thread) << "\n";
+  }
+  report << "memory " << (memory_locked ? "locked" : "not locked") << " ("
+         << LockedMemoryKb() << " kB), page faults: " << usage.ru_minflt
+         << " minor (+" << usage.ru_minflt - previous_minor_faults << "), "
+         << usage.ru_majflt << " major (+"
+         << usage.ru_majflt - previous_major_faults << ")";
+  previous_minor_faults = usage.ru_minflt;
+  previous_major_faults = usage.ru_majflt;
+  return report.str();
+}
+
+RealtimeReporter::RealtimeReporter(double period) {
+  DRAKE_DEMAND(period > 0);
+  drake::log()->info("{}", RealtimeReport());
+  thread_ = std::thread(&RealtimeReporter::Run, this, period);
+}
+
+RealtimeReporter::~RealtimeReporter() {
+  keep_running_ = false;
+  thread_.join();
+}
+
+void RealtimeReporter::Run(double period) {
+  const auto step = std::chrono::milliseconds(100);
+  auto next = std::chrono::steady_clock::now() +
+              std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::duration<double>(period));
+  while (keep_running_) {
+    std::this_thread::sleep_for(step);
+    if (std::chrono::steady_clock::now() >= next) {
+      drake::log()->info("{}", RealtimeReport());
+      next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(period));
+    }
+  }
+}
+
+}  // namespace dairlib
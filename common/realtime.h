@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+
+/// Real-time settings of a thread, e.g. a dispatcher or controller loop or the
+/// polling thread of CassieUDPSubscriber. The default values change nothing.
+struct RealtimeOptions {
+  /// SCHED_FIFO priority (1-99). 0 keeps the default scheduling.
+  int priority = 0;
+  /// The cpus the thread may run on. Empty for all of them.
+  std::vector<int> cpus;
+  /// Locks the memory of the process in RAM (see LockProcessMemory())
+  bool lock_memory = false;
+  /// Heap touched after locking the memory, in bytes
+  size_t prefault_heap_bytes = 64 << 20;
+  /// Stack of the thread touched at setup, in bytes
+  size_t prefault_stack_bytes = 512 << 10;
+};
+
+/// Parses a list of cpus such as "2,3" or "2-5,7"
+/// Throws std::runtime_error if the list is malformed.
+std::vector<int> ParseCpuList(const std::string& cpus);
+
+/// Locks the current and future memory of the process in RAM, keeps the freed
+/// heap memory in the process, and touches prefault_heap_bytes of heap, so
+/// that later allocations of the main heap arena don't page fault.
+/// Only locks once per process. Returns false if the memory cannot be locked
+/// (e.g. RLIMIT_MEMLOCK is too low).
+bool LockProcessMemory(size_t prefault_heap_bytes);
+
+/// Applies options to the calling thread: scheduling, cpu affinity, memory
+/// lock and a prefaulted stack. The thread is registered under name for
+/// RealtimeReport() until it exits, and its status is logged.
+/// Settings which cannot be applied (e.g. SCHED_FIFO without CAP_SYS_NICE or
+/// an rtprio limit) are logged as warnings rather than thrown, so that the
+/// binaries still run on development machines.
+/// @return true if all the settings were applied
+bool SetupRealtimeThread(const std::string& name,
+                         const RealtimeOptions& options);
+
+/// Scheduling policy, priority and cpus of each registered thread compared to
+/// the requested ones, whether the memory is locked, and the number of page
+/// faults of the process (in total and since the previous report)
+std::string RealtimeReport();
+
+/// Logs RealtimeReport() every period seconds on a background thread, to
+/// check that the process keeps running with the requested settings and
+/// doesn't page fault
+class RealtimeReporter {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(RealtimeReporter)
+
+  explicit RealtimeReporter(double period);
+  ~RealtimeReporter();
+
+ private:
+  void Run(double period);
+
+  std::atomic<bool> keep_running_{true};
+  std::thread thread_;
+};
+
+}  // namespace dairlib
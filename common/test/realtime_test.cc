@@ -0,0 +1,33 @@
+#include "common/realtime.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace dairlib {
+namespace {
+
+using std::vector;
+
+TEST(RealtimeTest, ParseCpuListTest) {
+  EXPECT_EQ(ParseCpuList(""), vector<int>());
+  EXPECT_EQ(ParseCpuList("3"), vector<int>({3}));
+  EXPECT_EQ(ParseCpuList("2,3"), vector<int>({2, 3}));
+  EXPECT_EQ(ParseCpuList("2-5"), vector<int>({2, 3, 4, 5}));
+  EXPECT_EQ(ParseCpuList("0,2-3,7"), vector<int>({0, 2, 3, 7}));
+  EXPECT_EQ(ParseCpuList("4-4"), vector<int>({4}));
+}
+
+TEST(RealtimeTest, MalformedCpuListTest) {
+  EXPECT_THROW(ParseCpuList("a"), std::runtime_error);
+  EXPECT_THROW(ParseCpuList("2,,3"), std::runtime_error);
+  EXPECT_THROW(ParseCpuList("2;3"), std::runtime_error);
+  EXPECT_THROW(ParseCpuList("2-"), std::runtime_error);
+  EXPECT_THROW(ParseCpuList("5-2"), std::runtime_error);
+  EXPECT_THROW(ParseCpuList("-1"), std::runtime_error);
+  EXPECT_THROW(ParseCpuList("2-3x"), std::runtime_error);
+}
+
+}  // namespace
+}  // namespace dairlib
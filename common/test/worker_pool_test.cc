@@ -0,0 +1,76 @@
+#include "common/worker_pool.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace dairlib {
+namespace {
+
+using std::vector;
+
+TEST(WorkerPoolTest, RunsEveryTaskOnce) {
+  for (int num_threads : {1, 4}) {
+    SCOPED_TRACE("num_threads = " + std::to_string(num_threads));
+    WorkerPool pool(num_threads);
+    EXPECT_EQ(pool.num_threads(), num_threads);
+    // The workers are reused by consecutive calls
+    for (int num_tasks : {0, 1, 3, 100}) {
+      vector<int> runs(num_tasks, 0);
+      std::atomic<bool> bad_thread{false};
+      pool.ParallelFor(num_tasks, [&](int index, int thread) {
+        if (thread < 0 || thread >= num_threads) {
+          bad_thread = true;
+          return;
+        }
+        runs[index]++;
+      });
+      EXPECT_FALSE(bad_thread);
+      EXPECT_EQ(runs, vector<int>(num_tasks, 1));
+    }
+  }
+}
+
+TEST(WorkerPoolTest, ThreadIndex) {
+  // Each thread index is used by a single thread, so it can pick scratch data
+  WorkerPool pool(3);
+  vector<std::set<std::thread::id>> ids(pool.num_threads());
+  vector<std::mutex> mutexes(pool.num_threads());
+  for (int repeat = 0; repeat < 10; repeat++) {
+    pool.ParallelFor(50, [&](int, int thread) {
+      std::lock_guard<std::mutex> lock(mutexes[thread]);
+      ids[thread].insert(std::this_thread::get_id());
+    });
+  }
+  EXPECT_EQ(ids[0], std::set<std::thread::id>({std::this_thread::get_id()}));
+  for (const auto& thread_ids : ids) {
+    EXPECT_LE(thread_ids.size(), 1u);
+  }
+}
+
+TEST(WorkerPoolTest, Exception) {
+  WorkerPool pool(4);
+  std::atomic<int> num_runs{0};
+  EXPECT_THROW(pool.ParallelFor(20,
+                                [&](int index, int) {
+                                  num_runs++;
+                                  if (index % 5 == 2) {
+                                    throw std::runtime_error("task failed");
+                                  }
+                                }),
+               std::runtime_error);
+  // The other tasks still ran, and the pool is still usable
+  EXPECT_EQ(num_runs, 20);
+  num_runs = 0;
+  pool.ParallelFor(20, [&](int, int) { num_runs++; });
+  EXPECT_EQ(num_runs, 20);
+}
+
+}  // namespace
+}  // namespace dairlib
@@ -0,0 +1,86 @@
+#include "common/worker_pool.h"
+
+#include "drake/common/drake_assert.h"
+
+namespace dairlib {
+
+WorkerPool::WorkerPool(int num_threads) {
+  DRAKE_DEMAND(num_threads >= 1);
+  for (int t = 1; t < num_threads; t++) {
+    workers_.emplace_back(&WorkerPool::Run, this, t);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void WorkerPool::ParallelFor(
+    int num_tasks, const std::function<void(int index, int thread)>& task) {
+  if (num_tasks <= 0) return;
+  std::lock_guard<std::mutex> call_lock(call_mutex_);
+  if (workers_.empty() || num_tasks == 1) {
+    for (int i = 0; i < num_tasks; i++) {
+      task(i, 0);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    num_tasks_ = num_tasks;
+    next_task_ = 0;
+    num_running_ = workers_.size();
+    exception_ = nullptr;
+    generation_++;
+  }
+  start_.notify_all();
+  RunTasks(0);
+
+  // Every worker checks in, so none of them still reads task_ afterwards
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return num_running_ == 0; });
+    task_ = nullptr;
+    std::swap(exception, exception_);
+  }
+  if (exception) std::rethrow_exception(exception);
+}
+
+void WorkerPool::Run(int thread) {
+  int64_t generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock,
+                  [&] { return stop_ || generation_ != generation; });
+      if (stop_) return;
+      generation = generation_;
+    }
+    RunTasks(thread);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--num_running_ == 0) done_.notify_one();
+  }
+}
+
+void WorkerPool::RunTasks(int thread) {
+  for (int i = next_task_++; i < num_tasks_; i = next_task_++) {
+    try {
+      (*task_)(i, thread);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!exception_) exception_ = std::current_exception();
+    }
+  }
+}
+
+}  // namespace dairlib
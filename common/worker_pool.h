@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+
+/// Fixed set of worker threads, started once and reused by every ParallelFor,
+/// for work which is repeated many times (e.g. the finite differences of a
+/// constraint at every solver iteration) and too short to pay for starting
+/// threads each time
+class WorkerPool {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(WorkerPool)
+
+  /// @param num_threads number of threads running the tasks, including the
+  /// thread calling ParallelFor, so num_threads - 1 workers are started
+  explicit WorkerPool(int num_threads);
+  ~WorkerPool();
+
+  int num_threads() const { return workers_.size() + 1; }
+
+  /// Runs task(index, thread) for every index in [0, num_tasks) on the calling
+  /// thread and the workers, and returns once all of them are done. thread, in
+  /// [0, num_threads()), identifies the thread running the task, e.g. to pick
+  /// its scratch data. Concurrent calls are run one after the other, and a
+  /// task must not call ParallelFor on the same pool. If tasks throw, the
+  /// other tasks still run and the first exception is rethrown.
+  void ParallelFor(int num_tasks,
+                   const std::function<void(int index, int thread)>& task);
+
+ private:
+  void Run(int thread);
+  void RunTasks(int thread);
+
+  std::vector<std::thread> workers_;
+  // Serializes the calls of ParallelFor
+  std::mutex call_mutex_;
+
+  // The members below are guarded by mutex_, except for next_task_. task_ and
+  // num_tasks_ are only written while no worker is running tasks.
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  int64_t generation_ = 0;
+  bool stop_ = false;
+  int num_running_ = 0;
+  const std::function<void(int, int)>* task_ = nullptr;
+  int num_tasks_ = 0;
+  std::atomic<int> next_task_{0};
+  std::exception_ptr exception_;
+};
+
+}  // namespace dairlib
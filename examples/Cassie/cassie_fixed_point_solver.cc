@@ -1,3 +1,6 @@
+#include <limits>
+#include <memory>
+
 #include "examples/Cassie/cassie_fixed_point_solver.h"
 #include "multibody/kinematic/kinematic_evaluator_set.h"
 #include "multibody/kinematic/world_point_evaluator.h"
@@ -14,131 +17,148 @@ namespace dairlib {
 
 using Eigen::VectorXd;
 
-void CassieFixedPointSolver(
-    const drake::multibody::MultibodyPlant<double>& plant,
-    double height, double mu, double min_normal_force,
-    bool linear_friction_cone, double toe_spread, VectorXd* q_result,
-    VectorXd* u_result, VectorXd* lambda_result,
-    std::string visualize_model_urdf) {
-  multibody::KinematicEvaluatorSet<double> evaluators(plant);
-
+CassieFixedPointProgram::CassieFixedPointProgram(
+    const drake::multibody::MultibodyPlant<double>& plant, double mu,
+    bool linear_friction_cone, double toe_spread)
+    : plant_(plant),
+      left_loop_(LeftLoopClosureEvaluator(plant)),
+      right_loop_(RightLoopClosureEvaluator(plant)),
+      left_toe_evaluator_(plant, LeftToeFront(plant).first,
+          LeftToeFront(plant).second, Eigen::Matrix3d::Identity(),
+          Eigen::Vector3d(0, toe_spread, 0), {1, 2}),
+      left_heel_evaluator_(plant, LeftToeRear(plant).first,
+          LeftToeRear(plant).second, Eigen::Vector3d(0, 0, 1),
+          Eigen::Vector3d::Zero(), false),
+      right_toe_evaluator_(plant, RightToeFront(plant).first,
+          RightToeFront(plant).second, Eigen::Matrix3d::Identity(),
+          Eigen::Vector3d(0, -toe_spread, 0), {1, 2}),
+      right_heel_evaluator_(plant, RightToeRear(plant).first,
+          RightToeRear(plant).second, Eigen::Vector3d(0, 0, 1),
+          Eigen::Vector3d::Zero(), false),
+      evaluators_(plant),
+      program_(plant),
+      positions_map_(multibody::makeNameToPositionsMap(plant)) {
   // Add loop closures
-  auto left_loop = LeftLoopClosureEvaluator(plant);
-  auto right_loop = RightLoopClosureEvaluator(plant);
-  evaluators.add_evaluator(&left_loop);
-  evaluators.add_evaluator(&right_loop);
+  evaluators_.add_evaluator(&left_loop_);
+  evaluators_.add_evaluator(&right_loop_);
 
   // Add contact points
-  auto left_toe = LeftToeFront(plant);
-  auto left_toe_evaluator = multibody::WorldPointEvaluator(plant,
-      left_toe.first, left_toe.second, Eigen::Matrix3d::Identity(),
-      Eigen::Vector3d(0, toe_spread, 0), {1, 2});
-  evaluators.add_evaluator(&left_toe_evaluator);
-
-  auto left_heel = LeftToeRear(plant);
-  auto left_heel_evaluator = multibody::WorldPointEvaluator(plant,
-      left_heel.first, left_heel.second, Eigen::Vector3d(0,0,1),
-      Eigen::Vector3d::Zero(), false);
-  evaluators.add_evaluator(&left_heel_evaluator);
-
-  auto right_toe = RightToeFront(plant);
-  auto right_toe_evaluator = multibody::WorldPointEvaluator(plant,
-      right_toe.first, right_toe.second, Eigen::Matrix3d::Identity(),
-      Eigen::Vector3d(0, -toe_spread, 0), {1, 2});
-  evaluators.add_evaluator(&right_toe_evaluator);
-
-  auto right_heel = RightToeRear(plant);
-  auto right_heel_evaluator = multibody::WorldPointEvaluator(plant,
-      right_heel.first, right_heel.second, Eigen::Vector3d(0,0,1),
-      Eigen::Vector3d::Zero(), false);
-  evaluators.add_evaluator(&right_heel_evaluator);
-
-  auto program = multibody::MultibodyProgram(plant);
-
-  std::cout << "N***** " << evaluators.count_active() << std::endl;
-
-  auto positions_map = multibody::makeNameToPositionsMap(plant);
-  auto q = program.AddPositionVariables();
-  auto u = program.AddInputVariables();
-  auto lambda = program.AddConstraintForceVariables(evaluators);
-  auto kinematic_constraint = program.AddKinematicConstraint(evaluators, q);
-  auto fp_constraint = program.AddFixedPointConstraint(evaluators, q, u,
-      lambda);
-  program.AddJointLimitConstraints(q);
+  evaluators_.add_evaluator(&left_toe_evaluator_);
+  evaluators_.add_evaluator(&left_heel_evaluator_);
+  evaluators_.add_evaluator(&right_toe_evaluator_);
+  evaluators_.add_evaluator(&right_heel_evaluator_);
+
+  q_ = program_.AddPositionVariables();
+  u_ = program_.AddInputVariables();
+  lambda_ = program_.AddConstraintForceVariables(evaluators_);
+  program_.AddKinematicConstraint(evaluators_, q_);
+  program_.AddFixedPointConstraint(evaluators_, q_, u_, lambda_);
+  program_.AddJointLimitConstraints(q_);
 
   // Fix floating base
-  program.AddConstraint(q(positions_map.at("base_qw")) == 1);
-  program.AddConstraint(q(positions_map.at("base_qx")) == 0);
-  program.AddConstraint(q(positions_map.at("base_qy")) == 0);
-  program.AddConstraint(q(positions_map.at("base_qz")) == 0);
+  program_.AddConstraint(q_(positions_map_.at("base_qw")) == 1);
+  program_.AddConstraint(q_(positions_map_.at("base_qx")) == 0);
+  program_.AddConstraint(q_(positions_map_.at("base_qy")) == 0);
+  program_.AddConstraint(q_(positions_map_.at("base_qz")) == 0);
 
-  program.AddConstraint(q(positions_map.at("base_x")) == 0);
-  program.AddConstraint(q(positions_map.at("base_y")) == 0);
-  program.AddConstraint(q(positions_map.at("base_z")) == height);
+  program_.AddConstraint(q_(positions_map_.at("base_x")) == 0);
+  program_.AddConstraint(q_(positions_map_.at("base_y")) == 0);
+  // Height is a parameter, set by SetParameters()
+  height_constraint_ = program_.AddBoundingBoxConstraint(0, 0,
+      q_(positions_map_.at("base_z")));
 
   // Add symmetry constraints, and zero roll/pitch on the hip
-  program.AddConstraint(q(positions_map.at("knee_left")) ==
-      q(positions_map.at("knee_right")));
-  program.AddConstraint(q(positions_map.at("hip_pitch_left")) ==
-      q(positions_map.at("hip_pitch_right")));
-  program.AddConstraint(q(positions_map.at("hip_roll_left")) ==
-      -q(positions_map.at("hip_roll_right")));
-  program.AddConstraint(q(positions_map.at("hip_yaw_right")) ==
-      -q(positions_map.at("hip_yaw_left")));
+  program_.AddConstraint(q_(positions_map_.at("knee_left")) ==
+      q_(positions_map_.at("knee_right")));
+  program_.AddConstraint(q_(positions_map_.at("hip_pitch_left")) ==
+      q_(positions_map_.at("hip_pitch_right")));
+  program_.AddConstraint(q_(positions_map_.at("hip_roll_left")) ==
+      -q_(positions_map_.at("hip_roll_right")));
+  program_.AddConstraint(q_(positions_map_.at("hip_yaw_right")) ==
+      -q_(positions_map_.at("hip_yaw_left")));
 
   // Add some contact force constraints: linear version
   if (linear_friction_cone) {
     int num_linear_faces = 40; // try lots of faces!
-    program.AddConstraint(solvers::CreateLinearFrictionConstraint(mu,
-        num_linear_faces), lambda.segment(2, 3));
-    program.AddConstraint(solvers::CreateLinearFrictionConstraint(mu,
-        num_linear_faces), lambda.segment(5, 3));
-    program.AddConstraint(solvers::CreateLinearFrictionConstraint(mu,
-        num_linear_faces), lambda.segment(8, 3));
-    program.AddConstraint(solvers::CreateLinearFrictionConstraint(mu,
-        num_linear_faces), lambda.segment(11, 3));
+    program_.AddConstraint(solvers::CreateLinearFrictionConstraint(mu,
+        num_linear_faces), lambda_.segment(2, 3));
+    program_.AddConstraint(solvers::CreateLinearFrictionConstraint(mu,
+        num_linear_faces), lambda_.segment(5, 3));
+    program_.AddConstraint(solvers::CreateLinearFrictionConstraint(mu,
+        num_linear_faces), lambda_.segment(8, 3));
+    program_.AddConstraint(solvers::CreateLinearFrictionConstraint(mu,
+        num_linear_faces), lambda_.segment(11, 3));
   } else {
     // Add some contact force constraints: Lorentz version
-    program.AddConstraint(solvers::CreateConicFrictionConstraint(mu),
-        lambda.segment(2, 3));
-    program.AddConstraint(solvers::CreateConicFrictionConstraint(mu),
-        lambda.segment(5, 3));
-    program.AddConstraint(solvers::CreateConicFrictionConstraint(mu),
-        lambda.segment(8, 3));
-    program.AddConstraint(solvers::CreateConicFrictionConstraint(mu),
-        lambda.segment(11, 3));
+    program_.AddConstraint(solvers::CreateConicFrictionConstraint(mu),
+        lambda_.segment(2, 3));
+    program_.AddConstraint(solvers::CreateConicFrictionConstraint(mu),
+        lambda_.segment(5, 3));
+    program_.AddConstraint(solvers::CreateConicFrictionConstraint(mu),
+        lambda_.segment(8, 3));
+    program_.AddConstraint(solvers::CreateConicFrictionConstraint(mu),
+        lambda_.segment(11, 3));
   }
- 
-  // Add minimum normal forces on all contact points
-  program.AddConstraint(lambda(4) >= min_normal_force);
-  program.AddConstraint(lambda(7) >= min_normal_force);
-  program.AddConstraint(lambda(10) >= min_normal_force);
-  program.AddConstraint(lambda(13) >= min_normal_force);
-
-  // Set initial guess/cost for q using a vaguely neutral position
-  Eigen::VectorXd q_guess = Eigen::VectorXd::Zero(plant.num_positions());
-  q_guess(0) = 1; //quaternion
-  q_guess(positions_map.at("base_z")) = height;
-  q_guess(positions_map.at("hip_pitch_left")) = 1;
-  q_guess(positions_map.at("knee_left")) = -2;
-  q_guess(positions_map.at("ankle_joint_left")) = 2;
-  q_guess(positions_map.at("toe_left")) = -2;
-  q_guess(positions_map.at("hip_pitch_right")) = 1;
-  q_guess(positions_map.at("knee_right")) = -2;
-  q_guess(positions_map.at("ankle_joint_right")) = 2;
-  q_guess(positions_map.at("toe_right")) = -2;
 
-  q_guess += .05*Eigen::VectorXd::Random(plant.num_positions());
+  // Add minimum normal forces on all contact points. The minimum is a
+  // parameter, set by SetParameters()
+  drake::solvers::VectorXDecisionVariable normal_forces(4);
+  normal_forces << lambda_(4), lambda_(7), lambda_(10), lambda_(13);
+  normal_force_constraint_ = program_.AddBoundingBoxConstraint(
+      Eigen::VectorXd::Zero(4),
+      Eigen::VectorXd::Constant(4, std::numeric_limits<double>::infinity()),
+      normal_forces);
 
   // Only cost in this program: u^T u
-  program.AddQuadraticCost(u.dot(1.0 * u));
+  program_.AddQuadraticCost(u_.dot(1.0 * u_));
+}
+
+void CassieFixedPointProgram::SetParameters(const VectorXd& parameters) {
+  DRAKE_DEMAND(parameters.size() == 2);
+  height_constraint_.evaluator()->set_bounds(parameters.head(1),
+                                             parameters.head(1));
+  normal_force_constraint_.evaluator()->UpdateLowerBound(
+      VectorXd::Constant(4, parameters(1)));
+}
+
+VectorXd CassieFixedPointProgram::MakeInitialGuess(double height) const {
+  // Set initial guess for q using a vaguely neutral position
+  Eigen::VectorXd q_guess = Eigen::VectorXd::Zero(plant_.num_positions());
+  q_guess(0) = 1; //quaternion
+  q_guess(positions_map_.at("base_z")) = height;
+  q_guess(positions_map_.at("hip_pitch_left")) = 1;
+  q_guess(positions_map_.at("knee_left")) = -2;
+  q_guess(positions_map_.at("ankle_joint_left")) = 2;
+  q_guess(positions_map_.at("toe_left")) = -2;
+  q_guess(positions_map_.at("hip_pitch_right")) = 1;
+  q_guess(positions_map_.at("knee_right")) = -2;
+  q_guess(positions_map_.at("ankle_joint_right")) = 2;
+  q_guess(positions_map_.at("toe_right")) = -2;
+
+  q_guess += .05*Eigen::VectorXd::Random(plant_.num_positions());
 
   // Random guess, except for the positions
-  Eigen::VectorXd guess = Eigen::VectorXd::Random(program.num_vars());
-  guess.head(plant.num_positions()) = q_guess;
+  Eigen::VectorXd guess = Eigen::VectorXd::Random(program_.num_vars());
+  guess.head(plant_.num_positions()) = q_guess;
+  return guess;
+}
+
+void CassieFixedPointSolver(
+    const drake::multibody::MultibodyPlant<double>& plant,
+    double height, double mu, double min_normal_force,
+    bool linear_friction_cone, double toe_spread, VectorXd* q_result,
+    VectorXd* u_result, VectorXd* lambda_result,
+    std::string visualize_model_urdf) {
+  CassieFixedPointProgram fixed_point(plant, mu, linear_friction_cone,
+                                      toe_spread);
+  fixed_point.SetParameters(Eigen::Vector2d(height, min_normal_force));
+  Eigen::VectorXd guess = fixed_point.MakeInitialGuess(height);
+  const auto& q = fixed_point.q();
+  const auto& u = fixed_point.u();
+  const auto& lambda = fixed_point.lambda();
 
   auto start = std::chrono::high_resolution_clock::now();
-  const auto result = drake::solvers::Solve(program, guess);
+  const auto result = drake::solvers::Solve(fixed_point.program(), guess);
        auto finish = std::chrono::high_resolution_clock::now();
   std::chrono::duration<double> elapsed = finish - start;
   std::cout << "Solve time:" << elapsed.count() << std::endl;
@@ -157,6 +177,62 @@ void CassieFixedPointSolver(
   *lambda_result = result.GetSolution(lambda);
 }
 
+multibody::BatchSolveResults CassieFixedPointSweep(
+    const drake::multibody::MultibodyPlant<double>& plant,
+    const std::vector<double>& heights, double mu, double min_normal_force,
+    bool linear_friction_cone, double toe_spread, int num_guesses,
+    int num_threads, std::vector<VectorXd>* q_results,
+    std::vector<VectorXd>* u_results, std::vector<VectorXd>* lambda_results) {
+  // Build the parameters and random guesses up front, since
+  // Eigen::VectorXd::Random is not thread safe
+  CassieFixedPointProgram reference(plant, mu, linear_friction_cone,
+                                    toe_spread);
+  std::vector<VectorXd> parameters;
+  std::vector<std::vector<VectorXd>> guesses;
+  for (double height : heights) {
+    parameters.push_back(Eigen::Vector2d(height, min_normal_force));
+    guesses.emplace_back();
+    for (int i = 0; i < num_guesses; i++) {
+      guesses.back().push_back(reference.MakeInitialGuess(height));
+    }
+  }
+
+  auto make_program = [&]() {
+    return std::make_unique<CassieFixedPointProgram>(
+        plant, mu, linear_friction_cone, toe_spread);
+  };
+  auto batch = multibody::SolveInParallel(make_program, parameters, guesses,
+                                          num_threads);
+
+  // Every program instance creates its variables in the same order, so the
+  // reference program's variable indices apply to all solutions
+  const auto& program = reference.program();
+  const VectorXd nan = VectorXd::Constant(program.num_vars(),
+      std::numeric_limits<double>::quiet_NaN());
+  q_results->clear();
+  u_results->clear();
+  lambda_results->clear();
+  for (int best : batch.best) {
+    const VectorXd& x = (best < 0) ? nan : batch.results[best].solution;
+    VectorXd q(reference.q().size());
+    VectorXd u(reference.u().size());
+    VectorXd lambda(reference.lambda().size());
+    for (int i = 0; i < q.size(); i++) {
+      q(i) = x(program.FindDecisionVariableIndex(reference.q()(i)));
+    }
+    for (int i = 0; i < u.size(); i++) {
+      u(i) = x(program.FindDecisionVariableIndex(reference.u()(i)));
+    }
+    for (int i = 0; i < lambda.size(); i++) {
+      lambda(i) = x(program.FindDecisionVariableIndex(reference.lambda()(i)));
+    }
+    q_results->push_back(q);
+    u_results->push_back(u);
+    lambda_results->push_back(lambda);
+  }
+  return batch;
+}
+
 void CassieFixedBaseFixedPointSolver(
     const drake::multibody::MultibodyPlant<double>& plant,
     VectorXd* q_result, VectorXd* u_result,
@@ -1,6 +1,65 @@
+#pragma once
+
+#include <vector>
+
 #include "examples/Cassie/cassie_utils.h"
+#include "multibody/kinematic/kinematic_evaluator_set.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "multibody/multibody_batch_solver.h"
+#include "multibody/multibody_solvers.h"
 
 namespace dairlib {
+
+/// The program solved by CassieFixedPointSolver, with four point contacts
+/// (front toes fixed at +/- toe_spread, rear toes normal-only).
+/// Parameters (see multibody::ParametricProgram) are
+/// [pelvis height, minimum normal force], which only change bounds, so the
+/// program is built once and reused for parameter sweeps.
+class CassieFixedPointProgram : public multibody::ParametricProgram {
+ public:
+  // evaluators_ and program_ hold pointers to the evaluators above
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(CassieFixedPointProgram)
+
+  CassieFixedPointProgram(
+      const drake::multibody::MultibodyPlant<double>& plant, double mu,
+      bool linear_friction_cone, double toe_spread);
+
+  const drake::solvers::MathematicalProgram& program() const override {
+    return program_;
+  }
+
+  void SetParameters(const Eigen::VectorXd& parameters) override;
+
+  /// A vaguely neutral pose at the given height, randomly perturbed, with
+  /// a random guess for all other decision variables
+  Eigen::VectorXd MakeInitialGuess(double height) const;
+
+  const drake::solvers::VectorXDecisionVariable& q() const { return q_; }
+  const drake::solvers::VectorXDecisionVariable& u() const { return u_; }
+  const drake::solvers::VectorXDecisionVariable& lambda() const {
+    return lambda_;
+  }
+
+ private:
+  const drake::multibody::MultibodyPlant<double>& plant_;
+  multibody::DistanceEvaluator<double> left_loop_;
+  multibody::DistanceEvaluator<double> right_loop_;
+  multibody::WorldPointEvaluator<double> left_toe_evaluator_;
+  multibody::WorldPointEvaluator<double> left_heel_evaluator_;
+  multibody::WorldPointEvaluator<double> right_toe_evaluator_;
+  multibody::WorldPointEvaluator<double> right_heel_evaluator_;
+  multibody::KinematicEvaluatorSet<double> evaluators_;
+  multibody::MultibodyProgram<double> program_;
+  std::map<std::string, int> positions_map_;
+  drake::solvers::VectorXDecisionVariable q_;
+  drake::solvers::VectorXDecisionVariable u_;
+  drake::solvers::VectorXDecisionVariable lambda_;
+  drake::solvers::Binding<drake::solvers::BoundingBoxConstraint>
+      height_constraint_;
+  drake::solvers::Binding<drake::solvers::BoundingBoxConstraint>
+      normal_force_constraint_;
+};
+
 /// Utility method to solve for a fixed point for Cassie
 /// This is a very narrow method, but could be useful across different
 /// Cassie examples
@@ -24,6 +83,20 @@ void CassieFixedPointSolver(
     Eigen::VectorXd* u_result, Eigen::VectorXd* lambda_result,
     std::string visualize_model_urdf = "");
 
+/// Solves CassieFixedPointSolver for every pelvis height in heights, each from
+/// num_guesses random initial guesses, in parallel on num_threads threads
+/// (0 for one per core). See multibody::SolveInParallel.
+/// @param q_results, u_results, lambda_results The lowest cost solution for
+///    each height, or NaN if no solve succeeded for that height
+/// @return the statistics of every solve
+multibody::BatchSolveResults CassieFixedPointSweep(
+    const drake::multibody::MultibodyPlant<double>& plant,
+    const std::vector<double>& heights, double mu, double min_normal_force,
+    bool linear_friction_cone, double toe_spread, int num_guesses,
+    int num_threads, std::vector<Eigen::VectorXd>* q_results,
+    std::vector<Eigen::VectorXd>* u_results,
+    std::vector<Eigen::VectorXd>* lambda_results);
+
 /// Utility method to solve for loop constraints for Cassie for a neutral
 /// position
 /// @param plant 
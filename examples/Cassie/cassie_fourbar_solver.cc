@@ -0,0 +1,172 @@
+#include "examples/Cassie/cassie_fourbar_solver.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "examples/Cassie/cassie_utils.h"
+
+#include "drake/common/drake_assert.h"
+#include "drake/math/rigid_transform.h"
+#include "drake/multibody/tree/revolute_joint.h"
+
+namespace dairlib {
+namespace systems {
+
+using drake::math::RigidTransformd;
+using drake::math::RotationMatrixd;
+using drake::multibody::Body;
+using drake::multibody::Frame;
+using drake::multibody::Joint;
+using drake::multibody::JointIndex;
+using drake::multibody::MultibodyPlant;
+using drake::multibody::RevoluteJoint;
+using Eigen::Array2d;
+using Eigen::Vector2d;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+
+namespace {
+
+// The revolute joints from `parent` down to `child`
+std::vector<const RevoluteJoint<double>*> FindJoints(
+    const MultibodyPlant<double>& plant, const Body<double>& parent,
+    const Body<double>& child) {
+  std::vector<const RevoluteJoint<double>*> joints;
+  const Body<double>* body = &child;
+  while (body->index() != parent.index()) {
+    const Joint<double>* inboard_joint = nullptr;
+    for (JointIndex i(0); i < plant.num_joints(); ++i) {
+      if (plant.get_joint(i).child_body().index() == body->index()) {
+        inboard_joint = &plant.get_joint(i);
+      }
+    }
+    if (inboard_joint == nullptr) {
+      throw std::runtime_error(parent.name() + " is not a parent of " +
+                               child.name());
+    }
+    const auto* joint =
+        dynamic_cast<const RevoluteJoint<double>*>(inboard_joint);
+    if (joint == nullptr) {
+      throw std::runtime_error(inboard_joint->name() +
+                               " is not a revolute joint");
+    }
+    joints.insert(joints.begin(), joint);
+    body = &joint->parent_body();
+  }
+  return joints;
+}
+
+// The rotation of the frames of `joint` that turns its axis onto z
+RigidTransformd AxisToZ(const RevoluteJoint<double>& joint) {
+  return RigidTransformd(RotationMatrixd(Eigen::Quaterniond::FromTwoVectors(
+      joint.revolute_axis(), Vector3d::UnitZ())));
+}
+
+// The pose of the parent body of `joint` in its rotated frame F
+RigidTransformd ParentInRotatedFrame(const RevoluteJoint<double>& joint) {
+  return AxisToZ(joint) *
+         joint.frame_on_parent().GetFixedPoseInBodyFrame().inverse();
+}
+
+// The pose of the rotated frame M of `joint` in its child body
+RigidTransformd RotatedFrameInChild(const RevoluteJoint<double>& joint) {
+  return joint.frame_on_child().GetFixedPoseInBodyFrame() *
+         AxisToZ(joint).inverse();
+}
+
+}  // namespace
+
+CassieFourbarSolver::CassieFourbarSolver(const MultibodyPlant<double>& plant)
+    : rod_length_(kCassieAchillesLength) {
+  const std::array<std::pair<const Vector3d, const Frame<double>&>, 2>
+      rod_on_thighs = {LeftRodOnThigh(plant), RightRodOnThigh(plant)};
+  const std::array<std::pair<const Vector3d, const Frame<double>&>, 2>
+      rod_on_heel_springs = {LeftRodOnHeel(plant), RightRodOnHeel(plant)};
+
+  for (int leg = 0; leg < 2; leg++) {
+    const Frame<double>& thigh = rod_on_thighs[leg].second;
+    const Frame<double>& heel_spring = rod_on_heel_springs[leg].second;
+    const auto joints = FindJoints(plant, thigh.body(), heel_spring.body());
+    // The heel spring joint comes last, and is at rest
+    DRAKE_DEMAND(static_cast<int>(joints.size()) == kNumJoints + 1);
+    const RevoluteJoint<double>& heel_spring_joint = *joints[kNumJoints];
+    const RigidTransformd X_SA =
+        heel_spring.GetFixedPoseInBodyFrame().inverse() *
+        heel_spring_joint.frame_on_child().GetFixedPoseInBodyFrame() *
+        heel_spring_joint.frame_on_parent().GetFixedPoseInBodyFrame().inverse();
+
+    const Vector3d ball = ParentInRotatedFrame(*joints[0]) *
+                          thigh.GetFixedPoseInBodyFrame() *
+                          rod_on_thighs[leg].first;
+    ball_x_(leg) = ball(0);
+    ball_y_(leg) = ball(1);
+    ball_z_(leg) = ball(2);
+
+    for (int k = 0; k < kNumJoints; k++) {
+      position_indices_[k][leg] = joints[k]->position_start();
+      const RigidTransformd X_next =
+          (k + 1 < kNumJoints) ? ParentInRotatedFrame(*joints[k + 1]) : X_SA;
+      const RigidTransformd X = X_next * RotatedFrameInChild(*joints[k]);
+      for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+          transforms_[k][3 * i + j](leg) = X.rotation().matrix()(i, j);
+        }
+        transforms_[k][9 + i](leg) = X.translation()(i);
+      }
+    }
+
+    const Vector3d& rod_on_heel_spring = rod_on_heel_springs[leg].first;
+    spring_length_(leg) = rod_on_heel_spring.norm();
+    spring_rest_offset_(leg) =
+        std::atan(rod_on_heel_spring(1) / rod_on_heel_spring(0));
+  }
+}
+
+Vector2d CassieFourbarSolver::Solve(
+    const Eigen::Ref<const VectorXd>& q) const {
+  // Move the ball joint into the heel spring frame
+  Array2d x = ball_x_;
+  Array2d y = ball_y_;
+  Array2d z = ball_z_;
+  for (int k = 0; k < kNumJoints; k++) {
+    const Array2d angle(q(position_indices_[k][0]),
+                        q(position_indices_[k][1]));
+    const Array2d cos_angle = angle.cos();
+    const Array2d sin_angle = angle.sin();
+    // Into the rotated frame of the child side of the joint
+    const Array2d x_rot = cos_angle * x + sin_angle * y;
+    const Array2d y_rot = cos_angle * y - sin_angle * x;
+    const AffinePair& X = transforms_[k];
+    x = X[0] * x_rot + X[1] * y_rot + X[2] * z + X[9];
+    y = X[3] * x_rot + X[4] * y_rot + X[5] * z + X[10];
+    z = X[6] * x_rot + X[7] * y_rot + X[8] * z + X[11];
+  }
+
+  // Intersections of the circle of the spring with that of the rod, projected
+  // onto the xy plane of the heel spring (see solveFourbarLinkage())
+  const Array2d projected_rod_length_sq = rod_length_ * rod_length_ - z * z;
+  const Array2d spring_length_sq = spring_length_ * spring_length_;
+  const Array2d k = -y / x;
+  const Array2d c =
+      (spring_length_sq - projected_rod_length_sq + x * x + y * y) / (2 * x);
+  const Array2d a = k * k + 1;
+  const Array2d d = (k * k * c * c - a * (c * c - spring_length_sq)).sqrt();
+  const Array2d y_sol_1 = (-k * c + d) / a;
+  const Array2d y_sol_2 = (-k * c - d) / a;
+  const Array2d x_sol_1 = k * y_sol_1 + c;
+  const Array2d x_sol_2 = k * y_sol_2 + c;
+
+  // Pick the only physically feasible solution from the two intersections
+  const Eigen::Array<bool, 2, 1> is_sol_2 =
+      (x_sol_1 * y_sol_2 - y_sol_1 * x_sol_2) >= 0;
+  const Array2d x_sol = is_sol_2.select(x_sol_2, x_sol_1);
+  const Array2d y_sol = is_sol_2.select(y_sol_2, y_sol_1);
+
+  return Vector2d(std::atan2(y_sol(0), x_sol(0)) - spring_rest_offset_(0),
+                  std::atan2(y_sol(1), x_sol(1)) - spring_rest_offset_(1));
+}
+
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+
+#include <Eigen/Dense>
+
+#include "drake/multibody/plant/multibody_plant.h"
+
+namespace dairlib {
+namespace systems {
+
+/// CassieFourbarSolver calculates the heel spring angles of both legs from the
+/// joint angles, as CassieStateEstimator::solveFourbarLinkage() does, but
+/// without the plant kinematics.
+///
+/// The joints between a thigh and its heel spring (knee, knee spring and
+/// ankle) are revolute, and the heel spring is at rest in the four-bar
+/// problem. At construction, the fixed transforms between these joints are
+/// read from the plant, with the joint axes rotated onto z. Solve() then only
+/// moves the achilles ball joint from the thigh to the heel spring frame
+/// through three rotations about z, before intersecting the rod and the
+/// spring (see solveFourbarLinkage()). The two legs are stored side by side
+/// in Eigen::Array2d, so that each step works on both legs at once.
+class CassieFourbarSolver {
+ public:
+  /// @param plant the MultibodyPlant of Cassie with springs
+  explicit CassieFourbarSolver(
+      const drake::multibody::MultibodyPlant<double>& plant);
+
+  /// Returns the left and right heel spring angles for the positions `q` of
+  /// the plant. Only the knee, knee spring and ankle angles are read.
+  Eigen::Vector2d Solve(const Eigen::Ref<const Eigen::VectorXd>& q) const;
+
+ private:
+  // Knee, knee spring and ankle
+  static constexpr int kNumJoints = 3;
+  // An affine transform of each leg: the 3x3 rotation in row-major order,
+  // followed by the translation
+  typedef std::array<Eigen::Array2d, 12> AffinePair;
+
+  // Position indices of the joints of each leg
+  std::array<std::array<int, 2>, kNumJoints> position_indices_;
+  // The transform from the rotated frame of each joint to that of the next
+  // one (or to the heel spring frame after the ankle)
+  std::array<AffinePair, kNumJoints> transforms_;
+  // The achilles ball joint in the rotated frame of the knee
+  Eigen::Array2d ball_x_;
+  Eigen::Array2d ball_y_;
+  Eigen::Array2d ball_z_;
+  // The rod on the heel spring
+  Eigen::Array2d spring_length_;
+  Eigen::Array2d spring_rest_offset_;
+  double rod_length_;
+};
+
+}  // namespace systems
+}  // namespace dairlib
@@ -20,6 +20,7 @@ using Eigen::Isometry3d;
 using Eigen::Matrix3d;
 using Eigen::MatrixXd;
 using Eigen::Quaterniond;
+using Eigen::Vector2d;
 using Eigen::Vector3d;
 using Eigen::VectorXd;
 
@@ -58,6 +59,7 @@ CassieStateEstimator::CassieStateEstimator(
       rod_on_thighs_({LeftRodOnThigh(plant), RightRodOnThigh(plant)}),
       rod_on_heel_springs_({LeftRodOnHeel(plant), RightRodOnHeel(plant)}),
       rod_length_(kCassieAchillesLength),
+      fourbar_solver_(plant),
       context_gt_(plant_.CreateDefaultContext()),
       test_with_ground_truth_state_(test_with_ground_truth_state),
       print_info_to_terminal_(print_info_to_terminal),
@@ -227,6 +229,8 @@ CassieStateEstimator::CassieStateEstimator(
 /// solveFourbarLinkage() calculates the angle of heel spring joints given the
 /// configuration of Cassie which could be in either fixed-base or floating-
 /// base.
+/// It evaluates the kinematics of the plant, and is kept as the reference for
+/// CassieFourbarSolver, which the estimator uses at every update.
 ///
 /// Input:
 ///  - Generalize position of the robot `q`
@@ -452,24 +456,14 @@ void CassieStateEstimator::AssignNonFloatingBaseStateToOutputVector(
   output->SetVelocityAtIndex(
       velocity_idx_map_.at("ankle_spring_joint_rightdot"), 0.0);
 
-  // Solve fourbar linkage for heel spring positions
-  double left_heel_spring = 0;
-  double right_heel_spring = 0;
-  VectorXd q = output->GetMutablePositions();
-  if (is_floating_base_) {
-    // Floating-base state doesn't affect the spring values
-    // We assign the floating base of q in case output's floating base is
-    // not initialized.
-    for (int i = 0; i < 7; i++) {
-      q[i] = 0;
-    }
-    q[0] = 1;
-  }
-  solveFourbarLinkage(q, &left_heel_spring, &right_heel_spring);
+  // Solve fourbar linkage for heel spring positions. Only the leg joints are
+  // read, so neither the floating base nor the heel springs need to be set.
+  const Vector2d heel_springs =
+      fourbar_solver_.Solve(output->GetMutablePositions());
   output->SetPositionAtIndex(position_idx_map_.at("ankle_spring_joint_left"),
-                             left_heel_spring);
+                             heel_springs(0));
   output->SetPositionAtIndex(position_idx_map_.at("ankle_spring_joint_right"),
-                             right_heel_spring);
+                             heel_springs(1));
 }
 
 void CassieStateEstimator::AssignFloatingBaseStateToOutputVector(
@@ -1076,24 +1070,8 @@ EventStatus CassieStateEstimator::Update(
     }
 
     // Estimated floating base state (pelvis)
-    VectorXd estimated_fb_state(13);
-    Vector3d r_imu_to_pelvis_global =
-        ekf.getState().getRotation() * (-imu_pos_);
-    // Rotational position
-    Quaterniond q(ekf.getState().getRotation());
-    q.normalize();
-    estimated_fb_state[0] = q.w();
-    estimated_fb_state.segment<3>(1) = q.vec();
-    // Translational position
-    estimated_fb_state.segment<3>(4) =
-        ekf.getState().getPosition() + r_imu_to_pelvis_global;
-    // Rotational velocity
-    Vector3d omega_global =
-        ekf.getState().getRotation() * imu_measurement.head(3);
-    estimated_fb_state.segment<3>(7) = omega_global;
-    // Translational velocity
-    estimated_fb_state.tail(3) = ekf.getState().getVelocity() +
-                                 omega_global.cross(r_imu_to_pelvis_global);
+    VectorXd estimated_fb_state =
+        CalcFloatingBaseState(ekf.getState(), imu_measurement.head(3));
 
     // Estimated robot output
     OutputVector<double> filtered_output(n_q_, n_v_, n_u_);
@@ -1197,7 +1175,6 @@ EventStatus CassieStateEstimator::Update(
 
     if (print_info_to_terminal_) {
       // Print for debugging
-      q = Quaterniond(ekf.getState().getRotation()).normalized();
       cout << "Update: " << endl;
       // cout << "Orientation (quaternion) : " << endl;
       // cout << q.w() << " ";
@@ -1228,20 +1205,8 @@ EventStatus CassieStateEstimator::Update(
     // Step 5 - Assign values to floating base state (pelvis)
     // We get the angular velocity directly from the IMU without filtering
     // because the magnitude of noise is about 2e-3.
-    // Rotational position
-    q = Quaterniond(ekf.getState().getRotation()).normalized();
-    estimated_fb_state[0] = q.w();
-    estimated_fb_state.segment<3>(1) = q.vec();
-    // Translational position
-    r_imu_to_pelvis_global = ekf.getState().getRotation() * (-imu_pos_);
-    estimated_fb_state.segment<3>(4) =
-        ekf.getState().getPosition() + r_imu_to_pelvis_global;
-    // Rotational velocity
-    omega_global = ekf.getState().getRotation() * imu_measurement.head(3);
-    estimated_fb_state.segment<3>(7) = omega_global;
-    // Translational velocity
-    estimated_fb_state.tail(3) = ekf.getState().getVelocity() +
-                                 omega_global.cross(r_imu_to_pelvis_global);
+    estimated_fb_state =
+        CalcFloatingBaseState(ekf.getState(), imu_measurement.head(3));
     state->get_mutable_discrete_state()
             .get_mutable_vector(fb_state_idx_)
             .get_mutable_value()
@@ -1261,6 +1226,42 @@ EventStatus CassieStateEstimator::Update(
   return EventStatus::Succeeded();
 }
 
+void CassieStateEstimator::PredictToTime(Context<double>* context,
+                                         double time) const {
+  if (!is_floating_base_) return;
+  const double prev_t = context->get_discrete_state(time_idx_).get_value()(0);
+  if (time <= prev_t) return;
+
+  const VectorXd prev_imu =
+      context->get_discrete_state(prev_imu_idx_).get_value();
+  auto& ekf = context->get_mutable_abstract_state<inekf::InEKF>(ekf_idx_);
+  ekf.Propagate(prev_imu, time - prev_t);
+
+  context->get_mutable_discrete_state(fb_state_idx_).get_mutable_value()
+      << CalcFloatingBaseState(ekf.getState(), prev_imu.head(3));
+  context->get_mutable_discrete_state(time_idx_).get_mutable_value() << time;
+}
+
+VectorXd CassieStateEstimator::CalcFloatingBaseState(
+    inekf::RobotState ekf_state, const Vector3d& imu_angular_velocity) const {
+  VectorXd fb_state(13);
+  Vector3d r_imu_to_pelvis_global = ekf_state.getRotation() * (-imu_pos_);
+  // Rotational position
+  Quaterniond q(ekf_state.getRotation());
+  q.normalize();
+  fb_state[0] = q.w();
+  fb_state.segment<3>(1) = q.vec();
+  // Translational position
+  fb_state.segment<3>(4) = ekf_state.getPosition() + r_imu_to_pelvis_global;
+  // Rotational velocity
+  Vector3d omega_global = ekf_state.getRotation() * imu_angular_velocity;
+  fb_state.segment<3>(7) = omega_global;
+  // Translational velocity
+  fb_state.tail(3) =
+      ekf_state.getVelocity() + omega_global.cross(r_imu_to_pelvis_global);
+  return fb_state;
+}
+
 /// Workhorse state estimation function. Given a `cassie_out_t`, compute the
 /// estimated state as an OutputVector
 /// Since it needs to map from a struct to a vector, and no assumptions on the
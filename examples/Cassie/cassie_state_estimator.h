@@ -13,6 +13,7 @@
 #include "multibody/multibody_utils.h"
 #include "systems/framework/output_vector.h"
 #include "systems/framework/timestamped_vector.h"
+#include "examples/Cassie/cassie_fourbar_solver.h"
 #include "examples/Cassie/datatypes/cassie_out_t.h"
 #include "examples/Cassie/cassie_utils.h"
 #include "multibody/kinematic/kinematic_evaluator_set.h"
@@ -90,6 +91,16 @@ class CassieStateEstimator : public drake::systems::LeafSystem<double> {
                             Eigen::Vector3d position);
   void setPreviousImuMeasurement(drake::systems::Context<double>* context,
                                  const Eigen::VectorXd& imu_value);
+
+  /// Propagates the EKF forward to `time` with the previous imu measurement,
+  /// without a measurement update, for when the next cassie_out_t is missing
+  /// or late. The floating base state is updated, while the rest of the
+  /// output keeps the values of the last cassie_out_t. The next update then
+  /// propagates from `time`. Does nothing if `time` is not after the previous
+  /// time or if the model is fixed-based.
+  void PredictToTime(drake::systems::Context<double>* context,
+                     double time) const;
+
  private:
   void AssignImuValueToOutputVector(const cassie_out_t& cassie_out,
       systems::OutputVector<double>* output) const;
@@ -99,6 +110,11 @@ class CassieStateEstimator : public drake::systems::LeafSystem<double> {
       systems::OutputVector<double>* output) const;
   void AssignFloatingBaseStateToOutputVector(const Eigen::VectorXd& state_est,
       systems::OutputVector<double>* output) const;
+  // Floating base state (pelvis) from the state of the ekf and the angular
+  // velocity measured by the imu
+  Eigen::VectorXd CalcFloatingBaseState(
+      inekf::RobotState ekf_state,
+      const Eigen::Vector3d& imu_angular_velocity) const;
 
 
   drake::systems::EventStatus Update(
@@ -158,6 +174,7 @@ class CassieStateEstimator : public drake::systems::LeafSystem<double> {
       std::pair<const Eigen::Vector3d, const drake::multibody::Frame<double>&>>
       rod_on_heel_springs_;
   double rod_length_;
+  CassieFourbarSolver fourbar_solver_;
   Eigen::Vector3d front_contact_disp_;
   Eigen::Vector3d rear_contact_disp_;
   Eigen::Vector3d mid_contact_disp_;
@@ -0,0 +1,195 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <gflags/gflags.h>
+
+#include "examples/Cassie/cassie_fixed_point_solver.h"
+#include "examples/Cassie/cassie_utils.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "multibody/multibody_utils.h"
+#include "systems/controllers/constrained_lqr_controller.h"
+#include "systems/controllers/lqr_gain_schedule.h"
+
+// Sweeps CassieFixedPointSolver over a range of pelvis heights and computes
+// the constrained LQR controller of run_lqr_balancing about each fixed point,
+// in parallel. The controllers are saved as an LQRGainSchedule over the
+// pelvis height, for run_lqr_balancing --gain_schedule.
+
+DEFINE_double(min_height, 0.65, "Lowest pelvis height of the schedule");
+DEFINE_double(max_height, 0.95, "Highest pelvis height of the schedule");
+DEFINE_int32(num_heights, 13, "Number of (uniformly spaced) heights");
+DEFINE_int32(num_guesses, 4, "Number of random initial guesses per height");
+DEFINE_int32(num_threads, 0, "Number of threads, 0 for one per core");
+DEFINE_string(output, "examples/Cassie/lqr_gain_schedule.bin",
+              "Gain schedule file");
+
+DEFINE_double(Q_scale, 1, "Gain for Q");
+DEFINE_double(Q_xy, 1, "Gain for Q");
+DEFINE_double(R_toe_scale, 1, "Gain for R diagonal toe elements");
+DEFINE_bool(spring_model, true, "Use a URDF with or without legs springs");
+
+namespace dairlib {
+
+using drake::AutoDiffVecXd;
+using drake::AutoDiffXd;
+using drake::multibody::MultibodyPlant;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using std::vector;
+
+namespace {
+
+// The constraints of run_lqr_balancing: loop closures, front toes fixed and
+// rear toes fixed in the normal direction
+class BalancingConstraints {
+ public:
+  explicit BalancingConstraints(const MultibodyPlant<AutoDiffXd>& plant)
+      : left_loop_(LeftLoopClosureEvaluator(plant)),
+        right_loop_(RightLoopClosureEvaluator(plant)),
+        left_toe_(plant, LeftToeFront(plant).first, LeftToeFront(plant).second,
+                  Eigen::Matrix3d::Identity(), Eigen::Vector3d::Zero(),
+                  {1, 2}),
+        right_toe_(plant, RightToeFront(plant).first,
+                   RightToeFront(plant).second, Eigen::Matrix3d::Identity(),
+                   Eigen::Vector3d::Zero(), {1, 2}),
+        left_heel_(plant, LeftToeRear(plant).first,
+                   LeftToeRear(plant).second),
+        right_heel_(plant, RightToeRear(plant).first,
+                    RightToeRear(plant).second),
+        evaluators_(plant) {
+    evaluators_.add_evaluator(&left_loop_);
+    evaluators_.add_evaluator(&right_loop_);
+    evaluators_.add_evaluator(&left_toe_);
+    evaluators_.add_evaluator(&right_toe_);
+    evaluators_.add_evaluator(&left_heel_);
+    evaluators_.add_evaluator(&right_heel_);
+  }
+
+  const multibody::KinematicEvaluatorSet<AutoDiffXd>& evaluators() const {
+    return evaluators_;
+  }
+
+ private:
+  multibody::DistanceEvaluator<AutoDiffXd> left_loop_;
+  multibody::DistanceEvaluator<AutoDiffXd> right_loop_;
+  multibody::WorldPointEvaluator<AutoDiffXd> left_toe_;
+  multibody::WorldPointEvaluator<AutoDiffXd> right_toe_;
+  multibody::WorldPointEvaluator<AutoDiffXd> left_heel_;
+  multibody::WorldPointEvaluator<AutoDiffXd> right_heel_;
+  multibody::KinematicEvaluatorSet<AutoDiffXd> evaluators_;
+};
+
+}  // namespace
+
+int do_main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  drake::logging::set_log_level("err");  // ignore warnings about joint limits
+
+  std::string urdf;
+  if (FLAGS_spring_model) {
+    urdf = "examples/Cassie/urdf/cassie_v2.urdf";
+  } else {
+    urdf = "examples/Cassie/urdf/cassie_fixed_springs.urdf";
+  }
+
+  MultibodyPlant<double> plant(0.0);
+  addCassieMultibody(&plant, nullptr, true, urdf, FLAGS_spring_model, false);
+  plant.Finalize();
+  const int nq = plant.num_positions();
+  const int nv = plant.num_velocities();
+  const int nu = plant.num_actuators();
+
+  // Fixed points, with the parameters of run_lqr_balancing
+  double mu_fp = 0;
+  double min_normal_fp = 70;
+  double toe_spread = .2;
+  VectorXd heights_vec = VectorXd::LinSpaced(FLAGS_num_heights,
+                                             FLAGS_min_height,
+                                             FLAGS_max_height);
+  vector<double> heights(heights_vec.data(),
+                         heights_vec.data() + heights_vec.size());
+  vector<VectorXd> q_sweep, u_sweep, lambda_sweep;
+  auto batch = CassieFixedPointSweep(plant, heights, mu_fp, min_normal_fp,
+                                     true, toe_spread, FLAGS_num_guesses,
+                                     FLAGS_num_threads, &q_sweep, &u_sweep,
+                                     &lambda_sweep);
+  std::cout << "Solved " << batch.num_success << "/" << batch.results.size()
+            << " fixed points in " << batch.wall_time << "s" << std::endl;
+  for (int i = 0; i < FLAGS_num_heights; i++) {
+    if (batch.best[i] < 0) {
+      std::cerr << "No fixed point at height " << heights[i] << std::endl;
+      return 1;
+    }
+  }
+
+  // Controller costs, as in run_lqr_balancing
+  MatrixXd Q = MatrixXd::Zero(nq + nv, nq + nv);
+  Q.topLeftCorner(nq, nq) = FLAGS_Q_scale * 10 * MatrixXd::Identity(nq, nq);
+  Q.bottomRightCorner(nv, nv) = FLAGS_Q_scale * MatrixXd::Identity(nv, nv);
+  Q(4, 4) *= FLAGS_Q_xy;
+  Q(5, 5) *= FLAGS_Q_xy;
+  MatrixXd R = MatrixXd::Identity(nu, nu);
+  R(8, 8) *= FLAGS_R_toe_scale;
+  R(9, 9) *= FLAGS_R_toe_scale;
+
+  auto positions_map = multibody::makeNameToPositionsMap(plant);
+  systems::LQRGainSchedule schedule({heights},
+                                    {positions_map.at("base_z")}, nq + nv,
+                                    nu);
+
+  // Each worker converts its own plant and builds its own constraints, and
+  // pulls heights in order. Every schedule entry is written by one worker.
+  int num_threads = FLAGS_num_threads;
+  if (num_threads <= 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  num_threads = std::min(num_threads, FLAGS_num_heights);
+  std::atomic<int> next_height{0};
+  std::mutex plant_mutex;
+  auto worker = [&]() {
+    std::unique_ptr<MultibodyPlant<AutoDiffXd>> plant_ad;
+    {
+      std::lock_guard<std::mutex> lock(plant_mutex);
+      plant_ad = drake::systems::System<double>::ToAutoDiffXd(plant);
+    }
+    BalancingConstraints constraints(*plant_ad);
+    for (int i = next_height++; i < FLAGS_num_heights; i = next_height++) {
+      VectorXd xu(nq + nv + nu);
+      xu << q_sweep[i], VectorXd::Zero(nv), u_sweep[i];
+      AutoDiffVecXd xu_ad = drake::math::initializeAutoDiff(xu);
+      auto context_ad = multibody::createContext(
+          *plant_ad, AutoDiffVecXd(xu_ad.head(nq + nv)),
+          AutoDiffVecXd(xu_ad.tail(nu)));
+
+      systems::ConstrainedLQRController controller(
+          constraints.evaluators(), *context_ad, lambda_sweep[i], Q, R);
+      schedule.SetEntry(i, controller.get_K(), controller.get_E(),
+                        controller.get_desired_state());
+    }
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  vector<std::thread> workers;
+  for (int i = 0; i < num_threads; i++) {
+    workers.emplace_back(worker);
+  }
+  for (auto& thread : workers) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << "Computed " << FLAGS_num_heights << " LQR controllers in "
+            << elapsed.count() << "s on " << num_threads << " threads"
+            << std::endl;
+
+  schedule.Save(FLAGS_output);
+  std::cout << "Saved the gain schedule to " << FLAGS_output << std::endl;
+
+  return 0;
+}
+
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::do_main(argc, argv); }
@@ -8,6 +8,7 @@
 #include "drake/systems/framework/diagram.h"
 #include "drake/systems/framework/diagram_builder.h"
 
+#include "common/realtime.h"
 #include "multibody/multibody_utils.h"
 #include "systems/robot_lcm_systems.h"
 #include "examples/Cassie/input_supervisor.h"
@@ -17,6 +18,7 @@
 #include "dairlib/lcmt_robot_output.hpp"
 #include "dairlib/lcmt_controller_switch.hpp"
 #include "systems/framework/lcm_driven_loop.h"
+#include "systems/framework/shared_memory_transport.h"
 
 namespace dairlib {
 using drake::systems::DiagramBuilder;
@@ -55,6 +57,24 @@ DEFINE_string(control_channel_name_3, "OSC_WALKING",
 // Cassie model parameter
 DEFINE_bool(floating_base, true, "Fixed or floating base model");
 
+DEFINE_string(shared_memory_channel, "",
+              "Control channel received over shared memory from a controller "
+              "on the same host (e.g. OSC_WALKING). Empty for none");
+DEFINE_bool(shared_memory_spin, false,
+            "Busy wait for the shared memory channel instead of sleeping (for "
+            "an isolated cpu)");
+
+DEFINE_int32(rt_priority, 0,
+             "SCHED_FIFO priority (1-99) of the main loop. 0 keeps the default "
+             "scheduling");
+DEFINE_string(rt_cpus, "",
+              "Cpus the main loop is pinned to, e.g. \"2,3\" or \"2-3\"");
+DEFINE_bool(rt_lock_memory, false,
+            "Lock the memory of the process in RAM and prefault the heap");
+DEFINE_double(rt_report_period, 0,
+              "Period (s) of the report of the real-time settings and page "
+              "faults. 0 for no report");
+
 /// Runs UDP driven loop for 10 seconds
 /// Re-publishes any received messages as LCM
 int do_main(int argc, char* argv[]) {
@@ -145,6 +165,28 @@ int do_main(int argc, char* argv[]) {
        FLAGS_control_channel_name_1,
        switch_channel,
        true);
+  std::unique_ptr<systems::SharedMemorySubscriber<dairlib::lcmt_robot_input>>
+      command_sub;
+  if (!FLAGS_shared_memory_channel.empty()) {
+    command_sub = std::make_unique<
+        systems::SharedMemorySubscriber<dairlib::lcmt_robot_input>>(
+        FLAGS_shared_memory_channel);
+    loop.SetSharedMemoryInput(FLAGS_shared_memory_channel, command_sub.get(),
+                              FLAGS_shared_memory_spin);
+  }
+
+  // Real-time settings of the main loop
+  RealtimeOptions realtime_options;
+  realtime_options.priority = FLAGS_rt_priority;
+  realtime_options.cpus = ParseCpuList(FLAGS_rt_cpus);
+  realtime_options.lock_memory = FLAGS_rt_lock_memory;
+  SetupRealtimeThread("dispatcher_robot_in", realtime_options);
+  std::unique_ptr<RealtimeReporter> realtime_reporter;
+  if (FLAGS_rt_report_period > 0) {
+    realtime_reporter =
+        std::make_unique<RealtimeReporter>(FLAGS_rt_report_period);
+  }
+
   loop.Simulate();
 
   return 0;
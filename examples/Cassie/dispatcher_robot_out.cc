@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <memory>
 
 #include <gflags/gflags.h>
@@ -9,16 +10,21 @@
 #include "drake/systems/lcm/lcm_subscriber_system.h"
 
 #include "dairlib/lcmt_cassie_out.hpp"
+#include "dairlib/lcmt_cassie_udp_timing.hpp"
+#include "common/realtime.h"
 #include "dairlib/lcmt_robot_output.hpp"
 #include "examples/Cassie/cassie_state_estimator.h"
 #include "examples/Cassie/cassie_utils.h"
 #include "examples/Cassie/networking/cassie_output_receiver.h"
 #include "examples/Cassie/networking/cassie_output_sender.h"
+#include "examples/Cassie/networking/cassie_udp_timing.h"
 #include "examples/Cassie/networking/simple_cassie_udp_subscriber.h"
 #include "multibody/kinematic/kinematic_evaluator_set.h"
 #include "multibody/kinematic/world_point_evaluator.h"
 #include "multibody/multibody_utils.h"
 #include "systems/framework/lcm_driven_loop.h"
+#include "systems/framework/lcm_log_replay.h"
+#include "systems/framework/shared_memory_transport.h"
 #include "systems/robot_lcm_systems.h"
 
 namespace dairlib {
@@ -52,6 +58,59 @@ DEFINE_string(state_channel_name, "CASSIE_STATE_SIMULATION",
 // Cassie model paramter
 DEFINE_bool(floating_base, true, "Fixed or floating base model");
 
+DEFINE_int32(rt_priority, 0,
+             "SCHED_FIFO priority (1-99) of the main loop. 0 keeps the default "
+             "scheduling");
+DEFINE_string(rt_cpus, "",
+              "Cpus the main loop is pinned to, e.g. \"2,3\" or \"2-3\"");
+DEFINE_bool(rt_lock_memory, false,
+            "Lock the memory of the process in RAM and prefault the heap");
+DEFINE_double(rt_report_period, 0,
+              "Period (s) of the report of the real-time settings and page "
+              "faults. 0 for no report");
+
+DEFINE_bool(shared_memory, false,
+            "Send CASSIE_STATE_DISPATCHER over shared memory to a controller "
+            "on the same host, mirrored on LCM for logging");
+DEFINE_double(shared_memory_mirror_period, 0,
+              "Minimum period (s) of the LCM mirror of the shared memory "
+              "channel");
+
+DEFINE_double(udp_late_period, 0,
+              "Time (s) after the last UDP packet after which it is late, and "
+              "the floating base state is predicted with the last imu "
+              "measurement instead. 0 to always wait for the packets");
+DEFINE_double(udp_max_prediction, 0.05,
+              "Maximum time (s) the state is predicted without packets");
+DEFINE_double(udp_timing_period, 0.1,
+              "Publishing period (s) of CASSIE_UDP_TIMING");
+DEFINE_bool(udp_check_sequence, true,
+            "Drop the duplicate and reordered UDP packets, from their "
+            "sequence numbers");
+
+DEFINE_string(replay_log, "",
+              "Instead of listening on CASSIE_OUTPUT, run the dispatcher (as "
+              "in simulation) on the replay_channel messages of this LCM log "
+              "as fast as possible, and record CASSIE_STATE_DISPATCHER (see "
+              "LcmLogReplay)");
+DEFINE_string(replay_channel, "CASSIE_OUTPUT",
+              "The lcmt_cassie_out channel of replay_log. It needs every "
+              "message from the robot");
+DEFINE_string(replay_output_log, "",
+              "LCM log the messages recorded in the replay are written to");
+DEFINE_string(replay_golden_log, "",
+              "LCM log (e.g. the replay_output_log of an earlier run) the "
+              "messages recorded in the replay are compared with");
+DEFINE_string(replay_tick_times, "",
+              "File the compute time of every tick of the replay is written "
+              "to");
+DEFINE_string(replay_baseline_tick_times, "",
+              "replay_tick_times of an earlier run on the same machine, the "
+              "compute times of the replay are compared with");
+DEFINE_double(replay_max_slowdown, 1.2,
+              "Ratio of the median or p99 compute time over the baseline "
+              "above which the replay fails");
+
 // Testing mode
 DEFINE_int64(test_mode, -1,
              "-1: Regular EKF (not testing mode). "
@@ -81,8 +140,13 @@ void setInitialEkfState(const drake::systems::Diagram<double>& diagram,
 int do_main(int argc, char* argv[]) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
-  drake::lcm::DrakeLcm lcm_local("udpm://239.255.76.67:7667?ttl=0");
-  drake::lcm::DrakeLcm lcm_network("udpm://239.255.76.67:7667?ttl=1");
+  // A replay stays in the process
+  const bool is_replay = !FLAGS_replay_log.empty();
+  DRAKE_DEMAND(!(is_replay && FLAGS_shared_memory));
+  drake::lcm::DrakeLcm lcm_local(is_replay ? "memq://"
+                                           : "udpm://239.255.76.67:7667?ttl=0");
+  drake::lcm::DrakeLcm lcm_network(
+      is_replay ? "memq://" : "udpm://239.255.76.67:7667?ttl=1");
   DiagramBuilder<double> builder;
 
   // Build Cassie MBP
@@ -141,7 +205,7 @@ int do_main(int argc, char* argv[]) {
 
   // Connect appropriate input receiver for simulation
   systems::CassieOutputReceiver* input_receiver = nullptr;
-  if (FLAGS_simulation) {
+  if (FLAGS_simulation || is_replay) {
     input_receiver = builder.AddSystem<systems::CassieOutputReceiver>();
     builder.Connect(*input_receiver, *output_sender);
     builder.Connect(input_receiver->get_output_port(0),
@@ -166,9 +230,18 @@ int do_main(int argc, char* argv[]) {
   // Create and connect RobotOutput publisher.
   auto robot_output_sender =
       builder.AddSystem<systems::RobotOutputSender>(plant, true);
-  auto state_pub =
-      builder.AddSystem(LcmPublisherSystem::Make<dairlib::lcmt_robot_output>(
-          "CASSIE_STATE_DISPATCHER", &lcm_local, {TriggerType::kForced}));
+  drake::systems::LeafSystem<double>* state_pub;
+  if (FLAGS_shared_memory) {
+    state_pub = builder.AddSystem(
+        std::make_unique<
+            systems::SharedMemoryPublisherSystem<dairlib::lcmt_robot_output>>(
+            "CASSIE_STATE_DISPATCHER", &lcm_local,
+            FLAGS_shared_memory_mirror_period));
+  } else {
+    state_pub =
+        builder.AddSystem(LcmPublisherSystem::Make<dairlib::lcmt_robot_output>(
+            "CASSIE_STATE_DISPATCHER", &lcm_local, {TriggerType::kForced}));
+  }
 
   // Create and connect RobotOutput publisher (low-rate for the network)
   auto net_state_pub =
@@ -207,37 +280,41 @@ int do_main(int argc, char* argv[]) {
   drake::systems::Simulator<double> simulator(std::move(owned_diagram));
   auto& diagram_context = simulator.get_mutable_context();
 
-  if (FLAGS_simulation) {
+  // Real-time settings of the main loop
+  RealtimeOptions realtime_options;
+  realtime_options.priority = FLAGS_rt_priority;
+  realtime_options.cpus = ParseCpuList(FLAGS_rt_cpus);
+  realtime_options.lock_memory = FLAGS_rt_lock_memory;
+  SetupRealtimeThread("dispatcher_robot_out", realtime_options);
+  std::unique_ptr<RealtimeReporter> realtime_reporter;
+  if (FLAGS_rt_report_period > 0) {
+    realtime_reporter =
+        std::make_unique<RealtimeReporter>(FLAGS_rt_report_period);
+  }
+
+  if (FLAGS_simulation || is_replay) {
     auto& input_receiver_context =
         diagram.GetMutableSubsystemContext(*input_receiver, &diagram_context);
+    drake::systems::FixedInputPortValue* input_value = nullptr;
+
+    // Initializes the context with the first message, and advances it to the
+    // time of every following message
+    auto step = [&](const dairlib::lcmt_cassie_out& message) {
+      const double time = message.utime * 1e-6;
+      if (input_value == nullptr) {
+        diagram_context.SetTime(time);
+        input_value = &input_receiver->get_input_port(0).FixValue(
+            &input_receiver_context, message);
+
+        // Set EKF previous time
+        if (FLAGS_floating_base) {
+          setInitialEkfState(diagram, state_estimator, diagram_context, time);
+        }
+        return;
+      }
 
-    // Wait for the first message.
-    drake::log()->info("Waiting for first lcmt_cassie_out");
-    drake::lcm::Subscriber<dairlib::lcmt_cassie_out> input_sub(&lcm_local,
-                                                               "CASSIE_OUTPUT");
-    LcmHandleSubscriptionsUntil(&lcm_local,
-                                [&]() { return input_sub.count() > 0; });
-
-    // Initialize the context based on the first message.
-    const double t0 = input_sub.message().utime * 1e-6;
-    diagram_context.SetTime(t0);
-    auto& input_value = input_receiver->get_input_port(0).FixValue(
-        &input_receiver_context, input_sub.message());
-
-    // Set EKF previous time
-    if (FLAGS_floating_base) {
-      setInitialEkfState(diagram, state_estimator, diagram_context, t0);
-    }
-
-    drake::log()->info("dispatcher_robot_out started");
-    while (true) {
-      // Wait for an lcmt_cassie_out message.
-      input_sub.clear();
-      LcmHandleSubscriptionsUntil(&lcm_local,
-                                  [&]() { return input_sub.count() > 0; });
       // Write the lcmt_robot_input message into the context and advance.
-      input_value.GetMutableData()->set_value(input_sub.message());
-      const double time = input_sub.message().utime * 1e-6;
+      input_value->GetMutableData()->set_value(message);
 
       // Check if we are very far ahead or behind
       // (likely due to a restart of the driving clock)
@@ -253,6 +330,41 @@ int do_main(int argc, char* argv[]) {
       simulator.AdvanceTo(time);
       // Force-publish via the diagram
       diagram.Publish(diagram_context);
+    };
+
+    if (is_replay) {
+      systems::LcmLogReplayOptions replay_options;
+      replay_options.input_log = FLAGS_replay_log;
+      replay_options.input_channel = FLAGS_replay_channel;
+      if (FLAGS_floating_base && FLAGS_test_with_ground_truth_state) {
+        replay_options.forwarded_channels = {FLAGS_state_channel_name};
+      }
+      replay_options.output_channels = {"CASSIE_STATE_DISPATCHER"};
+      replay_options.output_log = FLAGS_replay_output_log;
+      replay_options.golden_log = FLAGS_replay_golden_log;
+      replay_options.tick_times = FLAGS_replay_tick_times;
+      replay_options.baseline_tick_times = FLAGS_replay_baseline_tick_times;
+      replay_options.max_slowdown = FLAGS_replay_max_slowdown;
+      systems::LcmLogReplay replay(&lcm_local, replay_options);
+      replay.Replay(systems::MakeTickFunction<dairlib::lcmt_cassie_out>(step));
+      return replay.Report() ? 0 : 1;
+    }
+
+    // Wait for the first message.
+    drake::log()->info("Waiting for first lcmt_cassie_out");
+    drake::lcm::Subscriber<dairlib::lcmt_cassie_out> input_sub(&lcm_local,
+                                                               "CASSIE_OUTPUT");
+    LcmHandleSubscriptionsUntil(&lcm_local,
+                                [&]() { return input_sub.count() > 0; });
+    step(input_sub.message());
+
+    drake::log()->info("dispatcher_robot_out started");
+    while (true) {
+      // Wait for an lcmt_cassie_out message.
+      input_sub.clear();
+      LcmHandleSubscriptionsUntil(&lcm_local,
+                                  [&]() { return input_sub.count() > 0; });
+      step(input_sub.message());
     }
   } else {
     auto& output_sender_context =
@@ -261,9 +373,13 @@ int do_main(int argc, char* argv[]) {
         diagram.GetMutableSubsystemContext(*state_estimator, &diagram_context);
 
     // Wait for the first message.
-    SimpleCassieUdpSubscriber udp_sub(FLAGS_address, FLAGS_port);
+    SimpleCassieUdpSubscriber udp_sub(FLAGS_address, FLAGS_port,
+                                      FLAGS_udp_check_sequence);
+    systems::CassieUdpTiming udp_timing;
+    lcmt_cassie_udp_timing udp_timing_msg;
     drake::log()->info("Waiting for first UDP message from Cassie");
     udp_sub.Poll();
+    udp_timing.Receive(udp_sub.message_time());
 
     // Initialize the context based on the first message.
     const double t0 = udp_sub.message_time();
@@ -278,8 +394,36 @@ int do_main(int argc, char* argv[]) {
         &state_estimator_context, udp_sub.message());
     drake::log()->info("dispatcher_robot_out started");
 
+    double late_time = t0 + FLAGS_udp_late_period;
+    double last_timing_time = t0;
     while (true) {
-      udp_sub.Poll();
+      if (udp_sub.time() - last_timing_time >= FLAGS_udp_timing_period) {
+        last_timing_time = udp_sub.time();
+        udp_timing.CopyToLcm(udp_sub.sequence(), last_timing_time,
+                             &udp_timing_msg);
+        drake::lcm::Publish(&lcm_local, "CASSIE_UDP_TIMING", udp_timing_msg);
+      }
+
+      if (FLAGS_udp_late_period <= 0) {
+        udp_sub.Poll();
+      } else if (!udp_sub.Poll(std::max(late_time - udp_sub.time(), 0.0))) {
+        // The packet is late or lost. Rather than let the controller act on
+        // a stale state, predict the floating base state to the current time
+        // with the last imu measurement, until the packets come back.
+        udp_timing.Late();
+        const double time = udp_sub.time();
+        late_time = time + FLAGS_udp_late_period;
+        if (FLAGS_floating_base &&
+            time - udp_sub.message_time() <= FLAGS_udp_max_prediction &&
+            time > simulator.get_context().get_time()) {
+          state_estimator->PredictToTime(&state_estimator_context, time);
+          diagram_context.SetTime(time);
+          diagram.Publish(diagram_context);
+        }
+        continue;
+      }
+      udp_timing.Receive(udp_sub.message_time());
+      late_time = udp_sub.message_time() + FLAGS_udp_late_period;
       output_sender_value.GetMutableData()->set_value(udp_sub.message());
       state_estimator_value.GetMutableData()->set_value(udp_sub.message());
       const double time = udp_sub.message_time();
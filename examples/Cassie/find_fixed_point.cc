@@ -9,6 +9,14 @@ DEFINE_double(mu, .5, "Coefficient of friction,");
 DEFINE_double(min_normal_force, 50, "Minimum normal force per contact pont.");
 DEFINE_bool(linear_friction_cone, true, "Use linear or nonlinear Lorentz cone,");
 DEFINE_bool(spring_model, false, "Use a URDF with or without legs springs");
+DEFINE_double(sweep_height_max, 0, "If greater than height, solve for "
+              "num_sweep_heights heights between height and this height, "
+              "in parallel");
+DEFINE_int32(num_sweep_heights, 10, "Number of heights in the sweep");
+DEFINE_int32(num_guesses, 4, "Number of random initial guesses per height in "
+             "the sweep");
+DEFINE_int32(num_threads, 0, "Number of threads for the sweep, 0 for one per "
+             "core");
 
 namespace dairlib {
 
@@ -28,6 +36,33 @@ int do_main(int argc, char* argv[]) {
   addCassieMultibody(&plant, nullptr, true, urdf, FLAGS_spring_model, false);
   plant.Finalize();
 
+  if (FLAGS_sweep_height_max > FLAGS_height) {
+    Eigen::VectorXd heights = Eigen::VectorXd::LinSpaced(
+        FLAGS_num_sweep_heights, FLAGS_height, FLAGS_sweep_height_max);
+    std::vector<Eigen::VectorXd> q_sweep, u_sweep, lambda_sweep;
+    auto batch = CassieFixedPointSweep(plant,
+        std::vector<double>(heights.data(), heights.data() + heights.size()),
+        FLAGS_mu, FLAGS_min_normal_force, FLAGS_linear_friction_cone,
+        FLAGS_toe_spread, FLAGS_num_guesses, FLAGS_num_threads, &q_sweep,
+        &u_sweep, &lambda_sweep);
+
+    std::cout << "Solved " << batch.num_success << "/"
+              << batch.results.size() << " in " << batch.wall_time << "s"
+              << std::endl;
+    for (int i = 0; i < heights.size(); i++) {
+      std::cout << "Height " << heights(i) << ": ";
+      if (batch.best[i] < 0) {
+        std::cout << "no solution" << std::endl;
+        continue;
+      }
+      const auto& best = batch.results[batch.best[i]];
+      std::cout << "cost " << best.optimal_cost << ", solve time "
+                << best.solve_time << "s, |u| " << u_sweep[i].norm()
+                << std::endl;
+    }
+    return 0;
+  }
+
   Eigen::VectorXd q, u, lambda;
 
   CassieFixedPointSolver(plant, FLAGS_height, FLAGS_mu, FLAGS_min_normal_force,
@@ -0,0 +1,295 @@
+#include "examples/Cassie/monte_carlo_sim.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "dairlib/lcmt_osc_output.hpp"
+#include "examples/Cassie/cassie_utils.h"
+#include "multibody/multibody_utils.h"
+#include "systems/framework/lockstep_loop.h"
+
+#include "drake/geometry/scene_graph.h"
+#include "drake/multibody/plant/externally_applied_spatial_force.h"
+#include "drake/systems/framework/diagram_builder.h"
+
+namespace dairlib {
+
+using drake::geometry::SceneGraph;
+using drake::multibody::BodyIndex;
+using drake::multibody::ExternallyAppliedSpatialForce;
+using drake::multibody::MultibodyPlant;
+using drake::multibody::RigidBody;
+using drake::multibody::SpatialForce;
+using drake::systems::DiagramBuilder;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Nearest-rank percentile, p in [0, 1]. Reorders values.
+double Percentile(vector<double>* values, double p) {
+  if (values->empty()) return 0;
+  const int k = std::lround(p * (values->size() - 1));
+  std::nth_element(values->begin(), values->begin() + k, values->end());
+  return (*values)[k];
+}
+
+}  // namespace
+
+MonteCarloRun SimulateMonteCarloRun(const MonteCarloOptions& options,
+                                    int index, const VectorXd& q_init) {
+  auto start = std::chrono::steady_clock::now();
+
+  // Randomization, drawn in a fixed order from a generator seeded by the run
+  std::seed_seq seed_seq{options.seed, static_cast<uint32_t>(index)};
+  std::mt19937 generator(seed_seq);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  auto sample = [&](double min, double max) {
+    return min + (max - min) * uniform(generator);
+  };
+  MonteCarloRun run;
+  run.index = index;
+  run.mu = sample(options.min_mu, options.max_mu);
+  run.slope = sample(0, options.max_slope);
+  run.slope_direction = sample(-M_PI, M_PI);
+  const double push_magnitude = sample(0, options.max_push_force);
+  const double push_direction = sample(-M_PI, M_PI);
+  run.push_force << push_magnitude * std::cos(push_direction),
+      push_magnitude * std::sin(push_direction);
+  run.push_time = sample(options.min_push_time, options.max_push_time);
+
+  // The whole run is built and simulated in the try, so that an exception
+  // (e.g. of the model or of the controller) only ends this run, on whichever
+  // thread it runs
+  run.mass_scale = 1;
+  run.end_time = 0;
+  std::map<string, std::pair<double, int>> squared_errors;
+  try {
+    // Simulated plant, as in multibody_sim
+    DiagramBuilder<double> builder;
+    SceneGraph<double>& scene_graph = *builder.AddSystem<SceneGraph>();
+    MultibodyPlant<double>& plant =
+        *builder.AddSystem<MultibodyPlant>(options.sim_dt);
+    Vector3d normal_W(std::sin(run.slope) * std::cos(run.slope_direction),
+                      std::sin(run.slope) * std::sin(run.slope_direction),
+                      std::cos(run.slope));
+    multibody::addFlatTerrain(&plant, &scene_graph, run.mu, run.mu, normal_W);
+    addCassieMultibody(&plant, &scene_graph, true,
+                       "examples/Cassie/urdf/cassie_v2.urdf", true, true);
+    plant.Finalize();
+    plant.set_penetration_allowance(options.penetration_allowance);
+    plant.set_stiction_tolerance(options.v_stiction);
+    builder.Connect(
+        plant.get_geometry_poses_output_port(),
+        scene_graph.get_source_pose_port(plant.get_source_id().value()));
+    builder.Connect(scene_graph.get_query_output_port(),
+                    plant.get_geometry_query_input_port());
+
+    // Controller, as in run_osc_walking_controller
+    MultibodyPlant<double> plant_w_springs(0.0);
+    addCassieMultibody(&plant_w_springs, nullptr, true,
+                       "examples/Cassie/urdf/cassie_v2.urdf", true, false);
+    plant_w_springs.Finalize();
+    MultibodyPlant<double> plant_wo_springs(0.0);
+    addCassieMultibody(&plant_wo_springs, nullptr, true,
+                       "examples/Cassie/urdf/cassie_fixed_springs.urdf", false,
+                       false);
+    plant_wo_springs.Finalize();
+    auto controller =
+        std::make_unique<cassie::osc::OSCWalkingControllerDiagram>(
+            plant_w_springs, plant_wo_springs, options.controller);
+    const auto& state_port = controller->get_state_input_port();
+    const auto& control_port = controller->get_control_output_port();
+    const auto& osc_debug_port = controller->get_osc_debug_output_port();
+
+    systems::LockstepLoop loop(builder.Build(), plant, std::move(controller),
+                               state_port, control_port,
+                               options.controller_period);
+    auto& plant_context = loop.get_mutable_plant_context();
+
+    // Link masses
+    double nominal_mass = 0;
+    double mass = 0;
+    for (BodyIndex i(1); i < plant.num_bodies(); ++i) {
+      const auto& body =
+          dynamic_cast<const RigidBody<double>&>(plant.get_body(i));
+      const double scaled_mass =
+          body.get_default_mass() * sample(1 - options.mass_scale_range,
+                                           1 + options.mass_scale_range);
+      body.SetMass(&plant_context, scaled_mass);
+      nominal_mass += body.get_default_mass();
+      mass += scaled_mass;
+    }
+    run.mass_scale = mass / nominal_mass;
+
+    plant.SetPositions(&plant_context, q_init);
+    plant.SetVelocities(&plant_context,
+                        VectorXd::Zero(plant.num_velocities()));
+
+    const auto& pelvis = plant.GetBodyByName("pelvis");
+    vector<ExternallyAppliedSpatialForce<double>> push(1);
+    push[0].body_index = pelvis.index();
+    push[0].p_BoBq_B = Vector3d::Zero();
+    push[0].F_Bq_W = SpatialForce<double>(
+        Vector3d::Zero(), Vector3d(run.push_force(0), run.push_force(1), 0));
+    const vector<ExternallyAppliedSpatialForce<double>> no_push;
+    bool is_pushing = false;
+
+    const int num_ticks =
+        std::floor(options.end_time / options.controller_period + 1e-9);
+    run.controller_times.reserve(num_ticks);
+    loop.Initialize();
+    run.end_time = loop.get_time();
+    for (int k = 0; k < num_ticks; k++) {
+      const double time = loop.get_time();
+      const bool push_now = time >= run.push_time &&
+                            time < run.push_time + options.push_duration;
+      if (push_now != is_pushing) {
+        plant.get_applied_spatial_force_input_port().FixValue(
+            &plant_context, push_now ? push : no_push);
+        is_pushing = push_now;
+      }
+
+      run.controller_times.push_back(loop.Tick());
+      run.end_time = loop.get_time();
+
+      const auto& osc_output = osc_debug_port.Eval<lcmt_osc_output>(
+          loop.get_controller_context());
+      for (const auto& data : osc_output.tracking_data) {
+        double error = 0;
+        for (double e : data.error_y) error += e * e;
+        auto& sum = squared_errors[data.name];
+        sum.first += error;
+        sum.second++;
+      }
+
+      if (plant.EvalBodyPoseInWorld(plant_context, pelvis).translation()(2) <
+          options.fall_height) {
+        run.fell = true;
+        break;
+      }
+    }
+  } catch (const std::exception& e) {
+    run.fell = true;
+    run.error = e.what();
+  }
+
+  for (const auto& sum : squared_errors) {
+    run.rms_tracking_error[sum.first] =
+        std::sqrt(sum.second.first / sum.second.second);
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  run.wall_time = elapsed.count();
+  return run;
+}
+
+vector<MonteCarloRun> RunMonteCarloSims(const MonteCarloOptions& options,
+                                        const VectorXd& q_init,
+                                        double* wall_time) {
+  vector<MonteCarloRun> runs(options.num_runs);
+
+  // Each worker pulls runs in order, and every run is written by one worker
+  int num_threads = options.num_threads;
+  if (num_threads <= 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  num_threads = std::min(num_threads, options.num_runs);
+  std::atomic<int> next_run{0};
+  auto worker = [&]() {
+    for (int i = next_run++; i < options.num_runs; i = next_run++) {
+      runs[i] = SimulateMonteCarloRun(options, i, q_init);
+    }
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  vector<std::thread> workers;
+  for (int i = 0; i < num_threads; i++) {
+    workers.emplace_back(worker);
+  }
+  for (auto& thread : workers) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  if (wall_time != nullptr) {
+    *wall_time = elapsed.count();
+  }
+  return runs;
+}
+
+MonteCarloSummary SummarizeMonteCarloRuns(const vector<MonteCarloRun>& runs,
+                                          double wall_time) {
+  MonteCarloSummary summary;
+  summary.num_runs = runs.size();
+  summary.num_falls = 0;
+  summary.wall_time = wall_time;
+  summary.simulated_time = 0;
+
+  vector<double> controller_times;
+  std::map<string, std::pair<double, int>> rms_sums;
+  for (const auto& run : runs) {
+    if (run.fell) summary.num_falls++;
+    summary.simulated_time += run.end_time;
+    controller_times.insert(controller_times.end(),
+                            run.controller_times.begin(),
+                            run.controller_times.end());
+    for (const auto& rms : run.rms_tracking_error) {
+      auto& sum = rms_sums[rms.first];
+      sum.first += rms.second;
+      sum.second++;
+    }
+  }
+  for (const auto& sum : rms_sums) {
+    summary.mean_rms_tracking_error[sum.first] =
+        sum.second.first / sum.second.second;
+  }
+  summary.controller_time_p50 = Percentile(&controller_times, 0.5);
+  summary.controller_time_p90 = Percentile(&controller_times, 0.9);
+  summary.controller_time_p99 = Percentile(&controller_times, 0.99);
+  summary.controller_time_max = Percentile(&controller_times, 1);
+  return summary;
+}
+
+void WriteMonteCarloCsv(const vector<MonteCarloRun>& runs,
+                        const string& filepath) {
+  std::ofstream fout(filepath);
+  if (!fout) {
+    throw std::runtime_error("Could not open file: " + filepath);
+  }
+  std::set<string> names;
+  for (const auto& run : runs) {
+    for (const auto& rms : run.rms_tracking_error) names.insert(rms.first);
+  }
+
+  fout << "index,mu,slope,slope_direction,mass_scale,push_x,push_y,"
+          "push_time,fell,end_time";
+  for (const auto& name : names) fout << ",rms_" << name;
+  fout << ",controller_time_p50,controller_time_p99,wall_time" << std::endl;
+  for (const auto& run : runs) {
+    fout << run.index << "," << run.mu << "," << run.slope << ","
+         << run.slope_direction << "," << run.mass_scale << ","
+         << run.push_force(0) << "," << run.push_force(1) << ","
+         << run.push_time << "," << run.fell << "," << run.end_time;
+    for (const auto& name : names) {
+      auto it = run.rms_tracking_error.find(name);
+      fout << ",";
+      if (it != run.rms_tracking_error.end()) fout << it->second;
+    }
+    vector<double> times = run.controller_times;
+    fout << "," << Percentile(&times, 0.5) << "," << Percentile(&times, 0.99)
+         << "," << run.wall_time << std::endl;
+  }
+}
+
+}  // namespace dairlib
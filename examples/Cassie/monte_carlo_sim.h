@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "examples/Cassie/osc/osc_walking_controller_diagram.h"
+
+namespace dairlib {
+
+/// Options of a batch of randomized, in-process simulations of Cassie with
+/// the OSC walking controller (see RunMonteCarloSims)
+struct MonteCarloOptions {
+  int num_runs = 32;
+  /// Number of threads, 0 for one per core
+  int num_threads = 0;
+  /// The randomization of run i only depends on seed and i
+  uint32_t seed = 0;
+
+  // Simulation
+  double end_time = 5;
+  double sim_dt = 8e-5;
+  double penetration_allowance = 1e-5;
+  double v_stiction = 1e-3;
+  double init_height = 0.9;
+  /// Period of the lockstep controller updates
+  double controller_period = 1e-3;
+  /// A run is a fall once the pelvis is below this height
+  double fall_height = 0.5;
+
+  // Randomization, uniform in the given ranges
+  /// Ground friction coefficient (static and kinetic)
+  double min_mu = 0.6;
+  double max_mu = 1.0;
+  /// Ground slope (rad), in a random direction
+  double max_slope = 0.05;
+  /// Relative perturbation of each link mass
+  double mass_scale_range = 0.1;
+  /// Horizontal push on the pelvis, in a random direction, over
+  /// [push_time, push_time + push_duration] with push_time uniform in
+  /// [min_push_time, max_push_time]
+  double max_push_force = 50;
+  double push_duration = 0.1;
+  double min_push_time = 1;
+  double max_push_time = 3;
+
+  cassie::osc::OSCWalkingControllerOptions controller;
+};
+
+/// Randomized parameters and metrics of a single run
+struct MonteCarloRun {
+  int index;
+  double mu;
+  double slope;
+  double slope_direction;
+  /// Total mass of the randomized model over the nominal mass
+  double mass_scale;
+  Eigen::Vector2d push_force;
+  double push_time;
+
+  bool fell = false;
+  /// Time of the fall, or end_time
+  double end_time;
+  /// Root mean square of the OSC tracking error norm, per tracking data,
+  /// over the ticks where the tracking data is active
+  std::map<std::string, double> rms_tracking_error;
+  /// Wall-clock time of each controller update (seconds)
+  std::vector<double> controller_times;
+  /// Wall-clock time of the whole run (seconds)
+  double wall_time;
+  /// Message of the exception that ended the run, if any (counted as a fall)
+  std::string error;
+};
+
+/// Aggregated metrics of a batch of runs
+struct MonteCarloSummary {
+  int num_runs;
+  int num_falls;
+  double wall_time;
+  double simulated_time;
+  /// Mean of the per-run RMS tracking errors
+  std::map<std::string, double> mean_rms_tracking_error;
+  /// Percentiles of the controller update times over all runs (seconds)
+  double controller_time_p50;
+  double controller_time_p90;
+  double controller_time_p99;
+  double controller_time_max;
+};
+
+/// Simulates the run with the given index (randomized from options.seed and
+/// index). The plant and controller diagram are wired directly with a
+/// LockstepLoop. q_init is the initial configuration of the spring model.
+MonteCarloRun SimulateMonteCarloRun(const MonteCarloOptions& options,
+                                    int index, const Eigen::VectorXd& q_init);
+
+/// Simulates options.num_runs runs in parallel. Every run builds its own
+/// plants and diagrams, so the runs share no mutable state and the results
+/// do not depend on the number of threads.
+std::vector<MonteCarloRun> RunMonteCarloSims(const MonteCarloOptions& options,
+                                             const Eigen::VectorXd& q_init,
+                                             double* wall_time = nullptr);
+
+MonteCarloSummary SummarizeMonteCarloRuns(
+    const std::vector<MonteCarloRun>& runs, double wall_time);
+
+/// Writes one line per run (randomized parameters, fall, RMS tracking errors
+/// and controller time percentiles)
+void WriteMonteCarloCsv(const std::vector<MonteCarloRun>& runs,
+                        const std::string& filepath);
+
+}  // namespace dairlib
@@ -18,7 +18,9 @@
 
 #include "examples/Cassie/cassie_fixed_point_solver.h"
 #include "examples/Cassie/cassie_utils.h"
+#include "examples/Cassie/osc/osc_walking_controller_diagram.h"
 #include "multibody/multibody_utils.h"
+#include "systems/framework/lockstep_loop.h"
 #include "systems/primitives/subvector_pass_through.h"
 #include "systems/robot_lcm_systems.h"
 
@@ -63,6 +65,24 @@ DEFINE_double(init_height, .7,
               "ground");
 DEFINE_bool(spring_model, true, "Use a URDF with or without legs springs");
 
+// Lockstep mode
+DEFINE_bool(lockstep, false,
+            "If 'true', run the OSC walking controller in this process, wired "
+            "directly to the plant, instead of exchanging lcmt_robot_output "
+            "and lcmt_robot_input with a controller process. Set "
+            "--target_realtime_rate=0 to run as fast as possible.");
+DEFINE_double(controller_period, 1e-3,
+              "Period of the controller updates in lockstep mode");
+DEFINE_double(controller_delay, 0,
+              "Delay between a controller update and the application of its "
+              "efforts, in lockstep mode");
+DEFINE_double(controller_delay_jitter, 0,
+              "If positive, the delay is uniform in [controller_delay, "
+              "controller_delay + controller_delay_jitter]");
+DEFINE_int32(delay_seed, 0, "Seed of the random delays");
+DEFINE_bool(use_lipm_mpc, false,
+            "Use LipmMpc in the lockstep walking controller");
+
 
 int do_main(int argc, char* argv[]) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
@@ -92,15 +112,23 @@ int do_main(int argc, char* argv[]) {
   plant.set_penetration_allowance(FLAGS_penetration_allowance);
   plant.set_stiction_tolerance(FLAGS_v_stiction);
 
-  // Create lcm systems.
+  // Create lcm systems. In lockstep mode, the actuation input is set by the
+  // controller directly.
   auto lcm = builder.AddSystem<drake::systems::lcm::LcmInterfaceSystem>();
-  auto input_sub =
-      builder.AddSystem(LcmSubscriberSystem::Make<dairlib::lcmt_robot_input>(
-          "CASSIE_INPUT", lcm));
-  auto input_receiver = builder.AddSystem<systems::RobotInputReceiver>(plant);
-  auto passthrough = builder.AddSystem<SubvectorPassThrough>(
-      input_receiver->get_output_port(0).size(), 0,
-      plant.get_actuation_input_port().size());
+  if (!FLAGS_lockstep) {
+    auto input_sub =
+        builder.AddSystem(LcmSubscriberSystem::Make<dairlib::lcmt_robot_input>(
+            "CASSIE_INPUT", lcm));
+    auto input_receiver =
+        builder.AddSystem<systems::RobotInputReceiver>(plant);
+    auto passthrough = builder.AddSystem<SubvectorPassThrough>(
+        input_receiver->get_output_port(0).size(), 0,
+        plant.get_actuation_input_port().size());
+    builder.Connect(*input_sub, *input_receiver);
+    builder.Connect(*input_receiver, *passthrough);
+    builder.Connect(passthrough->get_output_port(),
+                    plant.get_actuation_input_port());
+  }
   auto state_pub =
       builder.AddSystem(LcmPublisherSystem::Make<dairlib::lcmt_robot_output>(
           "CASSIE_STATE_SIMULATION", lcm, 1.0 / FLAGS_publish_rate));
@@ -116,10 +144,6 @@ int do_main(int argc, char* argv[]) {
   contact_results_publisher.set_name("contact_results_publisher");
 
   // connect leaf systems
-  builder.Connect(*input_sub, *input_receiver);
-  builder.Connect(*input_receiver, *passthrough);
-  builder.Connect(passthrough->get_output_port(),
-                  plant.get_actuation_input_port());
   builder.Connect(plant.get_state_output_port(),
                   state_sender->get_input_port_state());
   builder.Connect(*state_sender, *state_pub);
@@ -135,14 +159,6 @@ int do_main(int argc, char* argv[]) {
 
   auto diagram = builder.Build();
 
-  // Create a context for this system:
-  std::unique_ptr<Context<double>> diagram_context =
-      diagram->CreateDefaultContext();
-  diagram_context->EnableCaching();
-  diagram->SetDefaultContext(diagram_context.get());
-  Context<double>& plant_context =
-      diagram->GetMutableSubsystemContext(plant, diagram_context.get());
-
   // Set initial conditions of the simulation
   VectorXd q_init, u_init, lambda_init;
 
@@ -155,22 +171,70 @@ int do_main(int argc, char* argv[]) {
   } else {
     CassieFixedBaseFixedPointSolver(plant, &q_init, &u_init, &lambda_init);
   }
+
+  auto configure_simulator = [](Simulator<double>* simulator) {
+    if (!FLAGS_time_stepping) {
+      // simulator->get_mutable_integrator()->set_maximum_step_size(0.01);
+      // simulator->get_mutable_integrator()->set_target_accuracy(1e-1);
+      // simulator->get_mutable_integrator()->set_fixed_step_mode(true);
+      simulator->reset_integrator<
+          drake::systems::RungeKutta2Integrator<double>>(FLAGS_dt);
+    }
+
+    simulator->set_publish_every_time_step(false);
+    simulator->set_publish_at_initialization(false);
+    simulator->set_target_realtime_rate(FLAGS_target_realtime_rate);
+  };
+
+  if (FLAGS_lockstep) {
+    // The walking controller of run_osc_walking_controller
+    DRAKE_DEMAND(FLAGS_floating_base && FLAGS_spring_model);
+    MultibodyPlant<double> plant_w_springs(0.0);
+    addCassieMultibody(&plant_w_springs, nullptr, true,
+                       "examples/Cassie/urdf/cassie_v2.urdf", true, false);
+    plant_w_springs.Finalize();
+    MultibodyPlant<double> plant_wo_springs(0.0);
+    addCassieMultibody(&plant_wo_springs, nullptr, true,
+                       "examples/Cassie/urdf/cassie_fixed_springs.urdf", false,
+                       false);
+    plant_wo_springs.Finalize();
+    cassie::osc::OSCWalkingControllerOptions controller_options;
+    controller_options.use_lipm_mpc = FLAGS_use_lipm_mpc;
+    auto controller =
+        std::make_unique<cassie::osc::OSCWalkingControllerDiagram>(
+            plant_w_springs, plant_wo_springs, controller_options);
+    const auto& state_port = controller->get_state_input_port();
+    const auto& control_port = controller->get_control_output_port();
+
+    systems::LockstepLoop loop(std::move(diagram), plant,
+                               std::move(controller), state_port,
+                               control_port, FLAGS_controller_period);
+    loop.SetDelay(FLAGS_controller_delay,
+                  FLAGS_controller_delay + FLAGS_controller_delay_jitter,
+                  FLAGS_delay_seed);
+    Context<double>& plant_context = loop.get_mutable_plant_context();
+    plant.SetPositions(&plant_context, q_init);
+    plant.SetVelocities(&plant_context,
+                        VectorXd::Zero(plant.num_velocities()));
+
+    configure_simulator(&loop.get_mutable_plant_simulator());
+    loop.Initialize();
+    loop.AdvanceTo(FLAGS_end_time);
+    return 0;
+  }
+
+  // Create a context for this system:
+  std::unique_ptr<Context<double>> diagram_context =
+      diagram->CreateDefaultContext();
+  diagram_context->EnableCaching();
+  diagram->SetDefaultContext(diagram_context.get());
+  Context<double>& plant_context =
+      diagram->GetMutableSubsystemContext(plant, diagram_context.get());
   plant.SetPositions(&plant_context, q_init);
   plant.SetVelocities(&plant_context, VectorXd::Zero(plant.num_velocities()));
 
   Simulator<double> simulator(*diagram, std::move(diagram_context));
-
-  if (!FLAGS_time_stepping) {
-    // simulator.get_mutable_integrator()->set_maximum_step_size(0.01);
-    // simulator.get_mutable_integrator()->set_target_accuracy(1e-1);
-    // simulator.get_mutable_integrator()->set_fixed_step_mode(true);
-    simulator.reset_integrator<drake::systems::RungeKutta2Integrator<double>>(
-        FLAGS_dt);
-  }
-
-  simulator.set_publish_every_time_step(false);
-  simulator.set_publish_at_initialization(false);
-  simulator.set_target_realtime_rate(FLAGS_target_realtime_rate);
+  configure_simulator(&simulator);
   simulator.Initialize();
   simulator.AdvanceTo(FLAGS_end_time);
 
@@ -1,4 +1,3 @@
-#include <algorithm>
 #include "examples/Cassie/networking/cassie_input_sender.h"
 #include "examples/Cassie/networking/udp_lcm_translator.h"
 
@@ -15,13 +14,6 @@ CassieInputSender::CassieInputSender() {
       &CassieInputSender::Output);
 }
 
-template <typename T>
-void copy_vector(const T* input, T* output, int size) {
-  for (int i = 0; i < size; i++) {
-    output[i] = input[i];
-  }
-}
-
 void CassieInputSender::Output(const Context<double>& context,
                                      lcmt_cassie_in* output) const {
   const cassie_user_in_t& cassie_in =
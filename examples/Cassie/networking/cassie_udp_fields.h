@@ -0,0 +1,77 @@
+#pragma once
+
+/// Field tables of the Cassie UDP structs, from which both the packing in
+/// udp_serializer.cc and the LCM translation in udp_lcm_translator.cc are
+/// generated.
+///
+/// CASSIE_OUT_FIELDS(X) expands X(field, wire_type) for each field of
+/// cassie_out_t, in the order of the packet (see unpack_cassie_out_t()).
+/// lcmt_cassie_out has the same fields, plus utime. The wire types are the
+/// integer types, float (the doubles are sent as floats), CassieBool and
+/// CassieDiagnosticCode (see udp_serializer.cc). Array fields are expanded
+/// once, with the wire type of their elements.
+
+#define CASSIE_ELMO_OUT_FIELDS(X, drive) \
+  X(drive.statusWord, uint16_t)          \
+  X(drive.position, float)               \
+  X(drive.velocity, float)               \
+  X(drive.torque, float)                 \
+  X(drive.driveTemperature, float)       \
+  X(drive.dcLinkVoltage, float)          \
+  X(drive.torqueLimit, float)            \
+  X(drive.gearRatio, float)
+
+#define CASSIE_LEG_OUT_FIELDS(X, leg)          \
+  CASSIE_ELMO_OUT_FIELDS(X, leg.hipRollDrive)  \
+  CASSIE_ELMO_OUT_FIELDS(X, leg.hipYawDrive)   \
+  CASSIE_ELMO_OUT_FIELDS(X, leg.hipPitchDrive) \
+  CASSIE_ELMO_OUT_FIELDS(X, leg.kneeDrive)     \
+  CASSIE_ELMO_OUT_FIELDS(X, leg.footDrive)     \
+  X(leg.shinJoint.position, float)             \
+  X(leg.shinJoint.velocity, float)             \
+  X(leg.tarsusJoint.position, float)           \
+  X(leg.tarsusJoint.velocity, float)           \
+  X(leg.footJoint.position, float)             \
+  X(leg.footJoint.velocity, float)             \
+  X(leg.medullaCounter, uint8_t)               \
+  X(leg.medullaCpuLoad, uint16_t)              \
+  X(leg.reedSwitchState, CassieBool)
+
+#define CASSIE_OUT_FIELDS(X)                                \
+  X(pelvis.targetPc.etherCatStatus, int32_t)                \
+  X(pelvis.targetPc.etherCatNotifications, int32_t)         \
+  X(pelvis.targetPc.taskExecutionTime, float)               \
+  X(pelvis.targetPc.overloadCounter, uint32_t)              \
+  X(pelvis.targetPc.cpuTemperature, float)                  \
+  X(pelvis.battery.dataGood, CassieBool)                    \
+  X(pelvis.battery.stateOfCharge, float)                    \
+  X(pelvis.battery.voltage, float)                          \
+  X(pelvis.battery.current, float)                          \
+  X(pelvis.battery.temperature, float)                      \
+  X(pelvis.radio.radioReceiverSignalGood, CassieBool)       \
+  X(pelvis.radio.receiverMedullaSignalGood, CassieBool)     \
+  X(pelvis.radio.channel, float)                            \
+  X(pelvis.vectorNav.dataGood, CassieBool)                  \
+  X(pelvis.vectorNav.vpeStatus, uint16_t)                   \
+  X(pelvis.vectorNav.pressure, float)                       \
+  X(pelvis.vectorNav.temperature, float)                    \
+  X(pelvis.vectorNav.magneticField, float)                  \
+  X(pelvis.vectorNav.angularVelocity, float)                \
+  X(pelvis.vectorNav.linearAcceleration, float)             \
+  X(pelvis.vectorNav.orientation, float)                    \
+  X(pelvis.medullaCounter, uint8_t)                         \
+  X(pelvis.medullaCpuLoad, uint16_t)                        \
+  X(pelvis.bleederState, CassieBool)                        \
+  X(pelvis.leftReedSwitchState, CassieBool)                 \
+  X(pelvis.rightReedSwitchState, CassieBool)                \
+  X(pelvis.vtmTemperature, float)                           \
+  CASSIE_LEG_OUT_FIELDS(X, leftLeg)                         \
+  CASSIE_LEG_OUT_FIELDS(X, rightLeg)                        \
+  X(isCalibrated, CassieBool)                               \
+  X(messages, CassieDiagnosticCode)
+
+/// CASSIE_USER_IN_FIELDS(X) is the table of cassie_user_in_t (see
+/// unpack_cassie_user_in_t()) and lcmt_cassie_in.
+#define CASSIE_USER_IN_FIELDS(X) \
+  X(torque, float)               \
+  X(telemetry, int16_t)
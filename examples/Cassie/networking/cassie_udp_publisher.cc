@@ -12,10 +12,6 @@ namespace systems {
 
 using drake::systems::TriggerType;
 
-namespace {
-const int kPortIndex = 0;
-}  // namespace
-
 CassieUDPPublisher::CassieUDPPublisher(const std::string& address,
       const int port, const UDPTriggerTypes& publish_triggers,
       double publish_period)
@@ -97,16 +93,14 @@ drake::systems::EventStatus CassieUDPPublisher::PublishInputAsUDPMessage(
     const drake::systems::Context<double>& context) const {
   SPDLOG_TRACE(drake::log(), "Publishing UDP {} message", address_);
 
-  // Converts the input into message bytes.
-  const drake::AbstractValue* const input_value =
-      this->EvalAbstractInput(context, kPortIndex);
-  DRAKE_ASSERT(input_value != nullptr);
-  std::vector<uint8_t> message_bytes;
-
-  serializer_->Serialize(*input_value, &message_bytes);
+  // Packs the input directly into a packet on the stack.
+  const auto& cassie_in =
+      this->get_input_port().Eval<cassie_user_in_t>(context);
+  CassieUserInPacket packet;
+  sequence_.Send(packet.data());
+  PackCassieUserIn(cassie_in, &packet[kCassieUdpHeaderLength]);
 
-  int result = sendto(socket_, message_bytes.data(),
-      message_bytes.size(), 0,
+  int result = sendto(socket_, packet.data(), packet.size(), 0,
       (struct sockaddr *)&server_address_, sizeof(server_address_));
   DRAKE_THROW_UNLESS(result >= 0);
   return drake::systems::EventStatus::Succeeded();
@@ -149,6 +149,9 @@ class CassieUDPPublisher : public drake::systems::LeafSystem<double> {
 
   // Converts Value<cassie_user_in_t> objects into UDP message bytes.
   std::unique_ptr<CassieUDPInSerializer> serializer_;
+
+  // Sequence numbers of the packet headers. Publishing is not concurrent.
+  mutable CassiePacketSequence sequence_;
 };
 
 }  // namespace systems
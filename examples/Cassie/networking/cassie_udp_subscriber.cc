@@ -34,7 +34,7 @@ constexpr int kStateIndexMessageUTime = 2;
 }  // namespace
 
 CassieUDPSubscriber::CassieUDPSubscriber(const std::string& address,
-    const int port)
+    const int port, const RealtimeOptions& polling_options)
     : address_(address),
       port_(port),
       serializer_(std::move(make_unique<CassieUDPOutSerializer>())) {
@@ -78,10 +78,12 @@ CassieUDPSubscriber::CassieUDPSubscriber(const std::string& address,
   
   set_name(make_name(address, port));
   std::cout << "Starting polling thread!" << std::endl;
-  polling_thread_ = std::thread(&CassieUDPSubscriber::Poll, this,
-      [this](const void* buffer, int size) {
-        this->HandleMessage(buffer, size);
-      });
+  polling_thread_ = std::thread([this, polling_options]() {
+    SetupRealtimeThread(get_name() + " polling", polling_options);
+    Poll([this](const void* buffer, int size) {
+      this->HandleMessage(buffer, size);
+    });
+  });
 
   start_ = steady_clock::now();
 }
@@ -137,9 +139,9 @@ void CassieUDPSubscriber::ProcessMessageAndStoreToAbstractState(
     AbstractValues* abstract_state) const {
   std::lock_guard<std::mutex> lock(received_message_mutex_);
   if (!received_message_.empty()) {
-    serializer_->Deserialize(
-        received_message_.data(), received_message_.size(),
-        &abstract_state->get_mutable_value(kStateIndexMessage));
+    UnpackCassieOut(received_message_.data(),
+                    &abstract_state->get_mutable_value(kStateIndexMessage)
+                         .get_mutable_value<cassie_out_t>());
   }
   abstract_state->get_mutable_value(kStateIndexMessageCount)
       .get_mutable_value<int>() = received_message_count_;
@@ -227,8 +229,8 @@ int CassieUDPSubscriber::WaitForMessage(
   }
   int new_message_count = received_message_count_;
   if (message) {
-      serializer_->Deserialize(
-          received_message_.data(), received_message_.size(), message);
+      UnpackCassieOut(received_message_.data(),
+                      &message->get_mutable_value<cassie_out_t>());
   }
   lock.unlock();
   // std::cout << "received!" << std::endl;
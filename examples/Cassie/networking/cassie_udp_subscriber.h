@@ -12,6 +12,7 @@
 #include <vector>
 #include <thread>
 
+#include "common/realtime.h"
 #include "drake/common/drake_copyable.h"
 #include "drake/common/drake_deprecated.h"
 #include "drake/common/drake_throw.h"
@@ -58,11 +59,14 @@ class CassieUDPSubscriber : public drake::systems::LeafSystem<double> {
    * @param address the IP address to subscribe to
    *
    * @param port the port to listen on
+   *
+   * @param polling_options the real-time settings of the polling thread
    */
   static std::unique_ptr<CassieUDPSubscriber> Make(const std::string& address,
-      const int port) {
+      const int port,
+      const RealtimeOptions& polling_options = RealtimeOptions()) {
     return std::make_unique<CassieUDPSubscriber>(
-        address, port);
+        address, port, polling_options);
   }
 
   /**
@@ -72,8 +76,12 @@ class CassieUDPSubscriber : public drake::systems::LeafSystem<double> {
    * @param address the IP address to subscribe to
    *
    * @param port the port to listen on
+   *
+   * @param polling_options the real-time settings of the polling thread,
+   * applied with SetupRealtimeThread() before it starts polling
    */
-  CassieUDPSubscriber(const std::string& address, const int port);
+  CassieUDPSubscriber(const std::string& address, const int port,
+      const RealtimeOptions& polling_options = RealtimeOptions());
 
   ~CassieUDPSubscriber() override;
 
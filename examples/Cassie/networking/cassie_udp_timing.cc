@@ -0,0 +1,44 @@
+#include "examples/Cassie/networking/cassie_udp_timing.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace dairlib {
+namespace systems {
+
+CassieUdpTiming::CassieUdpTiming(double expected_period)
+    : expected_period_(expected_period) {}
+
+void CassieUdpTiming::Receive(double time) {
+  if (has_received_) {
+    const double interarrival = time - last_time_;
+    // Same gain as the interarrival jitter of RFC 3550
+    jitter_ += (std::abs(interarrival - expected_period_) - jitter_) / 16;
+    num_interarrivals_++;
+    sum_interarrival_ += interarrival;
+    max_interarrival_ = std::max(max_interarrival_, interarrival);
+  }
+  has_received_ = true;
+  last_time_ = time;
+}
+
+void CassieUdpTiming::CopyToLcm(const CassiePacketSequence& sequence,
+                                double time,
+                                lcmt_cassie_udp_timing* message) {
+  message->utime = time * 1e6;
+  message->num_received = sequence.num_received();
+  message->num_missed = sequence.num_missed();
+  message->num_stale = sequence.num_stale();
+  message->num_late = num_late_;
+  message->mean_interarrival =
+      num_interarrivals_ > 0 ? sum_interarrival_ / num_interarrivals_ : 0;
+  message->max_interarrival = max_interarrival_;
+  message->jitter = jitter_;
+
+  num_interarrivals_ = 0;
+  sum_interarrival_ = 0;
+  max_interarrival_ = 0;
+}
+
+}  // namespace systems
+}  // namespace dairlib
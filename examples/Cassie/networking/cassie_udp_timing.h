@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+#include "dairlib/lcmt_cassie_udp_timing.hpp"
+#include "examples/Cassie/networking/udp_serializer.h"
+
+namespace dairlib {
+namespace systems {
+
+/// %CassieUdpTiming tracks the arrival times of the packets from Cassie: the
+/// inter-arrival times, their jitter relative to the expected period, and the
+/// number of times a packet was late. Together with the sequence statistics
+/// of CassiePacketSequence, they are published as lcmt_cassie_udp_timing.
+class CassieUdpTiming {
+ public:
+  /// @param expected_period the period (s) at which Cassie sends packets
+  explicit CassieUdpTiming(double expected_period = 5e-4);
+
+  /// Records a packet received at `time` (s)
+  void Receive(double time);
+
+  /// Records that no packet arrived in time
+  void Late() { num_late_++; }
+
+  /// Fills `message` with the statistics, and starts a new window of
+  /// inter-arrival times
+  void CopyToLcm(const CassiePacketSequence& sequence, double time,
+                 lcmt_cassie_udp_timing* message);
+
+  double jitter() const { return jitter_; }
+  int64_t num_late() const { return num_late_; }
+
+ private:
+  const double expected_period_;
+  bool has_received_ = false;
+  double last_time_ = 0;
+  double jitter_ = 0;
+  int64_t num_late_ = 0;
+
+  // Inter-arrival times since the last CopyToLcm()
+  int num_interarrivals_ = 0;
+  double sum_interarrival_ = 0;
+  double max_interarrival_ = 0;
+};
+
+}  // namespace systems
+}  // namespace dairlib
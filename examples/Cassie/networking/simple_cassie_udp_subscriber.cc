@@ -1,6 +1,8 @@
 #include <poll.h>
 #include <sys/ioctl.h>
 
+#include <algorithm>
+
 #include "drake/common/drake_throw.h"
 
 #include "examples/Cassie/networking/simple_cassie_udp_subscriber.h"
@@ -12,8 +14,8 @@ using std::chrono::steady_clock;
 using std::chrono::microseconds;
 
 SimpleCassieUdpSubscriber::SimpleCassieUdpSubscriber(const std::string& address,
-    const int port) :
-    count_(0), time_(0) {
+    const int port, bool check_sequence) :
+    count_(0), time_(0), check_sequence_(check_sequence) {
   // Creating socket file descriptor
   // todo: check buffer size
   socket_ = socket(AF_INET, SOCK_DGRAM, 0);
@@ -34,36 +36,55 @@ SimpleCassieUdpSubscriber::SimpleCassieUdpSubscriber(const std::string& address,
   start_ = steady_clock::now();
 }
 
-void SimpleCassieUdpSubscriber::Poll() {
+bool SimpleCassieUdpSubscriber::Poll(double timeout) {
   // Create cassie output struct
-  char receive_buffer[2 + CASSIE_OUT_T_LEN];
+  systems::CassieOutPacket receive_buffer;
 
-  ssize_t des_len = (sizeof receive_buffer);
+  ssize_t des_len = receive_buffer.size();
 
   // Poll for a new packet of the correct length
   ssize_t nbytes = 0;
   struct pollfd fd = {.fd = socket_, .events = POLLIN, .revents = 0};
+  const double deadline = time() + timeout;
   do {
-      poll(&fd, 1, -1);
+      if (timeout < 0) {
+        poll(&fd, 1, -1);
+      } else {
+        // ppoll, for a finer timeout than the milliseconds of poll
+        const double remaining = std::max(deadline - time(), 0.0);
+        struct timespec remaining_ts;
+        remaining_ts.tv_sec = static_cast<time_t>(remaining);
+        remaining_ts.tv_nsec =
+            static_cast<long>((remaining - remaining_ts.tv_sec) * 1e9);
+        if (ppoll(&fd, 1, &remaining_ts, nullptr) == 0) {
+          return false;
+        }
+      }
       // Get newest valid packet in RX buffer
-      // Does not use sequence number for determining newest packet
       ioctl(socket_, FIONREAD, &nbytes);
       if (des_len <= nbytes) {
-        nbytes = recv(socket_, receive_buffer, des_len, 0);
+        nbytes = recv(socket_, receive_buffer.data(), des_len, 0);
       } else {
-        recv(socket_, receive_buffer, 0, 0);  // Discard packet
+        recv(socket_, receive_buffer.data(), 0, 0);  // Discard packet
+      }
+      // Drop stale and duplicate packets if asked to
+      if (des_len == nbytes && sequence_.Receive(receive_buffer.data()) < 0 &&
+          check_sequence_) {
+        nbytes = 0;
       }
   } while (des_len != nbytes);
 
-  time_ =
-    (duration_cast<microseconds>(steady_clock::now() - start_)).count()/1.0e6;
+  time_ = time();
 
-  // Split header and data
-  const unsigned char *data_in =
-    reinterpret_cast<const unsigned char *>(&receive_buffer[2]);
-
-  unpack_cassie_out_t(data_in, &data_);
+  systems::UnpackCassieOut(
+      receive_buffer.data() + systems::kCassieUdpHeaderLength, &data_);
   count_++;
+  return true;
+}
+
+double SimpleCassieUdpSubscriber::time() const {
+  return (duration_cast<microseconds>(steady_clock::now() - start_)).count() /
+         1.0e6;
 }
 
 }  // namespace dairlib
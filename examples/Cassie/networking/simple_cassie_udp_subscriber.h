@@ -2,11 +2,13 @@
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <chrono>
 #include <string>
 
 #include "drake/common/drake_copyable.h"
 #include "drake/common/text_logging.h"
 #include "examples/Cassie/datatypes/cassie_out_t.h"
+#include "examples/Cassie/networking/udp_serializer.h"
 
 namespace dairlib {
 
@@ -27,14 +29,19 @@ class SimpleCassieUdpSubscriber final {
 
   /**
    * Subscribes to the given address and port
+   * @param check_sequence if true, packets whose sequence number (see
+   * CassiePacketSequence) is not newer than the last received one are dropped
    */
-  SimpleCassieUdpSubscriber(const std::string& address, const int port);
+  SimpleCassieUdpSubscriber(const std::string& address, const int port,
+                            bool check_sequence = false);
 
   /**
    * Receives and stores the next message. This method will block until a
-   * message is received. 
+   * message is received, or for at most `timeout` seconds if it is not
+   * negative.
+   * @return false if no message was received before the timeout
    */
-  void Poll();
+  bool Poll(double timeout = -1);
 
   /**
    * Returns the most recently received message, or a value-initialized (zeros)
@@ -51,6 +58,12 @@ class SimpleCassieUdpSubscriber final {
   */
   double message_time() const { return time_; }
 
+  /** Returns the current time, on the clock of message_time() */
+  double time() const;
+
+  /** Returns the sequence statistics of the received packets. */
+  const systems::CassiePacketSequence& sequence() const { return sequence_; }
+
  private:
   // The channel on which to receive messages.
   const std::string address_;
@@ -60,6 +73,8 @@ class SimpleCassieUdpSubscriber final {
   cassie_out_t data_;
   int64_t count_;
   double time_;
+  const bool check_sequence_;
+  systems::CassiePacketSequence sequence_;
 
   std::chrono::time_point<std::chrono::steady_clock> start_;
 };
@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "examples/Cassie/networking/udp_lcm_translator.h"
+#include "examples/Cassie/networking/udp_serializer.h"
+
+DEFINE_int32(num_reps, 100000, "Number of packets per path");
+
+namespace dairlib {
+namespace {
+
+typedef std::chrono::steady_clock my_clock;
+
+template <typename F>
+void PrintTime(const std::string& name, F f) {
+  const auto start = my_clock::now();
+  for (int i = 0; i < FLAGS_num_reps; i++) {
+    f(i);
+  }
+  std::chrono::duration<double, std::nano> elapsed = my_clock::now() - start;
+  std::cout << name << ": " << elapsed.count() / FLAGS_num_reps
+            << " ns per packet" << std::endl;
+}
+
+// Compares the per-packet cost of the serializer path (AbstractValue, vector
+// buffers and the generated pack/unpack functions) with the direct packing
+// into stack buffers, for both directions, and of the LCM translation.
+int do_main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<float> distribution(-10, 10);
+  systems::CassieOutPacket out_packet;
+  for (size_t i = 0; i + sizeof(float) <= out_packet.size();
+       i += sizeof(float)) {
+    const float value = distribution(generator);
+    std::memcpy(out_packet.data() + i, &value, sizeof(float));
+  }
+  const uint8_t* out_data =
+      out_packet.data() + systems::kCassieUdpHeaderLength;
+
+  // Received packets, as CassieUDPSubscriber used to handle them
+  std::unique_ptr<drake::AbstractValue> out_value =
+      drake::AbstractValue::Make(cassie_out_t{});
+  std::vector<uint8_t> received_message;
+  PrintTime("cassie_out_t, serializer", [&](int i) {
+    out_packet[0] = i;
+    received_message.clear();
+    received_message.insert(received_message.begin(), out_data,
+                            out_data + CASSIE_OUT_T_LEN);
+    unpack_cassie_out_t(received_message.data(),
+                        &out_value->get_mutable_value<cassie_out_t>());
+  });
+
+  cassie_out_t cassie_out;
+  systems::CassiePacketSequence out_sequence;
+  PrintTime("cassie_out_t, direct", [&](int i) {
+    out_packet[0] = i;
+    out_sequence.Receive(out_packet.data());
+    systems::UnpackCassieOut(out_data, &cassie_out);
+  });
+
+  lcmt_cassie_out lcm_out;
+  PrintTime("cassie_out_t to lcmt_cassie_out", [&](int i) {
+    cassieOutToLcm(cassie_out, i * 5e-4, &lcm_out);
+  });
+
+  // Sent packets, as CassieUDPPublisher used to send them
+  cassie_user_in_t cassie_in{};
+  for (int i = 0; i < 10; i++) {
+    cassie_in.torque[i] = distribution(generator);
+  }
+  std::unique_ptr<drake::AbstractValue> in_value =
+      drake::AbstractValue::Make(cassie_in);
+  size_t sent_size = 0;
+  PrintTime("cassie_user_in_t, serializer", [&](int i) {
+    in_value->get_mutable_value<cassie_user_in_t>().torque[0] = i;
+    std::vector<uint8_t> message_bytes;
+    message_bytes.resize(CASSIE_USER_IN_T_LEN + 2);
+    pack_cassie_user_in_t(&in_value->get_value<cassie_user_in_t>(),
+                          &message_bytes.data()[2]);
+    sent_size += message_bytes.size();
+  });
+
+  systems::CassieUserInPacket in_packet;
+  systems::CassiePacketSequence in_sequence;
+  PrintTime("cassie_user_in_t, direct", [&](int i) {
+    cassie_in.torque[0] = i;
+    in_sequence.Send(in_packet.data());
+    systems::PackCassieUserIn(
+        cassie_in, in_packet.data() + systems::kCassieUdpHeaderLength);
+  });
+
+  // Keep the results alive
+  std::cout << "(" << cassie_out.leftLeg.kneeDrive.position
+            << lcm_out.utime << sent_size
+            << static_cast<int>(in_packet[2]) << ")" << std::endl;
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::do_main(argc, argv); }
@@ -0,0 +1,49 @@
+#include "examples/Cassie/networking/cassie_udp_timing.h"
+
+#include <gtest/gtest.h>
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+TEST(CassieUdpTimingTest, StatisticsTest) {
+  CassieUdpTiming timing(1e-3);
+  CassiePacketSequence sequence;
+  uint8_t header[kCassieUdpHeaderLength] = {0, 0};
+
+  // Steady packets have no jitter
+  for (int i = 0; i < 10; i++) {
+    header[0] = i;
+    sequence.Receive(header);
+    timing.Receive(i * 1e-3);
+  }
+  EXPECT_NEAR(timing.jitter(), 0, 1e-12);
+
+  // A late packet, after a missed one
+  timing.Late();
+  header[0] = 11;
+  sequence.Receive(header);
+  timing.Receive(11e-3);
+  EXPECT_NEAR(timing.jitter(), 1e-3 / 16, 1e-12);
+
+  lcmt_cassie_udp_timing message;
+  timing.CopyToLcm(sequence, 0.5, &message);
+  EXPECT_EQ(message.utime, 500000);
+  EXPECT_EQ(message.num_received, 11);
+  EXPECT_EQ(message.num_missed, 1);
+  EXPECT_EQ(message.num_stale, 0);
+  EXPECT_EQ(message.num_late, 1);
+  EXPECT_NEAR(message.mean_interarrival, 11e-3 / 10, 1e-12);
+  EXPECT_NEAR(message.max_interarrival, 2e-3, 1e-12);
+
+  // The inter-arrival times are per message, the counts are not
+  timing.Receive(12e-3);
+  timing.CopyToLcm(sequence, 1, &message);
+  EXPECT_EQ(message.num_late, 1);
+  EXPECT_NEAR(message.mean_interarrival, 1e-3, 1e-12);
+  EXPECT_NEAR(message.max_interarrival, 1e-3, 1e-12);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
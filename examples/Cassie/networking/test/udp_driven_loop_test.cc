@@ -7,6 +7,7 @@
 #include "drake/systems/analysis/simulator.h"
 #include "drake/systems/framework/diagram.h"
 #include "drake/systems/framework/diagram_builder.h"
+#include "common/realtime.h"
 #include "examples/Cassie/networking/cassie_udp_subscriber.h"
 #include "examples/Cassie/networking/cassie_output_sender.h"
 #include "examples/Cassie/networking/udp_driven_loop.h"
@@ -22,6 +23,13 @@ using drake::systems::TriggerType;
 // Simulation parameters.
 DEFINE_string(address, "127.0.0.1", "IPv4 address to receive from.");
 DEFINE_int64(port, 5000, "Port to receive on.");
+DEFINE_int32(rt_polling_priority, 0,
+             "SCHED_FIFO priority (1-99) of the UDP polling thread. 0 keeps "
+             "the default scheduling");
+DEFINE_string(rt_polling_cpus, "",
+              "Cpus the UDP polling thread is pinned to, e.g. \"2\"");
+DEFINE_bool(rt_lock_memory, false,
+            "Lock the memory of the process in RAM and prefault the heap");
 
 /// Runs UDP driven loop for 10 seconds
 /// Re-publishes any received messages as LCM
@@ -32,8 +40,12 @@ int do_main(int argc, char* argv[]) {
   DiagramBuilder<double> builder;
 
   // Create input receiver.
-  auto input_sub = builder.AddSystem(
-      systems::CassieUDPSubscriber::Make(FLAGS_address, FLAGS_port));
+  RealtimeOptions polling_options;
+  polling_options.priority = FLAGS_rt_polling_priority;
+  polling_options.cpus = ParseCpuList(FLAGS_rt_polling_cpus);
+  polling_options.lock_memory = FLAGS_rt_lock_memory;
+  auto input_sub = builder.AddSystem(systems::CassieUDPSubscriber::Make(
+      FLAGS_address, FLAGS_port, polling_options));
 
   // Create publisher--no publishing rate since this will be driven by LCM
   auto output_sender = builder.AddSystem<systems::CassieOutputSender>();
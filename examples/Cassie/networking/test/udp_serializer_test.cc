@@ -0,0 +1,105 @@
+#include "examples/Cassie/networking/udp_serializer.h"
+
+#include <cstring>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "examples/Cassie/networking/udp_lcm_translator.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+// Fills the bytes of a packet with random floats, so that the doubles of the
+// generated unpack_cassie_out_t() are all finite and comparable
+template <size_t N>
+void FillRandom(std::mt19937* generator, std::array<uint8_t, N>* bytes) {
+  std::uniform_real_distribution<float> distribution(-10, 10);
+  for (size_t i = 0; i + sizeof(float) <= N; i += sizeof(float)) {
+    const float value = distribution(*generator);
+    std::memcpy(bytes->data() + i, &value, sizeof(float));
+  }
+}
+
+TEST(UdpSerializerTest, CassieOutTest) {
+  std::mt19937 generator(0);
+  std::array<uint8_t, CASSIE_OUT_T_LEN> bytes;
+  std::array<uint8_t, CASSIE_OUT_T_LEN> packed;
+  std::array<uint8_t, CASSIE_OUT_T_LEN> expected_packed;
+  for (int i = 0; i < 100; i++) {
+    FillRandom(&generator, &bytes);
+    // Tables and generated code agree on every field
+    cassie_out_t expected, unpacked;
+    unpack_cassie_out_t(bytes.data(), &expected);
+    UnpackCassieOut(bytes.data(), &unpacked);
+    pack_cassie_out_t(&expected, expected_packed.data());
+    PackCassieOut(unpacked, packed.data());
+    EXPECT_EQ(packed, expected_packed);
+
+    // and through the LCM message
+    lcmt_cassie_out message;
+    cassieOutToLcm(unpacked, 1.5, &message);
+    EXPECT_EQ(message.utime, 1500000);
+    cassie_out_t translated;
+    cassieOutFromLcm(message, &translated);
+    PackCassieOut(translated, packed.data());
+    EXPECT_EQ(packed, expected_packed);
+  }
+}
+
+TEST(UdpSerializerTest, CassieUserInTest) {
+  std::mt19937 generator(1);
+  std::array<uint8_t, CASSIE_USER_IN_T_LEN> bytes;
+  std::array<uint8_t, CASSIE_USER_IN_T_LEN> packed;
+  std::array<uint8_t, CASSIE_USER_IN_T_LEN> expected_packed;
+  FillRandom(&generator, &bytes);
+  cassie_user_in_t expected, unpacked;
+  unpack_cassie_user_in_t(bytes.data(), &expected);
+  UnpackCassieUserIn(bytes.data(), &unpacked);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(unpacked.torque[i], expected.torque[i]);
+  }
+  for (int i = 0; i < 9; i++) {
+    EXPECT_EQ(unpacked.telemetry[i], expected.telemetry[i]);
+  }
+  pack_cassie_user_in_t(&expected, expected_packed.data());
+  PackCassieUserIn(unpacked, packed.data());
+  EXPECT_EQ(packed, expected_packed);
+
+  lcmt_cassie_in message;
+  cassieInToLcm(unpacked, 2, &message);
+  cassie_user_in_t translated;
+  cassieInFromLcm(message, &translated);
+  PackCassieUserIn(translated, packed.data());
+  EXPECT_EQ(packed, expected_packed);
+}
+
+TEST(UdpSerializerTest, SequenceTest) {
+  CassiePacketSequence sequence;
+  uint8_t header[kCassieUdpHeaderLength] = {250, 0};
+  EXPECT_EQ(sequence.Receive(header), 0);
+  header[0] = 251;
+  EXPECT_EQ(sequence.Receive(header), 0);
+  // Wraps around, missing 252..255 and 0
+  header[0] = 1;
+  EXPECT_EQ(sequence.Receive(header), 5);
+  // Duplicate and reordered packets
+  EXPECT_EQ(sequence.Receive(header), -1);
+  header[0] = 0;
+  EXPECT_EQ(sequence.Receive(header), -1);
+  EXPECT_EQ(sequence.num_received(), 3);
+  EXPECT_EQ(sequence.num_missed(), 5);
+  EXPECT_EQ(sequence.num_stale(), 2);
+
+  uint8_t sent[kCassieUdpHeaderLength];
+  sequence.Send(sent);
+  EXPECT_EQ(sent[0], 1);
+  EXPECT_EQ(sent[1], 1);
+  sequence.Send(sent);
+  EXPECT_EQ(sent[0], 2);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
@@ -1,8 +1,188 @@
 #include "examples/Cassie/networking/udp_serializer.h"
 
+#include <cstring>
+#include <type_traits>
+
+#include "examples/Cassie/networking/cassie_udp_fields.h"
+
 namespace dairlib {
 namespace systems {
 
+namespace {
+
+// Wire types of the field tables besides the integer types and float
+struct CassieBool {};            // uint8_t, true if nonzero
+struct CassieDiagnosticCode {};  // int16_t, EMPTY if not a known code
+
+template <typename Wire>
+struct WireFormat {
+  static constexpr int kSize = sizeof(Wire);
+
+  template <typename T>
+  static void Read(const uint8_t* bytes, T* value) {
+    Wire wire;
+    std::memcpy(&wire, bytes, sizeof(Wire));
+    *value = wire;
+  }
+
+  template <typename T>
+  static void Write(const T& value, uint8_t* bytes) {
+    const Wire wire = static_cast<Wire>(value);
+    std::memcpy(bytes, &wire, sizeof(Wire));
+  }
+};
+
+template <>
+struct WireFormat<CassieBool> {
+  static constexpr int kSize = 1;
+
+  template <typename T>
+  static void Read(const uint8_t* bytes, T* value) {
+    *value = bytes[0] != 0;
+  }
+
+  template <typename T>
+  static void Write(const T& value, uint8_t* bytes) {
+    bytes[0] = value;
+  }
+};
+
+template <>
+struct WireFormat<CassieDiagnosticCode> {
+  static constexpr int kSize = sizeof(int16_t);
+
+  static void Read(const uint8_t* bytes, DiagnosticCodes* value) {
+    int16_t code;
+    std::memcpy(&code, bytes, sizeof(code));
+    switch (code) {
+      case LEFT_HIP_NOT_CALIB: case LEFT_KNEE_NOT_CALIB:
+      case RIGHT_HIP_NOT_CALIB: case RIGHT_KNEE_NOT_CALIB:
+      case LOW_BATTERY_CHARGE: case HIGH_CPU_TEMP: case HIGH_VTM_TEMP:
+      case HIGH_ELMO_DRIVE_TEMP: case HIGH_STATOR_TEMP:
+      case LOW_ELMO_LINK_VOLTAGE: case HIGH_BATTERY_TEMP: case RADIO_DATA_BAD:
+      case RADIO_SIGNAL_BAD: case BMS_DATA_BAD: case VECTORNAV_DATA_BAD:
+      case VPE_GYRO_SATURATION: case VPE_MAG_SATURATION:
+      case VPE_ACC_SATURATION: case VPE_ATTITUDE_BAD:
+      case VPE_ATTITUDE_NOT_TRACKING: case ETHERCAT_DC_ERROR:
+      case ETHERCAT_ERROR: case LOAD_CALIB_DATA_ERROR:
+      case CRITICAL_BATTERY_CHARGE: case CRITICAL_CPU_TEMP:
+      case CRITICAL_VTM_TEMP: case CRITICAL_ELMO_DRIVE_TEMP:
+      case CRITICAL_STATOR_TEMP: case CRITICAL_BATTERY_TEMP:
+      case TORQUE_LIMIT_REACHED: case JOINT_LIMIT_REACHED:
+      case ENCODER_FAILURE: case SPRING_FAILURE: case LEFT_LEG_MEDULLA_HANG:
+      case RIGHT_LEG_MEDULLA_HANG: case PELVIS_MEDULLA_HANG:
+      case CPU_OVERLOAD:
+        *value = code;
+        break;
+      default:
+        *value = EMPTY;
+    }
+  }
+
+  static void Write(DiagnosticCodes value, uint8_t* bytes) {
+    const int16_t code = value;
+    std::memcpy(bytes, &code, sizeof(code));
+  }
+};
+
+// Reads or writes a field of the tables, and advances bytes past it
+template <typename Wire, typename T>
+void ReadField(const uint8_t** bytes, T* value) {
+  WireFormat<Wire>::Read(*bytes, value);
+  *bytes += WireFormat<Wire>::kSize;
+}
+
+template <typename Wire, typename T, size_t N>
+void ReadField(const uint8_t** bytes, T (*values)[N]) {
+  for (size_t i = 0; i < N; i++) {
+    ReadField<Wire>(bytes, &(*values)[i]);
+  }
+}
+
+template <typename Wire, typename T>
+void WriteField(const T& value, uint8_t** bytes) {
+  WireFormat<Wire>::Write(value, *bytes);
+  *bytes += WireFormat<Wire>::kSize;
+}
+
+template <typename Wire, typename T, size_t N>
+void WriteField(const T (&values)[N], uint8_t** bytes) {
+  for (size_t i = 0; i < N; i++) {
+    WriteField<Wire>(values[i], bytes);
+  }
+}
+
+template <typename T>
+constexpr int kNumElements = std::is_array<T>::value ? std::extent<T>::value
+                                                     : 1;
+
+#define CASSIE_OUT_FIELD_SIZE(field, wire) \
+  +WireFormat<wire>::kSize * kNumElements<decltype(cassie_out_t::field)>
+#define CASSIE_USER_IN_FIELD_SIZE(field, wire) \
+  +WireFormat<wire>::kSize * kNumElements<decltype(cassie_user_in_t::field)>
+static_assert(0 CASSIE_OUT_FIELDS(CASSIE_OUT_FIELD_SIZE) == CASSIE_OUT_T_LEN,
+              "CASSIE_OUT_FIELDS doesn't match CASSIE_OUT_T_LEN");
+static_assert(0 CASSIE_USER_IN_FIELDS(CASSIE_USER_IN_FIELD_SIZE) ==
+                  CASSIE_USER_IN_T_LEN,
+              "CASSIE_USER_IN_FIELDS doesn't match CASSIE_USER_IN_T_LEN");
+#undef CASSIE_OUT_FIELD_SIZE
+#undef CASSIE_USER_IN_FIELD_SIZE
+
+}  // namespace
+
+#define READ_CASSIE_OUT_FIELD(field, wire) \
+  ReadField<wire>(&data, &cassie_out->field);
+#define WRITE_CASSIE_OUT_FIELD(field, wire) \
+  WriteField<wire>(cassie_out.field, &data);
+#define READ_CASSIE_USER_IN_FIELD(field, wire) \
+  ReadField<wire>(&data, &cassie_in->field);
+#define WRITE_CASSIE_USER_IN_FIELD(field, wire) \
+  WriteField<wire>(cassie_in.field, &data);
+
+void UnpackCassieOut(const uint8_t* data, cassie_out_t* cassie_out) {
+  CASSIE_OUT_FIELDS(READ_CASSIE_OUT_FIELD)
+}
+
+void PackCassieOut(const cassie_out_t& cassie_out, uint8_t* data) {
+  CASSIE_OUT_FIELDS(WRITE_CASSIE_OUT_FIELD)
+}
+
+void UnpackCassieUserIn(const uint8_t* data, cassie_user_in_t* cassie_in) {
+  CASSIE_USER_IN_FIELDS(READ_CASSIE_USER_IN_FIELD)
+}
+
+void PackCassieUserIn(const cassie_user_in_t& cassie_in, uint8_t* data) {
+  CASSIE_USER_IN_FIELDS(WRITE_CASSIE_USER_IN_FIELD)
+}
+
+#undef READ_CASSIE_OUT_FIELD
+#undef WRITE_CASSIE_OUT_FIELD
+#undef READ_CASSIE_USER_IN_FIELD
+#undef WRITE_CASSIE_USER_IN_FIELD
+
+int CassiePacketSequence::Receive(const uint8_t* header) {
+  const uint8_t sequence = header[0];
+  int num_missed = 0;
+  if (has_received_) {
+    const uint8_t difference = sequence - last_received_;
+    if (difference == 0 || difference >= 128) {
+      num_stale_++;
+      return -1;
+    }
+    num_missed = difference - 1;
+  }
+  has_received_ = true;
+  last_received_ = sequence;
+  num_received_++;
+  num_missed_ += num_missed;
+  return num_missed;
+}
+
+void CassiePacketSequence::Send(uint8_t* header) {
+  last_sent_++;
+  header[0] = last_sent_;
+  header[1] = last_received_;
+}
 
 }  // namespace systems
 }  // namespace dairlib
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -15,6 +16,53 @@
 namespace dairlib {
 namespace systems {
 
+/// A Cassie UDP packet: a 2 byte header, followed by the packed struct. The
+/// header holds the sequence number of the packet and the sequence number of
+/// the last packet received from the other side (see CassiePacketSequence).
+constexpr int kCassieUdpHeaderLength = 2;
+using CassieOutPacket =
+    std::array<uint8_t, kCassieUdpHeaderLength + CASSIE_OUT_T_LEN>;
+using CassieUserInPacket =
+    std::array<uint8_t, kCassieUdpHeaderLength + CASSIE_USER_IN_T_LEN>;
+
+/// Direct equivalents of the generated unpack_cassie_out_t(),
+/// pack_cassie_out_t(), unpack_cassie_user_in_t() and pack_cassie_user_in_t()
+/// (without the header), generated from the field tables of
+/// cassie_udp_fields.h. They produce the same bytes and structs, without the
+/// intermediate copies of the generated code.
+void UnpackCassieOut(const uint8_t* data, cassie_out_t* cassie_out);
+void PackCassieOut(const cassie_out_t& cassie_out, uint8_t* data);
+void UnpackCassieUserIn(const uint8_t* data, cassie_user_in_t* cassie_in);
+void PackCassieUserIn(const cassie_user_in_t& cassie_in, uint8_t* data);
+
+/**
+ * %CassiePacketSequence checks the sequence numbers in the headers of the
+ * received packets, and writes the headers of the sent packets, as in the
+ * Agility UDP examples. Sequence numbers wrap at 256.
+ */
+class CassiePacketSequence {
+ public:
+  /// Checks the header of a received packet.
+  /// @return the number of packets missed since the previous one, or -1 if
+  /// the packet is a duplicate or older than the previous one
+  int Receive(const uint8_t* header);
+
+  /// Writes the header of the next sent packet
+  void Send(uint8_t* header);
+
+  int64_t num_received() const { return num_received_; }
+  int64_t num_missed() const { return num_missed_; }
+  int64_t num_stale() const { return num_stale_; }
+
+ private:
+  bool has_received_ = false;
+  uint8_t last_received_ = 0;
+  uint8_t last_sent_ = 0;
+  int64_t num_received_ = 0;
+  int64_t num_missed_ = 0;
+  int64_t num_stale_ = 0;
+};
+
 /**
  * AS OF 5-17-2019, THIS CLASS IS DEPRECATED
  *
@@ -43,8 +91,10 @@ class CassieUDPOutSerializer : public drake::systems::lcm::SerializerInterface {
       drake::AbstractValue* abstract_value) const override {
     DRAKE_DEMAND(abstract_value != nullptr);
 
+    DRAKE_DEMAND(message_length == CASSIE_OUT_T_LEN);
+
     // Unpack received data into cassie output struct
-    unpack_cassie_out_t(reinterpret_cast<const unsigned char *>(message_bytes),
+    UnpackCassieOut(static_cast<const uint8_t*>(message_bytes),
         &abstract_value->get_mutable_value<cassie_out_t>());
   }
 
@@ -88,9 +138,9 @@ class CassieUDPInSerializer : public drake::systems::lcm::SerializerInterface {
     DRAKE_DEMAND(message_bytes != nullptr);
     const cassie_user_in_t& message =
         abstract_value.get_value<cassie_user_in_t>();
-    message_bytes->resize(CASSIE_USER_IN_T_LEN + 2);
+    message_bytes->resize(CASSIE_USER_IN_T_LEN + kCassieUdpHeaderLength);
 
-    pack_cassie_user_in_t(&message, &message_bytes->data()[2]);
+    PackCassieUserIn(message, &message_bytes->data()[kCassieUdpHeaderLength]);
   }
 };
 
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "multibody/kinematic/distance_evaluator.h"
+#include "multibody/kinematic/kinematic_evaluator_set.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "systems/controllers/osc/osc_tracking_data.h"
+
+#include "drake/common/drake_copyable.h"
+#include "drake/multibody/plant/multibody_plant.h"
+#include "drake/systems/framework/diagram.h"
+
+namespace dairlib {
+namespace cassie {
+namespace osc {
+
+/// Options of OSCWalkingControllerDiagram, which are the flags of
+/// run_osc_walking_controller
+struct OSCWalkingControllerOptions {
+  /// true: only right/left single support
+  /// false: both double and single support
+  bool is_two_phase = false;
+  /// Plan the CoM and footsteps with LipmMpc over num_mpc_steps steps,
+  /// instead of LIPMTrajGenerator and CPTrajGenerator (one step)
+  bool use_lipm_mpc = false;
+  int num_mpc_steps = 3;
+  /// Drift rate for the floating-base state
+  double drift_rate = 0;
+  bool print_osc = false;
+  /// Walking target of HighLevelCommand
+  Eigen::Vector2d global_target_position = Eigen::Vector2d(1, 0);
+};
+
+/// OSCWalkingControllerDiagram is the walking controller of
+/// run_osc_walking_controller (drift emulator, high-level command, heading
+/// and CoM/swing foot trajectory generators, finite state machine and OSC)
+/// as a single Diagram, so that it can be driven by LcmDrivenLoop or wired
+/// directly to a simulated plant.
+///
+/// Input:
+///  - OutputVector of plant_w_springs (state, efforts and timestamp)
+///
+/// Output:
+///  - TimestampedVector of the OSC efforts
+///  - lcmt_osc_output debug message
+///
+/// The diagram owns the kinematic evaluators and tracking data referenced by
+/// the OSC. Both plants must outlive it.
+class OSCWalkingControllerDiagram : public drake::systems::Diagram<double> {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(OSCWalkingControllerDiagram)
+
+  /// @param plant_w_springs Cassie with springs, the model of the state input
+  /// @param plant_wo_springs Cassie with fixed springs, used by the OSC
+  OSCWalkingControllerDiagram(
+      const drake::multibody::MultibodyPlant<double>& plant_w_springs,
+      const drake::multibody::MultibodyPlant<double>& plant_wo_springs,
+      const OSCWalkingControllerOptions& options =
+          OSCWalkingControllerOptions());
+
+  const drake::systems::InputPort<double>& get_state_input_port() const {
+    return this->get_input_port(state_port_);
+  }
+  const drake::systems::OutputPort<double>& get_control_output_port() const {
+    return this->get_output_port(control_port_);
+  }
+  const drake::systems::OutputPort<double>& get_osc_debug_output_port() const {
+    return this->get_output_port(osc_debug_port_);
+  }
+  const drake::systems::OutputPort<double>& get_fsm_output_port() const {
+    return this->get_output_port(fsm_port_);
+  }
+  /// The tracking data of the OSC, in the order of the lcmt_osc_output
+  const std::vector<systems::controllers::OscTrackingData*>&
+  get_tracking_data() const {
+    return tracking_data_;
+  }
+  /// The output ports of the systems upstream of the OSC, in stages for
+  /// ParallelOutputEvaluator: the systems of a stage are independent of each
+  /// other and only depend on the previous stages. The first stage reads the
+  /// state input port from two threads, so the port connected to it must be
+  /// evaluated by a stage of its own before these ones.
+  const std::vector<std::vector<const drake::systems::OutputPort<double>*>>&
+  get_concurrent_stages() const {
+    return concurrent_stages_;
+  }
+
+ private:
+  int state_port_;
+  int control_port_;
+  int osc_debug_port_;
+  int fsm_port_;
+
+  // Constraints and tracking data of the OSC, which keeps pointers to them
+  std::unique_ptr<multibody::KinematicEvaluatorSet<double>> evaluators_;
+  std::unique_ptr<multibody::DistanceEvaluator<double>> left_loop_;
+  std::unique_ptr<multibody::DistanceEvaluator<double>> right_loop_;
+  std::unique_ptr<multibody::WorldPointEvaluator<double>> left_toe_evaluator_;
+  std::unique_ptr<multibody::WorldPointEvaluator<double>> left_heel_evaluator_;
+  std::unique_ptr<multibody::WorldPointEvaluator<double>> right_toe_evaluator_;
+  std::unique_ptr<multibody::WorldPointEvaluator<double>>
+      right_heel_evaluator_;
+  std::unique_ptr<systems::controllers::TransTaskSpaceTrackingData>
+      swing_foot_traj_;
+  std::unique_ptr<systems::controllers::ComTrackingData> center_of_mass_traj_;
+  std::unique_ptr<systems::controllers::RotTaskSpaceTrackingData>
+      pelvis_balance_traj_;
+  std::unique_ptr<systems::controllers::RotTaskSpaceTrackingData>
+      pelvis_heading_traj_;
+  std::unique_ptr<systems::controllers::JointSpaceTrackingData>
+      swing_toe_traj_;
+  std::unique_ptr<systems::controllers::JointSpaceTrackingData>
+      swing_hip_yaw_traj_;
+  std::vector<systems::controllers::OscTrackingData*> tracking_data_;
+  std::vector<std::vector<const drake::systems::OutputPort<double>*>>
+      concurrent_stages_;
+};
+
+}  // namespace osc
+}  // namespace cassie
+}  // namespace dairlib
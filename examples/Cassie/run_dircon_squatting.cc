@@ -16,6 +16,7 @@
 #include "systems/trajectory_optimization/dircon_kinematic_data_set.h"
 #include "systems/trajectory_optimization/dircon_opt_constraints.h"
 #include "systems/trajectory_optimization/dircon_position_data.h"
+#include "systems/trajectory_optimization/dircon_warm_start.h"
 #include "systems/trajectory_optimization/hybrid_dircon.h"
 
 #include "drake/geometry/geometry_visualization.h"
@@ -63,6 +64,8 @@ using dairlib::goldilocks_models::readCSV;
 using dairlib::goldilocks_models::writeCSV;
 using dairlib::systems::SubvectorPassThrough;
 using dairlib::systems::trajectory_optimization::DirconOptions;
+using dairlib::systems::trajectory_optimization::DirconProblemKey;
+using dairlib::systems::trajectory_optimization::DirconWarmStartLibrary;
 using dairlib::systems::trajectory_optimization::HybridDircon;
 using dairlib::systems::trajectory_optimization::PointPositionConstraint;
 
@@ -70,6 +73,12 @@ DEFINE_string(init_file, "", "the file name of initial guess");
 DEFINE_string(data_directory, "../dairlib_data/cassie_trajopt_data/",
               "directory to save/read data");
 DEFINE_bool(store_data, false, "To store solution or not");
+DEFINE_string(warm_start_library, "",
+              "trajectory container (in data_directory) of previous solutions "
+              "used to warm start the solve when init_file is empty. "
+              "Successful solutions are added to it.");
+DEFINE_int32(warm_start_neighbors, 2,
+             "number of nearest previous solutions blended in the warm start");
 DEFINE_int32(max_iter, 100000, "Iteration limit");
 DEFINE_double(duration, 0.4, "Duration of the single support phase (s)");
 DEFINE_double(tol, 1e-4, "Tolerance for constraint violation and dual gap");
@@ -398,9 +407,20 @@ void DoMain(double duration, int max_iter, string data_directory,
   }
 
   // initial guess
+  DirconProblemKey warm_start_key{"squatting", num_time_samples, {"duration"},
+                                  (VectorXd(1) << duration).finished()};
+  std::unique_ptr<DirconWarmStartLibrary> warm_start_library;
+  if (!FLAGS_warm_start_library.empty()) {
+    warm_start_library = std::make_unique<DirconWarmStartLibrary>(
+        data_directory + FLAGS_warm_start_library);
+  }
   if (!init_file.empty()) {
     MatrixXd z0 = readCSV(data_directory + init_file);
     trajopt->SetInitialGuessForAllVariables(z0);
+  } else if (warm_start_library &&
+             warm_start_library->SetInitialGuess(
+                 warm_start_key, trajopt.get(), FLAGS_warm_start_neighbors)) {
+    cout << "Warm started from " << FLAGS_warm_start_library << endl;
   } else {
     // Add random initial guess first (the seed for RNG is fixed)
     trajopt->SetInitialGuessForAllVariables(
@@ -485,6 +505,9 @@ void DoMain(double duration, int max_iter, string data_directory,
   if (to_store_data) {
     writeCSV(data_directory + string("z.csv"), z);
   }
+  if (warm_start_library && result.is_success()) {
+    warm_start_library->Add(warm_start_key, *trajopt, result);
+  }
   // for (int i = 0; i < z.size(); i++) {
   //   cout << trajopt->decision_variables()[i] << ", " << z[i] << endl;
   // }
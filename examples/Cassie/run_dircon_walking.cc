@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 #include <gflags/gflags.h>
+#include <sys/resource.h>
 #include "common/find_resource.h"
 #include "examples/Cassie/cassie_utils.h"
 #include "multibody/com_pose_system.h"
@@ -14,6 +15,7 @@
 #include "systems/trajectory_optimization/dircon_kinematic_data_set.h"
 #include "systems/trajectory_optimization/dircon_opt_constraints.h"
 #include "systems/trajectory_optimization/dircon_position_data.h"
+#include "systems/trajectory_optimization/dircon_warm_start.h"
 #include "systems/trajectory_optimization/hybrid_dircon.h"
 #include "drake/geometry/geometry_visualization.h"
 #include "drake/lcm/drake_lcm.h"
@@ -42,6 +44,8 @@ using dairlib::goldilocks_models::readCSV;
 using dairlib::goldilocks_models::writeCSV;
 using dairlib::systems::SubvectorPassThrough;
 using dairlib::systems::trajectory_optimization::DirconOptions;
+using dairlib::systems::trajectory_optimization::DirconProblemKey;
+using dairlib::systems::trajectory_optimization::DirconWarmStartLibrary;
 using dairlib::systems::trajectory_optimization::HybridDircon;
 using dairlib::systems::trajectory_optimization::PointPositionConstraint;
 using drake::VectorX;
@@ -63,6 +67,12 @@ DEFINE_string(init_file, "", "the file name of initial guess");
 DEFINE_string(data_directory, "../dairlib_data/cassie_trajopt_data/",
               "directory to save/read data");
 DEFINE_bool(store_data, false, "To store solution or not");
+DEFINE_string(warm_start_library, "",
+              "trajectory container (in data_directory) of previous solutions "
+              "used to warm start the solve when init_file is empty. "
+              "Successful solutions are added to it.");
+DEFINE_int32(warm_start_neighbors, 2,
+             "number of nearest previous solutions blended in the warm start");
 
 // SNOPT parameters
 DEFINE_int32(max_iter, 100000, "Iteration limit");
@@ -87,9 +97,17 @@ DEFINE_double(ground_incline, 0.0,
 DEFINE_bool(is_scale_constraint, true, "Scale the nonlinear constraint values");
 DEFINE_bool(is_scale_variable, true, "Scale the decision variable");
 
+DEFINE_bool(quaternion_exp_map, false,
+            "Integrate the pelvis quaternion with the exponential map instead "
+            "of using quaternion slack variables and norm constraints");
+
 // Others
 DEFINE_bool(visualize_init_guess, false,
             "to visualize the poses of the initial guess");
+DEFINE_bool(setup_only, false,
+            "Print the program setup time and peak memory, and exit before "
+            "solving. Used to benchmark the HybridDircon construction, e.g. "
+            "with --n_node=60");
 
 namespace dairlib {
 
@@ -228,6 +246,8 @@ void DoMain(double duration, double stride_length, double ground_incline,
             bool is_fix_time, int n_node, int max_iter,
             const string& data_directory, const string& init_file, double tol,
             bool to_store_data, int scale_option) {
+  auto setup_start = std::chrono::high_resolution_clock::now();
+
   // Dircon parameter
   double minimum_timestep = 0.01;
   DRAKE_DEMAND(duration / (n_node - 1) >= minimum_timestep);
@@ -368,6 +388,7 @@ void DoMain(double duration, double stride_length, double ground_incline,
   // set force cost weight
   for (int i = 0; i < 2; i++) {
     options_list[i].setForceCost(w_lambda);
+    options_list[i].setQuaternionExpMap(FLAGS_quaternion_exp_map);
   }
 
   // Be careful in setting relative constraint, because we skip constraints
@@ -429,8 +450,11 @@ void DoMain(double duration, double stride_length, double ground_incline,
   dataset_list.push_back(&ls_dataset);
   dataset_list.push_back(&rs_dataset);
 
+  auto construction_start = std::chrono::high_resolution_clock::now();
   auto trajopt = std::make_shared<HybridDircon<double>>(
       plant, num_time_samples, min_dt, max_dt, dataset_list, options_list);
+  std::chrono::duration<double> construction_time =
+      std::chrono::high_resolution_clock::now() - construction_start;
 
   // Snopt settings
   //  trajopt->SetSolverOption(drake::solvers::SnoptSolver::id(), "Print file",
@@ -766,9 +790,26 @@ void DoMain(double duration, double stride_length, double ground_incline,
   }
 
   // initial guess
+  DirconProblemKey warm_start_key{
+      "walking",
+      num_time_samples,
+      {"stride_length", "duration", "ground_incline", "is_fix_time",
+       "quaternion_exp_map"},
+      (VectorXd(5) << stride_length, duration, ground_incline,
+       is_fix_time ? 1 : 0, FLAGS_quaternion_exp_map ? 1 : 0)
+          .finished()};
+  std::unique_ptr<DirconWarmStartLibrary> warm_start_library;
+  if (!FLAGS_warm_start_library.empty()) {
+    warm_start_library = std::make_unique<DirconWarmStartLibrary>(
+        data_directory + FLAGS_warm_start_library);
+  }
   if (!init_file.empty()) {
     MatrixXd z0 = readCSV(data_directory + init_file);
     trajopt->SetInitialGuessForAllVariables(z0);
+  } else if (warm_start_library &&
+             warm_start_library->SetInitialGuess(
+                 warm_start_key, trajopt.get(), FLAGS_warm_start_neighbors)) {
+    cout << "Warm started from " << FLAGS_warm_start_library << endl;
   } else {
     // Add random initial guess first (the seed for RNG is fixed)
     trajopt->SetInitialGuessForAllVariables(
@@ -902,6 +943,21 @@ void DoMain(double duration, double stride_length, double ground_incline,
   trajopt->CreateVisualizationCallback(
       "examples/Cassie/urdf/cassie_fixed_springs.urdf", 5);
 
+  std::chrono::duration<double> setup_time =
+      std::chrono::high_resolution_clock::now() - setup_start;
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  cout << "HybridDircon construction time: " << construction_time.count()
+       << " s\n";
+  cout << "Total setup time: " << setup_time.count() << " s\n";
+  cout << "Number of decision variables: " << trajopt->num_vars() << "\n";
+  cout << "Number of constraint bindings: "
+       << trajopt->GetAllConstraints().size() << "\n";
+  cout << "Peak RSS: " << usage.ru_maxrss / 1024.0 << " MB\n";
+  if (FLAGS_setup_only) {
+    return;
+  }
+
   cout << "\nChoose the best solver: "
        << drake::solvers::ChooseBestSolver(*trajopt).name() << endl;
 
@@ -926,6 +982,9 @@ void DoMain(double duration, double stride_length, double ground_incline,
   if (to_store_data) {
     writeCSV(data_directory + string("z.csv"), z);
   }
+  if (warm_start_library && result.is_success()) {
+    warm_start_library->Add(warm_start_key, *trajopt, result);
+  }
 
   // Print the solution
   /*for (int i = 0; i < z.size(); i++) {
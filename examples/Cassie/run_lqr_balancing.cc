@@ -10,6 +10,7 @@
 
 #include "multibody/kinematic/world_point_evaluator.h"
 #include "systems/controllers/constrained_lqr_controller.h"
+#include "systems/controllers/lqr_gain_schedule.h"
 #include "systems/robot_lcm_systems.h"
 #include "examples/Cassie/cassie_fixed_point_solver.h"
 #include "examples/Cassie/cassie_utils.h"
@@ -37,6 +38,14 @@ DEFINE_string(input_channel, "CASSIE_INPUT",
               "LCM channel for receiving the motor inputs");
 DEFINE_bool(spring_model, true, "Use a URDF with or without legs springs");
 
+// Gain scheduling
+DEFINE_string(gain_schedule, "",
+              "If set, an LQR gain schedule from compute_lqr_gain_schedule "
+              "to use instead of the controller about a single fixed point");
+DEFINE_bool(nearest_gain, false,
+            "Switch to the nearest gain of the schedule instead of "
+            "interpolating");
+
 using drake::AutoDiffVecXd;
 using drake::AutoDiffXd;
 using drake::multibody::MultibodyPlant;
@@ -67,7 +76,9 @@ int do_main(int argc, char* argv[]) {
   double mu_fp = 0;
   double min_normal_fp = 70;
   double toe_spread = .2;
-  if (FLAGS_floating_base) {
+  if (!FLAGS_gain_schedule.empty()) {
+    // The fixed points are in the gain schedule
+  } else if (FLAGS_floating_base) {
     CassieFixedPointSolver(plant, FLAGS_height, mu_fp, min_normal_fp,
         true, toe_spread, &q, &u, &lambda);  
   } else {
@@ -135,42 +146,51 @@ int do_main(int argc, char* argv[]) {
   }
 
 
-  // Create a context
-  VectorXd xul(plant.num_positions() + plant.num_velocities()
-      + plant.num_actuators() + evaluators.count_full());
-  xul << q, VectorXd::Zero(plant.num_velocities()), u, lambda;
-  AutoDiffVecXd xul_ad = drake::math::initializeAutoDiff(xul);
-
-  AutoDiffVecXd x_ad = xul_ad.head(plant.num_positions()
-      + plant.num_velocities());
-  AutoDiffVecXd u_ad = xul_ad.segment(plant.num_positions()
-      + plant.num_velocities(), plant.num_actuators());
-
-  auto context_autodiff = multibody::createContext(*plant_ad, x_ad, u_ad);
-
-  // controller gains
-  Eigen::MatrixXd Q =
-      Eigen::MatrixXd::Zero(plant.num_positions() + plant.num_velocities(),
-          plant.num_positions() + plant.num_velocities());
-
-  Q << FLAGS_Q_scale * 10 * Eigen::MatrixXd::Identity(plant.num_positions(),
-          plant.num_positions()),
-       Eigen::MatrixXd::Zero(plant.num_positions(), plant.num_velocities()),
-       Eigen::MatrixXd::Zero(plant.num_velocities(), plant.num_positions()),
-       FLAGS_Q_scale * 1 * Eigen::MatrixXd::Identity(plant.num_velocities(),
-          plant.num_velocities());
-
-  Q(4,4) *= FLAGS_Q_xy;
-  Q(5,5) *= FLAGS_Q_xy;
-
-
-  Eigen::MatrixXd R =  
-      Eigen::MatrixXd::Identity(plant.num_actuators(), plant.num_actuators());
-  R(8,8) *= FLAGS_R_toe_scale;
-  R(9,9) *= FLAGS_R_toe_scale;
-
-  auto controller = builder.AddSystem<systems::ConstrainedLQRController>(
-      evaluators, *context_autodiff, lambda, Q, R);
+  drake::systems::LeafSystem<double>* controller;
+  if (!FLAGS_gain_schedule.empty()) {
+    auto lookup = FLAGS_nearest_gain
+                      ? systems::LQRGainSchedule::Lookup::kNearest
+                      : systems::LQRGainSchedule::Lookup::kInterpolate;
+    controller = builder.AddSystem<systems::GainScheduledLQRController>(
+        plant, systems::LQRGainSchedule::Load(FLAGS_gain_schedule), lookup);
+  } else {
+    // Create a context
+    VectorXd xul(plant.num_positions() + plant.num_velocities()
+        + plant.num_actuators() + evaluators.count_full());
+    xul << q, VectorXd::Zero(plant.num_velocities()), u, lambda;
+    AutoDiffVecXd xul_ad = drake::math::initializeAutoDiff(xul);
+
+    AutoDiffVecXd x_ad = xul_ad.head(plant.num_positions()
+        + plant.num_velocities());
+    AutoDiffVecXd u_ad = xul_ad.segment(plant.num_positions()
+        + plant.num_velocities(), plant.num_actuators());
+
+    auto context_autodiff = multibody::createContext(*plant_ad, x_ad, u_ad);
+
+    // controller gains
+    Eigen::MatrixXd Q =
+        Eigen::MatrixXd::Zero(plant.num_positions() + plant.num_velocities(),
+            plant.num_positions() + plant.num_velocities());
+
+    Q << FLAGS_Q_scale * 10 * Eigen::MatrixXd::Identity(plant.num_positions(),
+            plant.num_positions()),
+         Eigen::MatrixXd::Zero(plant.num_positions(), plant.num_velocities()),
+         Eigen::MatrixXd::Zero(plant.num_velocities(), plant.num_positions()),
+         FLAGS_Q_scale * 1 * Eigen::MatrixXd::Identity(plant.num_velocities(),
+            plant.num_velocities());
+
+    Q(4,4) *= FLAGS_Q_xy;
+    Q(5,5) *= FLAGS_Q_xy;
+
+
+    Eigen::MatrixXd R =  
+        Eigen::MatrixXd::Identity(plant.num_actuators(), plant.num_actuators());
+    R(8,8) *= FLAGS_R_toe_scale;
+    R(9,9) *= FLAGS_R_toe_scale;
+
+    controller = builder.AddSystem<systems::ConstrainedLQRController>(
+        evaluators, *context_autodiff, lambda, Q, R);
+  }
 
   builder.Connect(*state_receiver, *controller);
   builder.Connect(*controller, *command_sender);
@@ -0,0 +1,110 @@
+#include <iostream>
+
+#include <gflags/gflags.h>
+
+#include "examples/Cassie/cassie_fixed_point_solver.h"
+#include "examples/Cassie/cassie_utils.h"
+#include "examples/Cassie/monte_carlo_sim.h"
+
+// Simulates the OSC walking controller on Cassie many times, in parallel and
+// in process (no LCM), with randomized ground friction and slope, link
+// masses and pushes on the pelvis, and prints the number of falls, the
+// tracking errors and the controller update time percentiles.
+
+DEFINE_int32(num_runs, 32, "Number of simulations");
+DEFINE_int32(num_threads, 0, "Number of threads, 0 for one per core");
+DEFINE_int32(seed, 0, "Seed of the randomization");
+DEFINE_double(end_time, 5, "Duration of each simulation");
+DEFINE_double(dt, 8e-5, "The step size of the time-stepping plant");
+DEFINE_double(init_height, .9,
+              "Initial starting height of the pelvis above ground");
+DEFINE_double(controller_period, 1e-3, "Period of the controller updates");
+DEFINE_double(fall_height, .5, "Pelvis height below which Cassie has fallen");
+
+DEFINE_double(min_mu, .6, "Lowest ground friction coefficient");
+DEFINE_double(max_mu, 1, "Highest ground friction coefficient");
+DEFINE_double(max_slope, .05, "Largest ground slope (rad)");
+DEFINE_double(mass_scale_range, .1, "Relative perturbation of link masses");
+DEFINE_double(max_push_force, 50, "Largest push on the pelvis (N)");
+DEFINE_double(push_duration, .1, "Duration of the push");
+
+DEFINE_bool(is_two_phase, false,
+            "true: only right/left single support"
+            "false: both double and single support");
+DEFINE_bool(use_lipm_mpc, false,
+            "true: plan the CoM and footsteps with LipmMpc over several steps"
+            "false: LIPMTrajGenerator and CPTrajGenerator (one step)");
+DEFINE_string(output, "", "If not empty, the per-run results csv file");
+
+namespace dairlib {
+
+int do_main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  drake::logging::set_log_level("err");  // ignore warnings about joint limits
+
+  MonteCarloOptions options;
+  options.num_runs = FLAGS_num_runs;
+  options.num_threads = FLAGS_num_threads;
+  options.seed = FLAGS_seed;
+  options.end_time = FLAGS_end_time;
+  options.sim_dt = FLAGS_dt;
+  options.init_height = FLAGS_init_height;
+  options.controller_period = FLAGS_controller_period;
+  options.fall_height = FLAGS_fall_height;
+  options.min_mu = FLAGS_min_mu;
+  options.max_mu = FLAGS_max_mu;
+  options.max_slope = FLAGS_max_slope;
+  options.mass_scale_range = FLAGS_mass_scale_range;
+  options.max_push_force = FLAGS_max_push_force;
+  options.push_duration = FLAGS_push_duration;
+  options.controller.is_two_phase = FLAGS_is_two_phase;
+  options.controller.use_lipm_mpc = FLAGS_use_lipm_mpc;
+
+  // The initial state of every run, as in multibody_sim
+  drake::multibody::MultibodyPlant<double> plant(0.0);
+  addCassieMultibody(&plant, nullptr, true,
+                     "examples/Cassie/urdf/cassie_v2.urdf", true, false);
+  plant.Finalize();
+  Eigen::VectorXd q_init, u_init, lambda_init;
+  double mu_fp = 0;
+  double min_normal_fp = 70;
+  double toe_spread = .2;
+  CassieFixedPointSolver(plant, options.init_height, mu_fp, min_normal_fp,
+                         true, toe_spread, &q_init, &u_init, &lambda_init);
+
+  double wall_time;
+  auto runs = RunMonteCarloSims(options, q_init, &wall_time);
+  auto summary = SummarizeMonteCarloRuns(runs, wall_time);
+
+  std::cout << "Simulated " << summary.num_runs << " runs ("
+            << summary.simulated_time << "s) in " << summary.wall_time
+            << "s, " << summary.simulated_time / summary.wall_time
+            << "x real time" << std::endl;
+  std::cout << "Falls: " << summary.num_falls << "/" << summary.num_runs
+            << std::endl;
+  for (const auto& run : runs) {
+    if (!run.error.empty()) {
+      std::cout << "  run " << run.index << " failed at " << run.end_time
+                << "s: " << run.error << std::endl;
+    }
+  }
+  std::cout << "Mean RMS tracking error:" << std::endl;
+  for (const auto& rms : summary.mean_rms_tracking_error) {
+    std::cout << "  " << rms.first << ": " << rms.second << std::endl;
+  }
+  std::cout << "Controller update time (ms): p50 "
+            << 1e3 * summary.controller_time_p50 << ", p90 "
+            << 1e3 * summary.controller_time_p90 << ", p99 "
+            << 1e3 * summary.controller_time_p99 << ", max "
+            << 1e3 * summary.controller_time_max << std::endl;
+
+  if (!FLAGS_output.empty()) {
+    WriteMonteCarloCsv(runs, FLAGS_output);
+    std::cout << "Saved the runs to " << FLAGS_output << std::endl;
+  }
+  return 0;
+}
+
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::do_main(argc, argv); }
@@ -1,19 +1,22 @@
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include <gflags/gflags.h>
 
+#include "common/realtime.h"
+#include "dairlib/lcmt_osc_output.hpp"
 #include "dairlib/lcmt_robot_input.hpp"
 #include "dairlib/lcmt_robot_output.hpp"
 #include "examples/Cassie/cassie_utils.h"
-#include "examples/Cassie/osc/deviation_from_cp.h"
-#include "examples/Cassie/osc/heading_traj_generator.h"
-#include "examples/Cassie/osc/high_level_command.h"
-#include "examples/Cassie/simulator_drift.h"
-#include "multibody/kinematic/kinematic_evaluator_set.h"
-#include "multibody/multibody_utils.h"
-#include "systems/controllers/cp_traj_gen.h"
-#include "systems/controllers/lipm_traj_gen.h"
-#include "systems/controllers/osc/operational_space_control.h"
-#include "systems/controllers/time_based_fsm.h"
+#include "examples/Cassie/osc/osc_walking_controller_diagram.h"
+#include "systems/controllers/osc/osc_debug_recorder.h"
 #include "systems/framework/lcm_driven_loop.h"
+#include "systems/framework/lcm_log_replay.h"
+#include "systems/framework/parallel_output_evaluator.h"
+#include "systems/framework/shared_memory_transport.h"
 #include "systems/robot_lcm_systems.h"
 
 #include "drake/systems/framework/diagram_builder.h"
@@ -21,28 +24,12 @@
 
 namespace dairlib {
 
-using std::cout;
-using std::endl;
-using std::vector;
-
-using Eigen::Matrix3d;
-using Eigen::MatrixXd;
-using Eigen::Vector3d;
-using Eigen::VectorXd;
-
-using drake::multibody::Frame;
 using drake::systems::DiagramBuilder;
 using drake::systems::TriggerType;
 using drake::systems::lcm::LcmPublisherSystem;
 using drake::systems::lcm::LcmSubscriberSystem;
 using drake::systems::lcm::TriggerTypeSet;
 
-using multibody::GetBodyIndexFromName;
-using systems::controllers::ComTrackingData;
-using systems::controllers::JointSpaceTrackingData;
-using systems::controllers::RotTaskSpaceTrackingData;
-using systems::controllers::TransTaskSpaceTrackingData;
-
 DEFINE_double(drift_rate, 0.0, "Drift rate for floating-base state");
 
 DEFINE_string(channel_x, "CASSIE_STATE_SIMULATION",
@@ -54,10 +41,75 @@ DEFINE_string(channel_u, "CASSIE_INPUT",
 
 DEFINE_bool(publish_osc_data, true,
             "whether to publish lcm messages for OscTrackData");
+DEFINE_bool(compact_osc_debug, false,
+            "true: record the OscTrackData with OscDebugRecorder on "
+            "OSC_DEBUG_SCHEMA/OSC_DEBUG_BATCH (decode with pydairlib.osc_debug)"
+            "false: publish lcmt_osc_output on OSC_DEBUG at every update");
+DEFINE_int32(osc_debug_decimation, 1,
+             "Records every n-th update in the compact OSC debug stream");
+DEFINE_string(osc_debug_decimations, "",
+              "Per tracking data decimations of the compact OSC debug stream, "
+              "e.g. \"cp_traj:1,pelvis_heading_traj:10\"");
+DEFINE_double(osc_debug_resolution, 1e-6,
+              "Quantization step of the compact OSC debug stream");
 DEFINE_bool(print_osc, false, "whether to print the osc debug message or not");
 DEFINE_bool(is_two_phase, false,
             "true: only right/left single support"
             "false: both double and single support");
+DEFINE_bool(use_lipm_mpc, false,
+            "true: plan the CoM and footsteps with LipmMpc over several steps"
+            "false: LIPMTrajGenerator and CPTrajGenerator (one step)");
+DEFINE_int32(num_mpc_steps, 3, "Number of footsteps planned by LipmMpc");
+DEFINE_int32(num_worker_threads, -1,
+             "Number of worker threads evaluating the trajectory generators "
+             "concurrently before the OSC. 0 evaluates them one after the "
+             "other on the control thread (the baseline of the trace), and -1 "
+             "leaves them to the OSC");
+DEFINE_string(worker_cpus, "",
+              "Cpus the worker threads are pinned to, e.g. \"2,3\" or "
+              "\"2-3\". They run at the priority of the main loop");
+DEFINE_string(worker_trace, "",
+              "File of the Chrome trace of the controller updates, written "
+              "after --worker_trace_ticks updates");
+DEFINE_int32(worker_trace_ticks, 2000, "Number of traced controller updates");
+DEFINE_bool(shared_memory, false,
+            "Receive channel_x and send channel_u over shared memory, with a "
+            "dispatcher on the same host. channel_u is mirrored on LCM for "
+            "logging");
+DEFINE_double(shared_memory_mirror_period, 0,
+              "Minimum period (s) of the LCM mirror of channel_u");
+DEFINE_bool(shared_memory_spin, false,
+            "Busy wait for channel_x instead of sleeping (for an isolated "
+            "cpu)");
+DEFINE_int32(rt_priority, 0,
+             "SCHED_FIFO priority (1-99) of the main loop. 0 keeps the default "
+             "scheduling");
+DEFINE_string(rt_cpus, "",
+              "Cpus the main loop is pinned to, e.g. \"2,3\" or \"2-3\"");
+DEFINE_bool(rt_lock_memory, false,
+            "Lock the memory of the process in RAM and prefault the heap");
+DEFINE_double(rt_report_period, 0,
+              "Period (s) of the report of the real-time settings and page "
+              "faults. 0 for no report");
+
+DEFINE_string(replay_log, "",
+              "Instead of listening on channel_x, run the controller on the "
+              "channel_x messages of this LCM log as fast as possible, and "
+              "record channel_u and OSC_DEBUG (see LcmLogReplay)");
+DEFINE_string(replay_output_log, "",
+              "LCM log the messages recorded in the replay are written to");
+DEFINE_string(replay_golden_log, "",
+              "LCM log (e.g. the replay_output_log of an earlier run) the "
+              "messages recorded in the replay are compared with");
+DEFINE_string(replay_tick_times, "",
+              "File the compute time of every tick of the replay is written "
+              "to");
+DEFINE_string(replay_baseline_tick_times, "",
+              "replay_tick_times of an earlier run on the same machine, the "
+              "compute times of the replay are compared with");
+DEFINE_double(replay_max_slowdown, 1.2,
+              "Ratio of the median or p99 compute time over the baseline "
+              "above which the replay fails");
 
 // Currently the controller runs at the rate between 500 Hz and 200 Hz, so the
 // publish rate of the robot state needs to be less than 500 Hz. Otherwise, the
@@ -84,330 +136,163 @@ int DoMain(int argc, char* argv[]) {
   // Build the controller diagram
   DiagramBuilder<double> builder;
 
-  drake::lcm::DrakeLcm lcm_local("udpm://239.255.76.67:7667?ttl=0");
-
-  // Get contact frames and position (doesn't matter whether we use
-  // plant_w_springs or plant_wo_springs because the contact frames exit in both
-  // plants)
-  auto left_toe = LeftToeFront(plant_wo_springs);
-  auto left_heel = LeftToeRear(plant_wo_springs);
-  auto right_toe = RightToeFront(plant_wo_springs);
-  auto right_heel = RightToeRear(plant_wo_springs);
-
-  // Get body frames and points
-  Vector3d mid_contact_point = (left_toe.first + left_heel.first) / 2;
-  auto left_toe_mid = std::pair<const Vector3d, const Frame<double>&>(
-      mid_contact_point, plant_w_springs.GetFrameByName("toe_left"));
-  auto right_toe_mid = std::pair<const Vector3d, const Frame<double>&>(
-      mid_contact_point, plant_w_springs.GetFrameByName("toe_right"));
-  auto left_toe_origin = std::pair<const Vector3d, const Frame<double>&>(
-      Vector3d::Zero(), plant_w_springs.GetFrameByName("toe_left"));
-  auto right_toe_origin = std::pair<const Vector3d, const Frame<double>&>(
-      Vector3d::Zero(), plant_w_springs.GetFrameByName("toe_right"));
+  // A replay stays in the process
+  const bool is_replay = !FLAGS_replay_log.empty();
+  DRAKE_DEMAND(!(is_replay && FLAGS_shared_memory));
+  const std::string lcm_url =
+      is_replay ? "memq://" : "udpm://239.255.76.67:7667?ttl=0";
+  drake::lcm::DrakeLcm lcm_local(lcm_url);
+  // OscDebugRecorder publishes from its own thread, and DrakeLcm isn't
+  // thread-safe, so it doesn't share lcm_local with the loop. Outlives the
+  // loop, which owns the recorder.
+  drake::lcm::DrakeLcm lcm_osc_debug(lcm_url);
 
   // Create state receiver.
   auto state_receiver =
       builder.AddSystem<systems::RobotOutputReceiver>(plant_w_springs);
 
   // Create command sender.
-  auto command_pub =
-      builder.AddSystem(LcmPublisherSystem::Make<dairlib::lcmt_robot_input>(
-          FLAGS_channel_u, &lcm_local, TriggerTypeSet({TriggerType::kForced})));
+  drake::systems::LeafSystem<double>* command_pub;
+  if (FLAGS_shared_memory) {
+    command_pub = builder.AddSystem(
+        std::make_unique<
+            systems::SharedMemoryPublisherSystem<dairlib::lcmt_robot_input>>(
+            FLAGS_channel_u, &lcm_local, FLAGS_shared_memory_mirror_period));
+  } else {
+    command_pub = builder.AddSystem(
+        LcmPublisherSystem::Make<dairlib::lcmt_robot_input>(
+            FLAGS_channel_u, &lcm_local,
+            TriggerTypeSet({TriggerType::kForced})));
+  }
   auto command_sender =
       builder.AddSystem<systems::RobotCommandSender>(plant_w_springs);
 
   builder.Connect(command_sender->get_output_port(0),
-                  command_pub->get_input_port());
-
-  // Add emulator for floating base drift
-  Eigen::VectorXd drift_mean =
-      Eigen::VectorXd::Zero(plant_w_springs.num_positions());
-  Eigen::MatrixXd drift_cov = Eigen::MatrixXd::Zero(
-      plant_w_springs.num_positions(), plant_w_springs.num_positions());
-  drift_cov(4, 4) = FLAGS_drift_rate;  // x
-  drift_cov(5, 5) = FLAGS_drift_rate;  // y
-  drift_cov(6, 6) = FLAGS_drift_rate;  // z
-  // Note that we didn't add drift to yaw angle here because it requires
-  // changing SimulatorDrift.
-
-  auto simulator_drift =
-      builder.AddSystem<SimulatorDrift>(plant_w_springs, drift_mean, drift_cov);
-  builder.Connect(state_receiver->get_output_port(0),
-                  simulator_drift->get_input_port_state());
-
-  // Create human high-level control
-  Eigen::Vector2d global_target_position(1, 0);
-  Eigen::Vector2d params_of_no_turning(5, 1);
-  // Logistic function 1/(1+5*exp(x-1))
-  // The function ouputs 0.0007 when x = 0
-  //                     0.5    when x = 1
-  //                     0.9993 when x = 2
-  auto high_level_command = builder.AddSystem<cassie::osc::HighLevelCommand>(
-      plant_w_springs, global_target_position, params_of_no_turning);
+                  command_pub->get_input_port(0));
+
+  // Create the walking controller (generators, finite state machine and OSC)
+  cassie::osc::OSCWalkingControllerOptions options;
+  options.is_two_phase = FLAGS_is_two_phase;
+  options.use_lipm_mpc = FLAGS_use_lipm_mpc;
+  options.num_mpc_steps = FLAGS_num_mpc_steps;
+  options.drift_rate = FLAGS_drift_rate;
+  options.print_osc = FLAGS_print_osc;
+  auto controller = builder.AddSystem<cassie::osc::OSCWalkingControllerDiagram>(
+      plant_w_springs, plant_wo_springs, options);
   builder.Connect(state_receiver->get_output_port(0),
-                  high_level_command->get_state_input_port());
-
-  // Create heading traj generator
-  auto head_traj_gen =
-      builder.AddSystem<cassie::osc::HeadingTrajGenerator>(plant_w_springs);
-  builder.Connect(simulator_drift->get_output_port(0),
-                  head_traj_gen->get_state_input_port());
-  builder.Connect(high_level_command->get_yaw_output_port(),
-                  head_traj_gen->get_yaw_input_port());
-
-  // Create finite state machine
-  int left_stance_state = 0;
-  int right_stance_state = 1;
-  int double_support_state = 2;
-  double left_support_duration = 0.35;
-  double right_support_duration = 0.35;
-  double double_support_duration = 0.02;
-  vector<int> fsm_states;
-  vector<double> state_durations;
-  if (FLAGS_is_two_phase) {
-    fsm_states = {left_stance_state, right_stance_state};
-    state_durations = {left_support_duration, right_support_duration};
-  } else {
-    fsm_states = {left_stance_state, double_support_state, right_stance_state,
-                  double_support_state};
-    state_durations = {left_support_duration, double_support_duration,
-                       right_support_duration, double_support_duration};
-  }
-  auto fsm = builder.AddSystem<systems::TimeBasedFiniteStateMachine>(
-      plant_w_springs, fsm_states, state_durations);
-  builder.Connect(simulator_drift->get_output_port(0),
-                  fsm->get_input_port_state());
-
-  // Create CoM trajectory generator
-  double desired_com_height = 0.89;
-  vector<int> unordered_fsm_states;
-  vector<double> unordered_state_durations;
-  vector<vector<std::pair<const Vector3d, const Frame<double>&>>>
-      contact_points_in_each_state;
-  if (FLAGS_is_two_phase) {
-    unordered_fsm_states = {left_stance_state, right_stance_state};
-    unordered_state_durations = {left_support_duration, right_support_duration};
-    contact_points_in_each_state.push_back({left_toe_mid});
-    contact_points_in_each_state.push_back({right_toe_mid});
-  } else {
-    unordered_fsm_states = {left_stance_state, right_stance_state,
-                            double_support_state};
-    unordered_state_durations = {left_support_duration, right_support_duration,
-                                 double_support_duration};
-    contact_points_in_each_state.push_back({left_toe_mid});
-    contact_points_in_each_state.push_back({right_toe_mid});
-    contact_points_in_each_state.push_back({left_toe_mid, right_toe_mid});
-  }
-  auto lipm_traj_generator = builder.AddSystem<systems::LIPMTrajGenerator>(
-      plant_w_springs, desired_com_height, unordered_fsm_states,
-      unordered_state_durations, contact_points_in_each_state);
-  builder.Connect(fsm->get_output_port(0),
-                  lipm_traj_generator->get_input_port_fsm());
-  builder.Connect(simulator_drift->get_output_port(0),
-                  lipm_traj_generator->get_input_port_state());
-
-  // Create velocity control by foot placement
-  auto deviation_from_cp =
-      builder.AddSystem<cassie::osc::DeviationFromCapturePoint>(
-          plant_w_springs);
-  builder.Connect(high_level_command->get_xy_output_port(),
-                  deviation_from_cp->get_input_port_des_hor_vel());
-  builder.Connect(simulator_drift->get_output_port(0),
-                  deviation_from_cp->get_input_port_state());
-
-  // Create swing leg trajectory generator (capture point)
-  double mid_foot_height = 0.1;
-  // Since the ground is soft in the simulation, we raise the desired final
-  // foot height by 1 cm. The controller is sensitive to this number, should
-  // tune this every time we change the simulation parameter or when we move
-  // to the hardware testing.
-  // Additionally, implementing a double support phase might mitigate the
-  // instability around state transition.
-  double desired_final_foot_height = 0.01;
-  double desired_final_vertical_foot_velocity = 0;  //-1;
-  double max_CoM_to_CP_dist = 0.4;
-  double cp_offset = 0.06;
-  double center_line_offset = 0.06;
-  vector<int> left_right_support_fsm_states = {left_stance_state,
-                                               right_stance_state};
-  vector<double> left_right_support_state_durations = {left_support_duration,
-                                                       right_support_duration};
-  vector<std::pair<const Vector3d, const Frame<double>&>> left_right_foot = {
-      left_toe_origin, right_toe_origin};
-  auto cp_traj_generator = builder.AddSystem<systems::CPTrajGenerator>(
-      plant_w_springs, left_right_support_fsm_states,
-      left_right_support_state_durations, left_right_foot, "pelvis", mid_foot_height,
-      desired_final_foot_height, desired_final_vertical_foot_velocity,
-      max_CoM_to_CP_dist, true, true, true, cp_offset, center_line_offset);
-  builder.Connect(fsm->get_output_port(0),
-                  cp_traj_generator->get_input_port_fsm());
-  builder.Connect(simulator_drift->get_output_port(0),
-                  cp_traj_generator->get_input_port_state());
-  builder.Connect(lipm_traj_generator->get_output_port(0),
-                  cp_traj_generator->get_input_port_com());
-  builder.Connect(deviation_from_cp->get_output_port(0),
-                  cp_traj_generator->get_input_port_fp());
-
-  // Create Operational space control
-  auto osc = builder.AddSystem<systems::controllers::OperationalSpaceControl>(
-      plant_w_springs, plant_wo_springs, true,
-      FLAGS_print_osc /*print_tracking_info*/);
-
-  // Cost
-  int n_v = plant_wo_springs.num_velocities();
-  MatrixXd Q_accel = 2 * MatrixXd::Identity(n_v, n_v);
-  osc->SetAccelerationCostForAllJoints(Q_accel);
-
-  // Distance constraint
-  multibody::KinematicEvaluatorSet<double> evaluators(plant_wo_springs);
-  auto left_loop = LeftLoopClosureEvaluator(plant_wo_springs);
-  auto right_loop = RightLoopClosureEvaluator(plant_wo_springs);
-  evaluators.add_evaluator(&left_loop);
-  evaluators.add_evaluator(&right_loop);
-  osc->AddKinematicConstraint(&evaluators);
-
-  // Soft constraint
-  // w_contact_relax shouldn't be too big, cause we want tracking error to be
-  // important
-  double w_contact_relax = 2000;
-  osc->SetWeightOfSoftContactConstraint(w_contact_relax);
-  // Friction coefficient
-  double mu = 0.4;
-  osc->SetContactFriction(mu);
-  // Add contact points (The position doesn't matter. It's not used in OSC)
-  auto left_toe_evaluator = multibody::WorldPointEvaluator(
-      plant_wo_springs, left_toe.first, left_toe.second, Matrix3d::Identity(),
-      Vector3d::Zero(), {1, 2});
-  auto left_heel_evaluator = multibody::WorldPointEvaluator(
-      plant_wo_springs, left_heel.first, left_heel.second, Matrix3d::Identity(),
-      Vector3d::Zero(), {0, 1, 2});
-  auto right_toe_evaluator = multibody::WorldPointEvaluator(
-      plant_wo_springs, right_toe.first, right_toe.second, Matrix3d::Identity(),
-      Vector3d::Zero(), {1, 2});
-  auto right_heel_evaluator = multibody::WorldPointEvaluator(
-      plant_wo_springs, right_heel.first, right_heel.second,
-      Matrix3d::Identity(), Vector3d::Zero(), {0, 1, 2});
-  osc->AddStateAndContactPoint(left_stance_state, &left_toe_evaluator);
-  osc->AddStateAndContactPoint(left_stance_state, &left_heel_evaluator);
-  osc->AddStateAndContactPoint(right_stance_state, &right_toe_evaluator);
-  osc->AddStateAndContactPoint(right_stance_state, &right_heel_evaluator);
-  if (!FLAGS_is_two_phase) {
-    osc->AddStateAndContactPoint(double_support_state, &left_toe_evaluator);
-    osc->AddStateAndContactPoint(double_support_state, &left_heel_evaluator);
-    osc->AddStateAndContactPoint(double_support_state, &right_toe_evaluator);
-    osc->AddStateAndContactPoint(double_support_state, &right_heel_evaluator);
-  }
-
-  // Swing foot tracking
-  MatrixXd W_swing_foot = 400 * MatrixXd::Identity(3, 3);
-  MatrixXd K_p_sw_ft = 100 * MatrixXd::Identity(3, 3);
-  MatrixXd K_d_sw_ft = 10 * MatrixXd::Identity(3, 3);
-  TransTaskSpaceTrackingData swing_foot_traj("cp_traj", 3, K_p_sw_ft, K_d_sw_ft,
-                                             W_swing_foot, &plant_w_springs,
-                                             &plant_wo_springs);
-  swing_foot_traj.AddStateAndPointToTrack(left_stance_state, "toe_right");
-  swing_foot_traj.AddStateAndPointToTrack(right_stance_state, "toe_left");
-  osc->AddTrackingData(&swing_foot_traj);
-  // Center of mass tracking
-  MatrixXd W_com = MatrixXd::Identity(3, 3);
-  W_com(0, 0) = 2;
-  W_com(1, 1) = 2;
-  W_com(2, 2) = 2000;
-  MatrixXd K_p_com = 50 * MatrixXd::Identity(3, 3);
-  MatrixXd K_d_com = 10 * MatrixXd::Identity(3, 3);
-  ComTrackingData center_of_mass_traj("lipm_traj", 3, K_p_com, K_d_com, W_com,
-                                      &plant_w_springs, &plant_wo_springs);
-  osc->AddTrackingData(&center_of_mass_traj);
-  // Pelvis rotation tracking (pitch and roll)
-  double w_pelvis_balance = 200;
-  double k_p_pelvis_balance = 200;
-  double k_d_pelvis_balance = 80;
-  Matrix3d W_pelvis_balance = MatrixXd::Zero(3, 3);
-  W_pelvis_balance(0, 0) = w_pelvis_balance;
-  W_pelvis_balance(1, 1) = w_pelvis_balance;
-  Matrix3d K_p_pelvis_balance = MatrixXd::Zero(3, 3);
-  K_p_pelvis_balance(0, 0) = k_p_pelvis_balance;
-  K_p_pelvis_balance(1, 1) = k_p_pelvis_balance;
-  Matrix3d K_d_pelvis_balance = MatrixXd::Zero(3, 3);
-  K_d_pelvis_balance(0, 0) = k_d_pelvis_balance;
-  K_d_pelvis_balance(1, 1) = k_d_pelvis_balance;
-  RotTaskSpaceTrackingData pelvis_balance_traj(
-      "pelvis_balance_traj", 3, K_p_pelvis_balance, K_d_pelvis_balance,
-      W_pelvis_balance, &plant_w_springs, &plant_wo_springs);
-  pelvis_balance_traj.AddFrameToTrack("pelvis");
-  osc->AddTrackingData(&pelvis_balance_traj);
-  // Pelvis rotation tracking (yaw)
-  double w_heading = 200;
-  double k_p_heading = 50;
-  double k_d_heading = 40;
-  Matrix3d W_pelvis_heading = MatrixXd::Zero(3, 3);
-  W_pelvis_heading(2, 2) = w_heading;
-  Matrix3d K_p_pelvis_heading = MatrixXd::Zero(3, 3);
-  K_p_pelvis_heading(2, 2) = k_p_heading;
-  Matrix3d K_d_pelvis_heading = MatrixXd::Zero(3, 3);
-  K_d_pelvis_heading(2, 2) = k_d_heading;
-  RotTaskSpaceTrackingData pelvis_heading_traj(
-      "pelvis_heading_traj", 3, K_p_pelvis_heading, K_d_pelvis_heading,
-      W_pelvis_heading, &plant_w_springs, &plant_wo_springs);
-  pelvis_heading_traj.AddFrameToTrack("pelvis");
-  osc->AddTrackingData(&pelvis_heading_traj, 0.1);  // 0.05
-  // Swing toe joint tracking (Currently use fix position)
-  // The desired position, -1.5, was derived heuristically. It is roughly the
-  // toe angle when Cassie stands on the ground.
-  MatrixXd W_swing_toe = 200 * MatrixXd::Identity(1, 1);
-  MatrixXd K_p_swing_toe = 200 * MatrixXd::Identity(1, 1);
-  MatrixXd K_d_swing_toe = 20 * MatrixXd::Identity(1, 1);
-  JointSpaceTrackingData swing_toe_traj("swing_toe_traj", K_p_swing_toe,
-                                        K_d_swing_toe, W_swing_toe,
-                                        &plant_w_springs, &plant_wo_springs);
-  swing_toe_traj.AddStateAndJointToTrack(left_stance_state, "toe_right",
-                                         "toe_rightdot");
-  swing_toe_traj.AddStateAndJointToTrack(right_stance_state, "toe_left",
-                                         "toe_leftdot");
-  osc->AddConstTrackingData(&swing_toe_traj, -1.5 * VectorXd::Ones(1), 0, 0.3);
-  // Swing hip yaw joint tracking
-  MatrixXd W_hip_yaw = 20 * MatrixXd::Identity(1, 1);
-  MatrixXd K_p_hip_yaw = 200 * MatrixXd::Identity(1, 1);
-  MatrixXd K_d_hip_yaw = 160 * MatrixXd::Identity(1, 1);
-  JointSpaceTrackingData swing_hip_yaw_traj(
-      "swing_hip_yaw_traj", K_p_hip_yaw, K_d_hip_yaw, W_hip_yaw,
-      &plant_w_springs, &plant_wo_springs);
-  swing_hip_yaw_traj.AddStateAndJointToTrack(left_stance_state, "hip_yaw_right",
-                                             "hip_yaw_rightdot");
-  swing_hip_yaw_traj.AddStateAndJointToTrack(right_stance_state, "hip_yaw_left",
-                                             "hip_yaw_leftdot");
-  osc->AddConstTrackingData(&swing_hip_yaw_traj, VectorXd::Zero(1));
-  // Build OSC problem
-  osc->Build();
-  // Connect ports
-  builder.Connect(simulator_drift->get_output_port(0),
-                  osc->get_robot_output_input_port());
-  builder.Connect(fsm->get_output_port(0), osc->get_fsm_input_port());
-  builder.Connect(lipm_traj_generator->get_output_port(0),
-                  osc->get_tracking_data_input_port("lipm_traj"));
-  builder.Connect(cp_traj_generator->get_output_port(0),
-                  osc->get_tracking_data_input_port("cp_traj"));
-  builder.Connect(head_traj_gen->get_output_port(0),
-                  osc->get_tracking_data_input_port("pelvis_balance_traj"));
-  builder.Connect(head_traj_gen->get_output_port(0),
-                  osc->get_tracking_data_input_port("pelvis_heading_traj"));
-  builder.Connect(osc->get_output_port(0), command_sender->get_input_port(0));
-  if (FLAGS_publish_osc_data) {
+                  controller->get_state_input_port());
+  builder.Connect(controller->get_control_output_port(),
+                  command_sender->get_input_port(0));
+  if (FLAGS_publish_osc_data && FLAGS_compact_osc_debug) {
+    // Create compact osc debug recorder.
+    auto streams = systems::controllers::MakeOscDebugStreams(
+        controller->get_tracking_data(), FLAGS_osc_debug_decimation);
+    std::stringstream decimations(FLAGS_osc_debug_decimations);
+    std::string entry;
+    while (std::getline(decimations, entry, ',')) {
+      const auto colon = entry.find(':');
+      DRAKE_DEMAND(colon != std::string::npos);
+      const std::string name = entry.substr(0, colon);
+      bool found = false;
+      for (auto& stream : streams) {
+        if (stream.name == name) {
+          stream.decimation = std::stoi(entry.substr(colon + 1));
+          found = true;
+        }
+      }
+      if (!found) {
+        throw std::runtime_error("Unknown tracking data: " + name);
+      }
+    }
+    auto osc_debug_recorder =
+        builder.AddSystem<systems::controllers::OscDebugRecorder>(
+            controller->get_tracking_data(), streams,
+            plant_w_springs.num_actuators(), &lcm_osc_debug, "OSC_DEBUG",
+            FLAGS_osc_debug_resolution);
+    builder.Connect(controller->get_fsm_output_port(),
+                    osc_debug_recorder->get_fsm_input_port());
+    builder.Connect(controller->get_control_output_port(),
+                    osc_debug_recorder->get_osc_output_input_port());
+  } else if (FLAGS_publish_osc_data) {
     // Create osc debug sender.
     auto osc_debug_pub =
         builder.AddSystem(LcmPublisherSystem::Make<dairlib::lcmt_osc_output>(
             "OSC_DEBUG", &lcm_local, TriggerTypeSet({TriggerType::kForced})));
-    builder.Connect(osc->get_osc_debug_port(), osc_debug_pub->get_input_port());
+    builder.Connect(controller->get_osc_debug_output_port(),
+                    osc_debug_pub->get_input_port());
   }
 
   // Create the diagram
   auto owned_diagram = builder.Build();
   owned_diagram->set_name("osc walking controller");
 
+  // Real-time settings of the main loop, applied before the worker threads
+  // of the evaluator are created so that they inherit the scheduling policy
+  // and don't hold up the loop at a lower priority
+  RealtimeOptions realtime_options;
+  realtime_options.priority = FLAGS_rt_priority;
+  realtime_options.cpus = ParseCpuList(FLAGS_rt_cpus);
+  realtime_options.lock_memory = FLAGS_rt_lock_memory;
+  SetupRealtimeThread("osc walking controller", realtime_options);
+
+  // Evaluate the independent generators concurrently
+  std::unique_ptr<systems::ParallelOutputEvaluator> evaluator;
+  if (FLAGS_num_worker_threads >= 0) {
+    evaluator = std::make_unique<systems::ParallelOutputEvaluator>(
+        FLAGS_num_worker_threads, ParseCpuList(FLAGS_worker_cpus));
+    // The first stage of the controller reads the state from two threads, so
+    // the cache entry of the receiver is filled before
+    evaluator->AddStage({&state_receiver->get_output_port(0)});
+    for (const auto& stage : controller->get_concurrent_stages()) {
+      evaluator->AddStage(stage);
+    }
+    if (!FLAGS_worker_trace.empty()) {
+      evaluator->StartTrace(FLAGS_worker_trace_ticks, FLAGS_worker_trace);
+    }
+  }
+
   // Run lcm-driven simulation
   systems::LcmDrivenLoop<dairlib::lcmt_robot_output> loop(
       &lcm_local, std::move(owned_diagram), state_receiver, FLAGS_channel_x,
       true);
+  loop.SetOutputEvaluator(evaluator.get());
+  std::unique_ptr<systems::SharedMemorySubscriber<dairlib::lcmt_robot_output>>
+      state_sub;
+  if (FLAGS_shared_memory) {
+    state_sub = std::make_unique<
+        systems::SharedMemorySubscriber<dairlib::lcmt_robot_output>>(
+        FLAGS_channel_x);
+    loop.SetSharedMemoryInput(FLAGS_channel_x, state_sub.get(),
+                              FLAGS_shared_memory_spin);
+  }
+
+  std::unique_ptr<RealtimeReporter> realtime_reporter;
+  if (FLAGS_rt_report_period > 0) {
+    realtime_reporter =
+        std::make_unique<RealtimeReporter>(FLAGS_rt_report_period);
+  }
+
+  if (is_replay) {
+    systems::LcmLogReplayOptions replay_options;
+    replay_options.input_log = FLAGS_replay_log;
+    replay_options.input_channel = FLAGS_channel_x;
+    replay_options.output_channels = {FLAGS_channel_u};
+    if (FLAGS_publish_osc_data && !FLAGS_compact_osc_debug) {
+      replay_options.output_channels.push_back("OSC_DEBUG");
+    }
+    replay_options.output_log = FLAGS_replay_output_log;
+    replay_options.golden_log = FLAGS_replay_golden_log;
+    replay_options.tick_times = FLAGS_replay_tick_times;
+    replay_options.baseline_tick_times = FLAGS_replay_baseline_tick_times;
+    replay_options.max_slowdown = FLAGS_replay_max_slowdown;
+    systems::LcmLogReplay replay(&lcm_local, replay_options);
+    replay.Replay(systems::MakeTickFunction<dairlib::lcmt_robot_output>(
+        [&loop](const dairlib::lcmt_robot_output& state) {
+          loop.Step(state);
+        }));
+    return replay.Report() ? 0 : 1;
+  }
+
   loop.Simulate();
 
   return 0;
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "examples/Cassie/cassie_fourbar_solver.h"
+#include "examples/Cassie/cassie_state_estimator.h"
+#include "examples/Cassie/cassie_utils.h"
+#include "multibody/multibody_utils.h"
+
+DEFINE_int32(num_reps, 100000, "Number of solves");
+
+using Eigen::Vector2d;
+using Eigen::VectorXd;
+
+namespace dairlib {
+namespace {
+
+typedef std::chrono::steady_clock my_clock;
+
+// Times CassieStateEstimator::solveFourbarLinkage and CassieFourbarSolver on
+// the same configurations, one solve per estimator update.
+int do_main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  drake::multibody::MultibodyPlant<double> plant(1e-3);
+  addCassieMultibody(&plant, nullptr, true /*floating base*/,
+                     "examples/Cassie/urdf/cassie_v2.urdf",
+                     true /*spring model*/, false /*loop closure*/);
+  plant.Finalize();
+
+  // solveFourbarLinkage() doesn't use the evaluators
+  multibody::KinematicEvaluatorSet<double> fourbar_evaluator(plant);
+  multibody::KinematicEvaluatorSet<double> left_contact_evaluator(plant);
+  multibody::KinematicEvaluatorSet<double> right_contact_evaluator(plant);
+  systems::CassieStateEstimator estimator(plant, &fourbar_evaluator,
+                                          &left_contact_evaluator,
+                                          &right_contact_evaluator);
+  systems::CassieFourbarSolver solver(plant);
+
+  // Random leg configurations within the joint limits
+  std::map<std::string, int> pos_map = multibody::makeNameToPositionsMap(plant);
+  VectorXd q_nominal = VectorXd::Zero(plant.num_positions());
+  q_nominal(0) = 1;
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> uniform(-1, 1);
+  std::vector<VectorXd> qs;
+  for (int i = 0; i < 1000; i++) {
+    VectorXd q = q_nominal;
+    for (const std::string& leg : {"_left", "_right"}) {
+      const double knee = -1.754 + 1.108 * uniform(generator);
+      q(pos_map.at("knee" + leg)) = knee;
+      q(pos_map.at("knee_joint" + leg)) = -0.0125 + 0.0875 * uniform(generator);
+      q(pos_map.at("ankle_joint" + leg)) =
+          std::clamp(-knee + 0.2 + 0.1 * uniform(generator), 0.8, 3.0);
+    }
+    qs.push_back(q);
+  }
+
+  double left_heel_spring, right_heel_spring;
+  double max_difference = 0;
+  auto start = my_clock::now();
+  for (int i = 0; i < FLAGS_num_reps; i++) {
+    estimator.solveFourbarLinkage(qs[i % qs.size()], &left_heel_spring,
+                                  &right_heel_spring);
+  }
+  std::chrono::duration<double, std::micro> plant_duration =
+      my_clock::now() - start;
+
+  Vector2d heel_springs;
+  start = my_clock::now();
+  for (int i = 0; i < FLAGS_num_reps; i++) {
+    heel_springs = solver.Solve(qs[i % qs.size()]);
+  }
+  std::chrono::duration<double, std::micro> solver_duration =
+      my_clock::now() - start;
+
+  for (const VectorXd& q : qs) {
+    estimator.solveFourbarLinkage(q, &left_heel_spring, &right_heel_spring);
+    heel_springs = solver.Solve(q);
+    max_difference =
+        std::max({max_difference, std::abs(heel_springs(0) - left_heel_spring),
+                  std::abs(heel_springs(1) - right_heel_spring)});
+  }
+
+  std::cout << std::to_string(FLAGS_num_reps)
+            << "x solveFourbarLinkage took " << plant_duration.count() / 1000
+            << " miliseconds. " << plant_duration.count() / FLAGS_num_reps
+            << " microseconds per." << std::endl;
+  std::cout << std::to_string(FLAGS_num_reps)
+            << "x CassieFourbarSolver::Solve took "
+            << solver_duration.count() / 1000 << " miliseconds. "
+            << solver_duration.count() / FLAGS_num_reps
+            << " microseconds per." << std::endl;
+  std::cout << "max difference: " << max_difference << std::endl;
+
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::do_main(argc, argv); }
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "systems/controllers/lipm_mpc.h"
+
+DEFINE_int32(num_reps, 10000, "Number of solves");
+DEFINE_int32(num_steps, 3, "Number of footsteps in the horizon");
+DEFINE_double(max_step_deviation, 0.1, "Bound on the step deviation");
+
+using Eigen::MatrixXd;
+using Eigen::Vector2d;
+using Eigen::Vector4d;
+
+namespace dairlib {
+namespace {
+
+typedef std::chrono::steady_clock my_clock;
+
+// Times LipmFootstepQp::Solve in closed loop with the LIPM, stepping onto the
+// first planned footstep after every solve, as LipmMpc does at touchdown.
+int do_main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  const std::vector<double> durations = {0.35, 0.35};
+  systems::LipmFootstepQp qp(0.89, durations, FLAGS_num_steps, 0.2,
+                             FLAGS_max_step_deviation);
+
+  Vector2d s_x(0, 0);
+  Vector2d s_y(0, 0);
+  Vector2d stance_foot(0, -0.1);
+  Vector2d des_vel(0.5, 0);
+  bool first_step_is_left = true;
+  double max_solve_time = 0;
+
+  auto start = my_clock::now();
+  for (int i = 0; i < FLAGS_num_reps; i++) {
+    // Change the command now and then so the warm start is not always exact
+    if (i % 100 == 0) {
+      des_vel(0) = (i % 200 == 0) ? 0.5 : 0.8;
+    }
+    const double T = qp.step_duration(1, first_step_is_left);
+    s_x = qp.Propagate(s_x, stance_foot(0), T);
+    s_y = qp.Propagate(s_y, stance_foot(1), T);
+    const Vector4d com_state(s_x(0), s_y(0), s_x(1), s_y(1));
+
+    auto solve_start = my_clock::now();
+    const MatrixXd footsteps =
+        qp.Solve(com_state, stance_foot, des_vel, 0, first_step_is_left);
+    std::chrono::duration<double, std::micro> solve_time =
+        my_clock::now() - solve_start;
+    max_solve_time = std::max(max_solve_time, solve_time.count());
+
+    stance_foot = footsteps.col(0);
+    first_step_is_left = !first_step_is_left;
+  }
+  auto stop = my_clock::now();
+  std::chrono::duration<double, std::micro> duration = stop - start;
+
+  std::cout << std::to_string(FLAGS_num_reps) << "x LIPM MPC solves ("
+            << FLAGS_num_steps << " steps) took " << duration.count() / 1000
+            << " miliseconds. " << duration.count() / FLAGS_num_reps
+            << " microseconds per, " << max_solve_time << " at most."
+            << std::endl;
+  std::cout << "final CoM velocity: " << s_x(1) << ", " << s_y(1)
+            << std::endl;
+
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::do_main(argc, argv); }
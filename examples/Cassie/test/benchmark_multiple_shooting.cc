@@ -0,0 +1,222 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "common/find_resource.h"
+#include "multibody/multibody_utils.h"
+#include "solvers/optimization_utils.h"
+#include "systems/trajectory_optimization/dircon_distance_data.h"
+#include "systems/trajectory_optimization/dircon_kinematic_data_set.h"
+#include "systems/trajectory_optimization/dircon_position_data.h"
+#include "systems/trajectory_optimization/hybrid_dircon.h"
+#include "systems/trajectory_optimization/hybrid_multiple_shooting.h"
+#include "drake/math/autodiff.h"
+#include "drake/multibody/parsing/parser.h"
+#include "drake/solvers/snopt_solver.h"
+#include "drake/solvers/solve.h"
+
+DEFINE_int32(n_node, 16, "Number of knot points of HybridDircon");
+DEFINE_int32(num_segments, 4,
+             "Number of segments of HybridMultipleShooting");
+DEFINE_int32(num_substeps, 4, "RK4 steps per segment");
+DEFINE_int32(num_threads, std::thread::hardware_concurrency(),
+             "Threads integrating the segments");
+DEFINE_int32(num_evals, 20,
+             "Number of evaluations of the constraints and their gradients");
+DEFINE_double(duration, 0.4, "Duration of the single support phase (s)");
+DEFINE_double(stride_length, 0.2, "Stride length of the walking");
+DEFINE_bool(solve, false, "Also solve both programs with SNOPT");
+DEFINE_int32(max_iter, 10000, "SNOPT iteration limit with --solve");
+
+using drake::AutoDiffVecXd;
+using drake::multibody::MultibodyPlant;
+using drake::solvers::MathematicalProgram;
+using drake::systems::trajectory_optimization::MultipleShooting;
+using drake::trajectories::PiecewisePolynomial;
+using Eigen::MatrixXd;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+using std::map;
+using std::string;
+using std::vector;
+
+namespace dairlib {
+namespace {
+
+using systems::trajectory_optimization::DirconOptions;
+using systems::trajectory_optimization::HybridDircon;
+using systems::trajectory_optimization::HybridMultipleShooting;
+
+typedef std::chrono::steady_clock my_clock;
+
+// Constraints, costs and initial guess shared by both transcriptions: one left
+// stance phase of the fixed-spring walking of run_dircon_walking.cc
+void SetUpWalking(const MultibodyPlant<double>& plant,
+                  MultipleShooting* trajopt) {
+  const int n_q = plant.num_positions();
+  const int n_v = plant.num_velocities();
+  const int n_u = plant.num_actuators();
+  map<string, int> pos_map = multibody::makeNameToPositionsMap(plant);
+  map<string, int> vel_map = multibody::makeNameToVelocitiesMap(plant);
+
+  trajopt->AddDurationBounds(FLAGS_duration, FLAGS_duration);
+  auto x0 = trajopt->initial_state();
+  auto xf = trajopt->final_state();
+  trajopt->AddBoundingBoxConstraint(0, 0, x0(pos_map.at("base_x")));
+  trajopt->AddBoundingBoxConstraint(FLAGS_stride_length, FLAGS_stride_length,
+                                    xf(pos_map.at("base_x")));
+  trajopt->AddBoundingBoxConstraint(1, 1, x0(pos_map.at("base_qw")));
+  for (int i = 0; i < trajopt->N(); i++) {
+    trajopt->AddBoundingBoxConstraint(VectorXd::Constant(n_u, -300),
+                                      VectorXd::Constant(n_u, 300),
+                                      trajopt->input(i));
+  }
+  auto x = trajopt->state();
+  auto u = trajopt->input();
+  trajopt->AddRunningCost(0.05 * x.tail(n_v).transpose() * x.tail(n_v));
+  trajopt->AddRunningCost(0.0001 * u.transpose() * u);
+
+  // Standing pose, moving forward at constant speed, and zero forces
+  trajopt->SetInitialGuessForAllVariables(VectorXd::Zero(trajopt->num_vars()));
+  VectorXd q_nominal(n_q);
+  q_nominal << 1, 0, 0, 0, 0, 0, 1, -0.0112109, 0.00927845, -0.000600725,
+      -0.000895805, 1.15086, 0.610808, -1.38608, -1.35926, 0.806192, 1.00716,
+      -M_PI / 2, -M_PI / 2;
+  vector<double> times;
+  vector<MatrixXd> states, inputs;
+  for (int i = 0; i < trajopt->N(); i++) {
+    const double s = static_cast<double>(i) / (trajopt->N() - 1);
+    VectorXd state = VectorXd::Zero(n_q + n_v);
+    state.head(n_q) = q_nominal;
+    state(pos_map.at("base_x")) = s * FLAGS_stride_length;
+    state(n_q + vel_map.at("base_vx")) = FLAGS_stride_length / FLAGS_duration;
+    times.push_back(s * FLAGS_duration);
+    states.push_back(state);
+    inputs.push_back(VectorXd::Zero(n_u));
+  }
+  trajopt->SetInitialTrajectory(
+      PiecewisePolynomial<double>::FirstOrderHold(times, inputs),
+      PiecewisePolynomial<double>::FirstOrderHold(times, states));
+}
+
+// Mean time to evaluate the nonlinear constraints and their gradients at the
+// initial guess, as the solver does at every major iteration
+double ConstraintEvalTime(const MathematicalProgram& prog) {
+  AutoDiffVecXd y;
+  auto start = my_clock::now();
+  for (int i = 0; i < FLAGS_num_evals; i++) {
+    for (const auto& binding : prog.generic_constraints()) {
+      binding.evaluator()->Eval(
+          drake::math::initializeAutoDiff(
+              prog.GetInitialGuess(binding.variables())),
+          &y);
+    }
+  }
+  std::chrono::duration<double, std::milli> duration = my_clock::now() - start;
+  return duration.count() / FLAGS_num_evals;
+}
+
+void Report(const string& name, const MultipleShooting& trajopt,
+            double construction_time) {
+  std::cout << name << std::endl;
+  std::cout << "  Knot points: " << trajopt.N() << std::endl;
+  std::cout << "  Decision variables: " << trajopt.num_vars() << std::endl;
+  std::cout << "  Constraint rows: " << solvers::CountConstraintRows(trajopt)
+            << std::endl;
+  std::cout << "  Construction time (ms): " << construction_time << std::endl;
+  std::cout << "  Constraint evaluation time (ms): "
+            << ConstraintEvalTime(trajopt) << std::endl;
+  if (!FLAGS_solve) return;
+
+  auto start = my_clock::now();
+  const auto result = drake::solvers::Solve(trajopt, trajopt.initial_guess());
+  std::chrono::duration<double> solve_time = my_clock::now() - start;
+  std::cout << "  Solve time (s): " << solve_time.count() << std::endl;
+  std::cout << "  Solution result: " << result.get_solution_result()
+            << std::endl;
+  std::cout << "  Cost: " << result.get_optimal_cost() << std::endl;
+}
+
+// Compares HybridDircon with HybridMultipleShooting, serial and threaded, on
+// Cassie walking: program size, construction time, the time to evaluate the
+// constraint gradients and optionally the solve.
+int do_main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  MultibodyPlant<double> plant(0.0);
+  drake::multibody::Parser parser(&plant);
+  parser.AddModelFromFile(
+      FindResourceOrThrow("examples/Cassie/urdf/cassie_fixed_springs.urdf"));
+  plant.Finalize();
+
+  // The left stance constraints of run_dircon_walking.cc
+  const auto& toe_left = plant.GetBodyByName("toe_left");
+  DirconPositionData<double> toe_front(plant, toe_left,
+                                       Vector3d(-0.0457, 0.112, 0), false);
+  DirconPositionData<double> toe_rear(plant, toe_left, Vector3d(0.088, 0, 0),
+                                      false);
+  toe_front.addFixedNormalFrictionConstraints(1);
+  toe_rear.addFixedNormalFrictionConstraints(1);
+  const double rod_length = 0.5012;
+  const Vector3d pt_on_heel_spring(.11877, -.01, 0.0);
+  DirconDistanceData<double> fourbar_left(
+      plant, plant.GetBodyByName("thigh_left"), Vector3d(0, 0, 0.045),
+      plant.GetBodyByName("heel_spring_left"), pt_on_heel_spring, rod_length);
+  DirconDistanceData<double> fourbar_right(
+      plant, plant.GetBodyByName("thigh_right"), Vector3d(0, 0, -0.045),
+      plant.GetBodyByName("heel_spring_right"), pt_on_heel_spring, rod_length);
+  vector<DirconKinematicData<double>*> constraints{&toe_front, &toe_rear,
+                                                   &fourbar_left,
+                                                   &fourbar_right};
+  DirconKinematicDataSet<double> dataset(plant, &constraints, {3});
+
+  DirconOptions options(dataset.countConstraints(), plant);
+  options.setForceCost(sqrt(0.1) * 1.0e-4);
+  options.setConstraintRelative(0, true);
+  options.setConstraintRelative(1, true);
+  options.setConstraintRelative(3, true);
+
+  const double min_dt = 0.01;
+  const double max_dt = 0.3;
+  auto start = my_clock::now();
+  HybridDircon<double> dircon(plant, {FLAGS_n_node}, {min_dt}, {max_dt},
+                              {&dataset}, {options});
+  std::chrono::duration<double, std::milli> dircon_time =
+      my_clock::now() - start;
+  SetUpWalking(plant, &dircon);
+  dircon.SetSolverOption(drake::solvers::SnoptSolver::id(),
+                         "Major iterations limit", FLAGS_max_iter);
+  Report("HybridDircon", dircon, dircon_time.count());
+
+  // The segments are longer, with the same duration bounds
+  const double segment_scale = (FLAGS_n_node - 1.0) / FLAGS_num_segments;
+  for (int num_threads : {1, FLAGS_num_threads}) {
+    start = my_clock::now();
+    HybridMultipleShooting<double> shooting(
+        plant, {FLAGS_num_segments + 1}, {min_dt * segment_scale},
+        {max_dt * segment_scale}, {&dataset}, {options}, FLAGS_num_substeps,
+        num_threads);
+    std::chrono::duration<double, std::milli> shooting_time =
+        my_clock::now() - start;
+    SetUpWalking(plant, &shooting);
+    shooting.SetSolverOption(drake::solvers::SnoptSolver::id(),
+                             "Major iterations limit", FLAGS_max_iter);
+    Report("HybridMultipleShooting, " + std::to_string(num_threads) +
+               " thread(s)",
+           shooting, shooting_time.count());
+    if (FLAGS_num_threads == 1) break;
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::do_main(argc, argv); }
@@ -1,5 +1,9 @@
 #include "examples/Cassie/cassie_state_estimator.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
 #include <gtest/gtest.h>
+#include "examples/Cassie/cassie_fourbar_solver.h"
 #include "multibody/kinematic/world_point_evaluator.h"
 #include "multibody/multibody_solvers.h"
 #include "drake/solvers/snopt_solver.h"
@@ -150,6 +154,60 @@ TEST_F(ContactEstimationTest, solveFourbarLinkageTest) {
   EXPECT_TRUE((calc_right_heel_spring - nlp_right_heel_spring) > -1e-10);
 }
 
+// Checks CassieFourbarSolver against solveFourbarLinkage() on the recorded
+// configurations of this file, and on random ones within the joint limits
+TEST_F(ContactEstimationTest, FourbarSolverTest) {
+  std::vector<VectorXd> qs(4, VectorXd(plant_.num_positions()));
+  qs[0] << 1, VectorXd::Zero(6), -0.084017, 0.084017, -0.00120735, 0.00120735,
+      0.366012, 0.366012, -0.6305, -0.6305, 0.00205363, 0.00205363, 0.838878,
+      0.838878, 0, 0.205351, 0, 0.205351;
+  qs[1] << 0.990065, 0.000339553, 0.00444831, 0.00085048, 0.00836164,
+      -0.000249535, 1.03223, -0.000810813, 6.8811e-05, 0.00177426,
+      -0.00514383, 0.447568, 0.44727, -1.01775, -1.01819, -0.044873,
+      -0.0450231, 1.29924, 1.30006, 0.00780166, -1.56023, 0.00757446,
+      -1.56018;
+  qs[2] << 0.989849, -0.000815987, -0.017933, -0.0111588, 0.344537, -0.148108,
+      1.00902, -0.0357916, -0.0422061, -0.0068692, -0.0355008, 0.274222,
+      0.644396, -1.00482, -1.50496, -0.0745786, -0.000565784, 1.36746, 1.73074,
+      -0.043625, -1.45868, -0.000678207, -0.936994;
+  qs[3] << 0.98987, -0.00811052, -0.00949625, 0.015811, 0.01949, -0.157343,
+      1.00405, 0.123047, -0.0753356, 0.0288855, -0.0330248, 0.832632,
+      0.0262067, -1.52869, -0.882942, -0.00078387, -0.0740736, 1.74919,
+      1.23608, 0.00556074, -1.49203, -0.0305797, -1.2012;
+
+  std::map<std::string, int> pos_map =
+      multibody::makeNameToPositionsMap(plant_);
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> uniform(-1, 1);
+  for (int i = 0; i < 1000; i++) {
+    VectorXd q = qs[0];
+    for (const std::string& leg : {"_left", "_right"}) {
+      const double knee = -1.754 + 1.108 * uniform(generator);
+      q(pos_map.at("knee" + leg)) = knee;
+      q(pos_map.at("knee_joint" + leg)) = -0.0125 + 0.0875 * uniform(generator);
+      q(pos_map.at("ankle_joint" + leg)) =
+          std::clamp(-knee + 0.2 + 0.1 * uniform(generator), 0.8, 3.0);
+    }
+    qs.push_back(q);
+  }
+
+  CassieFourbarSolver solver(plant_);
+  for (VectorXd& q : qs) {
+    // solveFourbarLinkage() measures the heel springs from their current angle
+    q(pos_map.at("ankle_spring_joint_left")) = 0;
+    q(pos_map.at("ankle_spring_joint_right")) = 0;
+    double left_heel_spring, right_heel_spring;
+    estimator_->solveFourbarLinkage(q, &left_heel_spring, &right_heel_spring);
+    const Eigen::Vector2d heel_springs = solver.Solve(q);
+    if (!std::isnan(left_heel_spring)) {
+      EXPECT_NEAR(heel_springs(0), left_heel_spring, 1e-8);
+    }
+    if (!std::isnan(right_heel_spring)) {
+      EXPECT_NEAR(heel_springs(1), right_heel_spring, 1e-8);
+    }
+  }
+}
+
 // Double support contact estimation test
 // Checks if the contactEstimation returns the correct contacts for a
 // configuration of the robot in double stance.
@@ -279,6 +337,40 @@ TEST_F(ContactEstimationTest, RightSupportContactEstimationTest) {
   EXPECT_TRUE(!left_contact_) << "Left contact error during right support.";
   EXPECT_TRUE(right_contact_) << "Right contact error during right support.";
 }
+
+TEST_F(ContactEstimationTest, PredictToTimeTest) {
+  auto context = estimator_->CreateDefaultContext();
+  estimator_->get_input_port(0).FixValue(context.get(), cassie_out_t{});
+  estimator_->setPreviousTime(context.get(), 1);
+  estimator_->setInitialPelvisPose(context.get(), Eigen::Vector4d(1, 0, 0, 0),
+                                   Vector3d(0, 0, 1));
+  // Accelerating forward at 1 m/s^2, without rotation
+  VectorXd imu(6);
+  imu << 0, 0, 0, 1, 0, 9.81;
+  estimator_->setPreviousImuMeasurement(context.get(), imu);
+
+  const int n_q = plant_.num_positions();
+  const int base_x = multibody::makeNameToPositionsMap(plant_).at("base_x");
+  const int base_vx =
+      n_q + multibody::makeNameToVelocitiesMap(plant_).at("base_vx");
+  estimator_->PredictToTime(context.get(), 1.01);
+  VectorXd output = estimator_->get_output_port(0).Eval(*context);
+  EXPECT_NEAR(output(base_vx), 0.01, 1e-6);
+  EXPECT_NEAR(output(base_x), 0.00005, 1e-6);
+
+  // Predicting in steps is the same as at once
+  estimator_->PredictToTime(context.get(), 1.015);
+  estimator_->PredictToTime(context.get(), 1.02);
+  output = estimator_->get_output_port(0).Eval(*context);
+  EXPECT_NEAR(output(base_vx), 0.02, 1e-6);
+  EXPECT_NEAR(output(base_x), 0.0002, 1e-6);
+
+  // but not backwards
+  estimator_->PredictToTime(context.get(), 1.01);
+  output = estimator_->get_output_port(0).Eval(*context);
+  EXPECT_NEAR(output(base_vx), 0.02, 1e-6);
+}
+
 }  // namespace
 }  // namespace systems
 }  // namespace dairlib
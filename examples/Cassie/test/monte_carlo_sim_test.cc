@@ -0,0 +1,88 @@
+#include "examples/Cassie/monte_carlo_sim.h"
+
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "examples/Cassie/cassie_fixed_point_solver.h"
+#include "examples/Cassie/cassie_utils.h"
+
+namespace dairlib {
+namespace {
+
+using Eigen::VectorXd;
+using std::vector;
+
+class MonteCarloSimTest : public ::testing::Test {
+ protected:
+  MonteCarloSimTest() {
+    options_.num_runs = 4;
+    options_.seed = 7;
+    options_.end_time = 0.05;
+    // Push early enough to happen in the runs
+    options_.min_push_time = 0.01;
+    options_.max_push_time = 0.03;
+
+    drake::multibody::MultibodyPlant<double> plant(0.0);
+    addCassieMultibody(&plant, nullptr, true,
+                       "examples/Cassie/urdf/cassie_v2.urdf", true, false);
+    plant.Finalize();
+    VectorXd u_init, lambda_init;
+    CassieFixedPointSolver(plant, options_.init_height, 0, 70, true, 0.2,
+                           &q_init_, &u_init, &lambda_init);
+  }
+
+  MonteCarloOptions options_;
+  VectorXd q_init_;
+};
+
+// A seeded batch gives the same runs on any number of threads
+TEST_F(MonteCarloSimTest, Deterministic) {
+  double serial_time;
+  double parallel_time;
+  options_.num_threads = 1;
+  const vector<MonteCarloRun> serial =
+      RunMonteCarloSims(options_, q_init_, &serial_time);
+  options_.num_threads = 4;
+  const vector<MonteCarloRun> parallel =
+      RunMonteCarloSims(options_, q_init_, &parallel_time);
+  std::cout << "1 thread: " << serial_time << " s, 4 threads: "
+            << parallel_time << " s" << std::endl;
+
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (size_t i = 0; i < serial.size(); i++) {
+    EXPECT_EQ(serial[i].index, static_cast<int>(i));
+    EXPECT_EQ(parallel[i].index, static_cast<int>(i));
+    EXPECT_EQ(serial[i].error, "");
+    EXPECT_EQ(serial[i].mu, parallel[i].mu);
+    EXPECT_EQ(serial[i].slope, parallel[i].slope);
+    EXPECT_EQ(serial[i].slope_direction, parallel[i].slope_direction);
+    EXPECT_EQ(serial[i].mass_scale, parallel[i].mass_scale);
+    EXPECT_EQ(serial[i].push_force, parallel[i].push_force);
+    EXPECT_EQ(serial[i].push_time, parallel[i].push_time);
+    EXPECT_EQ(serial[i].fell, parallel[i].fell);
+    EXPECT_EQ(serial[i].end_time, parallel[i].end_time);
+    EXPECT_EQ(serial[i].rms_tracking_error, parallel[i].rms_tracking_error);
+    EXPECT_EQ(serial[i].controller_times.size(),
+              parallel[i].controller_times.size());
+  }
+  // The runs are randomized differently
+  EXPECT_NE(serial[0].mu, serial[1].mu);
+}
+
+// An exception while building a run ends this run only
+TEST_F(MonteCarloSimTest, Exception) {
+  options_.num_threads = 2;
+  options_.sim_dt = -1;
+  const vector<MonteCarloRun> runs = RunMonteCarloSims(options_, q_init_);
+  ASSERT_EQ(static_cast<int>(runs.size()), options_.num_runs);
+  for (const auto& run : runs) {
+    EXPECT_TRUE(run.fell);
+    EXPECT_NE(run.error, "");
+    EXPECT_EQ(run.end_time, 0);
+  }
+}
+
+}  // namespace
+}  // namespace dairlib
@@ -22,6 +22,7 @@
 #include "systems/trajectory_optimization/dircon_position_data.h"
 #include "systems/trajectory_optimization/dircon_kinematic_data_set.h"
 #include "systems/trajectory_optimization/hybrid_dircon.h"
+#include "systems/trajectory_optimization/hybrid_multiple_shooting.h"
 #include "systems/trajectory_optimization/dircon_opt_constraints.h"
 #include "multibody/multibody_utils.h"
 #include "multibody/visualization_utils.h"
@@ -30,6 +31,14 @@
 DEFINE_double(strideLength, 0.1, "The stride length.");
 DEFINE_double(duration, 1, "The stride duration");
 DEFINE_bool(autodiff, false, "Double or autodiff version");
+DEFINE_bool(shooting, false,
+            "Transcribe with HybridMultipleShooting instead of HybridDircon, "
+            "to compare solve times (iteration counts are in ../snopt.out)");
+DEFINE_int32(num_shooting_segments, 4,
+             "Number of segments per mode with --shooting");
+DEFINE_int32(num_substeps, 4, "RK4 steps per segment with --shooting");
+DEFINE_int32(num_threads, 1,
+             "Threads integrating the segments with --shooting");
 
 using drake::multibody::MultibodyPlant;
 using drake::geometry::SceneGraph;
@@ -51,7 +60,9 @@ using std::endl;
 /// Outputs: trajectory optimization problem
 namespace dairlib {
 namespace {
+using drake::systems::trajectory_optimization::MultipleShooting;
 using systems::trajectory_optimization::HybridDircon;
+using systems::trajectory_optimization::HybridMultipleShooting;
 using systems::trajectory_optimization::DirconDynamicConstraint;
 using systems::trajectory_optimization::DirconKinematicConstraint;
 using systems::trajectory_optimization::DirconOptions;
@@ -60,7 +71,7 @@ using systems::SubvectorPassThrough;
 
 
 template <typename T>
-shared_ptr<HybridDircon<T>> runDircon(
+shared_ptr<MultipleShooting> runDircon(
     std::unique_ptr<MultibodyPlant<T>> plant_ptr,
     MultibodyPlant<double>* plant_double_ptr,
     std::unique_ptr<SceneGraph<double>> scene_graph_ptr,
@@ -135,8 +146,37 @@ shared_ptr<HybridDircon<T>> runDircon(
   options_list.push_back(leftOptions);
   options_list.push_back(rightOptions);
 
-  auto trajopt = std::make_shared<HybridDircon<T>>(plant,
-      timesteps, min_dt, max_dt, dataset_list, options_list);
+  shared_ptr<MultipleShooting> trajopt;
+  HybridDircon<T>* dircon = nullptr;
+  if (FLAGS_shooting) {
+    // Fewer, longer segments with the same total duration bounds
+    std::vector<int> segments(timesteps.size(),
+                              FLAGS_num_shooting_segments + 1);
+    for (uint j = 0; j < min_dt.size(); j++) {
+      min_dt[j] *= (timesteps[j] - 1.0) / FLAGS_num_shooting_segments;
+      max_dt[j] *= (timesteps[j] - 1.0) / FLAGS_num_shooting_segments;
+    }
+    auto shooting = std::make_shared<HybridMultipleShooting<T>>(plant,
+        segments, min_dt, max_dt, dataset_list, options_list,
+        FLAGS_num_substeps, FLAGS_num_threads);
+    shooting->SetInitialTrajectory(init_u_traj, init_x_traj);
+    for (uint j = 0; j < segments.size(); j++) {
+      shooting->SetInitialForceTrajectory(j, init_l_traj[j]);
+    }
+    trajopt = shooting;
+  } else {
+    auto hybrid_dircon = std::make_shared<HybridDircon<T>>(plant,
+        timesteps, min_dt, max_dt, dataset_list, options_list);
+    for (uint j = 0; j < timesteps.size(); j++) {
+      hybrid_dircon->drake::systems::trajectory_optimization::
+          MultipleShooting::SetInitialTrajectory(init_u_traj, init_x_traj);
+      hybrid_dircon->SetInitialForceTrajectory(j, init_l_traj[j],
+                                               init_lc_traj[j],
+                                               init_vc_traj[j]);
+    }
+    dircon = hybrid_dircon.get();
+    trajopt = hybrid_dircon;
+  }
 
   trajopt->AddDurationBounds(duration, duration);
 
@@ -148,13 +188,6 @@ shared_ptr<HybridDircon<T>> runDircon(
   // trajopt->SetSolverOption(drake::solvers::SnoptSolver::id(),
   //    "Verify level","1");
 
-  for (uint j = 0; j < timesteps.size(); j++) {
-    trajopt->drake::systems::trajectory_optimization::MultipleShooting::
-        SetInitialTrajectory(init_u_traj, init_x_traj);
-    trajopt->SetInitialForceTrajectory(j, init_l_traj[j], init_lc_traj[j],
-                                      init_vc_traj[j]);
-  }
-
   // Periodicity constraints
 // hip_pin = 3
 // left_knee_pin = 4
@@ -217,16 +250,25 @@ shared_ptr<HybridDircon<T>> runDircon(
   visualizer_poses.push_back(3);
   visualizer_poses.push_back(3);
 
-  trajopt->CreateVisualizationCallback(
-      dairlib::FindResourceOrThrow("examples/PlanarWalker/PlanarWalker.urdf"),
-      visualizer_poses, "base");
+  if (dircon) {
+    dircon->CreateVisualizationCallback(
+        dairlib::FindResourceOrThrow("examples/PlanarWalker/PlanarWalker.urdf"),
+        visualizer_poses, "base");
+  }
 
   auto start = std::chrono::high_resolution_clock::now();
   const auto result = Solve(*trajopt, trajopt->initial_guess());
   auto finish = std::chrono::high_resolution_clock::now();
   std::chrono::duration<double> elapsed = finish - start;
+  std::cout << "Transcription:"
+            << (FLAGS_shooting ? "multiple shooting" : "dircon") << std::endl;
+  std::cout << "Decision variables:" << trajopt->num_vars() << std::endl;
+  std::cout << "Constraint rows:" << solvers::CountConstraintRows(*trajopt)
+            << std::endl;
   std::cout << "Solve time:" << elapsed.count() <<std::endl;
   std::cout << "Cost:" << result.get_optimal_cost() <<std::endl;
+  std::cout << "Solution result:" << result.get_solution_result()
+            << std::endl;
 
   // systems::trajectory_optimization::checkConstraints(trajopt.get(), result);
 
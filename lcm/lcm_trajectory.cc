@@ -6,6 +6,7 @@
 #include <utility>
 
 #include "lcm/lcm_trajectory.h"
+#include "lcm/lcm_trajectory_container.h"
 #include "drake/common/value.h"
 
 using drake::AbstractValue;
@@ -169,6 +170,27 @@ void LcmTrajectory::loadFromFile(const std::string& filepath) {
   }
 }
 
+void LcmTrajectory::appendToContainer(const string& filepath,
+                                      const string& entry_name) const {
+  vector<Trajectory> trajectories;
+  for (const string& traj_name : trajectory_names_) {
+    trajectories.push_back(trajectories_.at(traj_name));
+  }
+  LcmTrajectoryContainerWriter writer(filepath);
+  writer.Append(entry_name, metadata_, trajectories, trajectory_names_);
+}
+
+void LcmTrajectory::loadFromContainer(const string& filepath,
+                                      const string& entry_name) {
+  LcmTrajectoryContainerReader reader(filepath);
+  metadata_ = reader.GetMetadata(entry_name);
+  trajectory_names_ = reader.GetTrajectoryNames(entry_name);
+  trajectories_ = unordered_map<string, Trajectory>();
+  for (const string& traj_name : trajectory_names_) {
+    trajectories_[traj_name] = reader.ReadTrajectory(entry_name, traj_name);
+  }
+}
+
 lcmt_metadata LcmTrajectory::constructMetadataObject(string name,
                                                      string description) const {
   lcmt_metadata metadata;
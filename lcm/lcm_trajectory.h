@@ -17,6 +17,11 @@ namespace dairlib {
 ///
 /// To load a saved LcmTrajectory object, call the loadFromFile() with relative
 /// filepath of the previously saved LcmTrajectory object
+///
+/// For large libraries of trajectories, many LcmTrajectory objects can instead
+/// be appended to a single chunked trajectory container file with
+/// appendToContainer() and loaded individually with loadFromContainer()
+/// (see lcm_trajectory_container.h)
 
 class LcmTrajectory {
  public:
@@ -56,6 +61,20 @@ class LcmTrajectory {
   /// reading/opening the file
   void loadFromFile(const std::string& filepath);
 
+  /// Appends this LcmTrajectory object as entry_name to the trajectory
+  /// container specified by filepath, creating the container if necessary
+  /// @throws std::exception along with the invalid filepath if unable to open
+  /// the file
+  void appendToContainer(const std::string& filepath,
+                         const std::string& entry_name) const;
+
+  /// Loads the entry entry_name from the trajectory container specified by
+  /// filepath
+  /// @throws std::exception along with the invalid filepath if error
+  /// reading/opening the file, or std::out_of_range if there is no such entry
+  void loadFromContainer(const std::string& filepath,
+                         const std::string& entry_name);
+
   const lcmt_metadata getMetadata() const { return metadata_; }
 
   Trajectory getTrajectory(const std::string& trajectory_name) const {
@@ -0,0 +1,441 @@
+#include "lcm/lcm_trajectory_container.h"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "drake/common/drake_assert.h"
+
+using Eigen::VectorXd;
+using std::string;
+using std::vector;
+
+namespace dairlib {
+
+namespace {
+
+const char kFileMagic[8] = {'D', 'A', 'I', 'R', 'T', 'R', 'J', 'C'};
+const uint32_t kFileVersion = 1;
+const uint32_t kRecordMagic = 0x44524352;  // "RCRD"
+// File magic + version
+const uint64_t kFileHeaderSize = sizeof(kFileMagic) + sizeof(uint32_t);
+// Record magic + header size + payload size
+const uint64_t kRecordPrefixSize = 4 + 8 + 8;
+
+enum ColumnCodec : uint8_t { kRaw = 0, kXor = 1, kDeltaOfDelta = 2 };
+
+/// Little-endian byte buffer helpers
+void PutUint(uint64_t value, int num_bytes, vector<uint8_t>* out) {
+  for (int i = 0; i < num_bytes; ++i) {
+    out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+void PutString(const string& str, vector<uint8_t>* out) {
+  PutUint(str.size(), 4, out);
+  out->insert(out->end(), str.begin(), str.end());
+}
+
+void PutVarint(uint64_t value, vector<uint8_t>* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+class ByteReader {
+ public:
+  ByteReader(const uint8_t* data, uint64_t size) : data_(data), size_(size) {}
+
+  uint64_t GetUint(int num_bytes) {
+    Require(num_bytes);
+    uint64_t value = 0;
+    for (int i = 0; i < num_bytes; ++i) {
+      value |= static_cast<uint64_t>(data_[pos_++]) << (8 * i);
+    }
+    return value;
+  }
+
+  uint64_t GetVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      Require(1);
+      uint8_t byte = data_[pos_++];
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error("Malformed varint in trajectory container");
+  }
+
+  string GetString() {
+    uint64_t length = GetUint(4);
+    Require(length);
+    string str(reinterpret_cast<const char*>(data_ + pos_), length);
+    pos_ += length;
+    return str;
+  }
+
+  const uint8_t* Skip(uint64_t num_bytes) {
+    Require(num_bytes);
+    const uint8_t* start = data_ + pos_;
+    pos_ += num_bytes;
+    return start;
+  }
+
+ private:
+  void Require(uint64_t num_bytes) const {
+    if (pos_ + num_bytes > size_) {
+      throw std::runtime_error("Truncated trajectory container record");
+    }
+  }
+
+  const uint8_t* data_;
+  uint64_t size_;
+  uint64_t pos_ = 0;
+};
+
+uint64_t DoubleToBits(double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+double BitsToDouble(uint64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void EncodeRaw(const VectorXd& column, vector<uint8_t>* out) {
+  for (int i = 0; i < column.size(); ++i) {
+    PutUint(DoubleToBits(column(i)), 8, out);
+  }
+}
+
+/// XOR each value against the previous one and only store the bytes between
+/// the leading and trailing zero bytes of the result. A control byte per value
+/// stores (leading zero bytes, trailing zero bytes), or 0 for a repeat.
+void EncodeXor(const VectorXd& column, vector<uint8_t>* out) {
+  uint64_t prev = 0;
+  for (int i = 0; i < column.size(); ++i) {
+    uint64_t bits = DoubleToBits(column(i));
+    uint64_t x = bits ^ prev;
+    prev = bits;
+    if (x == 0) {
+      out->push_back(0);
+      continue;
+    }
+    int leading = __builtin_clzll(x) / 8;
+    int trailing = __builtin_ctzll(x) / 8;
+    out->push_back(static_cast<uint8_t>(0x80 | (leading << 3) | trailing));
+    for (int b = trailing; b < 8 - leading; ++b) {
+      out->push_back(static_cast<uint8_t>(x >> (8 * b)));
+    }
+  }
+}
+
+/// Treats the bit patterns as integers and stores the zigzag/varint coded
+/// second difference. All arithmetic wraps, so the encoding is lossless.
+void EncodeDeltaOfDelta(const VectorXd& column, vector<uint8_t>* out) {
+  uint64_t prev = 0;
+  uint64_t prev_delta = 0;
+  for (int i = 0; i < column.size(); ++i) {
+    uint64_t bits = DoubleToBits(column(i));
+    uint64_t delta = bits - prev;
+    auto delta_of_delta = static_cast<int64_t>(delta - prev_delta);
+    prev = bits;
+    prev_delta = delta;
+    PutVarint((static_cast<uint64_t>(delta_of_delta) << 1) ^
+                  static_cast<uint64_t>(delta_of_delta >> 63),
+              out);
+  }
+}
+
+/// Encodes a column with every codec and keeps the smallest result
+uint8_t EncodeColumn(const VectorXd& column, vector<uint8_t>* out) {
+  vector<uint8_t> best;
+  EncodeRaw(column, &best);
+  uint8_t best_codec = kRaw;
+
+  vector<uint8_t> candidate;
+  EncodeXor(column, &candidate);
+  if (candidate.size() < best.size()) {
+    best.swap(candidate);
+    best_codec = kXor;
+  }
+  candidate.clear();
+  EncodeDeltaOfDelta(column, &candidate);
+  if (candidate.size() < best.size()) {
+    best.swap(candidate);
+    best_codec = kDeltaOfDelta;
+  }
+  out->insert(out->end(), best.begin(), best.end());
+  return best_codec;
+}
+
+VectorXd DecodeColumn(uint8_t codec, const uint8_t* data, uint64_t size,
+                      int num_points) {
+  VectorXd column(num_points);
+  ByteReader reader(data, size);
+  uint64_t prev = 0;
+  uint64_t prev_delta = 0;
+  for (int i = 0; i < num_points; ++i) {
+    uint64_t bits;
+    switch (codec) {
+      case kRaw:
+        bits = reader.GetUint(8);
+        break;
+      case kXor: {
+        uint8_t control = reader.GetUint(1);
+        uint64_t x = 0;
+        if (control != 0) {
+          int leading = (control >> 3) & 0x7;
+          int trailing = control & 0x7;
+          for (int b = trailing; b < 8 - leading; ++b) {
+            x |= reader.GetUint(1) << (8 * b);
+          }
+        }
+        bits = prev ^ x;
+        break;
+      }
+      case kDeltaOfDelta: {
+        uint64_t zigzag = reader.GetVarint();
+        uint64_t delta_of_delta = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        prev_delta += delta_of_delta;
+        bits = prev + prev_delta;
+        break;
+      }
+      default:
+        throw std::runtime_error("Unknown column codec in trajectory "
+                                 "container");
+    }
+    prev = bits;
+    column(i) = BitsToDouble(bits);
+  }
+  return column;
+}
+
+}  // namespace
+
+LcmTrajectoryContainerWriter::LcmTrajectoryContainerWriter(
+    const string& filepath)
+    : filepath_(filepath) {
+  // Check for an existing, non-empty file with a valid header
+  std::ifstream fin(filepath, std::ios_base::binary | std::ios_base::ate);
+  bool write_header = !fin || fin.tellg() == 0;
+  if (!write_header) {
+    char magic[sizeof(kFileMagic)];
+    fin.seekg(0);
+    fin.read(magic, sizeof(magic));
+    if (!fin || std::memcmp(magic, kFileMagic, sizeof(kFileMagic)) != 0) {
+      throw std::runtime_error("Not a trajectory container: " + filepath);
+    }
+  }
+  fin.close();
+
+  fout_.open(filepath, std::ios_base::binary | std::ios_base::app);
+  if (!fout_) {
+    std::cerr << "Could not open file: " << filepath << std::endl;
+    throw std::runtime_error("Could not open file: " + filepath);
+  }
+  if (write_header) {
+    vector<uint8_t> header(kFileMagic, kFileMagic + sizeof(kFileMagic));
+    PutUint(kFileVersion, 4, &header);
+    fout_.write(reinterpret_cast<const char*>(header.data()), header.size());
+    fout_.flush();
+  }
+}
+
+void LcmTrajectoryContainerWriter::Append(
+    const string& entry_name, const lcmt_metadata& metadata,
+    const vector<LcmTrajectory::Trajectory>& trajectories,
+    const vector<string>& trajectory_names) {
+  DRAKE_DEMAND(trajectories.size() == trajectory_names.size());
+
+  vector<uint8_t> header;
+  vector<uint8_t> payload;
+
+  PutString(entry_name, &header);
+  vector<uint8_t> metadata_bytes(metadata.getEncodedSize());
+  metadata.encode(metadata_bytes.data(), 0, metadata_bytes.size());
+  PutUint(metadata_bytes.size(), 4, &header);
+  header.insert(header.end(), metadata_bytes.begin(), metadata_bytes.end());
+
+  PutUint(trajectories.size(), 4, &header);
+  for (size_t i = 0; i < trajectories.size(); ++i) {
+    const LcmTrajectory::Trajectory& traj = trajectories[i];
+    int num_points = traj.time_vector.size();
+    int num_datatypes = traj.datatypes.size();
+    DRAKE_DEMAND(traj.datapoints.rows() == num_datatypes);
+    DRAKE_DEMAND(traj.datapoints.cols() == num_points);
+
+    PutString(trajectory_names[i], &header);
+    PutUint(num_points, 4, &header);
+    PutUint(num_datatypes, 4, &header);
+    for (const auto& datatype : traj.datatypes) {
+      PutString(datatype, &header);
+    }
+    for (int col = 0; col < num_datatypes + 1; ++col) {
+      uint64_t offset = payload.size();
+      uint8_t codec = (col == 0)
+          ? EncodeColumn(traj.time_vector, &payload)
+          : EncodeColumn(traj.datapoints.row(col - 1).transpose(), &payload);
+      PutUint(codec, 1, &header);
+      PutUint(offset, 8, &header);
+      PutUint(payload.size() - offset, 8, &header);
+    }
+  }
+
+  vector<uint8_t> record;
+  record.reserve(kRecordPrefixSize + header.size() + payload.size());
+  PutUint(kRecordMagic, 4, &record);
+  PutUint(header.size(), 8, &record);
+  PutUint(payload.size(), 8, &record);
+  record.insert(record.end(), header.begin(), header.end());
+  record.insert(record.end(), payload.begin(), payload.end());
+
+  fout_.write(reinterpret_cast<const char*>(record.data()), record.size());
+  fout_.flush();
+  if (!fout_) {
+    throw std::runtime_error("Could not write to file: " + filepath_);
+  }
+}
+
+LcmTrajectoryContainerReader::LcmTrajectoryContainerReader(
+    const string& filepath)
+    : filepath_(filepath), fin_(filepath, std::ios_base::binary) {
+  if (!fin_) {
+    std::cerr << "Could not open file: " << filepath << std::endl;
+    throw std::runtime_error("Could not open file: " + filepath);
+  }
+  char magic[sizeof(kFileMagic)];
+  fin_.read(magic, sizeof(magic));
+  if (!fin_ || std::memcmp(magic, kFileMagic, sizeof(kFileMagic)) != 0) {
+    throw std::runtime_error("Not a trajectory container: " + filepath);
+  }
+  uint8_t version_bytes[4];
+  fin_.read(reinterpret_cast<char*>(version_bytes), sizeof(version_bytes));
+  if (ByteReader(version_bytes, 4).GetUint(4) != kFileVersion) {
+    throw std::runtime_error("Unsupported trajectory container version: " +
+                             filepath);
+  }
+  scanned_bytes_ = kFileHeaderSize;
+  Refresh();
+}
+
+void LcmTrajectoryContainerReader::Refresh() {
+  fin_.clear();
+  fin_.seekg(0, std::ios_base::end);
+  uint64_t file_size = fin_.tellg();
+
+  while (scanned_bytes_ + kRecordPrefixSize <= file_size) {
+    uint8_t prefix[kRecordPrefixSize];
+    fin_.seekg(scanned_bytes_);
+    fin_.read(reinterpret_cast<char*>(prefix), kRecordPrefixSize);
+    ByteReader prefix_reader(prefix, kRecordPrefixSize);
+    if (prefix_reader.GetUint(4) != kRecordMagic) {
+      throw std::runtime_error("Corrupt trajectory container: " + filepath_);
+    }
+    uint64_t header_size = prefix_reader.GetUint(8);
+    uint64_t payload_size = prefix_reader.GetUint(8);
+    uint64_t header_start = scanned_bytes_ + kRecordPrefixSize;
+    uint64_t payload_start = header_start + header_size;
+    if (payload_start + payload_size > file_size) {
+      // Record is still being written
+      break;
+    }
+
+    vector<uint8_t> header(header_size);
+    fin_.read(reinterpret_cast<char*>(header.data()), header_size);
+    ByteReader reader(header.data(), header_size);
+
+    string entry_name = reader.GetString();
+    EntryIndex entry;
+    uint64_t metadata_size = reader.GetUint(4);
+    entry.metadata.decode(reader.Skip(metadata_size), 0, metadata_size);
+    int num_trajectories = reader.GetUint(4);
+    for (int i = 0; i < num_trajectories; ++i) {
+      TrajectoryIndex traj;
+      traj.traj_name = reader.GetString();
+      traj.num_points = reader.GetUint(4);
+      int num_datatypes = reader.GetUint(4);
+      for (int j = 0; j < num_datatypes; ++j) {
+        traj.datatypes.push_back(reader.GetString());
+      }
+      for (int col = 0; col < num_datatypes + 1; ++col) {
+        ColumnIndex column;
+        column.codec = reader.GetUint(1);
+        column.offset = payload_start + reader.GetUint(8);
+        column.size = reader.GetUint(8);
+        traj.columns.push_back(column);
+      }
+      entry.trajectory_names.push_back(traj.traj_name);
+      entry.trajectories[traj.traj_name] = std::move(traj);
+    }
+
+    if (!entries_.count(entry_name)) {
+      entry_names_.push_back(entry_name);
+    }
+    entries_[entry_name] = std::move(entry);
+    scanned_bytes_ = payload_start + payload_size;
+  }
+}
+
+const LcmTrajectoryContainerReader::TrajectoryIndex&
+LcmTrajectoryContainerReader::GetTrajectoryIndex(
+    const string& entry_name, const string& traj_name) const {
+  return entries_.at(entry_name).trajectories.at(traj_name);
+}
+
+VectorXd LcmTrajectoryContainerReader::ReadColumn(const ColumnIndex& column,
+                                                  int num_points) {
+  vector<uint8_t> bytes(column.size);
+  fin_.clear();
+  fin_.seekg(column.offset);
+  fin_.read(reinterpret_cast<char*>(bytes.data()), column.size);
+  if (!fin_) {
+    throw std::runtime_error("Could not read from file: " + filepath_);
+  }
+  return DecodeColumn(column.codec, bytes.data(), bytes.size(), num_points);
+}
+
+VectorXd LcmTrajectoryContainerReader::ReadColumn(const string& entry_name,
+                                                  const string& traj_name,
+                                                  const string& datatype) {
+  const TrajectoryIndex& traj = GetTrajectoryIndex(entry_name, traj_name);
+  for (size_t i = 0; i < traj.datatypes.size(); ++i) {
+    if (traj.datatypes[i] == datatype) {
+      return ReadColumn(traj.columns[i + 1], traj.num_points);
+    }
+  }
+  throw std::out_of_range("No datatype " + datatype + " in trajectory " +
+                          traj_name);
+}
+
+LcmTrajectory::Trajectory LcmTrajectoryContainerReader::ReadTrajectory(
+    const string& entry_name, const string& traj_name) {
+  const TrajectoryIndex& index = GetTrajectoryIndex(entry_name, traj_name);
+  LcmTrajectory::Trajectory traj;
+  traj.traj_name = traj_name;
+  traj.datatypes = index.datatypes;
+  traj.time_vector = ReadColumn(index.columns[0], index.num_points);
+  traj.datapoints.resize(index.datatypes.size(), index.num_points);
+  for (size_t i = 0; i < index.datatypes.size(); ++i) {
+    traj.datapoints.row(i) =
+        ReadColumn(index.columns[i + 1], index.num_points).transpose();
+  }
+  return traj;
+}
+
+vector<LcmTrajectory::Trajectory>
+LcmTrajectoryContainerReader::ReadTrajectories(const string& entry_name) {
+  vector<LcmTrajectory::Trajectory> trajectories;
+  for (const auto& traj_name : GetTrajectoryNames(entry_name)) {
+    trajectories.push_back(ReadTrajectory(entry_name, traj_name));
+  }
+  return trajectories;
+}
+
+}  // namespace dairlib
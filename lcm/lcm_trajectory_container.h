@@ -0,0 +1,125 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Dense>
+
+#include "dairlib/lcmt_metadata.hpp"
+#include "lcm/lcm_trajectory.h"
+
+namespace dairlib {
+
+/// Chunked, columnar container for libraries of LcmTrajectory objects (e.g.
+/// thousands of DIRCON solutions making up a gait library).
+///
+/// The file is append-only. It starts with a short file header and is followed
+/// by one record per appended entry. Each record contains a small header
+/// (entry name, lcmt_metadata, trajectory names, datatypes, and a column
+/// directory) followed by the column payloads. Every column (the time vector
+/// and each datatype row of LcmTrajectory::Trajectory::datapoints) is
+/// compressed independently and losslessly, using whichever of the following
+/// is smallest for that column:
+///   - raw little-endian doubles
+///   - XOR of consecutive IEEE-754 bit patterns with zero-byte suppression
+///   - delta-of-delta of the bit patterns (as integers), zigzag + varint coded
+///     (very effective for uniformly spaced time vectors)
+///
+/// Because records are never modified after they are written, any number of
+/// processes can read the same file concurrently while another one appends.
+/// A reader only sees complete records; a partially written trailing record is
+/// ignored until a later Refresh(). Appending an entry with an existing name
+/// shadows the older entry.
+
+class LcmTrajectoryContainerWriter {
+ public:
+  /// Opens (or creates) the container at filepath for appending
+  /// @throws std::exception along with the invalid filepath if unable to open
+  /// the file or if the file is not a trajectory container
+  explicit LcmTrajectoryContainerWriter(const std::string& filepath);
+
+  /// Appends a single entry to the container. The record is assembled in
+  /// memory and written with a single write call followed by a flush.
+  void Append(const std::string& entry_name, const lcmt_metadata& metadata,
+              const std::vector<LcmTrajectory::Trajectory>& trajectories,
+              const std::vector<std::string>& trajectory_names);
+
+ private:
+  std::string filepath_;
+  std::ofstream fout_;
+};
+
+class LcmTrajectoryContainerReader {
+ public:
+  /// Opens the container at filepath and builds the entry directory by
+  /// scanning the record headers (column payloads are not read)
+  /// @throws std::exception along with the invalid filepath if unable to open
+  /// the file or if the file is not a trajectory container
+  explicit LcmTrajectoryContainerReader(const std::string& filepath);
+
+  /// Picks up any complete records appended since the last scan
+  void Refresh();
+
+  /// Entry names in the order they were first appended
+  const std::vector<std::string>& GetEntryNames() const {
+    return entry_names_;
+  }
+
+  bool HasEntry(const std::string& entry_name) const {
+    return entries_.count(entry_name) > 0;
+  }
+
+  const lcmt_metadata& GetMetadata(const std::string& entry_name) const {
+    return entries_.at(entry_name).metadata;
+  }
+
+  const std::vector<std::string>& GetTrajectoryNames(
+      const std::string& entry_name) const {
+    return entries_.at(entry_name).trajectory_names;
+  }
+
+  /// Decodes a single trajectory of an entry, only reading its own columns
+  LcmTrajectory::Trajectory ReadTrajectory(const std::string& entry_name,
+                                           const std::string& traj_name);
+
+  /// Decodes all trajectories of an entry, in the order they were saved
+  std::vector<LcmTrajectory::Trajectory> ReadTrajectories(
+      const std::string& entry_name);
+
+  /// Decodes a single column (one datatype) of a trajectory
+  Eigen::VectorXd ReadColumn(const std::string& entry_name,
+                             const std::string& traj_name,
+                             const std::string& datatype);
+
+ private:
+  struct ColumnIndex {
+    uint8_t codec;
+    uint64_t offset;  // Absolute offset in the file
+    uint64_t size;
+  };
+  struct TrajectoryIndex {
+    std::string traj_name;
+    int num_points;
+    std::vector<std::string> datatypes;
+    // Column 0 is the time vector, column i + 1 is datatypes[i]
+    std::vector<ColumnIndex> columns;
+  };
+  struct EntryIndex {
+    lcmt_metadata metadata;
+    std::vector<std::string> trajectory_names;
+    std::unordered_map<std::string, TrajectoryIndex> trajectories;
+  };
+
+  Eigen::VectorXd ReadColumn(const ColumnIndex& column, int num_points);
+  const TrajectoryIndex& GetTrajectoryIndex(const std::string& entry_name,
+                                            const std::string& traj_name) const;
+
+  std::string filepath_;
+  std::ifstream fin_;
+  uint64_t scanned_bytes_ = 0;
+  std::vector<std::string> entry_names_;
+  std::unordered_map<std::string, EntryIndex> entries_;
+};
+
+}  // namespace dairlib
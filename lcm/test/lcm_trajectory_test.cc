@@ -5,11 +5,13 @@
 #include <utility>
 #include <string>
 #include <chrono>
+#include <cstdio>
 #include <unordered_map>
 #include <vector>
 #include "drake/common/value.h"
 
 #include "lcm/lcm_trajectory.h"
+#include "lcm/lcm_trajectory_container.h"
 
 namespace dairlib {
 
@@ -27,6 +29,9 @@ using Eigen::RowMajor;
 using Eigen::Map;
 
 static const char TEST_FILEPATH[] = "TEST_FILEPATH";
+static const char TEST_CONTAINER_FILEPATH[] = "TEST_CONTAINER_FILEPATH";
+static const char TEST_ENTRY_1[] = "TEST_ENTRY_1";
+static const char TEST_ENTRY_2[] = "TEST_ENTRY_2";
 static const char TEST_TRAJ_NAME_1[] = "TEST_TRAJ_NAME_1";
 static const char TEST_TRAJ_NAME_2[] = "TEST_TRAJ_NAME_2";
 static const char TEST_NAME[] = "TEST_NAME";
@@ -117,8 +122,50 @@ TEST_F(LcmTrajectoryTest, TestConstructorFromLcmTObject) {
   EXPECT_TRUE(
       loaded_traj.getTrajectory(TEST_TRAJ_NAME_2).datatypes ==
           lcm_traj_.getTrajectory(TEST_TRAJ_NAME_2).datatypes);
+}
+
+TEST_F(LcmTrajectoryTest, TestContainerRoundTrip) {
+  std::remove(TEST_CONTAINER_FILEPATH);
+  lcm_traj_.appendToContainer(TEST_CONTAINER_FILEPATH, TEST_ENTRY_1);
+
+  LcmTrajectory::Trajectory traj_3 = traj_1_;
+  traj_3.time_vector = VectorXd::LinSpaced(NUM_DATAPOINTS, 0, 1);
+  traj_3.datapoints = MatrixXd::Random(NUM_DATATYPES, NUM_DATAPOINTS);
+  LcmTrajectory lcm_traj_2({traj_3}, {TEST_TRAJ_NAME_1}, TEST_NAME,
+                           TEST_DESCRIPTION);
+  lcm_traj_2.appendToContainer(TEST_CONTAINER_FILEPATH, TEST_ENTRY_2);
+
+  LcmTrajectoryContainerReader reader(TEST_CONTAINER_FILEPATH);
+  ASSERT_EQ(reader.GetEntryNames().size(), 2);
+  EXPECT_EQ(reader.GetEntryNames()[0], TEST_ENTRY_1);
+  EXPECT_EQ(reader.GetEntryNames()[1], TEST_ENTRY_2);
+  EXPECT_EQ(reader.GetTrajectoryNames(TEST_ENTRY_1), trajectory_names_);
+
+  // Compression is lossless, so compare exactly
+  LcmTrajectory loaded_traj;
+  loaded_traj.loadFromContainer(TEST_CONTAINER_FILEPATH, TEST_ENTRY_1);
+  EXPECT_EQ(loaded_traj.getMetadata().name, TEST_NAME);
+  EXPECT_EQ(loaded_traj.getMetadata().description, TEST_DESCRIPTION);
+  EXPECT_EQ(loaded_traj.getTrajectoryNames(), trajectory_names_);
+  for (const auto& traj : trajectories_) {
+    EXPECT_TRUE(loaded_traj.getTrajectory(traj.traj_name).time_vector ==
+                traj.time_vector);
+    EXPECT_TRUE(loaded_traj.getTrajectory(traj.traj_name).datapoints ==
+                traj.datapoints);
+    EXPECT_TRUE(loaded_traj.getTrajectory(traj.traj_name).datatypes ==
+                traj.datatypes);
+  }
 
+  // Random access to a single column
+  EXPECT_TRUE(reader.ReadColumn(TEST_ENTRY_2, TEST_TRAJ_NAME_1, DATATYPE_2) ==
+              traj_3.datapoints.row(1).transpose());
 
+  // Appending an existing entry name shadows the previous entry
+  lcm_traj_2.appendToContainer(TEST_CONTAINER_FILEPATH, TEST_ENTRY_1);
+  reader.Refresh();
+  EXPECT_EQ(reader.GetEntryNames().size(), 2);
+  EXPECT_TRUE(reader.ReadTrajectory(TEST_ENTRY_1, TEST_TRAJ_NAME_1).datapoints
+              == traj_3.datapoints);
 }
 
 }  // namespace dairlib
@@ -57,35 +57,62 @@ VectorX<T> KinematicEvaluator<T>::EvalActiveTimeDerivative(
 template <typename T>
 MatrixX<T> KinematicEvaluator<T>::EvalActiveJacobian(
       const Context<T>& context) const {
+  MatrixX<T> J(num_active_, plant_.num_velocities());
+  EvalActiveJacobianInto(context, J);
+  return J;
+}
+
+template <typename T>
+VectorX<T> KinematicEvaluator<T>::EvalActiveJacobianDotTimesV(
+      const Context<T>& context) const {
+  VectorX<T> Jdot_v(num_active_);
+  EvalActiveJacobianDotTimesVInto(context, Jdot_v);
+  return Jdot_v;
+}
+
+template <typename T>
+void KinematicEvaluator<T>::EvalActiveJacobianInto(
+      const Context<T>& context, Eigen::Ref<MatrixX<T>> J) const {
+  DRAKE_DEMAND(J.rows() == num_active_);
   // TODO: With Eigen 3.4, can slice by (active_inds_, all);
-  auto J_full = EvalFullJacobian(context);
   if (all_active_default_order_) {
-    return J_full;
+    EvalFullJacobianInto(context, J);
+    return;
   }
 
-  MatrixX<T> J_active(num_active_, J_full.cols());
+  // Extract active rows only
+  auto J_full = EvalFullJacobian(context);
   for (int i = 0; i < num_active_; i++) {
-    J_active.row(i) = J_full.row(active_inds_.at(i));
+    J.row(i) = J_full.row(active_inds_.at(i));
   }
-
-  // Extract active rows only
-  return J_active;
 }
 
 template <typename T>
-VectorX<T> KinematicEvaluator<T>::EvalActiveJacobianDotTimesV(
-      const Context<T>& context) const {
+void KinematicEvaluator<T>::EvalActiveJacobianDotTimesVInto(
+      const Context<T>& context, Eigen::Ref<VectorX<T>> Jdotv) const {
+  DRAKE_DEMAND(Jdotv.size() == num_active_);
   // TODO: With Eigen 3.4, can slice by (active_inds_);
-  auto Jdot_v_full = EvalFullJacobianDotTimesV(context);
   if (all_active_default_order_) {
-    return Jdot_v_full;
+    EvalFullJacobianDotTimesVInto(context, Jdotv);
+    return;
   }
 
-  VectorX<T> Jdot_v(num_active_);
+  auto Jdot_v_full = EvalFullJacobianDotTimesV(context);
   for (int i = 0; i < num_active_; i++) {
-    Jdot_v(i) = Jdot_v_full(active_inds_.at(i));
+    Jdotv(i) = Jdot_v_full(active_inds_.at(i));
   }
-  return Jdot_v;
+}
+
+template <typename T>
+void KinematicEvaluator<T>::EvalFullJacobianInto(
+      const Context<T>& context, Eigen::Ref<MatrixX<T>> J) const {
+  J = EvalFullJacobian(context);
+}
+
+template <typename T>
+void KinematicEvaluator<T>::EvalFullJacobianDotTimesVInto(
+      const Context<T>& context, Eigen::Ref<VectorX<T>> Jdotv) const {
+  Jdotv = EvalFullJacobianDotTimesV(context);
 }
 
 template <typename T>
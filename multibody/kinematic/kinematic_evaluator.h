@@ -50,6 +50,29 @@ class KinematicEvaluator {
   drake::VectorX<T> EvalActiveJacobianDotTimesV(
       const drake::systems::Context<T>& context) const;
 
+  /// Writes EvalActiveJacobian() into J (num_active() x num_velocities),
+  /// which can be a block of a larger matrix.
+  /// The default implementations of the XXXInto methods copy the result of
+  /// the corresponding EvalXXX method. Evaluators with fixed-size kernels
+  /// (see WorldPointEvaluator) override them to skip the temporaries.
+  virtual void EvalActiveJacobianInto(
+      const drake::systems::Context<T>& context,
+      Eigen::Ref<drake::MatrixX<T>> J) const;
+
+  /// Writes EvalActiveJacobianDotTimesV() into Jdotv (num_active())
+  virtual void EvalActiveJacobianDotTimesVInto(
+      const drake::systems::Context<T>& context,
+      Eigen::Ref<drake::VectorX<T>> Jdotv) const;
+
+  /// Writes EvalFullJacobian() into J (num_full() x num_velocities)
+  virtual void EvalFullJacobianInto(const drake::systems::Context<T>& context,
+                                    Eigen::Ref<drake::MatrixX<T>> J) const;
+
+  /// Writes EvalFullJacobianDotTimesV() into Jdotv (num_full())
+  virtual void EvalFullJacobianDotTimesVInto(
+      const drake::systems::Context<T>& context,
+      Eigen::Ref<drake::VectorX<T>> Jdotv) const;
+
   /// Evaluates the time-derivative, d/dt phi(q)
   drake::VectorX<T> EvalFullTimeDerivative(
       const drake::systems::Context<T>& context) const;
@@ -72,6 +95,11 @@ class KinematicEvaluator {
 
   const std::vector<int>& active_inds() const;
 
+  /// True if all rows are active, in the original order {0,1,...}
+  bool all_active_default_order() const {
+    return all_active_default_order_;
+  }
+
   int num_full() const {
     return length_;
   }
@@ -44,8 +44,8 @@ MatrixX<T> KinematicEvaluatorSet<T>::EvalActiveJacobian(
   MatrixX<T> J(count_active(), num_velocities);
   int ind = 0;
   for (const auto& e : evaluators_) {
-    J.block(ind, 0, e->num_active(), num_velocities) =
-        e->EvalActiveJacobian(context);
+    e->EvalActiveJacobianInto(context,
+                              J.block(ind, 0, e->num_active(), num_velocities));
     ind += e->num_active();
   }
   return J;
@@ -57,7 +57,8 @@ VectorX<T> KinematicEvaluatorSet<T>::EvalActiveJacobianDotTimesV(
   VectorX<T> Jdotv(count_active());
   int ind = 0;
   for (const auto& e : evaluators_) {
-    Jdotv.segment(ind, e->num_active()) = e->EvalActiveJacobianDotTimesV(context);
+    e->EvalActiveJacobianDotTimesVInto(context,
+                                       Jdotv.segment(ind, e->num_active()));
     ind += e->num_active();
   }
   return Jdotv;
@@ -94,8 +95,8 @@ MatrixX<T> KinematicEvaluatorSet<T>::EvalFullJacobian(
   MatrixX<T> J(count_full(), num_velocities);
   int ind = 0;
   for (const auto& e : evaluators_) {
-    J.block(ind, 0, e->num_full(), num_velocities) =
-        e->EvalFullJacobian(context);
+    e->EvalFullJacobianInto(context,
+                            J.block(ind, 0, e->num_full(), num_velocities));
     ind += e->num_full();
   }
   return J;
@@ -107,7 +108,8 @@ VectorX<T> KinematicEvaluatorSet<T>::EvalFullJacobianDotTimesV(
   VectorX<T> Jdotv(count_full());
   int ind = 0;
   for (const auto& e : evaluators_) {
-    Jdotv.segment(ind, e->num_full()) = e->EvalFullJacobianDotTimesV(context);
+    e->EvalFullJacobianDotTimesVInto(context,
+                                     Jdotv.segment(ind, e->num_full()));
     ind += e->num_full();
   }
   return Jdotv;
@@ -4,11 +4,13 @@
 
 #include "drake/common/test_utilities/eigen_matrix_compare.h"
 #include "drake/multibody/plant/multibody_plant.h"
+#include "drake/math/orthonormal_basis.h"
 #include "drake/multibody/parsing/parser.h"
 
 #include "common/find_resource.h"
 #include "multibody/kinematic/distance_evaluator.h"
 #include "multibody/kinematic/kinematic_evaluator.h"
+#include "multibody/kinematic/kinematic_evaluator_set.h"
 #include "multibody/kinematic/world_point_evaluator.h"
 
 namespace dairlib {
@@ -118,6 +120,80 @@ TEST_F(KinematicEvaluatorTest, WorldPointEvaluatorTest) {
       tolerance));  
 }
 
+TEST_F(KinematicEvaluatorTest, WorldPointEvaluatorIntoTest) {
+  const double tolerance = 1e-10;
+  const int n_v = plant_->num_velocities();
+
+  Vector3d pt_A({0, 0, -.5});
+  const auto& frame = plant_->GetFrameByName("right_lower_leg");
+  const Vector3d normal = Vector3d(1, 0, 2).normalized();
+
+  // Point contact, normal-only contact and a two-direction subset (which
+  // falls back on the generic slicing)
+  auto point = WorldPointEvaluator<double>(*plant_, pt_A, frame, normal,
+                                           Vector3d::Zero(), true);
+  auto normal_only = WorldPointEvaluator<double>(*plant_, pt_A, frame, normal,
+                                                 Vector3d::Zero(), false);
+  auto subset = WorldPointEvaluator<double>(*plant_, pt_A, frame,
+                                            Eigen::Matrix3d::Identity(),
+                                            Vector3d::Zero(), {2, 0});
+
+  auto context = plant_->CreateDefaultContext();
+  VectorXd q = VectorXd::LinSpaced(plant_->num_positions(), -1, 1);
+  plant_->SetPositions(context.get(), q);
+  plant_->SetVelocities(context.get(), VectorXd::LinSpaced(n_v, 2, -1));
+
+  // Reference, from the plant directly
+  MatrixXd J_WQ(3, n_v);
+  plant_->CalcJacobianTranslationalVelocity(
+      *context, drake::multibody::JacobianWrtVariable::kV, frame, pt_A,
+      plant_->world_frame(), plant_->world_frame(), &J_WQ);
+  const Vector3d Jdotv_WQ =
+      plant_
+          ->CalcBiasSpatialAcceleration(
+              *context, drake::multibody::JacobianWrtVariable::kV, frame, pt_A,
+              plant_->world_frame(), plant_->world_frame())
+          .translational();
+  const Eigen::Matrix3d R = drake::math::ComputeBasisFromAxis(2, normal);
+
+  // Written into blocks of larger matrices
+  MatrixXd J = MatrixXd::Constant(8, n_v, 7);
+  VectorXd Jdotv = VectorXd::Constant(8, 7);
+  point.EvalFullJacobianInto(*context, J.block(1, 0, 3, n_v));
+  point.EvalFullJacobianDotTimesVInto(*context, Jdotv.segment(1, 3));
+  normal_only.EvalActiveJacobianInto(*context, J.block(4, 0, 1, n_v));
+  normal_only.EvalActiveJacobianDotTimesVInto(*context, Jdotv.segment(4, 1));
+  subset.EvalActiveJacobianInto(*context, J.block(5, 0, 2, n_v));
+  subset.EvalActiveJacobianDotTimesVInto(*context, Jdotv.segment(5, 2));
+
+  MatrixXd J_expected = MatrixXd::Constant(8, n_v, 7);
+  VectorXd Jdotv_expected = VectorXd::Constant(8, 7);
+  J_expected.block(1, 0, 3, n_v) = R * J_WQ;
+  Jdotv_expected.segment(1, 3) = R * Jdotv_WQ;
+  J_expected.row(4) = R.row(2) * J_WQ;
+  Jdotv_expected(4) = R.row(2) * Jdotv_WQ;
+  J_expected.row(5) = J_WQ.row(2);
+  J_expected.row(6) = J_WQ.row(0);
+  Jdotv_expected(5) = Jdotv_WQ(2);
+  Jdotv_expected(6) = Jdotv_WQ(0);
+  EXPECT_TRUE(CompareMatrices(J, J_expected, tolerance));
+  EXPECT_TRUE(CompareMatrices(Jdotv, Jdotv_expected, tolerance));
+
+  // The allocating methods and KinematicEvaluatorSet agree
+  EXPECT_TRUE(CompareMatrices(point.EvalFullJacobian(*context),
+                              J.block(1, 0, 3, n_v), tolerance));
+  EXPECT_TRUE(CompareMatrices(normal_only.EvalActiveJacobian(*context),
+                              J.row(4), tolerance));
+  KinematicEvaluatorSet<double> evaluators(*plant_);
+  evaluators.add_evaluator(&point);
+  evaluators.add_evaluator(&normal_only);
+  evaluators.add_evaluator(&subset);
+  EXPECT_TRUE(CompareMatrices(evaluators.EvalActiveJacobian(*context),
+                              J.block(1, 0, 6, n_v), tolerance));
+  EXPECT_TRUE(CompareMatrices(evaluators.EvalActiveJacobianDotTimesV(*context),
+                              Jdotv.segment(1, 6), tolerance));
+}
+
 TEST_F(KinematicEvaluatorTest, DistanceEvaluatorTest) {
   const double tolerance = 1e-6;
 
@@ -59,27 +59,57 @@ template <typename T>
 MatrixX<T> WorldPointEvaluator<T>::EvalFullJacobian(
     const Context<T>& context) const {
   MatrixX<T> J(3, plant().num_velocities());
-
-  const drake::multibody::Frame<T>& world = plant().world_frame();
-
-  // .template cast<T> converts pt_A_, as a double, into type T
-  plant().CalcJacobianTranslationalVelocity(
-    context, drake::multibody::JacobianWrtVariable::kV,
-    frame_A_, pt_A_.template cast<T>(), world, world, &J);
-
-  return rotation_ * J;
+  EvalFullJacobianInto(context, J);
+  return J;
 }
 
 template <typename T>
 VectorX<T> WorldPointEvaluator<T>::EvalFullJacobianDotTimesV(
     const Context<T>& context) const {
-  const drake::multibody::Frame<T>& world = plant().world_frame();
+  VectorX<T> Jdot_times_V(3);
+  EvalFullJacobianDotTimesVInto(context, Jdot_times_V);
+  return Jdot_times_V;
+}
 
-  MatrixX<T> Jdot_times_V = plant().CalcBiasSpatialAcceleration(
-      context, drake::multibody::JacobianWrtVariable::kV, frame_A_,
-      pt_A_.template cast<T>(), world, world).translational();
+template <typename T>
+void WorldPointEvaluator<T>::EvalFullJacobianInto(
+    const Context<T>& context, Eigen::Ref<MatrixX<T>> J) const {
+  CalcWorldPointJacobian<T, 3>(plant(), context, frame_A_, pt_A_, rotation_,
+                               J);
+}
 
-  return rotation_ * Jdot_times_V;
+template <typename T>
+void WorldPointEvaluator<T>::EvalFullJacobianDotTimesVInto(
+    const Context<T>& context, Eigen::Ref<VectorX<T>> Jdotv) const {
+  CalcWorldPointJacobianDotTimesV<T, 3>(plant(), context, frame_A_, pt_A_,
+                                        rotation_, Jdotv);
+}
+
+template <typename T>
+void WorldPointEvaluator<T>::EvalActiveJacobianInto(
+    const Context<T>& context, Eigen::Ref<MatrixX<T>> J) const {
+  if (this->num_active() == 1) {
+    const Eigen::RowVector3d R = rotation_.row(this->active_inds().at(0));
+    // Evaluators are shared between threads, so the scratch space is per
+    // thread rather than a member
+    thread_local MatrixX<T> J_WQ;
+    CalcWorldPointJacobian<T, 1>(plant(), context, frame_A_, pt_A_, R, J,
+                                 &J_WQ);
+  } else {
+    KinematicEvaluator<T>::EvalActiveJacobianInto(context, J);
+  }
+}
+
+template <typename T>
+void WorldPointEvaluator<T>::EvalActiveJacobianDotTimesVInto(
+    const Context<T>& context, Eigen::Ref<VectorX<T>> Jdotv) const {
+  if (this->num_active() == 1) {
+    const Eigen::RowVector3d R = rotation_.row(this->active_inds().at(0));
+    CalcWorldPointJacobianDotTimesV<T, 1>(plant(), context, frame_A_, pt_A_,
+                                          R, Jdotv);
+  } else {
+    KinematicEvaluator<T>::EvalActiveJacobianDotTimesVInto(context, Jdotv);
+  }
 }
 
 DRAKE_DEFINE_CLASS_TEMPLATE_INSTANTIATIONS_ON_DEFAULT_NONSYMBOLIC_SCALARS(
@@ -7,6 +7,66 @@
 namespace dairlib {
 namespace multibody {
 
+/// Fixed-size kernel of WorldPointEvaluator (also used by DIRCON): writes
+/// R * J_WQ into J (kRows x nv), where J_WQ is the Jacobian w.r.t. v of the
+/// translational velocity in the world of the point Q, pt_A in frame_A.
+/// kRows is 3 for point contacts, 2 for the planar (xz) contacts of DIRCON and
+/// 1 for normal-only contacts (R is then the normal). With kRows = 3, the
+/// plant writes J_WQ directly into J, which is rotated in place, column by
+/// column. Otherwise J_WQ is written into the caller-owned J_WQ_scratch,
+/// which is only resized (to 3 x nv) on its first use, so that nothing is
+/// allocated when it is reused between calls.
+template <typename T, int kRows>
+void CalcWorldPointJacobian(const drake::multibody::MultibodyPlant<T>& plant,
+                            const drake::systems::Context<T>& context,
+                            const drake::multibody::Frame<T>& frame_A,
+                            const Eigen::Vector3d& pt_A,
+                            const Eigen::Matrix<double, kRows, 3>& R,
+                            Eigen::Ref<drake::MatrixX<T>> J,
+                            drake::MatrixX<T>* J_WQ_scratch = nullptr) {
+  DRAKE_DEMAND(J.rows() == kRows);
+  const auto& world = plant.world_frame();
+  if constexpr (kRows == 3) {
+    plant.CalcJacobianTranslationalVelocity(
+        context, drake::multibody::JacobianWrtVariable::kV, frame_A,
+        pt_A.template cast<T>(), world, world, &J);
+    if (R != Eigen::Matrix3d::Identity()) {
+      for (int i = 0; i < J.cols(); i++) {
+        const drake::Vector3<T> J_i = J.col(i);
+        J.col(i).noalias() = R * J_i;
+      }
+    }
+  } else {
+    DRAKE_DEMAND(J_WQ_scratch != nullptr);
+    drake::MatrixX<T>& J_WQ = *J_WQ_scratch;
+    J_WQ.resize(3, plant.num_velocities());
+    plant.CalcJacobianTranslationalVelocity(
+        context, drake::multibody::JacobianWrtVariable::kV, frame_A,
+        pt_A.template cast<T>(), world, world, &J_WQ);
+    J.noalias() = R * J_WQ;
+  }
+}
+
+/// Fixed-size kernel of WorldPointEvaluator (also used by DIRCON): writes
+/// R * Jdot_WQ * v into Jdotv (kRows), see CalcWorldPointJacobian
+template <typename T, int kRows>
+void CalcWorldPointJacobianDotTimesV(
+    const drake::multibody::MultibodyPlant<T>& plant,
+    const drake::systems::Context<T>& context,
+    const drake::multibody::Frame<T>& frame_A, const Eigen::Vector3d& pt_A,
+    const Eigen::Matrix<double, kRows, 3>& R,
+    Eigen::Ref<drake::VectorX<T>> Jdotv) {
+  DRAKE_DEMAND(Jdotv.size() == kRows);
+  const auto& world = plant.world_frame();
+  const drake::Vector3<T> Jdotv_WQ =
+      plant
+          .CalcBiasSpatialAcceleration(
+              context, drake::multibody::JacobianWrtVariable::kV, frame_A,
+              pt_A.template cast<T>(), world, world)
+          .translational();
+  Jdotv.noalias() = R * Jdotv_WQ;
+}
+
 /// Basic contact evaluator for a point on a body w.r.t. the world
 template <typename T>
 class WorldPointEvaluator :  public KinematicEvaluator<T> {
@@ -61,6 +121,22 @@ class WorldPointEvaluator :  public KinematicEvaluator<T> {
   drake::VectorX<T> EvalFullJacobianDotTimesV(
       const drake::systems::Context<T>& context) const;
 
+  /// Point contacts (all directions active) and normal-only contacts use the
+  /// fixed-size kernels above, writing directly into J and Jdotv
+  void EvalActiveJacobianInto(const drake::systems::Context<T>& context,
+                              Eigen::Ref<drake::MatrixX<T>> J) const override;
+
+  void EvalActiveJacobianDotTimesVInto(
+      const drake::systems::Context<T>& context,
+      Eigen::Ref<drake::VectorX<T>> Jdotv) const override;
+
+  void EvalFullJacobianInto(const drake::systems::Context<T>& context,
+                            Eigen::Ref<drake::MatrixX<T>> J) const override;
+
+  void EvalFullJacobianDotTimesVInto(
+      const drake::systems::Context<T>& context,
+      Eigen::Ref<drake::VectorX<T>> Jdotv) const override;
+
   using KinematicEvaluator<T>::plant;
 
  private:
@@ -0,0 +1,156 @@
+#include "multibody/multibody_batch_solver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "drake/common/drake_assert.h"
+#include "drake/common/text_logging.h"
+#include "drake/solvers/solve.h"
+
+namespace dairlib {
+namespace multibody {
+
+using Eigen::VectorXd;
+using std::vector;
+
+namespace {
+
+// Message of the exception being handled
+std::string CurrentExceptionMessage() {
+  try {
+    throw;
+  } catch (const std::exception& e) {
+    return e.what();
+  } catch (...) {
+    return "unknown exception";
+  }
+}
+
+}  // namespace
+
+BatchSolveResults SolveInParallel(
+    const std::function<std::unique_ptr<ParametricProgram>()>& make_program,
+    const vector<VectorXd>& parameters,
+    const vector<vector<VectorXd>>& initial_guesses, int num_threads) {
+  DRAKE_DEMAND(initial_guesses.size() == 1 ||
+               initial_guesses.size() == parameters.size());
+  auto guesses_for = [&initial_guesses](int parameter_index)
+      -> const vector<VectorXd>& {
+    return initial_guesses.size() == 1 ? initial_guesses[0]
+                                       : initial_guesses[parameter_index];
+  };
+
+  // Flatten the (parameter set, guess) pairs, preallocating one result slot
+  // per task so that each slot is only ever written by one worker
+  BatchSolveResults batch;
+  for (int i = 0; i < static_cast<int>(parameters.size()); i++) {
+    for (int j = 0; j < static_cast<int>(guesses_for(i).size()); j++) {
+      BatchSolveResult result;
+      result.parameter_index = i;
+      result.guess_index = j;
+      batch.results.push_back(result);
+    }
+  }
+
+  if (num_threads <= 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  num_threads = std::min<int>(num_threads, batch.results.size());
+
+  std::atomic<int> next_task{0};
+  std::mutex make_program_mutex;
+  // First exception of make_program, guarded by make_program_mutex
+  std::exception_ptr make_program_error;
+  // Exceptions must not escape the threads, which would terminate the process
+  auto worker = [&]() {
+    std::unique_ptr<ParametricProgram> program;
+    {
+      std::lock_guard<std::mutex> lock(make_program_mutex);
+      try {
+        program = make_program();
+      } catch (...) {
+        drake::log()->warn("SolveInParallel: make_program threw: {}",
+                           CurrentExceptionMessage());
+        if (!make_program_error) {
+          make_program_error = std::current_exception();
+        }
+        return;
+      }
+    }
+    int current_parameter_index = -1;
+    for (int task = next_task++; task < static_cast<int>(batch.results.size());
+         task = next_task++) {
+      BatchSolveResult& result = batch.results[task];
+      try {
+        if (result.parameter_index != current_parameter_index) {
+          // Unset until SetParameters succeeds, so that it is retried
+          current_parameter_index = -1;
+          program->SetParameters(parameters[result.parameter_index]);
+          current_parameter_index = result.parameter_index;
+        }
+        const VectorXd& guess =
+            guesses_for(result.parameter_index)[result.guess_index];
+
+        auto start = std::chrono::steady_clock::now();
+        const auto solution = drake::solvers::Solve(program->program(), guess);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        result.solution = solution.get_x_val();
+        result.solution_result = solution.get_solution_result();
+        result.is_success = solution.is_success();
+        result.optimal_cost = solution.get_optimal_cost();
+        result.solve_time = elapsed.count();
+      } catch (...) {
+        result.error = CurrentExceptionMessage();
+        drake::log()->warn(
+            "SolveInParallel: parameter set {}, guess {} threw: {}",
+            result.parameter_index, result.guess_index, result.error);
+        result.solution = VectorXd();
+        result.solution_result = drake::solvers::SolutionResult::kUnknownError;
+        result.is_success = false;
+        result.optimal_cost = NAN;
+        result.solve_time = 0;
+      }
+    }
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  vector<std::thread> workers;
+  for (int i = 0; i < num_threads; i++) {
+    workers.emplace_back(worker);
+  }
+  for (auto& thread : workers) {
+    thread.join();
+  }
+  // Only left over if no worker could make a program
+  if (next_task < static_cast<int>(batch.results.size())) {
+    std::rethrow_exception(make_program_error);
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  batch.wall_time = elapsed.count();
+
+  // Pick the lowest cost successful solve for each parameter set
+  batch.best = vector<int>(parameters.size(), -1);
+  batch.num_success = 0;
+  for (int i = 0; i < static_cast<int>(batch.results.size()); i++) {
+    const BatchSolveResult& result = batch.results[i];
+    if (!result.is_success) continue;
+    batch.num_success++;
+    int& best = batch.best[result.parameter_index];
+    if (best < 0 || result.optimal_cost < batch.results[best].optimal_cost) {
+      best = i;
+    }
+  }
+  return batch;
+}
+
+}  // namespace multibody
+}  // namespace dairlib
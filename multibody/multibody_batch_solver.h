@@ -0,0 +1,85 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "drake/solvers/mathematical_program.h"
+#include "drake/solvers/solution_result.h"
+
+namespace dairlib {
+namespace multibody {
+
+/// A family of programs that share the same structure (variables, constraint
+/// and cost objects) and differ only by a parameter vector, e.g. a bound or a
+/// constraint coefficient. SetParameters() updates the program in place, so
+/// the constraint structure is built once and reused between solves.
+class ParametricProgram {
+ public:
+  virtual ~ParametricProgram() = default;
+
+  virtual const drake::solvers::MathematicalProgram& program() const = 0;
+
+  /// Updates the program in place for the given parameters
+  virtual void SetParameters(const Eigen::VectorXd& parameters) = 0;
+};
+
+/// Outcome of a single solve within SolveInParallel
+struct BatchSolveResult {
+  int parameter_index;
+  int guess_index;
+  Eigen::VectorXd solution;
+  drake::solvers::SolutionResult solution_result;
+  bool is_success;
+  double optimal_cost;
+  double solve_time;
+  /// Message of the exception thrown by SetParameters or the solve, in which
+  /// case is_success is false and solution is empty. Empty otherwise.
+  std::string error;
+};
+
+struct BatchSolveResults {
+  /// One result per (parameter set, initial guess), ordered by parameter
+  /// index and then by guess index
+  std::vector<BatchSolveResult> results;
+  /// Index into results of the lowest cost successful solve for each
+  /// parameter set, or -1 if none of its solves succeeded
+  std::vector<int> best;
+  /// Number of successful solves
+  int num_success;
+  /// Wall clock time of the whole batch
+  double wall_time;
+};
+
+/// Solves a ParametricProgram for every parameter set from every initial
+/// guess, in parallel on a pool of worker threads.
+///
+/// Each worker calls make_program once and keeps the result for all of its
+/// solves, so every thread owns its own program, constraint objects and
+/// plant contexts (e.g. those owned by MultibodyProgram), and the program is
+/// only rebuilt once per thread rather than once per solve. Workers pull
+/// (parameter set, guess) pairs in order, so SetParameters() is only called
+/// when the parameter set changes.
+///
+/// The solver chosen by drake::solvers::Solve must be reentrant (SNOPT is).
+///
+/// An exception thrown by SetParameters or a solve only fails that solve (see
+/// BatchSolveResult::error). A worker whose make_program throws stops, and the
+/// others take over its solves; if make_program throws on every worker, the
+/// first exception is rethrown.
+///
+/// @param make_program creates a new program. Calls are serialized.
+/// @param parameters the parameter sets
+/// @param initial_guesses the initial guesses for each parameter set. If it
+///    has a single element, those guesses are used for every parameter set.
+/// @param num_threads the number of workers. 0 uses
+///    std::thread::hardware_concurrency()
+BatchSolveResults SolveInParallel(
+    const std::function<std::unique_ptr<ParametricProgram>()>& make_program,
+    const std::vector<Eigen::VectorXd>& parameters,
+    const std::vector<std::vector<Eigen::VectorXd>>& initial_guesses,
+    int num_threads = 0);
+
+}  // namespace multibody
+}  // namespace dairlib
@@ -0,0 +1,120 @@
+#include "multibody/quaternion_integration.h"
+
+#include <cmath>
+
+#include "drake/math/autodiff_gradient.h"
+
+namespace dairlib {
+namespace multibody {
+
+using drake::AutoDiffXd;
+using drake::Matrix4;
+using drake::Vector3;
+using drake::Vector4;
+using Eigen::Matrix;
+using Eigen::MatrixXd;
+using Eigen::Vector3d;
+using Eigen::Vector4d;
+
+namespace {
+// Below this squared angle, the trigonometric ratios are replaced by their
+// Taylor expansions. The truncation error is O(theta^4) relative.
+const double kSmallAngleSquared = 1e-6;
+}  // namespace
+
+template <typename T>
+Vector4<T> QuaternionExp(const Vector3<T>& phi) {
+  using std::cos;
+  using std::sin;
+  using std::sqrt;
+  const T theta_sq = phi.squaredNorm();
+  T cos_half;
+  T sinc_half;  // sin(theta/2) / theta
+  if (theta_sq < kSmallAngleSquared) {
+    cos_half = 1 - theta_sq / 8;
+    sinc_half = 0.5 - theta_sq / 48;
+  } else {
+    const T theta = sqrt(theta_sq);
+    cos_half = cos(theta / 2);
+    sinc_half = sin(theta / 2) / theta;
+  }
+  Vector4<T> q;
+  q << cos_half, sinc_half * phi;
+  return q;
+}
+
+Matrix<double, 4, 3> QuaternionExpJacobian(const Vector3d& phi) {
+  // With s = sin(theta/2)/theta, w = cos(theta/2) and v = s phi,
+  //   dw/dphi = -s/2 phi^T,  dv/dphi = s I + (ds/dtheta / theta) phi phi^T
+  const double theta_sq = phi.squaredNorm();
+  double sinc_half;
+  double dsinc_half;  // (ds/dtheta) / theta
+  if (theta_sq < kSmallAngleSquared) {
+    sinc_half = 0.5 - theta_sq / 48;
+    dsinc_half = -1.0 / 24 + theta_sq / 960;
+  } else {
+    const double theta = std::sqrt(theta_sq);
+    sinc_half = std::sin(theta / 2) / theta;
+    dsinc_half = (0.5 * theta * std::cos(theta / 2) - std::sin(theta / 2)) /
+                 (theta_sq * theta);
+  }
+  Matrix<double, 4, 3> J;
+  J.row(0) = -0.5 * sinc_half * phi.transpose();
+  J.bottomRows<3>() = sinc_half * Eigen::Matrix3d::Identity() +
+                      dsinc_half * phi * phi.transpose();
+  return J;
+}
+
+template <>
+Vector4<AutoDiffXd> QuaternionExp(const Vector3<AutoDiffXd>& phi) {
+  const Vector3d phi_val = drake::math::autoDiffToValueMatrix(phi);
+  const MatrixXd phi_grad = drake::math::autoDiffToGradientMatrix(phi);
+  Vector4<AutoDiffXd> q;
+  drake::math::initializeAutoDiffGivenGradientMatrix(
+      QuaternionExp<double>(phi_val),
+      QuaternionExpJacobian(phi_val) * phi_grad, q);
+  return q;
+}
+
+template <typename T>
+Matrix4<T> QuaternionLeftMultiplyMatrix(const Vector4<T>& p) {
+  Matrix4<T> L;
+  L << p(0), -p(1), -p(2), -p(3),
+       p(1),  p(0), -p(3),  p(2),
+       p(2),  p(3),  p(0), -p(1),
+       p(3), -p(2),  p(1),  p(0);
+  return L;
+}
+
+template <typename T>
+Matrix4<T> QuaternionRightMultiplyMatrix(const Vector4<T>& q) {
+  Matrix4<T> R;
+  R << q(0), -q(1), -q(2), -q(3),
+       q(1),  q(0),  q(3), -q(2),
+       q(2), -q(3),  q(0),  q(1),
+       q(3),  q(2), -q(1),  q(0);
+  return R;
+}
+
+template <typename T>
+Vector4<T> QuaternionProduct(const Vector4<T>& p, const Vector4<T>& q) {
+  return QuaternionLeftMultiplyMatrix(p) * q;
+}
+
+template <typename T>
+Vector4<T> IntegrateQuaternion(const Vector4<T>& q, const Vector3<T>& phi) {
+  return QuaternionRightMultiplyMatrix(q) * QuaternionExp(phi);
+}
+
+template Vector4<double> QuaternionExp(const Vector3<double>& phi);  // NOLINT
+template Matrix4<double> QuaternionLeftMultiplyMatrix(const Vector4<double>& p);  // NOLINT
+template Matrix4<AutoDiffXd> QuaternionLeftMultiplyMatrix(const Vector4<AutoDiffXd>& p);  // NOLINT
+template Matrix4<double> QuaternionRightMultiplyMatrix(const Vector4<double>& q);  // NOLINT
+template Matrix4<AutoDiffXd> QuaternionRightMultiplyMatrix(const Vector4<AutoDiffXd>& q);  // NOLINT
+template Vector4<double> QuaternionProduct(const Vector4<double>& p, const Vector4<double>& q);  // NOLINT
+template Vector4<AutoDiffXd> QuaternionProduct(const Vector4<AutoDiffXd>& p, const Vector4<AutoDiffXd>& q);  // NOLINT
+template Vector4<double> IntegrateQuaternion(const Vector4<double>& q, const Vector3<double>& phi);  // NOLINT
+template Vector4<AutoDiffXd> IntegrateQuaternion(const Vector4<AutoDiffXd>& q, const Vector3<AutoDiffXd>& phi);  // NOLINT
+
+}  // namespace multibody
+}  // namespace dairlib
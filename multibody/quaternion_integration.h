@@ -0,0 +1,53 @@
+#pragma once
+
+#include "drake/common/autodiff.h"
+#include "drake/common/eigen_types.h"
+
+namespace dairlib {
+namespace multibody {
+
+/// Quaternion integration on the unit sphere, using the exponential map.
+///
+/// Quaternions are ordered [w, x, y, z], as in the generalized positions of a
+/// quaternion floating base, and rotation vectors are expressed in the parent
+/// (world) frame, like the angular velocity of the floating base. Then
+///   qdot = 1/2 [0; omega] * q,
+/// and for a constant omega over h, q(h) = exp(h omega) * q(0) exactly.
+///
+/// The AutoDiffXd versions propagate gradients with closed-form Jacobians, so
+/// they are well defined at zero rotation and cheaper than differentiating
+/// through the trigonometric functions.
+
+/// Unit quaternion of the rotation by the rotation vector phi,
+///   [cos(|phi|/2); sin(|phi|/2) phi/|phi|]
+template <typename T>
+drake::Vector4<T> QuaternionExp(const drake::Vector3<T>& phi);
+
+template <>
+drake::Vector4<drake::AutoDiffXd> QuaternionExp(
+    const drake::Vector3<drake::AutoDiffXd>& phi);
+
+/// Jacobian of QuaternionExp(phi) with respect to phi (4 x 3)
+Eigen::Matrix<double, 4, 3> QuaternionExpJacobian(const Eigen::Vector3d& phi);
+
+/// Matrix L(p) such that p * q = L(p) q
+template <typename T>
+drake::Matrix4<T> QuaternionLeftMultiplyMatrix(const drake::Vector4<T>& p);
+
+/// Matrix R(q) such that p * q = R(q) p
+template <typename T>
+drake::Matrix4<T> QuaternionRightMultiplyMatrix(const drake::Vector4<T>& q);
+
+/// Quaternion product p * q
+template <typename T>
+drake::Vector4<T> QuaternionProduct(const drake::Vector4<T>& p,
+                                    const drake::Vector4<T>& q);
+
+/// Rotates q by the world frame rotation vector phi (e.g. angular velocity
+/// times timestep), exp(phi) * q. Preserves the norm of q.
+template <typename T>
+drake::Vector4<T> IntegrateQuaternion(const drake::Vector4<T>& q,
+                                      const drake::Vector3<T>& phi);
+
+}  // namespace multibody
+}  // namespace dairlib
@@ -0,0 +1,180 @@
+#include "multibody/multibody_batch_solver.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/solvers/solve.h"
+
+namespace dairlib {
+namespace multibody {
+namespace {
+
+using drake::CompareMatrices;
+using Eigen::Matrix2d;
+using Eigen::Vector2d;
+using Eigen::VectorXd;
+using std::vector;
+
+// Closest point to the parameter outside of the unit circle, which is
+// nonconvex, so the solution depends on the initial guess
+class ClosestPointProgram : public ParametricProgram {
+ public:
+  ClosestPointProgram() {
+    x_ = program_.NewContinuousVariables(2, "x");
+    cost_ = program_.AddQuadraticCost(2 * Matrix2d::Identity(),
+                                      Vector2d::Zero(), x_);
+    program_.AddConstraint(x_(0) * x_(0) + x_(1) * x_(1) >= 1);
+  }
+
+  const drake::solvers::MathematicalProgram& program() const override {
+    return program_;
+  }
+
+  void SetParameters(const VectorXd& parameters) override {
+    cost_.evaluator()->UpdateCoefficients(2 * Matrix2d::Identity(),
+                                          -2 * parameters,
+                                          parameters.squaredNorm());
+  }
+
+ private:
+  drake::solvers::MathematicalProgram program_;
+  drake::solvers::VectorXDecisionVariable x_;
+  drake::solvers::Binding<drake::solvers::QuadraticCost> cost_;
+};
+
+// Throws for a given parameter set
+class ThrowingProgram : public ClosestPointProgram {
+ public:
+  explicit ThrowingProgram(const VectorXd& bad_parameters)
+      : bad_parameters_(bad_parameters) {}
+
+  void SetParameters(const VectorXd& parameters) override {
+    if (parameters == bad_parameters_) {
+      throw std::runtime_error("bad parameters");
+    }
+    ClosestPointProgram::SetParameters(parameters);
+  }
+
+ private:
+  const VectorXd bad_parameters_;
+};
+
+class MultibodyBatchSolverTest : public ::testing::Test {
+ protected:
+  MultibodyBatchSolverTest()
+      : parameters_({Vector2d(0.1, 0.2), Vector2d(2, 0), Vector2d(-0.3, 0),
+                     Vector2d(0, 1.5), Vector2d(0.5, -0.5)}),
+        guesses_({{Vector2d(1, 1), Vector2d(-1, 0.5), Vector2d(0, -2)}}) {}
+
+  void ExpectMatchesSequential(const BatchSolveResults& batch,
+                               int failed_parameter_index = -1) const;
+
+  vector<VectorXd> parameters_;
+  vector<vector<VectorXd>> guesses_;
+};
+
+// Expects every solve to match a sequential solve of a freshly built program,
+// except those of failed_parameter_index, which threw
+void MultibodyBatchSolverTest::ExpectMatchesSequential(
+    const BatchSolveResults& batch, int failed_parameter_index) const {
+  const int num_guesses = guesses_[0].size();
+  ASSERT_EQ(batch.results.size(), parameters_.size() * num_guesses);
+  ASSERT_EQ(batch.best.size(), parameters_.size());
+  int num_success = 0;
+  for (int i = 0; i < static_cast<int>(parameters_.size()); i++) {
+    int best = -1;
+    for (int j = 0; j < num_guesses; j++) {
+      const int index = i * num_guesses + j;
+      const BatchSolveResult& result = batch.results[index];
+      EXPECT_EQ(result.parameter_index, i);
+      EXPECT_EQ(result.guess_index, j);
+      if (i == failed_parameter_index) {
+        EXPECT_EQ(result.error, "bad parameters");
+        EXPECT_EQ(result.solution_result,
+                  drake::solvers::SolutionResult::kUnknownError);
+        EXPECT_FALSE(result.is_success);
+        EXPECT_EQ(result.solution.size(), 0);
+        continue;
+      }
+      EXPECT_EQ(result.error, "");
+
+      ClosestPointProgram program;
+      program.SetParameters(parameters_[i]);
+      const auto expected =
+          drake::solvers::Solve(program.program(), guesses_[0][j]);
+      EXPECT_EQ(result.solution_result, expected.get_solution_result());
+      EXPECT_EQ(result.is_success, expected.is_success());
+      EXPECT_TRUE(CompareMatrices(result.solution, expected.get_x_val(), 1e-8));
+      if (!expected.is_success()) continue;
+      EXPECT_NEAR(result.optimal_cost, expected.get_optimal_cost(), 1e-8);
+      num_success++;
+      if (best < 0 ||
+          result.optimal_cost < batch.results[best].optimal_cost) {
+        best = index;
+      }
+    }
+    EXPECT_EQ(batch.best[i], best);
+  }
+  EXPECT_EQ(batch.num_success, num_success);
+  EXPECT_GT(batch.num_success, 0);
+
+  // Sanity check of the parameters: a point outside of the circle is its own
+  // closest point
+  ASSERT_GE(batch.best[1], 0);
+  EXPECT_TRUE(CompareMatrices(batch.results[batch.best[1]].solution,
+                              parameters_[1], 1e-6));
+}
+
+TEST_F(MultibodyBatchSolverTest, MatchesSequential) {
+  for (int num_threads : {1, 4}) {
+    SCOPED_TRACE("num_threads = " + std::to_string(num_threads));
+    ExpectMatchesSequential(SolveInParallel(
+        [] { return std::make_unique<ClosestPointProgram>(); }, parameters_,
+        guesses_, num_threads));
+  }
+}
+
+TEST_F(MultibodyBatchSolverTest, SetParametersThrows) {
+  const int failed_parameter_index = 2;
+  const VectorXd bad_parameters = parameters_[failed_parameter_index];
+  for (int num_threads : {1, 4}) {
+    SCOPED_TRACE("num_threads = " + std::to_string(num_threads));
+    ExpectMatchesSequential(
+        SolveInParallel(
+            [&] { return std::make_unique<ThrowingProgram>(bad_parameters); },
+            parameters_, guesses_, num_threads),
+        failed_parameter_index);
+  }
+}
+
+// The other workers take over the solves of a worker whose make_program threw
+TEST_F(MultibodyBatchSolverTest, MakeProgramThrowsOnce) {
+  int num_calls = 0;
+  ExpectMatchesSequential(SolveInParallel(
+      [&]() -> std::unique_ptr<ParametricProgram> {
+        if (num_calls++ == 0) throw std::runtime_error("make_program");
+        return std::make_unique<ClosestPointProgram>();
+      },
+      parameters_, guesses_, 4));
+}
+
+TEST_F(MultibodyBatchSolverTest, MakeProgramAlwaysThrows) {
+  for (int num_threads : {1, 4}) {
+    SCOPED_TRACE("num_threads = " + std::to_string(num_threads));
+    EXPECT_THROW(SolveInParallel(
+                     []() -> std::unique_ptr<ParametricProgram> {
+                       throw std::runtime_error("make_program");
+                     },
+                     parameters_, guesses_, num_threads),
+                 std::runtime_error);
+  }
+}
+
+}  // namespace
+}  // namespace multibody
+}  // namespace dairlib
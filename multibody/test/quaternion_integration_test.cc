@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/math/autodiff.h"
+#include "drake/math/autodiff_gradient.h"
+#include "multibody/quaternion_integration.h"
+
+namespace dairlib {
+namespace multibody {
+namespace {
+
+using drake::AutoDiffXd;
+using drake::CompareMatrices;
+using drake::Vector3;
+using drake::Vector4;
+using Eigen::Matrix;
+using Eigen::MatrixXd;
+using Eigen::Vector3d;
+using Eigen::Vector4d;
+
+Matrix<double, 4, 3> NumericalExpJacobian(const Vector3d& phi) {
+  const double eps = 1e-6;
+  Matrix<double, 4, 3> J;
+  for (int i = 0; i < 3; i++) {
+    Vector3d dphi = Vector3d::Zero();
+    dphi(i) = eps;
+    J.col(i) = (QuaternionExp<double>(phi + dphi) -
+                QuaternionExp<double>(phi - dphi)) / (2 * eps);
+  }
+  return J;
+}
+
+TEST(QuaternionIntegrationTest, ExpOfZero) {
+  EXPECT_TRUE(CompareMatrices(QuaternionExp<double>(Vector3d::Zero()),
+                              Vector4d(1, 0, 0, 0), 1e-15));
+
+  // The gradient at zero rotation is well defined, [0; I/2]
+  Matrix<double, 4, 3> J_expected = Matrix<double, 4, 3>::Zero();
+  J_expected.bottomRows<3>() = 0.5 * Eigen::Matrix3d::Identity();
+  EXPECT_TRUE(CompareMatrices(QuaternionExpJacobian(Vector3d::Zero()),
+                              J_expected, 1e-15));
+
+  const Vector3<AutoDiffXd> phi_ad =
+      drake::math::initializeAutoDiff(Vector3d::Zero());
+  const Vector4<AutoDiffXd> q_ad = QuaternionExp(phi_ad);
+  EXPECT_TRUE(CompareMatrices(drake::math::autoDiffToGradientMatrix(q_ad),
+                              J_expected, 1e-15));
+}
+
+TEST(QuaternionIntegrationTest, ExpJacobian) {
+  for (const Vector3d& phi :
+       {Vector3d(1e-5, -2e-5, 3e-5), Vector3d(2e-3, 1e-3, -1e-3),
+        Vector3d(0.3, -0.2, 0.5), Vector3d(2.0, 1.0, -1.5)}) {
+    const Vector4d q = QuaternionExp<double>(phi);
+    EXPECT_NEAR(q.norm(), 1, 1e-12);
+    EXPECT_TRUE(CompareMatrices(QuaternionExpJacobian(phi),
+                                NumericalExpJacobian(phi), 1e-8));
+  }
+}
+
+TEST(QuaternionIntegrationTest, MatchesAngleAxis) {
+  const Vector4d q = Vector4d(0.9, 0.1, -0.3, 0.2).normalized();
+  const Vector3d phi(0.4, -0.7, 0.1);
+
+  const Eigen::Quaterniond expected =
+      Eigen::Quaterniond(Eigen::AngleAxisd(phi.norm(), phi.normalized())) *
+      Eigen::Quaterniond(q(0), q(1), q(2), q(3));
+  const Vector4d q_next = IntegrateQuaternion<double>(q, phi);
+  EXPECT_TRUE(CompareMatrices(
+      q_next,
+      Vector4d(expected.w(), expected.x(), expected.y(), expected.z()),
+      1e-14));
+  EXPECT_NEAR(q_next.norm(), 1, 1e-14);
+
+  // The products agree with the multiplication matrices
+  EXPECT_TRUE(CompareMatrices(
+      QuaternionProduct<double>(q, q_next),
+      QuaternionRightMultiplyMatrix<double>(q_next) * q, 1e-15));
+}
+
+TEST(QuaternionIntegrationTest, AutoDiffGradient) {
+  Eigen::VectorXd x(7);
+  x << Vector4d(0.9, 0.1, -0.3, 0.2).normalized(), 0.4, -0.7, 0.1;
+  const auto x_ad = drake::math::initializeAutoDiff(x);
+  const Vector4<AutoDiffXd> q_next = IntegrateQuaternion<AutoDiffXd>(
+      x_ad.head<4>(), x_ad.tail<3>());
+
+  const double eps = 1e-6;
+  MatrixXd numerical(4, 7);
+  for (int i = 0; i < 7; i++) {
+    Eigen::VectorXd dx = Eigen::VectorXd::Zero(7);
+    dx(i) = eps;
+    const Eigen::VectorXd xp = x + dx;
+    const Eigen::VectorXd xm = x - dx;
+    const Vector4d q_p = IntegrateQuaternion<double>(xp.head<4>(),
+                                                     xp.tail<3>());
+    const Vector4d q_m = IntegrateQuaternion<double>(xm.head<4>(),
+                                                     xm.tail<3>());
+    numerical.col(i) = (q_p - q_m) / (2 * eps);
+  }
+  EXPECT_TRUE(CompareMatrices(drake::math::autoDiffToGradientMatrix(q_next),
+                              numerical, 1e-8));
+}
+
+}  // namespace
+}  // namespace multibody
+}  // namespace dairlib
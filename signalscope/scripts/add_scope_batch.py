@@ -0,0 +1,12 @@
+'''
+Plots a signal recorded by AsyncVectorScope. The scope publishes batches of
+samples on SCOPE_<signal name>; msg.latest holds the most recent sample of each
+batch, which is what signal-scope plots.
+Set the channel and the number of elements to the signal you want to plot.
+'''
+
+channel = 'SCOPE_debug'
+num_elements = 3
+
+addPlot()
+addSignals(channel, msg.utime, msg.latest, range(num_elements))
@@ -1,4 +1,8 @@
 #include "solvers/nonlinear_constraint.h"
+
+#include <algorithm>
+#include <memory>
+
 #include "drake/math/autodiff.h"
 #include "drake/math/autodiff_gradient.h"
 #include "drake/common/default_scalars.h"
@@ -17,7 +21,11 @@ NonlinearConstraint<T>::NonlinearConstraint(int num_constraints, int num_vars,
     const VectorXd& lb, const VectorXd& ub,
     const std::string& description, double eps)
     : Constraint(num_constraints, num_vars, lb, ub, description),
-    eps_(eps) {}
+    eps_(eps) {
+  for (int i = 0; i < num_vars; i++) {
+    colors_.push_back({i});
+  }
+}
 
 template <typename T>
 void NonlinearConstraint<T>::SetConstraintScaling(
@@ -25,6 +33,81 @@ void NonlinearConstraint<T>::SetConstraintScaling(
   constraint_scaling_ = map;
 }
 
+template <typename T>
+void NonlinearConstraint<T>::SetGradientSparsityPattern(
+    const std::vector<std::pair<int, int>>& gradient_sparsity_pattern) {
+  Constraint::SetGradientSparsityPattern(gradient_sparsity_pattern);
+
+  column_rows_.assign(num_vars(), {});
+  for (const auto& [row, col] : gradient_sparsity_pattern) {
+    column_rows_[col].push_back(row);
+  }
+
+  // Greedy coloring: a column joins the first color with none of its rows
+  colors_.clear();
+  std::vector<std::vector<bool>> color_rows;
+  for (int col = 0; col < num_vars(); col++) {
+    if (column_rows_[col].empty()) continue;
+    size_t color = 0;
+    for (; color < colors_.size(); color++) {
+      if (std::none_of(column_rows_[col].begin(), column_rows_[col].end(),
+                       [&](int row) { return color_rows[color][row]; })) {
+        break;
+      }
+    }
+    if (color == colors_.size()) {
+      colors_.emplace_back();
+      color_rows.emplace_back(num_constraints(), false);
+    }
+    colors_[color].push_back(col);
+    for (int row : column_rows_[col]) {
+      color_rows[color][row] = true;
+    }
+  }
+}
+
+template <typename T>
+void NonlinearConstraint<T>::SetNumDifferencingThreads(int num_threads) {
+  if (num_threads > 1) {
+    differencing_pool_ = std::make_unique<WorkerPool>(num_threads);
+  } else {
+    differencing_pool_.reset();
+  }
+}
+
+template <typename T>
+void NonlinearConstraint<T>::DetectGradientSparsityPattern(
+    const Eigen::Ref<const VectorXd>& x, int num_samples) {
+  std::vector<std::vector<bool>> is_nonzero(
+      num_vars(), std::vector<bool>(num_constraints(), false));
+  for (int sample = 0; sample < num_samples; sample++) {
+    VectorXd x_sample = x;
+    if (sample > 0) {
+      x_sample += 1e-2 * VectorXd::Random(x.size()).cwiseProduct(
+                             (1 + x.array().abs()).matrix());
+    }
+    VectorX<T> y0, yi;
+    EvaluateConstraint(x_sample.cast<T>(), &y0);
+    for (int i = 0; i < x.size(); i++) {
+      const double step = 1e-4 * (1 + std::abs(x_sample(i)));
+      x_sample(i) += step;
+      EvaluateConstraint(x_sample.cast<T>(), &yi);
+      x_sample(i) -= step;
+      for (int j = 0; j < yi.size(); j++) {
+        if (yi(j) != y0(j)) is_nonzero[i][j] = true;
+      }
+    }
+  }
+
+  std::vector<std::pair<int, int>> gradient_sparsity_pattern;
+  for (int i = 0; i < num_vars(); i++) {
+    for (int j = 0; j < num_constraints(); j++) {
+      if (is_nonzero[i][j]) gradient_sparsity_pattern.emplace_back(j, i);
+    }
+  }
+  SetGradientSparsityPattern(gradient_sparsity_pattern);
+}
+
 template <typename T>
 template <typename U>
 void NonlinearConstraint<T>::ScaleConstraint(VectorX<U>* y) const {
@@ -69,20 +152,66 @@ void NonlinearConstraint<double>::DoEval(
     const Eigen::Ref<const AutoDiffVecXd>& x, AutoDiffVecXd* y) const {
   MatrixXd original_grad = drake::math::autoDiffToGradientMatrix(x);
 
-  // forward differencing
   VectorXd x_val = drake::math::autoDiffToValueMatrix(x);
-  VectorXd y0, yi;
+  VectorXd y0;
   EvaluateConstraint(x_val, &y0);
 
-  MatrixXd dy = MatrixXd(y0.size(), x_val.size());
-  for (int i = 0; i < x_val.size(); i++) {
-    x_val(i) += eps_;
-    EvaluateConstraint(x_val, &yi);
-    x_val(i) -= eps_;
-    dy.col(i) = (yi - y0) / eps_;
+  // Each color perturbs all of its columns at once. Since no two columns of a
+  // color share a nonzero row, each row of the difference belongs to a single
+  // column.
+  const bool central =
+      finite_difference_method_ == FiniteDifferenceMethod::kCentral;
+  const int num_colors = colors_.size();
+  MatrixXd dy = MatrixXd::Zero(y0.size(), x_val.size());
+  const int num_threads =
+      differencing_pool_ ? differencing_pool_->num_threads() : 1;
+  std::vector<VectorXd> x_perturbed(num_threads, x_val);
+  std::vector<VectorXd> y_plus(num_threads), y_minus(num_threads);
+  // Each color writes to the disjoint columns of its own variables, and uses
+  // the scratch vectors of the thread running it
+  auto difference_color = [&](int c, int thread) {
+    VectorXd& x_c = x_perturbed[thread];
+    VectorXd& y_plus_c = y_plus[thread];
+    VectorXd& y_minus_c = y_minus[thread];
+    const std::vector<int>& columns = colors_[c];
+    for (int i : columns) x_c(i) = x_val(i) + eps_;
+    EvaluateConstraint(x_c, &y_plus_c);
+    if (central) {
+      for (int i : columns) x_c(i) = x_val(i) - eps_;
+      EvaluateConstraint(x_c, &y_minus_c);
+    } else {
+      y_minus_c = y0;
+    }
+    const double step = central ? 2 * eps_ : eps_;
+    for (int i : columns) {
+      x_c(i) = x_val(i);
+      if (column_rows_.empty()) {
+        dy.col(i) = (y_plus_c - y_minus_c) / step;
+      } else {
+        for (int row : column_rows_[i]) {
+          dy(row, i) = (y_plus_c(row) - y_minus_c(row)) / step;
+        }
+      }
+    }
+  };
+
+  if (differencing_pool_) {
+    differencing_pool_->ParallelFor(num_colors, difference_color);
+  } else {
+    for (int c = 0; c < num_colors; c++) {
+      difference_color(c, 0);
+    }
+  }
+
+  // The solvers typically pass x with an identity gradient, in which case the
+  // chain rule product is skipped
+  if (original_grad.rows() == original_grad.cols() &&
+      original_grad.isIdentity(0)) {
+    drake::math::initializeAutoDiffGivenGradientMatrix(y0, dy, *y);
+  } else {
+    drake::math::initializeAutoDiffGivenGradientMatrix(y0, dy * original_grad,
+                                                       *y);
   }
-  drake::math::initializeAutoDiffGivenGradientMatrix(y0, dy * original_grad,
-                                                     *y);
 
   this->ScaleConstraint<AutoDiffXd>(y);
 }
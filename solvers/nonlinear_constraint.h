@@ -1,17 +1,35 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+#include "common/worker_pool.h"
 #include "drake/common/symbolic.h"
 #include "drake/solvers/constraint.h"
 
 namespace dairlib {
 namespace solvers {
 
+/// Finite difference scheme used by NonlinearConstraint<double>
+///  - kForward: (f(x + eps) - f(x)) / eps, one evaluation per color
+///  - kCentral: (f(x + eps) - f(x - eps)) / (2 eps), two evaluations per
+///    color, with O(eps^2) instead of O(eps) truncation error
+enum class FiniteDifferenceMethod { kForward, kCentral };
+
 /// Abstract class for nonlinear constraints that manages 
 /// manages evaluation of functions and numerical differentiation
 /// 
 /// Subclasses should implement the method EvaluateConstraint
+///
+/// With T = double, the gradient is computed by finite differences. By default
+/// every variable is perturbed separately (one evaluation per variable). If
+/// the sparsity pattern of the gradient is known (SetGradientSparsityPattern)
+/// or detected (DetectGradientSparsityPattern), the columns are colored so
+/// that variables which do not share a constraint row are perturbed together,
+/// taking one evaluation per color instead. The colors can also be evaluated
+/// on several threads (SetNumDifferencingThreads).
 template <typename T>
 class NonlinearConstraint : public drake::solvers::Constraint {
  public:
@@ -38,6 +56,38 @@ class NonlinearConstraint : public drake::solvers::Constraint {
 
   void SetConstraintScaling(const std::unordered_map<int, double>& map);
 
+  /// Declares the nonzero (row, column) entries of the constraint gradient and
+  /// colors the columns for finite differencing. Also forwards the pattern to
+  /// drake::solvers::EvaluatorBase, which solvers such as SNOPT use.
+  void SetGradientSparsityPattern(
+      const std::vector<std::pair<int, int>>& gradient_sparsity_pattern);
+
+  /// Detects the sparsity pattern by perturbing one variable at a time at x
+  /// and at num_samples - 1 random points around x, and sets it with
+  /// SetGradientSparsityPattern. An entry is kept if it changed at any of the
+  /// points, so the pattern is only as reliable as the sampling: entries which
+  /// are exactly zero at all the points are treated as structural zeros.
+  void DetectGradientSparsityPattern(const Eigen::Ref<const Eigen::VectorXd>& x,
+                                     int num_samples = 3);
+
+  void SetFiniteDifferenceMethod(FiniteDifferenceMethod method) {
+    finite_difference_method_ = method;
+  }
+
+  /// Evaluates the finite difference colors on num_threads threads, which are
+  /// started here and reused by every evaluation. Only use this if
+  /// EvaluateConstraint is safe to call concurrently (e.g. it does not write
+  /// to a shared plant context).
+  void SetNumDifferencingThreads(int num_threads);
+
+  /// Number of constraint evaluations per finite difference gradient,
+  /// excluding the nominal one
+  int num_differencing_evaluations() const {
+    return colors_.size() *
+           (finite_difference_method_ == FiniteDifferenceMethod::kCentral ? 2
+                                                                          : 1);
+  }
+
   virtual void EvaluateConstraint(const Eigen::Ref<const drake::VectorX<T>>& x,
                                   drake::VectorX<T>* y) const = 0;
 
@@ -46,6 +96,14 @@ class NonlinearConstraint : public drake::solvers::Constraint {
   void ScaleConstraint(drake::VectorX<U>* y) const;
   std::unordered_map<int, double> constraint_scaling_;
   double eps_;
+  FiniteDifferenceMethod finite_difference_method_ =
+      FiniteDifferenceMethod::kForward;
+  // Null when differencing on the calling thread only
+  std::unique_ptr<WorkerPool> differencing_pool_;
+  // Columns perturbed together, one entry per color
+  std::vector<std::vector<int>> colors_;
+  // Nonzero rows of each column, empty if the gradient is dense
+  std::vector<std::vector<int>> column_rows_;
 };
 
 }  // namespace solvers
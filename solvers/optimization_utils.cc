@@ -1,18 +1,149 @@
 #include "solvers/optimization_utils.h"
 
+#include <algorithm>
+#include <map>
+#include <thread>
+#include <vector>
+
 using Eigen::MatrixXd;
 using Eigen::VectorXd;
+using drake::solvers::BoundingBoxConstraint;
 using drake::solvers::Constraint;
 using drake::solvers::Binding;
+using drake::solvers::EvaluatorBase;
+using drake::solvers::LinearConstraint;
+using drake::solvers::LinearCost;
+using drake::solvers::QuadraticCost;
 using drake::solvers::MathematicalProgram;
 using drake::AutoDiffVecXd;
 using drake::math::initializeAutoDiff;
 using drake::math::autoDiffToGradientMatrix;
 using drake::math::autoDiffToValueMatrix;
+using Eigen::SparseMatrix;
+using Eigen::Triplet;
+using std::vector;
 
 namespace dairlib {
 namespace solvers {
 
+namespace {
+
+// Groups the bindings by evaluator, so that a shared evaluator is only ever
+// evaluated from one thread
+template <typename C>
+vector<vector<int>> GroupByEvaluator(const vector<Binding<C>>& bindings) {
+  std::map<const EvaluatorBase*, int> group_index;
+  vector<vector<int>> groups;
+  for (size_t i = 0; i < bindings.size(); i++) {
+    auto it = group_index.emplace(bindings[i].evaluator().get(), groups.size());
+    if (it.second) groups.emplace_back();
+    groups[it.first->second].push_back(i);
+  }
+  return groups;
+}
+
+// Calls task(group, thread) for every group, distributing the groups over
+// num_threads threads
+template <typename F>
+void ForEachGroup(int num_groups, int num_threads, const F& task) {
+  num_threads = std::max(1, std::min(num_threads, num_groups));
+  auto run = [&](int thread) {
+    for (int g = thread; g < num_groups; g += num_threads) {
+      task(g, thread);
+    }
+  };
+  vector<std::thread> threads;
+  for (int t = 1; t < num_threads; t++) {
+    threads.emplace_back(run, t);
+  }
+  run(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+vector<int> VariableIndices(
+    const MathematicalProgram& prog,
+    const drake::solvers::VectorXDecisionVariable& vars) {
+  vector<int> indices(vars.size());
+  for (int i = 0; i < vars.size(); i++) {
+    indices[i] = prog.FindDecisionVariableIndex(vars(i));
+  }
+  return indices;
+}
+
+VectorXd BindingValues(const VectorXd& x, const vector<int>& indices) {
+  VectorXd x_binding(indices.size());
+  for (size_t i = 0; i < indices.size(); i++) {
+    x_binding(i) = x(indices[i]);
+  }
+  return x_binding;
+}
+
+// AutoDiff gradient of an evaluator, padded with zeros if the output did not
+// depend on the input
+MatrixXd EvalGradient(const EvaluatorBase& evaluator,
+                      const AutoDiffVecXd& x_val, VectorXd* y) {
+  AutoDiffVecXd y_val;
+  evaluator.Eval(x_val, &y_val);
+  *y = autoDiffToValueMatrix(y_val);
+  MatrixXd gradient = autoDiffToGradientMatrix(y_val);
+  if (gradient.cols() != x_val.size()) {
+    gradient = MatrixXd::Zero(y_val.size(), x_val.size());
+  }
+  return gradient;
+}
+
+// Linearizes a single constraint binding, whose rows start at row
+void LinearizeBinding(const MathematicalProgram& prog,
+                      const Binding<Constraint>& binding, const VectorXd& x,
+                      int row, VectorXd* y, VectorXd* lb, VectorXd* ub,
+                      vector<Triplet<double>>* triplets) {
+  const auto& c = binding.evaluator();
+  const int n = c->num_constraints();
+  lb->segment(row, n) = c->lower_bound();
+  ub->segment(row, n) = c->upper_bound();
+
+  const vector<int> columns = VariableIndices(prog, binding.variables());
+  const VectorXd x_binding = BindingValues(x, columns);
+
+  if (dynamic_cast<const BoundingBoxConstraint*>(c.get())) {
+    y->segment(row, n) = x_binding;
+    for (int i = 0; i < n; i++) {
+      triplets->emplace_back(row + i, columns[i], 1);
+    }
+    return;
+  }
+  if (auto linear = dynamic_cast<const LinearConstraint*>(c.get())) {
+    y->segment(row, n) = linear->A() * x_binding;
+    for (int i = 0; i < n; i++) {
+      for (size_t j = 0; j < columns.size(); j++) {
+        if (linear->A()(i, j) != 0) {
+          triplets->emplace_back(row + i, columns[j], linear->A()(i, j));
+        }
+      }
+    }
+    return;
+  }
+
+  VectorXd y_binding;
+  MatrixXd dx = EvalGradient(*c, initializeAutoDiff(x_binding), &y_binding);
+  y->segment(row, n) = y_binding;
+  if (c->gradient_sparsity_pattern().has_value()) {
+    for (const auto& [i, j] : c->gradient_sparsity_pattern().value()) {
+      triplets->emplace_back(row + i, columns[j], dx(i, j));
+    }
+  } else {
+    for (int j = 0; j < dx.cols(); j++) {
+      for (int i = 0; i < n; i++) {
+        triplets->emplace_back(row + i, columns[j], dx(i, j));
+      }
+    }
+  }
+}
+
+}  // namespace
+
 bool CheckGenericConstraints(const MathematicalProgram& prog,
     const drake::solvers::MathematicalProgramResult& result,
     double tol) {
@@ -86,6 +217,80 @@ double SecondOrderCost(const MathematicalProgram& prog, const VectorXd& x_nom,
   return c;
 }
 
+double SecondOrderCost(const MathematicalProgram& prog, const VectorXd& x_nom,
+    SparseMatrix<double>* Q, VectorXd* w, double eps, int num_threads) {
+  const auto costs = prog.GetAllCosts();
+  const auto groups = GroupByEvaluator(costs);
+  num_threads = std::max(1, std::min<int>(num_threads, groups.size()));
+
+  // Costs share variables, so each thread accumulates its own w and c
+  vector<vector<Triplet<double>>> triplets(num_threads);
+  vector<VectorXd> w_thread(num_threads, VectorXd::Zero(prog.num_vars()));
+  vector<double> c_thread(num_threads, 0);
+
+  ForEachGroup(groups.size(), num_threads, [&](int group, int thread) {
+    for (int b : groups[group]) {
+      const auto& binding = costs[b];
+      const auto& cost = binding.evaluator();
+      if (binding.variables().size() == 0) continue;
+      const vector<int> columns = VariableIndices(prog, binding.variables());
+      const VectorXd x_binding = BindingValues(x_nom, columns);
+      const int n = columns.size();
+
+      VectorXd y;
+      VectorXd gradient;
+      MatrixXd hessian;
+      if (auto quadratic = dynamic_cast<const QuadraticCost*>(cost.get())) {
+        hessian = (quadratic->Q() + quadratic->Q().transpose()) / 2;
+        gradient = hessian * x_binding + quadratic->b();
+        y = VectorXd::Constant(1, 0.5 * x_binding.dot(hessian * x_binding) +
+                                      quadratic->b().dot(x_binding) +
+                                      quadratic->c());
+      } else if (auto linear = dynamic_cast<const LinearCost*>(cost.get())) {
+        gradient = linear->a();
+        y = VectorXd::Constant(1, linear->a().dot(x_binding) + linear->b());
+      } else {
+        AutoDiffVecXd x_val = initializeAutoDiff(x_binding);
+        gradient = EvalGradient(*cost, x_val, &y).row(0).transpose();
+        // forward differencing of the gradient for the Hessian
+        hessian = MatrixXd(n, n);
+        VectorXd y_perturbed;
+        for (int i = 0; i < n; i++) {
+          x_val(i) += eps;
+          hessian.col(i) =
+              (EvalGradient(*cost, x_val, &y_perturbed).row(0).transpose() -
+               gradient) / eps;
+          x_val(i) -= eps;
+        }
+        hessian = (hessian + hessian.transpose()) / 2;
+      }
+
+      c_thread[thread] += y(0);  // costs are length 1
+      for (int i = 0; i < n; i++) {
+        w_thread[thread](columns[i]) += gradient(i);
+        for (int j = 0; j < hessian.cols(); j++) {
+          if (hessian(i, j) != 0) {
+            triplets[thread].emplace_back(columns[i], columns[j],
+                                          hessian(i, j));
+          }
+        }
+      }
+    }
+  });
+
+  *w = VectorXd::Zero(prog.num_vars());
+  double c = 0;
+  vector<Triplet<double>> all_triplets;
+  for (int t = 0; t < num_threads; t++) {
+    *w += w_thread[t];
+    c += c_thread[t];
+    all_triplets.insert(all_triplets.end(), triplets[t].begin(),
+                        triplets[t].end());
+  }
+  Q->resize(prog.num_vars(), prog.num_vars());
+  Q->setFromTriplets(all_triplets.begin(), all_triplets.end());
+  return c;
+}
 
 // Evaluate all constraints and construct a linearization of them
 void LinearizeConstraints(const MathematicalProgram& prog, const VectorXd& x,
@@ -139,6 +344,42 @@ void LinearizeConstraints(const MathematicalProgram& prog, const VectorXd& x,
   }
 }
 
+void LinearizeConstraints(const MathematicalProgram& prog, const VectorXd& x,
+    VectorXd* y, SparseMatrix<double>* A, VectorXd* lb, VectorXd* ub,
+    int num_threads) {
+  const int num_constraints = CountConstraintRows(prog);
+  lb->resize(num_constraints);
+  ub->resize(num_constraints);
+  y->resize(num_constraints);
+
+  const auto constraints = prog.GetAllConstraints();
+  vector<int> row_start(constraints.size());
+  int constraint_index = 0;
+  for (size_t i = 0; i < constraints.size(); i++) {
+    row_start[i] = constraint_index;
+    constraint_index += constraints[i].evaluator()->num_constraints();
+  }
+
+  // Each binding writes to its own rows of y, lb and ub
+  const auto groups = GroupByEvaluator(constraints);
+  num_threads = std::max(1, std::min<int>(num_threads, groups.size()));
+  vector<vector<Triplet<double>>> triplets(num_threads);
+  ForEachGroup(groups.size(), num_threads, [&](int group, int thread) {
+    for (int b : groups[group]) {
+      LinearizeBinding(prog, constraints[b], x, row_start[b], y, lb, ub,
+                       &triplets[thread]);
+    }
+  });
+
+  vector<Triplet<double>> all_triplets;
+  for (const auto& thread_triplets : triplets) {
+    all_triplets.insert(all_triplets.end(), thread_triplets.begin(),
+                        thread_triplets.end());
+  }
+  A->resize(num_constraints, prog.num_vars());
+  A->setFromTriplets(all_triplets.begin(), all_triplets.end());
+}
+
 /// Helper method, returns a vector of given length
 /// [start, start+1, ..., (start + length -1)]
 VectorXd NVec(int start, int length) {
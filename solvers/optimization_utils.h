@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Eigen/SparseCore>
+
 #include "drake/solvers/mathematical_program.h"
 #include "drake/solvers/mathematical_program_result.h"
 #include "drake/solvers/decision_variable.h"
@@ -38,6 +40,21 @@ void LinearizeConstraints(const drake::solvers::MathematicalProgram& prog,
                           Eigen::MatrixXd* A, Eigen::VectorXd* lb,
                           Eigen::VectorXd* ub);
 
+/// Sparse variant of LinearizeConstraints for large programs
+///
+/// Only the entries of each binding's own block of the gradient are stored.
+/// Linear and bounding box constraints use their exact coefficients, and
+/// constraints which declare a gradient sparsity pattern only contribute the
+/// entries of that pattern.
+/// @param num_threads the bindings are grouped by evaluator, and the groups
+///   are linearized on num_threads threads. Each evaluator is only ever called
+///   from one thread at a time, but evaluators which share state with each
+///   other (e.g. a common plant context) require num_threads = 1.
+void LinearizeConstraints(const drake::solvers::MathematicalProgram& prog,
+                          const Eigen::VectorXd& x, Eigen::VectorXd* y,
+                          Eigen::SparseMatrix<double>* A, Eigen::VectorXd* lb,
+                          Eigen::VectorXd* ub, int num_threads = 1);
+
 /// Form a second order approximation to the cost of an optimization program
 /// about some nominal value
 ///
@@ -55,6 +72,16 @@ double SecondOrderCost(const drake::solvers::MathematicalProgram& prog,
     const Eigen::VectorXd& x_nom, Eigen::MatrixXd* Q, Eigen::VectorXd* w,
     double eps = 1e-8);
 
+/// Sparse variant of SecondOrderCost for large programs
+///
+/// The Hessian of quadratic costs is exact, linear costs have none, and
+/// the Hessian of any other cost is computed by differencing its AutoDiff
+/// gradient, which only couples the variables of that binding.
+/// @param num_threads as in the sparse LinearizeConstraints
+double SecondOrderCost(const drake::solvers::MathematicalProgram& prog,
+    const Eigen::VectorXd& x_nom, Eigen::SparseMatrix<double>* Q,
+    Eigen::VectorXd* w, double eps = 1e-8, int num_threads = 1);
+
 /// Count the total number of constraint rows, if lb <= f(x) <= ub, this is
 /// the dimension of f(x)
 int CountConstraintRows(const drake::solvers::MathematicalProgram& prog);
@@ -102,6 +102,40 @@ TEST_F(CostConstraintApproximationTest, QPTest) {
   EXPECT_EQ(ub_o, ub_a);
 }
 
+TEST_F(CostConstraintApproximationTest, SparseMatchesDense) {
+  MathematicalProgram prog;
+  auto x = prog.NewContinuousVariables(6, "x");
+  prog.AddBoundingBoxConstraint(-VectorXd::Ones(3), VectorXd::Ones(3),
+                                x.head(3));
+  prog.AddLinearConstraint(Eigen::RowVector3d(1, 0, 2), 0, 1, x.tail(3));
+  prog.AddConstraint(x(0) * x(1) + x(5) * x(5), 0, 1);
+  prog.AddConstraint(x(2) * x(3), -1, 1);
+  prog.AddQuadraticCost(x.head(2).dot(x.head(2)) + 2 * x(3));
+  prog.AddCost(x(4) * x(4) * x(5) + x(0) * x(4));
+
+  VectorXd x_nom = VectorXd::LinSpaced(6, 0.5, 1.5);
+
+  VectorXd y_d, lb_d, ub_d, w_d, y_s, lb_s, ub_s, w_s;
+  MatrixXd A_d, Q_d;
+  Eigen::SparseMatrix<double> A_s, Q_s;
+  LinearizeConstraints(prog, x_nom, &y_d, &A_d, &lb_d, &ub_d);
+  double c_d = SecondOrderCost(prog, x_nom, &Q_d, &w_d);
+
+  for (int num_threads : {1, 3}) {
+    LinearizeConstraints(prog, x_nom, &y_s, &A_s, &lb_s, &ub_s, num_threads);
+    double c_s = SecondOrderCost(prog, x_nom, &Q_s, &w_s, 1e-8, num_threads);
+    EXPECT_TRUE(CompareMatrices(y_d, y_s, 1e-12));
+    EXPECT_TRUE(CompareMatrices(A_d, MatrixXd(A_s), 1e-12));
+    EXPECT_EQ(lb_d, lb_s);
+    EXPECT_EQ(ub_d, ub_s);
+    EXPECT_NEAR(c_d, c_s, 1e-12);
+    EXPECT_TRUE(CompareMatrices(w_d, w_s, 1e-12));
+    EXPECT_TRUE(CompareMatrices(Q_d, MatrixXd(Q_s), 1e-5));
+  }
+  // Only the entries of each binding's block are stored
+  EXPECT_LT(A_s.nonZeros(), A_s.rows() * A_s.cols());
+}
+
 }  // namespace
 }  // namespace solvers
 }  // namespace dairlib
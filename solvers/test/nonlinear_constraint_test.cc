@@ -0,0 +1,124 @@
+#include <memory>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/math/autodiff.h"
+#include "drake/math/autodiff_gradient.h"
+#include "solvers/nonlinear_constraint.h"
+
+namespace dairlib {
+namespace solvers {
+namespace {
+
+using drake::AutoDiffVecXd;
+using drake::CompareMatrices;
+using drake::VectorX;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+// y(i) = x(i)^2 * x(i + 1) + sin(x(i + 2)), a tridiagonal-like gradient
+class BandedConstraint : public NonlinearConstraint<double> {
+ public:
+  explicit BandedConstraint(int n)
+      : NonlinearConstraint<double>(n - 2, n, VectorXd::Zero(n - 2),
+                                    VectorXd::Zero(n - 2)) {}
+
+  void EvaluateConstraint(const Eigen::Ref<const VectorX<double>>& x,
+                          VectorX<double>* y) const override {
+    *y = VectorXd(x.size() - 2);
+    for (int i = 0; i < y->size(); i++) {
+      (*y)(i) = x(i) * x(i) * x(i + 1) + std::sin(x(i + 2));
+    }
+  }
+
+  MatrixXd AnalyticalGradient(const VectorXd& x) const {
+    MatrixXd grad = MatrixXd::Zero(x.size() - 2, x.size());
+    for (int i = 0; i < grad.rows(); i++) {
+      grad(i, i) = 2 * x(i) * x(i + 1);
+      grad(i, i + 1) = x(i) * x(i);
+      grad(i, i + 2) = std::cos(x(i + 2));
+    }
+    return grad;
+  }
+};
+
+class NonlinearConstraintTest : public ::testing::Test {
+ protected:
+  MatrixXd Gradient(const BandedConstraint& constraint, const VectorXd& x) {
+    AutoDiffVecXd y;
+    constraint.Eval(drake::math::initializeAutoDiff(x), &y);
+    return drake::math::autoDiffToGradientMatrix(y);
+  }
+
+  const int n_ = 40;
+  const VectorXd x_ = VectorXd::LinSpaced(n_, -1, 1);
+};
+
+TEST_F(NonlinearConstraintTest, DenseForwardDifference) {
+  BandedConstraint constraint(n_);
+  EXPECT_EQ(constraint.num_differencing_evaluations(), n_);
+  EXPECT_TRUE(CompareMatrices(Gradient(constraint, x_),
+                              constraint.AnalyticalGradient(x_), 1e-6));
+}
+
+TEST_F(NonlinearConstraintTest, ColoredDifference) {
+  BandedConstraint constraint(n_);
+  constraint.DetectGradientSparsityPattern(x_);
+  // Columns three apart never share a row
+  EXPECT_EQ(constraint.num_differencing_evaluations(), 3);
+  EXPECT_EQ(static_cast<int>(constraint.gradient_sparsity_pattern()->size()),
+            3 * (n_ - 2));
+  EXPECT_TRUE(CompareMatrices(Gradient(constraint, x_),
+                              constraint.AnalyticalGradient(x_), 1e-6));
+
+  constraint.SetFiniteDifferenceMethod(FiniteDifferenceMethod::kCentral);
+  EXPECT_EQ(constraint.num_differencing_evaluations(), 6);
+  EXPECT_TRUE(CompareMatrices(Gradient(constraint, x_),
+                              constraint.AnalyticalGradient(x_), 1e-6));
+}
+
+TEST_F(NonlinearConstraintTest, ParallelDifference) {
+  BandedConstraint serial(n_);
+  BandedConstraint parallel(n_);
+  parallel.SetNumDifferencingThreads(4);
+  EXPECT_TRUE(CompareMatrices(Gradient(serial, x_), Gradient(parallel, x_)));
+
+  serial.DetectGradientSparsityPattern(x_);
+  parallel.DetectGradientSparsityPattern(x_);
+  // The threads are reused by consecutive evaluations
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(CompareMatrices(Gradient(serial, x_), Gradient(parallel, x_)));
+  }
+
+  serial.SetFiniteDifferenceMethod(FiniteDifferenceMethod::kCentral);
+  parallel.SetFiniteDifferenceMethod(FiniteDifferenceMethod::kCentral);
+  EXPECT_TRUE(CompareMatrices(Gradient(serial, x_), Gradient(parallel, x_)));
+
+  // Back to the calling thread only
+  parallel.SetNumDifferencingThreads(1);
+  EXPECT_TRUE(CompareMatrices(Gradient(serial, x_), Gradient(parallel, x_)));
+}
+
+TEST_F(NonlinearConstraintTest, ChainRule) {
+  BandedConstraint constraint(n_);
+  constraint.DetectGradientSparsityPattern(x_);
+  MatrixXd x_grad = MatrixXd::Random(n_, 5);
+  AutoDiffVecXd x_ad;
+  drake::math::initializeAutoDiffGivenGradientMatrix(x_, x_grad, x_ad);
+  AutoDiffVecXd y;
+  constraint.Eval(x_ad, &y);
+  EXPECT_TRUE(CompareMatrices(drake::math::autoDiffToGradientMatrix(y),
+                              constraint.AnalyticalGradient(x_) * x_grad,
+                              1e-6));
+}
+
+}  // namespace
+}  // namespace solvers
+}  // namespace dairlib
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,165 @@
+#include "systems/async_vector_scope.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "dairlib/lcmt_scope_batch.hpp"
+
+namespace dairlib {
+namespace systems {
+
+using drake::systems::BasicVector;
+using drake::systems::Context;
+using drake::systems::DiscreteValues;
+using drake::systems::EventStatus;
+using Eigen::VectorXd;
+using std::string;
+using std::vector;
+
+SampleQueue::SampleQueue(int capacity, int sample_size)
+    : capacity_(capacity),
+      sample_size_(sample_size),
+      utimes_(capacity),
+      samples_(capacity * sample_size) {}
+
+bool SampleQueue::Push(int64_t utime,
+                       const Eigen::Ref<const VectorXd>& sample) {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) >=
+      static_cast<size_t>(capacity_)) {
+    return false;
+  }
+  const int index = tail % capacity_;
+  utimes_[index] = utime;
+  Eigen::Map<VectorXd>(&samples_[index * sample_size_], sample_size_) = sample;
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+bool SampleQueue::Pop(int64_t* utime, double* sample) {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  if (head == tail_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  const int index = head % capacity_;
+  *utime = utimes_[index];
+  std::copy(&samples_[index * sample_size_],
+            &samples_[index * sample_size_] + sample_size_, sample);
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+AsyncVectorScope::AsyncVectorScope(const vector<ScopeSignal>& signals,
+                                   double sample_period,
+                                   drake::lcm::DrakeLcmInterface* lcm,
+                                   const string& log_filepath,
+                                   int queue_capacity, double flush_period)
+    : signals_(signals),
+      lcm_(lcm),
+      flush_period_(flush_period) {
+  for (const auto& signal : signals_) {
+    DRAKE_DEMAND(signal.decimation > 0);
+    DRAKE_DEMAND(signal.element_names.empty() ||
+                 static_cast<int>(signal.element_names.size()) == signal.size);
+    this->DeclareVectorInputPort(signal.name,
+                                 BasicVector<double>(signal.size));
+    queues_.push_back(
+        std::make_unique<SampleQueue>(queue_capacity, signal.size));
+    num_dropped_.push_back(std::make_unique<std::atomic<int64_t>>(0));
+  }
+  // Number of sample events of each signal
+  this->DeclareDiscreteState(VectorXd::Zero(signals_.size()));
+  this->DeclarePeriodicDiscreteUpdateEvent(sample_period, 0.0,
+                                           &AsyncVectorScope::Sample);
+
+  if (!log_filepath.empty()) {
+    log_ = std::make_unique<lcm::LogFile>(log_filepath, "w");
+    if (!log_->good()) {
+      throw std::runtime_error("Could not open file: " + log_filepath);
+    }
+  }
+  drain_thread_ = std::thread(&AsyncVectorScope::Run, this);
+}
+
+AsyncVectorScope::~AsyncVectorScope() { Stop(); }
+
+void AsyncVectorScope::Stop() {
+  keep_running_ = false;
+  if (drain_thread_.joinable()) {
+    drain_thread_.join();
+  }
+}
+
+EventStatus AsyncVectorScope::Sample(
+    const Context<double>& context,
+    DiscreteValues<double>* discrete_state) const {
+  const auto utime =
+      static_cast<int64_t>(std::round(context.get_time() * 1e6));
+  const BasicVector<double>& num_sample_events =
+      context.get_discrete_state(0);
+  BasicVector<double>& next_num_sample_events =
+      discrete_state->get_mutable_vector(0);
+  for (size_t i = 0; i < signals_.size(); ++i) {
+    const auto num_events = static_cast<int64_t>(num_sample_events[i]);
+    next_num_sample_events[i] = num_events + 1;
+    if (num_events % signals_[i].decimation != 0) continue;
+    const auto& input = this->EvalVectorInput(context, i)->get_value();
+    if (!queues_[i]->Push(utime, input)) {
+      num_dropped_[i]->fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  return EventStatus::Succeeded();
+}
+
+void AsyncVectorScope::Run() {
+  const auto period = std::chrono::duration<double>(flush_period_);
+  while (keep_running_) {
+    std::this_thread::sleep_for(period);
+    Drain();
+  }
+  // Pick up anything pushed before Stop()
+  Drain();
+}
+
+void AsyncVectorScope::Drain() {
+  for (size_t i = 0; i < signals_.size(); ++i) {
+    const ScopeSignal& signal = signals_[i];
+    lcmt_scope_batch msg;
+    msg.name = signal.name;
+    msg.vector_length = signal.size;
+    msg.element_names = signal.element_names;
+    msg.element_names.resize(signal.size);
+
+    int64_t utime;
+    vector<double> sample(signal.size);
+    while (queues_[i]->Pop(&utime, sample.data())) {
+      msg.sample_utime.push_back(utime);
+      msg.samples.push_back(sample);
+    }
+    if (msg.samples.empty()) continue;
+
+    msg.num_samples = msg.samples.size();
+    msg.utime = msg.sample_utime.back();
+    msg.latest = msg.samples.back();
+    msg.dropped_samples = num_dropped_[i]->load();
+
+    const string channel = "SCOPE_" + signal.name;
+    if (lcm_) {
+      drake::lcm::Publish(lcm_, channel, msg);
+    }
+    if (log_) {
+      vector<uint8_t> bytes(msg.getEncodedSize());
+      msg.encode(bytes.data(), 0, bytes.size());
+      lcm::LogEvent event;
+      event.timestamp = msg.utime;
+      event.channel = channel;
+      event.datalen = bytes.size();
+      event.data = bytes.data();
+      log_->writeEvent(&event);
+    }
+  }
+}
+
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lcm/lcm-cpp.hpp"
+#include "drake/lcm/drake_lcm_interface.h"
+#include "drake/systems/framework/leaf_system.h"
+
+namespace dairlib {
+namespace systems {
+
+/// Single-producer/single-consumer, lock-free queue of fixed-size samples.
+/// All storage is allocated at construction. Push() never blocks and returns
+/// false if the queue is full.
+class SampleQueue {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(SampleQueue)
+
+  SampleQueue(int capacity, int sample_size);
+
+  /// Called by the producer thread only
+  bool Push(int64_t utime, const Eigen::Ref<const Eigen::VectorXd>& sample);
+
+  /// Called by the consumer thread only
+  bool Pop(int64_t* utime, double* sample);
+
+ private:
+  const int capacity_;
+  const int sample_size_;
+  std::vector<int64_t> utimes_;
+  std::vector<double> samples_;
+  // Index of the next sample to pop, written by the consumer
+  std::atomic<size_t> head_{0};
+  // Index of the next sample to push, written by the producer
+  std::atomic<size_t> tail_{0};
+};
+
+/// A signal recorded by AsyncVectorScope
+/// @param name the signal name, also used for the channel SCOPE_<name>
+/// @param size the size of the input vector
+/// @param decimation records every decimation-th sample event
+/// @param element_names optional names of the vector elements
+struct ScopeSignal {
+  std::string name;
+  int size;
+  int decimation = 1;
+  std::vector<std::string> element_names;
+};
+
+/// Replacement for VectorScope that never touches stdio from the thread
+/// advancing the diagram.
+///
+/// Samples all input ports at a fixed period and pushes them into lock-free,
+/// preallocated queues (one per signal). A background thread drains the
+/// queues every flush_period seconds and batches the samples of each signal
+/// into an lcmt_scope_batch message, which is published on the channel
+/// SCOPE_<signal name> and/or written to an LCM log file. signal-scope can
+/// subscribe to these channels directly (see
+/// signalscope/scripts/add_scope_batch.py).
+///
+/// If a queue is full when sampling, the sample is dropped and counted in the
+/// dropped_samples field rather than blocking the control loop.
+///
+/// The number of sample events of each signal, used for decimation, is kept in
+/// the discrete state, so sampling is a periodic discrete update that leaves
+/// the state unchanged apart from these counters.
+class AsyncVectorScope : public drake::systems::LeafSystem<double> {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(AsyncVectorScope)
+
+  /// @param signals the signals to record, one input port per signal
+  /// @param sample_period the period at which the inputs are sampled
+  /// @param lcm the lcm instance to publish on, or nullptr to not publish
+  /// @param log_filepath the LCM log file to write, or "" to not write a file
+  /// @param queue_capacity the number of samples each queue holds
+  /// @param flush_period the period of the background thread, in seconds
+  AsyncVectorScope(const std::vector<ScopeSignal>& signals,
+                   double sample_period, drake::lcm::DrakeLcmInterface* lcm,
+                   const std::string& log_filepath = "",
+                   int queue_capacity = 4096, double flush_period = 0.05);
+
+  ~AsyncVectorScope() override;
+
+  const drake::systems::InputPort<double>& get_input_port(
+      int signal_index) const {
+    return drake::systems::LeafSystem<double>::get_input_port(signal_index);
+  }
+
+  /// Stops the background thread after draining all queued samples. Called by
+  /// the destructor.
+  void Stop();
+
+  int64_t get_num_dropped(int signal_index) const {
+    return num_dropped_[signal_index]->load();
+  }
+
+ private:
+  drake::systems::EventStatus Sample(
+      const drake::systems::Context<double>& context,
+      drake::systems::DiscreteValues<double>* discrete_state) const;
+
+  void Run();
+  void Drain();
+
+  const std::vector<ScopeSignal> signals_;
+  drake::lcm::DrakeLcmInterface* lcm_;
+  std::unique_ptr<lcm::LogFile> log_;
+  const double flush_period_;
+
+  std::vector<std::unique_ptr<SampleQueue>> queues_;
+  std::vector<std::unique_ptr<std::atomic<int64_t>>> num_dropped_;
+
+  std::atomic<bool> keep_running_{true};
+  std::thread drain_thread_;
+};
+
+}  // namespace systems
+}  // namespace dairlib
@@ -1,5 +1,7 @@
 #include "systems/controllers/affine_controller.h"
 
+#include <algorithm>
+
 namespace dairlib {
 namespace systems {
 
@@ -49,5 +51,55 @@ void AffineController::CalcControl(const Context<double>& context,
   control->set_timestamp(info->get_timestamp());
 }
 
+AffineBatchEvaluator::AffineBatchEvaluator(const MatrixXd& K,
+                                           const VectorXd& E,
+                                           const VectorXd& desired_state)
+    : K_(K), offset_(E + K * desired_state) {
+  DRAKE_DEMAND(E.size() == K.rows());
+  DRAKE_DEMAND(desired_state.size() == K.cols());
+}
+
+AffineBatchEvaluator::AffineBatchEvaluator(const AffineParams& params)
+    : AffineBatchEvaluator(params.get_K(), params.get_E(),
+                           params.get_desired_state()) {}
+
+AffineBatchEvaluator::AffineBatchEvaluator(const VectorXd& params,
+                                           int num_states, int num_efforts) {
+  AffineParams affine_params(num_states, num_efforts);
+  DRAKE_DEMAND(params.size() == affine_params.get_data().size());
+  affine_params.SetDataVector(params);
+  *this = AffineBatchEvaluator(affine_params);
+}
+
+MatrixXd AffineBatchEvaluator::Eval(
+    const Eigen::Ref<const MatrixXd>& states) const {
+  MatrixXd efforts(num_efforts(), states.cols());
+  Eval(states, efforts);
+  return efforts;
+}
+
+void AffineBatchEvaluator::Eval(const Eigen::Ref<const MatrixXd>& states,
+                                Eigen::Ref<MatrixXd> efforts) const {
+  DRAKE_DEMAND(states.rows() == num_states());
+  DRAKE_DEMAND(efforts.rows() == num_efforts());
+  DRAKE_DEMAND(efforts.cols() == states.cols());
+  for (int start = 0; start < states.cols(); start += kBlockSize) {
+    const int n = std::min<int>(kBlockSize, states.cols() - start);
+    auto block = efforts.middleCols(start, n);
+    block.colwise() = offset_;
+    block.noalias() -= K_ * states.middleCols(start, n);
+  }
+}
+
+MatrixXd AffineBatchEvaluator::EvalTimestamped(
+    const Eigen::Ref<const MatrixXd>& timestamped_states) const {
+  DRAKE_DEMAND(timestamped_states.rows() == num_states() + 1);
+  MatrixXd result(num_efforts() + 1, timestamped_states.cols());
+  Eval(timestamped_states.topRows(num_states()),
+       result.topRows(num_efforts()));
+  result.bottomRows(1) = timestamped_states.bottomRows(1);
+  return result;
+}
+
 }  // namespace systems
 }  // namespace dairlib
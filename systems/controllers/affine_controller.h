@@ -111,5 +111,59 @@ class AffineParams : public TimestampedVector<double> {
   Eigen::Map<Eigen::VectorXd> desired_state_;
 };
 
+/*
+ * AffineBatchEvaluator evaluates the law of an AffineController,
+ * u = K(x_desired - x) + E, for many states at once and without a diagram,
+ * e.g. for offline Monte Carlo studies.
+ * States are the columns of a column-major matrix. The law is evaluated as
+ * u = c - K x, with c = E + K x_desired precomputed, one block of columns
+ * at a time, so each block is a single matrix-matrix product (GEMM) that
+ * writes into the output without temporaries.
+ */
+class AffineBatchEvaluator {
+ public:
+  AffineBatchEvaluator(const Eigen::MatrixXd& K, const Eigen::VectorXd& E,
+                       const Eigen::VectorXd& desired_state);
+
+  /*
+   * The law of an AffineController with the given parameters
+   */
+  explicit AffineBatchEvaluator(const AffineParams& params);
+
+  /*
+   * The law of an AffineController with the parameters in the data layout of
+   * AffineParams, [K; E; desired_state], without timestamp
+   */
+  AffineBatchEvaluator(const Eigen::VectorXd& params, int num_states,
+                       int num_efforts);
+
+  int num_states() const { return K_.cols(); }
+  int num_efforts() const { return K_.rows(); }
+
+  /*
+   * Evaluates the efforts (num_efforts x N) of the states (num_states x N)
+   */
+  Eigen::MatrixXd Eval(const Eigen::Ref<const Eigen::MatrixXd>& states) const;
+  void Eval(const Eigen::Ref<const Eigen::MatrixXd>& states,
+            Eigen::Ref<Eigen::MatrixXd> efforts) const;
+
+  /*
+   * Same as Eval(), in the layout of TimestampedVector: each column of
+   * timestamped_states is a state followed by its timestamp, and each column
+   * of the result is the effort followed by the same timestamp, as output by
+   * AffineController.
+   */
+  Eigen::MatrixXd EvalTimestamped(
+      const Eigen::Ref<const Eigen::MatrixXd>& timestamped_states) const;
+
+  // Number of columns per GEMM, sized so that a block of states and efforts
+  // stays in cache
+  static constexpr int kBlockSize = 256;
+
+ private:
+  Eigen::MatrixXd K_;
+  Eigen::VectorXd offset_;
+};
+
 }  // namespace systems
 }  // namespace dairlib
@@ -31,6 +31,12 @@ void LinearController::CalcControl(const Context<double>& context,
     control->set_timestamp(output->get_timestamp());
 }
 
+AffineBatchEvaluator MakeLinearBatchEvaluator(const LinearConfig& config) {
+  const MatrixXd K = config.GetK();
+  return AffineBatchEvaluator(K, VectorXd::Zero(K.rows()),
+                              config.GetDesiredState());
+}
+
 
 }
 }
\ No newline at end of file
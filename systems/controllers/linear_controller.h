@@ -1,6 +1,7 @@
 #pragma once
 
 #include "drake/systems/framework/leaf_system.h"
+#include "systems/controllers/affine_controller.h"
 #include "systems/framework/output_vector.h"
 
 using Eigen::VectorXd;
@@ -71,5 +72,10 @@ class LinearConfig : public TimestampedVector<double> {
     MatrixXd K_;
 };
 
+/// Batch evaluation of the law of a LinearController with the given
+/// configuration, u = K (x_desired - x), outside of a diagram. See
+/// AffineBatchEvaluator.
+AffineBatchEvaluator MakeLinearBatchEvaluator(const LinearConfig& config);
+
 }
 }
\ No newline at end of file
@@ -0,0 +1,481 @@
+#include "systems/controllers/lipm_mpc.h"
+
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+using std::string;
+using std::vector;
+
+using Eigen::Matrix2d;
+using Eigen::MatrixXd;
+using Eigen::Vector2d;
+using Eigen::Vector3d;
+using Eigen::Vector4d;
+using Eigen::VectorXd;
+
+using drake::systems::BasicVector;
+using drake::systems::Context;
+using drake::systems::DiscreteValues;
+using drake::systems::EventStatus;
+
+using drake::multibody::Frame;
+using drake::multibody::JacobianWrtVariable;
+using drake::multibody::MultibodyPlant;
+using drake::solvers::MathematicalProgram;
+using drake::trajectories::PiecewisePolynomial;
+
+namespace dairlib {
+namespace systems {
+
+namespace {
+// LIPM transition over t, (c - p, cdot)(t) = A(t) (c - p, cdot)(0)
+Matrix2d LipmA(double omega, double t) {
+  Matrix2d A;
+  A << cosh(omega * t), sinh(omega * t) / omega,
+      omega * sinh(omega * t), cosh(omega * t);
+  return A;
+}
+
+// s(t) = A(t) s(0) + B(t) p
+Vector2d LipmB(double omega, double t) {
+  return Vector2d(1 - cosh(omega * t), -omega * sinh(omega * t));
+}
+}  // namespace
+
+LipmFootstepQp::LipmFootstepQp(
+    double com_height, const vector<double>& left_right_support_durations,
+    int num_steps, double step_width, double max_step_deviation,
+    double w_velocity, double w_step)
+    : omega_(sqrt(9.81 / com_height)),
+      durations_(left_right_support_durations),
+      num_steps_(num_steps),
+      step_width_(step_width),
+      max_step_deviation_(max_step_deviation),
+      w_velocity_(w_velocity),
+      w_step_(w_step) {
+  DRAKE_DEMAND(com_height > 0);
+  DRAKE_DEMAND(durations_.size() == 2);
+  DRAKE_DEMAND(num_steps > 0);
+  const int n = num_steps_;
+
+  D_ = MatrixXd::Identity(n, n);
+  for (int j = 1; j < n; j++) {
+    D_(j, j - 1) = -1;
+  }
+
+  // Condensed dynamics for either foot taking the first step
+  for (bool first_step_is_left : {false, true}) {
+    Structure structure;
+    structure.Phi_v = MatrixXd::Zero(n, 2);
+    structure.G = MatrixXd::Zero(n, n);
+    Matrix2d Phi = Matrix2d::Identity();
+    MatrixXd Gamma = MatrixXd::Zero(2, n);
+    for (int j = 0; j < n; j++) {
+      const double T = step_duration(j, first_step_is_left);
+      const Matrix2d A = LipmA(omega_, T);
+      Phi = A * Phi;
+      Gamma = A * Gamma;
+      Gamma.col(j) += LipmB(omega_, T);
+      structure.Phi_v.row(j) = Phi.row(1);
+      structure.G.row(j) = Gamma.row(1);
+    }
+    const MatrixXd Q_axis = 2 * (w_velocity_ * structure.G.transpose() *
+                                     structure.G +
+                                 w_step_ * D_.transpose() * D_);
+    structure.Q = MatrixXd::Zero(2 * n, 2 * n);
+    structure.Q.topLeftCorner(n, n) = Q_axis;
+    structure.Q.bottomRightCorner(n, n) = Q_axis;
+    structures_.push_back(structure);
+  }
+
+  // Program, with p = (x_1, ..., x_n, y_1, ..., y_n)
+  prog_ = std::make_unique<MathematicalProgram>();
+  footsteps_ = prog_->NewContinuousVariables(2 * n, "p");
+  cost_ = prog_->AddQuadraticCost(structures_[0].Q, VectorXd::Zero(2 * n),
+                                  footsteps_)
+              .evaluator();
+  A_steps_ = MatrixXd::Zero(2 * n, 2 * n);
+  A_steps_.topLeftCorner(n, n) = D_;
+  A_steps_.bottomRightCorner(n, n) = D_;
+  step_constraint_ = prog_->AddLinearConstraint(A_steps_,
+                                                VectorXd::Zero(2 * n),
+                                                VectorXd::Zero(2 * n),
+                                                footsteps_)
+                         .evaluator();
+  prev_solution_ = VectorXd::Zero(2 * n);
+  nominal_ = MatrixXd::Zero(2, n);
+  e_ = VectorXd::Zero(n);
+  velocity_error_ = VectorXd::Zero(n);
+  b_ = VectorXd::Zero(2 * n);
+  lb_ = VectorXd::Zero(2 * n);
+  ub_ = VectorXd::Zero(2 * n);
+}
+
+double LipmFootstepQp::step_duration(int j, bool first_step_is_left) const {
+  const bool is_left = first_step_is_left == (j % 2 == 0);
+  return durations_[is_left ? 0 : 1];
+}
+
+Vector2d LipmFootstepQp::Propagate(const Vector2d& s, double p,
+                                   double t) const {
+  return LipmA(omega_, t) * s + LipmB(omega_, t) * p;
+}
+
+MatrixXd LipmFootstepQp::Solve(const Vector4d& com_state,
+                               const Vector2d& stance_foot,
+                               const Vector2d& des_vel, double heading,
+                               bool first_step_is_left) {
+  const int n = num_steps_;
+  const Structure& structure = structures_[first_step_is_left ? 1 : 0];
+
+  // Nominal steps, rotated into the world frame
+  const Vector2d lateral(-sin(heading), cos(heading));
+  for (int j = 0; j < n; j++) {
+    const bool is_left = first_step_is_left == (j % 2 == 0);
+    nominal_.col(j) = des_vel * step_duration(j, first_step_is_left) +
+                      (is_left ? 1 : -1) * step_width_ * lateral;
+  }
+
+  // Runs every controller tick, so the vectors are members and the products
+  // are evaluated in place
+  for (int axis = 0; axis < 2; axis++) {
+    const Vector2d s0(com_state(axis), com_state(2 + axis));
+    // Desired step differences, including the current stance foot
+    e_ = nominal_.row(axis).transpose();
+    e_(0) += stance_foot(axis);
+    velocity_error_.noalias() = structure.Phi_v * s0;
+    velocity_error_.array() -= des_vel(axis);
+    auto b = b_.segment(axis * n, n);
+    b.noalias() = 2 * w_velocity_ * structure.G.transpose() * velocity_error_;
+    b.noalias() -= 2 * w_step_ * D_.transpose() * e_;
+    lb_.segment(axis * n, n) = e_.array() - max_step_deviation_;
+    ub_.segment(axis * n, n) = e_.array() + max_step_deviation_;
+  }
+  cost_->UpdateCoefficients(structure.Q, b_);
+  step_constraint_->UpdateCoefficients(A_steps_, lb_, ub_);
+
+  solver_.Solve(*prog_, prev_solution_, {}, &result_);
+  if (result_.is_success()) {
+    prev_solution_ = result_.GetSolution(footsteps_);
+  } else {
+    // Fall back to the nominal steps
+    for (int axis = 0; axis < 2; axis++) {
+      double p = stance_foot(axis);
+      for (int j = 0; j < n; j++) {
+        p += nominal_(axis, j);
+        prev_solution_(axis * n + j) = p;
+      }
+    }
+  }
+
+  MatrixXd footsteps(2, n);
+  footsteps.row(0) = prev_solution_.head(n).transpose();
+  footsteps.row(1) = prev_solution_.tail(n).transpose();
+  return footsteps;
+}
+
+LipmMpc::LipmMpc(
+    const MultibodyPlant<double>& plant, double desired_com_height,
+    const vector<int>& left_right_support_fsm_states,
+    const vector<double>& left_right_support_durations,
+    const vector<std::pair<const Vector3d, const Frame<double>&>>&
+        left_right_foot,
+    const string& floating_base_body_name, int num_steps, double step_width,
+    double max_step_deviation, double mid_foot_height,
+    double desired_final_foot_height, int num_knots_per_step)
+    : plant_(plant),
+      desired_com_height_(desired_com_height),
+      left_right_support_fsm_states_(left_right_support_fsm_states),
+      left_right_support_durations_(left_right_support_durations),
+      left_right_foot_(left_right_foot),
+      mid_foot_height_(mid_foot_height),
+      desired_final_foot_height_(desired_final_foot_height),
+      num_knots_per_step_(num_knots_per_step),
+      world_(plant_.world_frame()),
+      pelvis_(plant_.GetBodyByName(floating_base_body_name)) {
+  this->set_name("lipm_mpc");
+
+  DRAKE_DEMAND(left_right_support_fsm_states_.size() == 2);
+  DRAKE_DEMAND(left_right_support_durations_.size() == 2);
+  DRAKE_DEMAND(left_right_foot_.size() == 2);
+  DRAKE_DEMAND(num_knots_per_step > 1);
+
+  // Input/Output Setup
+  state_port_ =
+      this->DeclareVectorInputPort(OutputVector<double>(plant.num_positions(),
+                                                        plant.num_velocities(),
+                                                        plant.num_actuators()))
+          .get_index();
+  fsm_port_ = this->DeclareVectorInputPort(BasicVector<double>(1)).get_index();
+  des_vel_port_ =
+      this->DeclareVectorInputPort(BasicVector<double>(2)).get_index();
+  PiecewisePolynomial<double> pp(VectorXd::Zero(0));
+  drake::trajectories::Trajectory<double>& traj_instance = pp;
+  com_traj_port_ = this->DeclareAbstractOutputPort("lipm_mpc_com_traj",
+                                                   traj_instance,
+                                                   &LipmMpc::CalcComTraj)
+                       .get_index();
+  swing_foot_traj_port_ =
+      this->DeclareAbstractOutputPort("lipm_mpc_swing_foot_traj",
+                                      traj_instance,
+                                      &LipmMpc::CalcSwingFootTraj)
+          .get_index();
+  footsteps_port_ = this->DeclareVectorOutputPort(BasicVector<double>(
+                                                      2 * num_steps),
+                                                  &LipmMpc::CalcFootsteps)
+                        .get_index();
+
+  // Discrete state event, which also solves the MPC
+  DeclarePerStepDiscreteUpdateEvent(&LipmMpc::DiscreteVariableUpdate);
+  // The time of the last touch down
+  prev_td_time_idx_ = this->DeclareDiscreteState(1);
+  // The last state of FSM
+  prev_fsm_state_idx_ = this->DeclareDiscreteState(-0.1 * VectorXd::Ones(1));
+  // The stance foot of the last single support state
+  stance_idx_ = this->DeclareDiscreteState(VectorXd::Zero(1));
+  // The swing foot position in the beginning of the swing phase
+  prev_td_swing_foot_idx_ = this->DeclareDiscreteState(3);
+  // The planned footsteps
+  footsteps_idx_ = this->DeclareDiscreteState(2 * num_steps);
+
+  qp_ = std::make_unique<LipmFootstepQp>(desired_com_height,
+                                         left_right_support_durations,
+                                         num_steps, step_width,
+                                         max_step_deviation);
+
+  // Create context
+  context_ = plant_.CreateDefaultContext();
+}
+
+int LipmMpc::StanceIndex(const Context<double>& context) const {
+  return static_cast<int>(context.get_discrete_state(stance_idx_)[0]);
+}
+
+void LipmMpc::CalcLipmState(const Context<double>& context, int stance,
+                            Vector4d* com_state, Vector3d* stance_foot_pos,
+                            double* time_remaining) const {
+  const OutputVector<double>* robot_output =
+      (OutputVector<double>*)this->EvalVectorInput(context, state_port_);
+  VectorXd v = robot_output->GetVelocities();
+  plant_.SetPositions(context_.get(), robot_output->GetPositions());
+
+  Vector3d CoM = plant_.CalcCenterOfMassPosition(*context_);
+  MatrixXd J(3, plant_.num_velocities());
+  plant_.CalcJacobianCenterOfMassTranslationalVelocity(
+      *context_, JacobianWrtVariable::kV, world_, world_, &J);
+  Vector3d dCoM = J * v;
+  *com_state << CoM(0), CoM(1), dCoM(0), dCoM(1);
+
+  plant_.CalcPointsPositions(*context_, left_right_foot_[stance].second,
+                             left_right_foot_[stance].first, world_,
+                             stance_foot_pos);
+
+  const double current_time = robot_output->get_timestamp();
+  const double prev_td_time =
+      context.get_discrete_state(prev_td_time_idx_)[0];
+  *time_remaining = std::max(
+      0.0, prev_td_time + left_right_support_durations_[stance] - current_time);
+}
+
+EventStatus LipmMpc::DiscreteVariableUpdate(
+    const Context<double>& context,
+    DiscreteValues<double>* discrete_state) const {
+  // Read in finite state machine
+  const BasicVector<double>* fsm_output =
+      (BasicVector<double>*)this->EvalVectorInput(context, fsm_port_);
+  VectorXd fsm_state = fsm_output->get_value();
+
+  auto prev_fsm_state = discrete_state->get_mutable_vector(prev_fsm_state_idx_)
+                            .get_mutable_value();
+  auto stance = discrete_state->get_mutable_vector(stance_idx_)
+                    .get_mutable_value();
+
+  auto it = find(left_right_support_fsm_states_.begin(),
+                 left_right_support_fsm_states_.end(), int(fsm_state(0)));
+  bool is_single_support_phase = it != left_right_support_fsm_states_.end();
+
+  const OutputVector<double>* robot_output =
+      (OutputVector<double>*)this->EvalVectorInput(context, state_port_);
+
+  // when entering a new single support state
+  if ((fsm_state(0) != prev_fsm_state(0)) && is_single_support_phase) {
+    prev_fsm_state(0) = fsm_state(0);
+    stance(0) = std::distance(left_right_support_fsm_states_.begin(), it);
+
+    discrete_state->get_mutable_vector(prev_td_time_idx_)
+        .get_mutable_value()(0) = robot_output->get_timestamp();
+
+    // Swing foot position at touchdown
+    plant_.SetPositions(context_.get(), robot_output->GetPositions());
+    Vector3d swing_foot_pos;
+    const auto& swing_foot = left_right_foot_[1 - int(stance(0))];
+    plant_.CalcPointsPositions(*context_, swing_foot.second, swing_foot.first,
+                               world_, &swing_foot_pos);
+    discrete_state->get_mutable_vector(prev_td_swing_foot_idx_)
+        .SetFromVector(swing_foot_pos);
+  } else if (!is_single_support_phase) {
+    prev_fsm_state(0) = fsm_state(0);
+  }
+
+  // Predict the CoM state at the end of the stance, with the discrete state
+  // updated above
+  const int stance_index = int(stance(0));
+  Vector4d com_state;
+  Vector3d stance_foot_pos;
+  double time_remaining;
+  CalcLipmState(context, stance_index, &com_state, &stance_foot_pos,
+                &time_remaining);
+  if (is_single_support_phase) {
+    // Uses the touchdown time of this call, not the one in context
+    time_remaining = std::max(
+        0.0, discrete_state->get_vector(prev_td_time_idx_)[0] +
+                 left_right_support_durations_[stance_index] -
+                 robot_output->get_timestamp());
+  }
+  for (int axis = 0; axis < 2; axis++) {
+    const Vector2d s_end = qp_->Propagate(
+        Vector2d(com_state(axis), com_state(2 + axis)),
+        stance_foot_pos(axis), time_remaining);
+    com_state(axis) = s_end(0);
+    com_state(2 + axis) = s_end(1);
+  }
+
+  // Desired velocity, from the pelvis heading frame to the world frame
+  Vector3d pelvis_heading_vec =
+      plant_.EvalBodyPoseInWorld(*context_, pelvis_).rotation().col(0);
+  const double heading = atan2(pelvis_heading_vec(1), pelvis_heading_vec(0));
+  const VectorXd des_vel_local =
+      this->EvalVectorInput(context, des_vel_port_)->get_value();
+  const Vector2d des_vel(
+      cos(heading) * des_vel_local(0) - sin(heading) * des_vel_local(1),
+      sin(heading) * des_vel_local(0) + cos(heading) * des_vel_local(1));
+
+  // The swing foot takes the first step
+  const MatrixXd footsteps = qp_->Solve(com_state, stance_foot_pos.head(2),
+                                        des_vel, heading, stance_index == 1);
+  discrete_state->get_mutable_vector(footsteps_idx_)
+      .SetFromVector(Eigen::Map<const VectorXd>(footsteps.data(),
+                                                footsteps.size()));
+
+  return EventStatus::Succeeded();
+}
+
+void LipmMpc::CalcComTraj(const Context<double>& context,
+                          drake::trajectories::Trajectory<double>* traj) const {
+  auto pp_traj = (PiecewisePolynomial<double>*)dynamic_cast<
+      PiecewisePolynomial<double>*>(traj);
+
+  const int stance = StanceIndex(context);
+  Vector4d com_state;
+  Vector3d stance_foot_pos;
+  double time_remaining;
+  CalcLipmState(context, stance, &com_state, &stance_foot_pos,
+                &time_remaining);
+  const OutputVector<double>* robot_output =
+      (OutputVector<double>*)this->EvalVectorInput(context, state_port_);
+  const double current_time = robot_output->get_timestamp();
+  const VectorXd footsteps =
+      context.get_discrete_state(footsteps_idx_).get_value();
+  const int n = qp_->num_steps();
+
+  // Segments of the horizon: the rest of the current stance, then the planned
+  // steps. Each is sampled with the exact LIPM solution.
+  vector<double> T_waypoint;
+  vector<MatrixXd> Y;
+  vector<MatrixXd> Y_dot;
+  Vector2d s_x(com_state(0), com_state(2));
+  Vector2d s_y(com_state(1), com_state(3));
+  double t_start = current_time;
+  // We add stance_foot_pos(2) to desired COM height to account for state
+  // drifting
+  const double com_z = desired_com_height_ + stance_foot_pos(2);
+  for (int j = -1; j < n; j++) {
+    const double duration =
+        (j < 0) ? time_remaining : qp_->step_duration(j, stance == 1);
+    const Vector2d foot = (j < 0) ? Vector2d(stance_foot_pos.head(2))
+                                  : Vector2d(footsteps(2 * j),
+                                             footsteps(2 * j + 1));
+    // Skip a vanishing remainder of the current stance
+    if (duration < 1e-3) continue;
+    const int first_knot = T_waypoint.empty() ? 0 : 1;
+    for (int k = first_knot; k < num_knots_per_step_; k++) {
+      const double t = duration * k / (num_knots_per_step_ - 1);
+      const Vector2d x_k = qp_->Propagate(s_x, foot(0), t);
+      const Vector2d y_k = qp_->Propagate(s_y, foot(1), t);
+      T_waypoint.push_back(t_start + t);
+      Y.push_back(Vector3d(x_k(0), y_k(0), com_z));
+      Y_dot.push_back(Vector3d(x_k(1), y_k(1), 0));
+    }
+    s_x = qp_->Propagate(s_x, foot(0), duration);
+    s_y = qp_->Propagate(s_y, foot(1), duration);
+    t_start += duration;
+  }
+
+  *pp_traj = PiecewisePolynomial<double>::CubicHermite(T_waypoint, Y, Y_dot);
+}
+
+void LipmMpc::CalcSwingFootTraj(
+    const Context<double>& context,
+    drake::trajectories::Trajectory<double>* traj) const {
+  auto pp_traj = (PiecewisePolynomial<double>*)dynamic_cast<
+      PiecewisePolynomial<double>*>(traj);
+
+  const BasicVector<double>* fsm_output =
+      (BasicVector<double>*)this->EvalVectorInput(context, fsm_port_);
+  auto it = find(left_right_support_fsm_states_.begin(),
+                 left_right_support_fsm_states_.end(),
+                 int(fsm_output->get_value()(0)));
+  if (it == left_right_support_fsm_states_.end()) {
+    // Assign a constant traj
+    *pp_traj = PiecewisePolynomial<double>(Vector3d::Zero());
+    return;
+  }
+  const int stance = std::distance(left_right_support_fsm_states_.begin(), it);
+
+  const OutputVector<double>* robot_output =
+      (OutputVector<double>*)this->EvalVectorInput(context, state_port_);
+  const double current_time = robot_output->get_timestamp();
+  const double start_time =
+      context.get_discrete_state(prev_td_time_idx_)[0];
+  double end_time = start_time + left_right_support_durations_[stance];
+  // Ensure current_time < end_time to avoid error in creating trajectory.
+  if (end_time <= current_time + 0.001) {
+    end_time = current_time + 0.002;
+  }
+
+  plant_.SetPositions(context_.get(), robot_output->GetPositions());
+  Vector3d stance_foot_pos;
+  plant_.CalcPointsPositions(*context_, left_right_foot_[stance].second,
+                             left_right_foot_[stance].first, world_,
+                             &stance_foot_pos);
+  const Vector3d init_pos =
+      context.get_discrete_state(prev_td_swing_foot_idx_).get_value();
+  const VectorXd footsteps =
+      context.get_discrete_state(footsteps_idx_).get_value();
+  const Vector2d target = footsteps.head(2);
+
+  // Two segments of cubic polynomial with velocity constraints, as in
+  // CPTrajGenerator
+  vector<double> T_waypoint = {start_time, (start_time + end_time) / 2,
+                               end_time};
+  vector<MatrixXd> Y(3, MatrixXd::Zero(3, 1));
+  vector<MatrixXd> Y_dot(3, MatrixXd::Zero(3, 1));
+  Y[0] = init_pos;
+  Y[1].topRows(2) = (init_pos.head(2) + target) / 2;
+  Y[1](2, 0) = mid_foot_height_ + stance_foot_pos(2);
+  Y[2].topRows(2) = target;
+  Y[2](2, 0) = desired_final_foot_height_ + stance_foot_pos(2);
+  Y_dot[1].topRows(2) = (target - init_pos.head(2)) /
+                        left_right_support_durations_[stance];
+  *pp_traj = PiecewisePolynomial<double>::CubicHermite(T_waypoint, Y, Y_dot);
+}
+
+void LipmMpc::CalcFootsteps(const Context<double>& context,
+                            BasicVector<double>* footsteps) const {
+  footsteps->SetFromVector(
+      context.get_discrete_state(footsteps_idx_).get_value());
+}
+
+}  // namespace systems
+}  // namespace dairlib
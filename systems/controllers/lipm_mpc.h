@@ -0,0 +1,226 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "drake/common/trajectories/piecewise_polynomial.h"
+#include "drake/solvers/mathematical_program.h"
+#include "drake/solvers/mathematical_program_result.h"
+#include "drake/solvers/osqp_solver.h"
+#include "drake/systems/framework/leaf_system.h"
+
+#include "multibody/multibody_utils.h"
+#include "systems/framework/output_vector.h"
+
+namespace dairlib {
+namespace systems {
+
+/// Condensed footstep QP of the linear inverted pendulum (LIPM) over a
+/// horizon of num_steps steps.
+///
+/// In each horizontal axis, the CoM state s = (c, cdot) at the end of step j
+/// is s_j = A_j s_{j-1} + B_j p_j, where p_j is the stance foot position of
+/// step j and A_j, B_j are the closed form LIPM transition matrices over the
+/// step duration. Condensing gives s_j as an affine function of the state at
+/// the end of the current stance, s_0, and the footsteps p_1, ..., p_n, which
+/// are the only decision variables. The cost is
+///   w_velocity sum_j (cdot_j - v_des)^2 + w_step sum_j (p_j - p_{j-1} - d_j)^2
+/// where d_j is the nominal step (v_des T_j plus the step width toward the
+/// side of the stance foot), subject to |p_j - p_{j-1} - d_j| <=
+/// max_step_deviation.
+///
+/// The step durations alternate between left and right support, so the
+/// condensed matrices and the Hessian only depend on which foot takes the
+/// first step. Both are built in the constructor, together with the
+/// MathematicalProgram; Solve() only updates the linear cost term and the
+/// constraint bounds, and warm starts OSQP from the previous solution.
+class LipmFootstepQp {
+ public:
+  /// @param com_height the (constant) CoM height of the LIPM
+  /// @param left_right_support_durations durations of the left and right
+  ///    support phases
+  /// @param num_steps the number of footsteps planned ahead
+  /// @param step_width nominal lateral distance between the feet
+  /// @param max_step_deviation bound on the deviation of each step from the
+  ///    nominal step, per axis
+  /// @param w_velocity weight on the CoM velocity error at the end of each step
+  /// @param w_step weight on the deviation from the nominal steps
+  LipmFootstepQp(double com_height,
+                 const std::vector<double>& left_right_support_durations,
+                 int num_steps, double step_width, double max_step_deviation,
+                 double w_velocity = 1, double w_step = 0.1);
+
+  /// Plans the footsteps
+  /// @param com_state (x, y, xdot, ydot) of the CoM at the end of the current
+  ///    stance
+  /// @param stance_foot (x, y) of the current stance foot
+  /// @param des_vel desired CoM velocity, in the world frame
+  /// @param heading yaw angle used to place the nominal step width
+  /// @param first_step_is_left whether p_1 is a left foot step
+  /// @return the (x, y) footsteps, 2 x num_steps
+  Eigen::MatrixXd Solve(const Eigen::Vector4d& com_state,
+                        const Eigen::Vector2d& stance_foot,
+                        const Eigen::Vector2d& des_vel, double heading,
+                        bool first_step_is_left);
+
+  /// (c, cdot) after t seconds on the stance foot p, starting from s
+  Eigen::Vector2d Propagate(const Eigen::Vector2d& s, double p,
+                            double t) const;
+
+  double omega() const { return omega_; }
+  int num_steps() const { return num_steps_; }
+  double step_duration(int j, bool first_step_is_left) const;
+  const drake::solvers::MathematicalProgram& prog() const { return *prog_; }
+
+ private:
+  // Condensed velocity rows, cdot_j = Phi_v.row(j) s_0 + G.row(j) p
+  struct Structure {
+    Eigen::MatrixXd Phi_v;
+    Eigen::MatrixXd G;
+    Eigen::MatrixXd Q;
+  };
+
+  const double omega_;
+  const std::vector<double> durations_;
+  const int num_steps_;
+  const double step_width_;
+  const double max_step_deviation_;
+  const double w_velocity_;
+  const double w_step_;
+
+  // Indexed by first_step_is_left
+  std::vector<Structure> structures_;
+  // Step differences, (D p)_j = p_j - p_{j-1} (with p_0 = 0), per axis
+  Eigen::MatrixXd D_;
+  Eigen::MatrixXd A_steps_;
+
+  std::unique_ptr<drake::solvers::MathematicalProgram> prog_;
+  drake::solvers::VectorXDecisionVariable footsteps_;
+  std::shared_ptr<drake::solvers::QuadraticCost> cost_;
+  std::shared_ptr<drake::solvers::LinearConstraint> step_constraint_;
+  drake::solvers::OsqpSolver solver_;
+  Eigen::VectorXd prev_solution_;
+  drake::solvers::MathematicalProgramResult result_;
+
+  // Scratch space of Solve()
+  Eigen::MatrixXd nominal_;
+  Eigen::VectorXd e_;
+  Eigen::VectorXd velocity_error_;
+  Eigen::VectorXd b_;
+  Eigen::VectorXd lb_;
+  Eigen::VectorXd ub_;
+};
+
+/// LipmMpc is a receding-horizon replacement for the LIPMTrajGenerator and
+/// CPTrajGenerator pair. At every update, it plans num_steps footsteps with
+/// LipmFootstepQp, starting from the predicted CoM state at the end of the
+/// current stance, and outputs
+///  - the CoM trajectory over the horizon (for ComTrackingData). The
+///    horizontal motion is the exact LIPM solution, sampled into a cubic
+///    Hermite spline; the height is desired_com_height above the stance foot.
+///  - the swing foot trajectory to the first planned footstep (for
+///    TransTaskSpaceTrackingData), shaped like the one of CPTrajGenerator.
+///  - the planned footsteps, (x_1, y_1, ..., x_n, y_n).
+///
+/// The desired velocity input is (sagittal, lateral) in the pelvis heading
+/// frame, as for DeviationFromCapturePoint. In FSM states other than left and
+/// right support (e.g. double support), the last single support state is
+/// continued with no time remaining and the swing foot trajectory is
+/// constant.
+class LipmMpc : public drake::systems::LeafSystem<double> {
+ public:
+  LipmMpc(const drake::multibody::MultibodyPlant<double>& plant,
+          double desired_com_height,
+          const std::vector<int>& left_right_support_fsm_states,
+          const std::vector<double>& left_right_support_durations,
+          const std::vector<std::pair<const Eigen::Vector3d,
+                                      const drake::multibody::Frame<double>&>>&
+              left_right_foot,
+          const std::string& floating_base_body_name, int num_steps,
+          double step_width, double max_step_deviation, double mid_foot_height,
+          double desired_final_foot_height, int num_knots_per_step = 5);
+
+  const drake::systems::InputPort<double>& get_input_port_state() const {
+    return this->get_input_port(state_port_);
+  }
+  const drake::systems::InputPort<double>& get_input_port_fsm() const {
+    return this->get_input_port(fsm_port_);
+  }
+  const drake::systems::InputPort<double>& get_input_port_des_vel() const {
+    return this->get_input_port(des_vel_port_);
+  }
+  const drake::systems::OutputPort<double>& get_output_port_com() const {
+    return this->get_output_port(com_traj_port_);
+  }
+  const drake::systems::OutputPort<double>& get_output_port_swing_foot()
+      const {
+    return this->get_output_port(swing_foot_traj_port_);
+  }
+  const drake::systems::OutputPort<double>& get_output_port_footsteps()
+      const {
+    return this->get_output_port(footsteps_port_);
+  }
+
+  const LipmFootstepQp& qp() const { return *qp_; }
+
+ private:
+  // Stance foot index (0 for left, 1 for right) of the current or last single
+  // support state
+  int StanceIndex(const drake::systems::Context<double>& context) const;
+
+  // CoM (x, y, xdot, ydot), stance foot position and remaining stance time
+  void CalcLipmState(const drake::systems::Context<double>& context,
+                     int stance, Eigen::Vector4d* com_state,
+                     Eigen::Vector3d* stance_foot_pos,
+                     double* time_remaining) const;
+
+  drake::systems::EventStatus DiscreteVariableUpdate(
+      const drake::systems::Context<double>& context,
+      drake::systems::DiscreteValues<double>* discrete_state) const;
+
+  void CalcComTraj(const drake::systems::Context<double>& context,
+                   drake::trajectories::Trajectory<double>* traj) const;
+
+  void CalcSwingFootTraj(const drake::systems::Context<double>& context,
+                         drake::trajectories::Trajectory<double>* traj) const;
+
+  void CalcFootsteps(const drake::systems::Context<double>& context,
+                     drake::systems::BasicVector<double>* footsteps) const;
+
+  // Port indices
+  int state_port_;
+  int fsm_port_;
+  int des_vel_port_;
+  int com_traj_port_;
+  int swing_foot_traj_port_;
+  int footsteps_port_;
+
+  // Discrete state indices
+  int prev_td_time_idx_;
+  int prev_fsm_state_idx_;
+  int stance_idx_;
+  int prev_td_swing_foot_idx_;
+  int footsteps_idx_;
+
+  const drake::multibody::MultibodyPlant<double>& plant_;
+  const double desired_com_height_;
+  const std::vector<int> left_right_support_fsm_states_;
+  const std::vector<double> left_right_support_durations_;
+  const std::vector<std::pair<const Eigen::Vector3d,
+                              const drake::multibody::Frame<double>&>>
+      left_right_foot_;
+  const double mid_foot_height_;
+  const double desired_final_foot_height_;
+  const int num_knots_per_step_;
+
+  const drake::multibody::BodyFrame<double>& world_;
+  const drake::multibody::Body<double>& pelvis_;
+  std::unique_ptr<drake::systems::Context<double>> context_;
+  // Solve() updates the program and warm start in place
+  std::unique_ptr<LipmFootstepQp> qp_;
+};
+
+}  // namespace systems
+}  // namespace dairlib
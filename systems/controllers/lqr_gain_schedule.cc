@@ -0,0 +1,297 @@
+#include "systems/controllers/lqr_gain_schedule.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+namespace dairlib {
+namespace systems {
+
+using drake::systems::Context;
+using Eigen::Map;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using std::string;
+using std::vector;
+
+namespace {
+const uint32_t kMagic = 0x53474c44;  // "DLGS"
+const uint32_t kVersion = 1;
+
+template <typename T>
+void WriteValue(std::ofstream* fout, T value) {
+  fout->write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T ReadValue(std::ifstream* fin) {
+  T value;
+  fin->read(reinterpret_cast<char*>(&value), sizeof(T));
+  return value;
+}
+}  // namespace
+
+LQRGainSchedule::LQRGainSchedule(const vector<vector<double>>& breakpoints,
+                                 const vector<int>& scheduling_indices,
+                                 int num_states, int num_inputs)
+    : breakpoints_(breakpoints),
+      scheduling_indices_(scheduling_indices),
+      num_states_(num_states),
+      num_inputs_(num_inputs) {
+  DRAKE_DEMAND(breakpoints.size() == scheduling_indices.size());
+  DRAKE_DEMAND(num_dimensions() > 0);
+  DRAKE_DEMAND(num_dimensions() <= kMaxDimensions);
+
+  // Strides of the entries, last dimension fastest
+  strides_ = vector<int>(num_dimensions());
+  int num_entries = 1;
+  for (int i = num_dimensions() - 1; i >= 0; i--) {
+    const vector<double>& b = breakpoints_[i];
+    DRAKE_DEMAND(!b.empty());
+    DRAKE_DEMAND(std::is_sorted(b.begin(), b.end()));
+    DRAKE_DEMAND(scheduling_indices_[i] >= 0 &&
+                 scheduling_indices_[i] < num_states);
+    strides_[i] = num_entries;
+    num_entries *= b.size();
+  }
+
+  uniform_spacing_ = vector<double>(num_dimensions(), 0);
+  for (int i = 0; i < num_dimensions(); i++) {
+    const vector<double>& b = breakpoints_[i];
+    if (b.size() < 2) continue;
+    const double spacing = (b.back() - b.front()) / (b.size() - 1);
+    bool is_uniform = spacing > 0;
+    for (int j = 1; j < static_cast<int>(b.size()) && is_uniform; j++) {
+      is_uniform = std::abs(b[j] - b[0] - j * spacing) < 1e-9 * spacing;
+    }
+    if (is_uniform) uniform_spacing_[i] = spacing;
+  }
+
+  data_ = MatrixXd::Zero(num_inputs * num_states + 2 * num_inputs + num_states,
+                         num_entries);
+}
+
+int LQRGainSchedule::EntryIndex(const vector<int>& grid_index) const {
+  DRAKE_DEMAND(static_cast<int>(grid_index.size()) == num_dimensions());
+  int entry = 0;
+  for (int i = 0; i < num_dimensions(); i++) {
+    DRAKE_DEMAND(grid_index[i] >= 0 &&
+                 grid_index[i] < static_cast<int>(breakpoints_[i].size()));
+    entry += strides_[i] * grid_index[i];
+  }
+  return entry;
+}
+
+void LQRGainSchedule::SetEntry(int entry, const MatrixXd& K,
+                               const VectorXd& E, const VectorXd& x_desired) {
+  DRAKE_DEMAND(entry >= 0 && entry < num_entries());
+  DRAKE_DEMAND(K.rows() == num_inputs_ && K.cols() == num_states_);
+  DRAKE_DEMAND(E.size() == num_inputs_);
+  DRAKE_DEMAND(x_desired.size() == num_states_);
+  const int nK = num_inputs_ * num_states_;
+  auto column = data_.col(entry);
+  column.head(nK) = Map<const VectorXd>(K.data(), nK);
+  column.segment(nK, num_inputs_) = E;
+  column.segment(nK + num_inputs_, num_states_) = x_desired;
+  column.tail(num_inputs_) = E + K * x_desired;
+}
+
+Map<const MatrixXd> LQRGainSchedule::K(int entry) const {
+  return Map<const MatrixXd>(data_.col(entry).data(), num_inputs_,
+                             num_states_);
+}
+
+Map<const VectorXd> LQRGainSchedule::E(int entry) const {
+  return Map<const VectorXd>(
+      data_.col(entry).data() + num_inputs_ * num_states_, num_inputs_);
+}
+
+Map<const VectorXd> LQRGainSchedule::x_desired(int entry) const {
+  return Map<const VectorXd>(
+      data_.col(entry).data() + num_inputs_ * num_states_ + num_inputs_,
+      num_states_);
+}
+
+void LQRGainSchedule::Locate(int i, double s, int* cell,
+                             double* fraction) const {
+  const vector<double>& b = breakpoints_[i];
+  const int n = b.size();
+  if (n == 1 || s <= b.front()) {
+    *cell = 0;
+    *fraction = 0;
+    return;
+  }
+  if (s >= b.back()) {
+    *cell = n - 2;
+    *fraction = 1;
+    return;
+  }
+  if (uniform_spacing_[i] > 0) {
+    *cell = std::min(n - 2,
+                     static_cast<int>((s - b[0]) / uniform_spacing_[i]));
+  } else {
+    *cell = std::upper_bound(b.begin(), b.end(), s) - b.begin() - 1;
+  }
+  *fraction = std::min(1.0, std::max(0.0, (s - b[*cell]) /
+                                              (b[*cell + 1] - b[*cell])));
+}
+
+int LQRGainSchedule::CalcWeights(const Eigen::Ref<const VectorXd>& x,
+                                 Lookup lookup, int* entries,
+                                 double* weights) const {
+  DRAKE_ASSERT(x.size() == num_states_);
+  int cells[kMaxDimensions];
+  double fractions[kMaxDimensions];
+  for (int i = 0; i < num_dimensions(); i++) {
+    Locate(i, x(scheduling_indices_[i]), &cells[i], &fractions[i]);
+  }
+
+  if (lookup == Lookup::kNearest) {
+    int entry = 0;
+    for (int i = 0; i < num_dimensions(); i++) {
+      entry += strides_[i] * (cells[i] + (fractions[i] > 0.5 ? 1 : 0));
+    }
+    entries[0] = entry;
+    weights[0] = 1;
+    return 1;
+  }
+
+  // Corners of the cell, skipping those with zero weight (which includes the
+  // nonexistent second corner of single breakpoint dimensions)
+  int num_corners = 0;
+  for (int corner = 0; corner < (1 << num_dimensions()); corner++) {
+    int entry = 0;
+    double weight = 1;
+    for (int i = 0; i < num_dimensions(); i++) {
+      const bool upper = corner & (1 << i);
+      entry += strides_[i] * (cells[i] + (upper ? 1 : 0));
+      weight *= upper ? fractions[i] : 1 - fractions[i];
+    }
+    if (weight == 0) continue;
+    entries[num_corners] = entry;
+    weights[num_corners] = weight;
+    num_corners++;
+  }
+  return num_corners;
+}
+
+void LQRGainSchedule::CalcInput(const Eigen::Ref<const VectorXd>& x,
+                                Lookup lookup,
+                                Eigen::Ref<VectorXd> u) const {
+  DRAKE_ASSERT(u.size() == num_inputs_);
+  int entries[1 << kMaxDimensions];
+  double weights[1 << kMaxDimensions];
+  const int num_corners = CalcWeights(x, lookup, entries, weights);
+
+  // u = sum_i w_i (E_i + K_i x_desired_i - K_i x)
+  u.setZero();
+  for (int i = 0; i < num_corners; i++) {
+    u += weights[i] * data_.col(entries[i]).tail(num_inputs_);
+    u.noalias() -= weights[i] * K(entries[i]) * x;
+  }
+}
+
+void LQRGainSchedule::Save(const string& filepath) const {
+  std::ofstream fout(filepath, std::ios_base::binary | std::ios_base::trunc);
+  if (!fout) {
+    throw std::runtime_error("Could not open file: " + filepath);
+  }
+  WriteValue<uint32_t>(&fout, kMagic);
+  WriteValue<uint32_t>(&fout, kVersion);
+  WriteValue<int32_t>(&fout, num_dimensions());
+  WriteValue<int32_t>(&fout, num_states_);
+  WriteValue<int32_t>(&fout, num_inputs_);
+  for (int i = 0; i < num_dimensions(); i++) {
+    WriteValue<int32_t>(&fout, scheduling_indices_[i]);
+    WriteValue<int32_t>(&fout, breakpoints_[i].size());
+    fout.write(reinterpret_cast<const char*>(breakpoints_[i].data()),
+               sizeof(double) * breakpoints_[i].size());
+  }
+  // The offsets are recomputed on load
+  const int entry_size = num_inputs_ * num_states_ + num_inputs_ + num_states_;
+  const MatrixXd entries = data_.topRows(entry_size);
+  fout.write(reinterpret_cast<const char*>(entries.data()),
+             sizeof(double) * entries.size());
+  if (!fout) {
+    throw std::runtime_error("Could not write file: " + filepath);
+  }
+}
+
+LQRGainSchedule LQRGainSchedule::Load(const string& filepath) {
+  std::ifstream fin(filepath, std::ios_base::binary);
+  if (!fin) {
+    throw std::runtime_error("Could not open file: " + filepath);
+  }
+  if (ReadValue<uint32_t>(&fin) != kMagic ||
+      ReadValue<uint32_t>(&fin) != kVersion) {
+    throw std::runtime_error("Not an LQR gain schedule file: " + filepath);
+  }
+  const int num_dims = ReadValue<int32_t>(&fin);
+  const int num_states = ReadValue<int32_t>(&fin);
+  const int num_inputs = ReadValue<int32_t>(&fin);
+  if (!fin || num_dims <= 0 || num_dims > kMaxDimensions) {
+    throw std::runtime_error("Corrupt LQR gain schedule file: " + filepath);
+  }
+  vector<vector<double>> breakpoints(num_dims);
+  vector<int> scheduling_indices(num_dims);
+  for (int i = 0; i < num_dims; i++) {
+    scheduling_indices[i] = ReadValue<int32_t>(&fin);
+    const int num_breakpoints = ReadValue<int32_t>(&fin);
+    if (!fin || num_breakpoints <= 0) {
+      throw std::runtime_error("Corrupt LQR gain schedule file: " + filepath);
+    }
+    breakpoints[i].resize(num_breakpoints);
+    fin.read(reinterpret_cast<char*>(breakpoints[i].data()),
+             sizeof(double) * num_breakpoints);
+  }
+
+  LQRGainSchedule schedule(breakpoints, scheduling_indices, num_states,
+                           num_inputs);
+  const int nK = num_inputs * num_states;
+  MatrixXd entries(nK + num_inputs + num_states, schedule.num_entries());
+  fin.read(reinterpret_cast<char*>(entries.data()),
+           sizeof(double) * entries.size());
+  if (!fin) {
+    throw std::runtime_error("Truncated LQR gain schedule file: " + filepath);
+  }
+  for (int j = 0; j < schedule.num_entries(); j++) {
+    schedule.SetEntry(
+        j, Map<const MatrixXd>(entries.col(j).data(), num_inputs, num_states),
+        entries.col(j).segment(nK, num_inputs),
+        entries.col(j).segment(nK + num_inputs, num_states));
+  }
+  return schedule;
+}
+
+GainScheduledLQRController::GainScheduledLQRController(
+    const drake::multibody::MultibodyPlant<double>& plant,
+    const LQRGainSchedule& schedule, LQRGainSchedule::Lookup lookup)
+    : schedule_(schedule), lookup_(lookup) {
+  DRAKE_DEMAND(schedule.num_states() ==
+               plant.num_positions() + plant.num_velocities());
+  DRAKE_DEMAND(schedule.num_inputs() == plant.num_actuators());
+
+  input_port_info_index_ = this->DeclareVectorInputPort(
+      OutputVector<double>(plant.num_positions(),
+          plant.num_velocities(), plant.num_actuators())).get_index();
+
+  output_port_efforts_index_ = this->DeclareVectorOutputPort(
+      TimestampedVector<double>(plant.num_actuators()),
+          &GainScheduledLQRController::CalcControl).get_index();
+}
+
+void GainScheduledLQRController::CalcControl(
+    const Context<double>& context, TimestampedVector<double>* control) const {
+  const OutputVector<double>* info =
+      (OutputVector<double>*)this->EvalVectorInput(context,
+                                                   input_port_info_index_);
+
+  auto u = control->get_mutable_data();
+  schedule_.CalcInput(info->GetState(), lookup_, u);
+  control->set_timestamp(info->get_timestamp());
+}
+
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "systems/framework/output_vector.h"
+
+#include "drake/multibody/plant/multibody_plant.h"
+#include "drake/systems/framework/leaf_system.h"
+
+namespace dairlib {
+namespace systems {
+
+/// A table of LQR controllers u = K (x_desired - x) + E, computed offline
+/// (e.g. by ConstrainedLQRController) on a rectilinear grid over a few
+/// scheduling coordinates. Each scheduling coordinate is an element of the
+/// state, such as the pelvis height.
+///
+/// Entries are stored contiguously, one column per grid point, together with
+/// the offset E + K x_desired, so that evaluating the controller of an entry
+/// is a single matrix-vector product. Locating the grid cell of a state is
+/// O(1) along uniformly spaced coordinates (checked at construction) and a
+/// binary search along the others. States outside of the grid are clamped to
+/// its boundary.
+///
+/// The binary file format of Save() and Load() is
+///   uint32 magic, uint32 version, int32 num_dims, num_states, num_inputs,
+///   per dimension: int32 state index, int32 num_breakpoints, the breakpoints
+///   per entry: K (column major), E, x_desired
+/// with entries ordered by the last dimension fastest, in native byte order.
+class LQRGainSchedule {
+ public:
+  enum class Lookup {
+    /// Multilinear blend of the inputs of the controllers at the corners of
+    /// the grid cell
+    kInterpolate,
+    /// The controller at the nearest grid point
+    kNearest
+  };
+
+  static constexpr int kMaxDimensions = 4;
+
+  /// @param breakpoints sorted grid breakpoints of each scheduling coordinate
+  /// @param scheduling_indices state index of each scheduling coordinate
+  LQRGainSchedule(const std::vector<std::vector<double>>& breakpoints,
+                  const std::vector<int>& scheduling_indices, int num_states,
+                  int num_inputs);
+
+  int num_dimensions() const { return scheduling_indices_.size(); }
+  int num_entries() const { return data_.cols(); }
+  int num_states() const { return num_states_; }
+  int num_inputs() const { return num_inputs_; }
+  const std::vector<std::vector<double>>& breakpoints() const {
+    return breakpoints_;
+  }
+  const std::vector<int>& scheduling_indices() const {
+    return scheduling_indices_;
+  }
+
+  /// Entry of the grid point with the given breakpoint index per dimension
+  int EntryIndex(const std::vector<int>& grid_index) const;
+
+  void SetEntry(int entry, const Eigen::MatrixXd& K, const Eigen::VectorXd& E,
+                const Eigen::VectorXd& x_desired);
+  Eigen::Map<const Eigen::MatrixXd> K(int entry) const;
+  Eigen::Map<const Eigen::VectorXd> E(int entry) const;
+  Eigen::Map<const Eigen::VectorXd> x_desired(int entry) const;
+
+  /// Entries and weights of the controllers to blend at state x. Writes at
+  /// most 2^num_dimensions() entries and returns their number.
+  int CalcWeights(const Eigen::Ref<const Eigen::VectorXd>& x, Lookup lookup,
+                  int* entries, double* weights) const;
+
+  /// The scheduled input at state x. Does not allocate.
+  void CalcInput(const Eigen::Ref<const Eigen::VectorXd>& x, Lookup lookup,
+                 Eigen::Ref<Eigen::VectorXd> u) const;
+
+  void Save(const std::string& filepath) const;
+  static LQRGainSchedule Load(const std::string& filepath);
+
+ private:
+  // Cell of scheduling coordinate i containing s, and the fraction of s
+  // within the cell, in [0, 1]
+  void Locate(int i, double s, int* cell, double* fraction) const;
+
+  std::vector<std::vector<double>> breakpoints_;
+  std::vector<int> scheduling_indices_;
+  int num_states_;
+  int num_inputs_;
+  std::vector<int> strides_;
+  // Breakpoint spacing of each coordinate, or 0 if not uniformly spaced
+  std::vector<double> uniform_spacing_;
+  // One column per entry, [K (column major); E; x_desired; E + K x_desired]
+  Eigen::MatrixXd data_;
+};
+
+/// GainScheduledLQRController applies the LQR controller of an
+/// LQRGainSchedule at the current state. It has the same ports as
+/// ConstrainedLQRController.
+class GainScheduledLQRController : public drake::systems::LeafSystem<double> {
+ public:
+  GainScheduledLQRController(
+      const drake::multibody::MultibodyPlant<double>& plant,
+      const LQRGainSchedule& schedule,
+      LQRGainSchedule::Lookup lookup = LQRGainSchedule::Lookup::kInterpolate);
+
+  const drake::systems::InputPort<double>& get_input_port_info() const {
+    return this->get_input_port(input_port_info_index_);
+  }
+  const drake::systems::OutputPort<double>& get_output_port_efforts() const {
+    return this->get_output_port(output_port_efforts_index_);
+  }
+
+  const LQRGainSchedule& schedule() const { return schedule_; }
+
+ private:
+  void CalcControl(const drake::systems::Context<double>& context,
+                   TimestampedVector<double>* control) const;
+
+  const LQRGainSchedule schedule_;
+  const LQRGainSchedule::Lookup lookup_;
+  int input_port_info_index_;
+  int output_port_efforts_index_;
+};
+
+}  // namespace systems
+}  // namespace dairlib
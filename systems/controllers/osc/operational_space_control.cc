@@ -189,6 +189,7 @@ void OperationalSpaceControl::AddTrackingData(OscTrackingData* tracking_data,
                                               double t_lb, double t_ub) {
   tracking_data_vec_->push_back(tracking_data);
   fixed_position_vec_.push_back(VectorXd::Zero(0));
+  fixed_traj_vec_.emplace_back();
   t_s_vec_.push_back(t_lb);
   t_e_vec_.push_back(t_ub);
 
@@ -211,6 +212,7 @@ void OperationalSpaceControl::AddConstTrackingData(
     double t_ub) {
   tracking_data_vec_->push_back(tracking_data);
   fixed_position_vec_.push_back(v);
+  fixed_traj_vec_.emplace_back(v);
   t_s_vec_.push_back(t_lb);
   t_e_vec_.push_back(t_ub);
 }
@@ -436,8 +438,8 @@ VectorXd OperationalSpaceControl::SolveQp(
   MatrixXd J_c = MatrixXd::Zero(n_c_, n_v_);
   for (unsigned int i = 0; i < all_contacts_.size(); i++) {
     if (active_contact_set.find(i) != active_contact_set.end()) {
-      J_c.block(SPACE_DIM * i, 0, SPACE_DIM, n_v_) =
-          all_contacts_[i]->EvalFullJacobian(*context_wo_spr_);
+      all_contacts_[i]->EvalFullJacobianInto(
+          *context_wo_spr_, J_c.block(SPACE_DIM * i, 0, SPACE_DIM, n_v_));
     }
   }
 
@@ -454,8 +456,9 @@ VectorXd OperationalSpaceControl::SolveQp(
         J_c_active.row(row_idx + j) =
             J_c.row(SPACE_DIM * i + contact_i->active_inds().at(j));
       }
-      JdotV_c_active.segment(row_idx, contact_i->num_active()) =
-          contact_i->EvalActiveJacobianDotTimesV(*context_wo_spr_);
+      contact_i->EvalActiveJacobianDotTimesVInto(
+          *context_wo_spr_,
+          JdotV_c_active.segment(row_idx, contact_i->num_active()));
     }
     row_idx += contact_i->num_active();
   }
@@ -539,10 +542,10 @@ VectorXd OperationalSpaceControl::SolveQp(
 
     // Check whether or not it is a constant trajectory, and update TrackingData
     if (fixed_position_vec_.at(i).size() != 0) {
-      // Create constant trajectory and update
-      tracking_data->Update(
-          x_w_spr, *context_w_spr_, x_wo_spr, *context_wo_spr_,
-          PiecewisePolynomial<double>(fixed_position_vec_.at(i)), t, fsm_state);
+      // Update with the constant trajectory built in AddConstTrackingData()
+      tracking_data->Update(x_w_spr, *context_w_spr_, x_wo_spr,
+                            *context_wo_spr_, fixed_traj_vec_.at(i), t,
+                            fsm_state);
     } else {
       // Read in traj from input port
       string traj_name = tracking_data->GetName();
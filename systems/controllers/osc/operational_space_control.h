@@ -268,6 +268,10 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
 
   // Fixed position of constant trajectories
   std::vector<Eigen::VectorXd> fixed_position_vec_;
+  // Constant trajectories of fixed_position_vec_ (empty if not constant), so
+  // that they are not rebuilt at every update
+  std::vector<drake::trajectories::PiecewisePolynomial<double>>
+      fixed_traj_vec_;
 
   // Set a period during which we apply control (Unit: seconds)
   // Let t be the elapsed time since fsm switched to a new state.
@@ -0,0 +1,320 @@
+#include "systems/controllers/osc/osc_debug_recorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+namespace dairlib {
+namespace systems {
+namespace controllers {
+
+using drake::systems::BasicVector;
+using drake::systems::Context;
+using drake::systems::EventStatus;
+using Eigen::VectorXd;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Getters of the recorded fields, in the order of OscDebugFieldNames() and
+// as in OperationalSpaceControl::AssignOscLcmOutput()
+const VectorXd& (OscTrackingData::*const kFields[])() const = {
+    &OscTrackingData::GetY,
+    &OscTrackingData::GetYDes,
+    &OscTrackingData::GetErrorY,
+    &OscTrackingData::GetYdot,
+    &OscTrackingData::GetYdotDes,
+    &OscTrackingData::GetErrorYdot,
+    &OscTrackingData::GetYddotDesConverted,
+    &OscTrackingData::GetYddotCommand,
+    &OscTrackingData::GetYddotCommandSol};
+const int kNumFields = sizeof(kFields) / sizeof(kFields[0]);
+
+// Bound of the quantized values, so that their differences fit in an int64
+const double kMaxQuantized = 4e18;
+
+// Non-finite values are encoded as 0
+int64_t Quantize(double value, double resolution) {
+  if (!std::isfinite(value)) return 0;
+  return std::llround(
+      std::max(std::min(value / resolution, kMaxQuantized), -kMaxQuantized));
+}
+
+// Zigzag LEB128 varint
+void AppendVarint(int64_t value, vector<uint8_t>* data) {
+  uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^
+                    static_cast<uint64_t>(value >> 63);
+  while (zigzag >= 0x80) {
+    data->push_back(static_cast<uint8_t>(zigzag | 0x80));
+    zigzag >>= 7;
+  }
+  data->push_back(static_cast<uint8_t>(zigzag));
+}
+
+int64_t ReadVarint(const vector<uint8_t>& data, size_t* index) {
+  uint64_t zigzag = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (*index >= data.size()) {
+      throw std::runtime_error("Truncated lcmt_osc_debug_batch");
+    }
+    const uint8_t byte = data[(*index)++];
+    zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return static_cast<int64_t>(zigzag >> 1) ^
+             -static_cast<int64_t>(zigzag & 1);
+    }
+  }
+  throw std::runtime_error("Malformed lcmt_osc_debug_batch");
+}
+
+// FNV-1a hash of the schema content
+int64_t HashSchema(const lcmt_osc_debug_schema& schema) {
+  uint64_t hash = 14695981039346656037ull;
+  auto add = [&hash](const void* bytes, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      hash = (hash ^ static_cast<const uint8_t*>(bytes)[i]) * 1099511628211ull;
+    }
+  };
+  add(&schema.resolution, sizeof(schema.resolution));
+  for (int i = 0; i < schema.num_streams; i++) {
+    add(schema.names[i].data(), schema.names[i].size() + 1);
+    add(&schema.y_dims[i], sizeof(schema.y_dims[i]));
+    add(&schema.decimations[i], sizeof(schema.decimations[i]));
+  }
+  return static_cast<int64_t>(hash);
+}
+
+}  // namespace
+
+vector<OscDebugStream> MakeOscDebugStreams(
+    const vector<OscTrackingData*>& tracking_data, int decimation) {
+  vector<OscDebugStream> streams;
+  for (auto data : tracking_data) {
+    // Tracking data sharing a trajectory have the same name and dimension
+    bool is_new = true;
+    for (const auto& stream : streams) {
+      is_new = is_new && stream.name != data->GetName();
+    }
+    if (is_new) {
+      streams.push_back({data->GetName(), data->GetTrajDim(), decimation});
+    }
+  }
+  return streams;
+}
+
+const vector<string>& OscDebugFieldNames() {
+  static const vector<string> names = {
+      "y",         "y_des",         "error_y",
+      "ydot",      "ydot_des",      "error_ydot",
+      "yddot_des", "yddot_command", "yddot_command_sol"};
+  return names;
+}
+
+void EncodeOscDebugSamples(const vector<int64_t>& utimes,
+                           const vector<double>& values, int sample_size,
+                           double resolution, lcmt_osc_debug_batch* batch) {
+  DRAKE_DEMAND(sample_size > 0);
+  DRAKE_DEMAND(values.size() == utimes.size() * sample_size);
+  batch->num_samples = utimes.size();
+  batch->first_utime = utimes.empty() ? 0 : utimes.front();
+  batch->utime = utimes.empty() ? 0 : utimes.back();
+  batch->data.clear();
+  batch->data.reserve(utimes.size() * (sample_size + 1));
+
+  vector<int64_t> previous(sample_size, 0);
+  int64_t previous_utime = batch->first_utime;
+  for (size_t k = 0; k < utimes.size(); k++) {
+    AppendVarint(utimes[k] - previous_utime, &batch->data);
+    previous_utime = utimes[k];
+    for (int i = 0; i < sample_size; i++) {
+      // The fsm state is exact
+      const int64_t quantized =
+          Quantize(values[k * sample_size + i], i == 0 ? 1 : resolution);
+      AppendVarint(quantized - previous[i], &batch->data);
+      previous[i] = quantized;
+    }
+  }
+  batch->num_bytes = batch->data.size();
+}
+
+void DecodeOscDebugSamples(const lcmt_osc_debug_batch& batch, int sample_size,
+                           double resolution, vector<int64_t>* utimes,
+                           vector<double>* values) {
+  DRAKE_DEMAND(sample_size > 0);
+  utimes->resize(batch.num_samples);
+  values->resize(batch.num_samples * sample_size);
+
+  size_t index = 0;
+  vector<int64_t> previous(sample_size, 0);
+  int64_t previous_utime = batch.first_utime;
+  for (int k = 0; k < batch.num_samples; k++) {
+    previous_utime += ReadVarint(batch.data, &index);
+    (*utimes)[k] = previous_utime;
+    for (int i = 0; i < sample_size; i++) {
+      previous[i] += ReadVarint(batch.data, &index);
+      (*values)[k * sample_size + i] =
+          i == 0 ? previous[i] : previous[i] * resolution;
+    }
+  }
+}
+
+OscDebugRecorder::OscDebugRecorder(
+    const vector<OscTrackingData*>& tracking_data,
+    const vector<OscDebugStream>& streams, int num_inputs,
+    drake::lcm::DrakeLcmInterface* lcm, const string& channel,
+    double resolution, int queue_capacity, double flush_period,
+    double schema_period)
+    : tracking_data_(tracking_data),
+      streams_(streams),
+      lcm_(lcm),
+      schema_channel_(channel + "_SCHEMA"),
+      batch_channel_(channel + "_BATCH"),
+      resolution_(resolution),
+      flush_period_(flush_period),
+      schema_period_(schema_period) {
+  DRAKE_DEMAND(lcm != nullptr);
+  DRAKE_DEMAND(resolution > 0);
+  fsm_port_ =
+      this->DeclareVectorInputPort("fsm", BasicVector<double>(1)).get_index();
+  osc_output_port_ =
+      this->DeclareVectorInputPort("u, t",
+                                   TimestampedVector<double>(num_inputs))
+          .get_index();
+  this->DeclareForcedPublishEvent(&OscDebugRecorder::Sample);
+
+  schema_.resolution = resolution;
+  schema_.num_streams = streams_.size();
+  schema_.field_names = OscDebugFieldNames();
+  schema_.num_fields = schema_.field_names.size();
+  std::map<string, int> name_to_stream;
+  for (size_t i = 0; i < streams_.size(); i++) {
+    const OscDebugStream& stream = streams_[i];
+    DRAKE_DEMAND(stream.y_dim > 0);
+    DRAKE_DEMAND(stream.decimation > 0);
+    DRAKE_DEMAND(name_to_stream.count(stream.name) == 0);
+    name_to_stream[stream.name] = i;
+    schema_.names.push_back(stream.name);
+    schema_.y_dims.push_back(stream.y_dim);
+    schema_.decimations.push_back(stream.decimation);
+
+    const int sample_size = 1 + kNumFields * stream.y_dim;
+    queues_.push_back(
+        std::make_unique<SampleQueue>(queue_capacity, sample_size));
+    num_dropped_.push_back(std::make_unique<std::atomic<int64_t>>(0));
+    samples_.push_back(VectorXd::Zero(sample_size));
+  }
+  schema_.schema_id = HashSchema(schema_);
+
+  for (auto data : tracking_data_) {
+    auto it = name_to_stream.find(data->GetName());
+    tracking_data_stream_.push_back(it == name_to_stream.end() ? -1
+                                                               : it->second);
+  }
+
+  drain_thread_ = std::thread(&OscDebugRecorder::Run, this);
+}
+
+OscDebugRecorder::~OscDebugRecorder() { Stop(); }
+
+void OscDebugRecorder::Stop() {
+  keep_running_ = false;
+  if (drain_thread_.joinable()) {
+    drain_thread_.join();
+  }
+}
+
+EventStatus OscDebugRecorder::Sample(const Context<double>& context) const {
+  const int64_t update = num_updates_++;
+  bool any_due = false;
+  for (const auto& stream : streams_) {
+    any_due = any_due || update % stream.decimation == 0;
+  }
+  if (!any_due) return EventStatus::Succeeded();
+
+  // Makes sure that the OSC has updated the tracking data for this context
+  const auto* osc_output = static_cast<const TimestampedVector<double>*>(
+      this->EvalVectorInput(context, osc_output_port_));
+  const double fsm_state =
+      this->EvalVectorInput(context, fsm_port_)->get_value()(0);
+  const auto utime =
+      static_cast<int64_t>(std::round(osc_output->get_timestamp() * 1e6));
+  for (size_t k = 0; k < tracking_data_.size(); k++) {
+    const int i = tracking_data_stream_[k];
+    if (i < 0 || update % streams_[i].decimation != 0 ||
+        !tracking_data_[k]->IsActive()) {
+      continue;
+    }
+
+    // As in the lcm encoding of lcmt_osc_output, only the first y_dim values
+    // of each field are recorded. Shorter fields are padded with zeros, rather
+    // than keeping the values of the previous sample.
+    VectorXd& sample = samples_[i];
+    const int y_dim = streams_[i].y_dim;
+    sample(0) = fsm_state;
+    for (int j = 0; j < kNumFields; j++) {
+      const VectorXd& field = (tracking_data_[k]->*kFields[j])();
+      const int n = std::min<int>(y_dim, field.size());
+      sample.segment(1 + j * y_dim, n) = field.head(n);
+      sample.segment(1 + j * y_dim + n, y_dim - n).setZero();
+    }
+    if (!queues_[i]->Push(utime, sample)) {
+      num_dropped_[i]->fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  latest_utime_ = utime;
+  return EventStatus::Succeeded();
+}
+
+void OscDebugRecorder::Run() {
+  const auto period = std::chrono::duration<double>(flush_period_);
+  const auto schema_period = std::chrono::duration<double>(schema_period_);
+  PublishSchema();
+  auto last_schema = std::chrono::steady_clock::now();
+  while (keep_running_) {
+    std::this_thread::sleep_for(period);
+    if (std::chrono::steady_clock::now() - last_schema >= schema_period) {
+      PublishSchema();
+      last_schema = std::chrono::steady_clock::now();
+    }
+    Drain();
+  }
+  // Pick up anything pushed before Stop()
+  Drain();
+}
+
+void OscDebugRecorder::PublishSchema() {
+  lcmt_osc_debug_schema schema = schema_;
+  schema.utime = latest_utime_;
+  drake::lcm::Publish(lcm_, schema_channel_, schema);
+}
+
+void OscDebugRecorder::Drain() {
+  vector<int64_t> utimes;
+  vector<double> values;
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    const int sample_size = 1 + kNumFields * streams_[i].y_dim;
+    utimes.clear();
+    values.clear();
+    int64_t utime;
+    vector<double> sample(sample_size);
+    while (queues_[i]->Pop(&utime, sample.data())) {
+      utimes.push_back(utime);
+      values.insert(values.end(), sample.begin(), sample.end());
+    }
+    if (utimes.empty()) continue;
+
+    lcmt_osc_debug_batch batch;
+    batch.schema_id = schema_.schema_id;
+    batch.stream_index = i;
+    batch.dropped_samples = num_dropped_[i]->load();
+    EncodeOscDebugSamples(utimes, values, sample_size, resolution_, &batch);
+    drake::lcm::Publish(lcm_, batch_channel_, batch);
+  }
+}
+
+}  // namespace controllers
+}  // namespace systems
+}  // namespace dairlib
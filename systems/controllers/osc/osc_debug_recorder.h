@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dairlib/lcmt_osc_debug_batch.hpp"
+#include "dairlib/lcmt_osc_debug_schema.hpp"
+#include "systems/async_vector_scope.h"
+#include "systems/controllers/osc/osc_tracking_data.h"
+#include "systems/framework/timestamped_vector.h"
+
+#include "drake/lcm/drake_lcm_interface.h"
+#include "drake/systems/framework/leaf_system.h"
+
+namespace dairlib {
+namespace systems {
+namespace controllers {
+
+/// A tracking data recorded by OscDebugRecorder
+/// @param name the name of the tracking data (OscTrackingData::GetName())
+/// @param y_dim the dimension of the tracking data
+/// @param decimation records every decimation-th controller update
+struct OscDebugStream {
+  std::string name;
+  int y_dim;
+  int decimation = 1;
+};
+
+/// One stream per tracking data of the OSC, with the same decimation
+std::vector<OscDebugStream> MakeOscDebugStreams(
+    const std::vector<OscTrackingData*>& tracking_data, int decimation = 1);
+
+/// Names of the fields of lcmt_osc_tracking_data recorded in each sample,
+/// after the fsm state
+const std::vector<std::string>& OscDebugFieldNames();
+
+/// Encodes samples of sample_size values (fsm state first) into the data of
+/// batch, as described in lcmt_osc_debug_batch. `values` holds the samples
+/// one after the other.
+void EncodeOscDebugSamples(const std::vector<int64_t>& utimes,
+                           const std::vector<double>& values, int sample_size,
+                           double resolution, lcmt_osc_debug_batch* batch);
+
+/// Inverse of EncodeOscDebugSamples, up to the quantization of the values.
+/// Throws std::runtime_error if the data is truncated.
+void DecodeOscDebugSamples(const lcmt_osc_debug_batch& batch, int sample_size,
+                           double resolution, std::vector<int64_t>* utimes,
+                           std::vector<double>* values);
+
+/// Compact replacement for publishing lcmt_osc_output on every controller
+/// update.
+///
+/// On each forced publish (as the OSC_DEBUG publishers of the controllers
+/// driven by LcmDrivenLoop), the streams which are due copy the values of
+/// their active tracking data, read directly from the OscTrackingData of the
+/// OSC, into lock-free, preallocated queues (see SampleQueue). Nothing is
+/// allocated on the thread advancing the diagram: the OSC's lcmt_osc_output
+/// is never evaluated, and the LCM messages are only built by a background
+/// thread, which drains the queues every flush_period seconds and publishes:
+///  - lcmt_osc_debug_schema on <channel>_SCHEMA, with the tracking data names
+///    and dimensions, once at startup and then every schema_period seconds
+///    so that late subscribers and logs can decode the stream
+///  - one lcmt_osc_debug_batch per stream on <channel>_BATCH, quantized and
+///    delta encoded
+///
+/// The OSC control output is an input so that the tracking data are up to
+/// date with the context when sampled (as it is cached, evaluating it again
+/// is free), and its timestamp is the utime of the samples. The fsm state is
+/// recorded from the fsm input.
+///
+/// pydairlib.osc_debug reconstructs the signals from an LCM log.
+class OscDebugRecorder : public drake::systems::LeafSystem<double> {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(OscDebugRecorder)
+
+  /// @param tracking_data the tracking data of the OSC
+  /// @param streams the tracking data to record, by name. Tracking data
+  ///    sharing a name are recorded in the same stream.
+  /// @param num_inputs the size of the OSC control output
+  /// @param lcm the lcm instance to publish on, from the background thread.
+  ///    DrakeLcm isn't thread-safe, so no other thread (e.g. the one handling
+  ///    the subscriptions of an LcmDrivenLoop) may use it: give the recorder
+  ///    its own instance, which outlives it.
+  /// @param channel the prefix of the schema and batch channels
+  /// @param resolution the quantization step of the values
+  /// @param queue_capacity the number of samples each queue holds
+  /// @param flush_period the period of the background thread, in seconds
+  /// @param schema_period the period of the schema messages, in seconds
+  OscDebugRecorder(const std::vector<OscTrackingData*>& tracking_data,
+                   const std::vector<OscDebugStream>& streams, int num_inputs,
+                   drake::lcm::DrakeLcmInterface* lcm,
+                   const std::string& channel = "OSC_DEBUG",
+                   double resolution = 1e-6, int queue_capacity = 4096,
+                   double flush_period = 0.05, double schema_period = 1.0);
+
+  ~OscDebugRecorder() override;
+
+  const drake::systems::InputPort<double>& get_fsm_input_port() const {
+    return this->get_input_port(fsm_port_);
+  }
+  const drake::systems::InputPort<double>& get_osc_output_input_port() const {
+    return this->get_input_port(osc_output_port_);
+  }
+
+  /// Stops the background thread after draining all queued samples. Called by
+  /// the destructor.
+  void Stop();
+
+  const lcmt_osc_debug_schema& get_schema() const { return schema_; }
+
+  int64_t get_num_dropped(int stream_index) const {
+    return num_dropped_[stream_index]->load();
+  }
+
+ private:
+  drake::systems::EventStatus Sample(
+      const drake::systems::Context<double>& context) const;
+
+  void Run();
+  void Drain();
+  void PublishSchema();
+
+  const std::vector<OscTrackingData*> tracking_data_;
+  const std::vector<OscDebugStream> streams_;
+  // Stream of each tracking data, or -1 if it isn't recorded
+  std::vector<int> tracking_data_stream_;
+  int fsm_port_;
+  int osc_output_port_;
+  drake::lcm::DrakeLcmInterface* lcm_;
+  const std::string schema_channel_;
+  const std::string batch_channel_;
+  const double resolution_;
+  const double flush_period_;
+  const double schema_period_;
+  lcmt_osc_debug_schema schema_;
+
+  std::vector<std::unique_ptr<SampleQueue>> queues_;
+  std::vector<std::unique_ptr<std::atomic<int64_t>>> num_dropped_;
+  // Only touched by the thread advancing the diagram
+  mutable int64_t num_updates_ = 0;
+  mutable std::vector<Eigen::VectorXd> samples_;
+
+  std::atomic<int64_t> latest_utime_{0};
+  std::atomic<bool> keep_running_{true};
+  std::thread drain_thread_;
+};
+
+}  // namespace controllers
+}  // namespace systems
+}  // namespace dairlib
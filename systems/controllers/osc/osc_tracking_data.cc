@@ -2,6 +2,7 @@
 
 #include <math.h>
 #include <algorithm>
+#include <drake/common/trajectories/piecewise_polynomial.h>
 #include <drake/multibody/plant/multibody_plant.h>
 #include "multibody/multibody_utils.h"
 
@@ -11,6 +12,8 @@ using std::endl;
 using drake::multibody::JacobianWrtVariable;
 using drake::multibody::MultibodyPlant;
 using drake::systems::Context;
+using drake::trajectories::PiecewisePolynomial;
+using drake::trajectories::Trajectory;
 using Eigen::Isometry3d;
 using Eigen::MatrixXd;
 using Eigen::Quaterniond;
@@ -24,6 +27,36 @@ namespace dairlib::systems::controllers {
 using multibody::makeNameToPositionsMap;
 using multibody::makeNameToVelocitiesMap;
 
+void EvalTrajectoryAndDerivatives(const Trajectory<double>& traj, double t,
+                                  VectorXd* y, VectorXd* ydot,
+                                  VectorXd* yddot) {
+  DRAKE_DEMAND(traj.cols() == 1);
+  const auto* pp = dynamic_cast<const PiecewisePolynomial<double>*>(&traj);
+  if (pp == nullptr || pp->get_number_of_segments() == 0) {
+    *y = traj.value(t);
+    *ydot = traj.MakeDerivative(1)->value(t);
+    *yddot = traj.MakeDerivative(2)->value(t);
+    return;
+  }
+
+  // Same clamping as PiecewisePolynomial::value(), whose derivatives are
+  // piecewise polynomials with the same breaks
+  const double t_clamped =
+      std::min(std::max(t, pp->start_time()), pp->end_time());
+  const int segment = pp->get_segment_index(t_clamped);
+  const double dt = t_clamped - pp->start_time(segment);
+  const int n = pp->rows();
+  y->resize(n);
+  ydot->resize(n);
+  yddot->resize(n);
+  for (int i = 0; i < n; i++) {
+    const auto& polynomial = pp->getPolynomial(segment, i, 0);
+    (*y)(i) = polynomial.EvaluateUnivariate(dt);
+    (*ydot)(i) = polynomial.EvaluateUnivariate(dt, 1);
+    (*yddot)(i) = polynomial.EvaluateUnivariate(dt, 2);
+  }
+}
+
 /**** OscTrackingData ****/
 OscTrackingData::OscTrackingData(
     const string& name, int n_r, const MatrixXd& K_p, const MatrixXd& K_d,
@@ -43,7 +76,7 @@ OscTrackingData::OscTrackingData(
 bool OscTrackingData::Update(
     const VectorXd& x_w_spr, Context<double>& context_w_spr,
     const VectorXd& x_wo_spr, Context<double>& context_wo_spr,
-    const drake::trajectories::Trajectory<double>& traj, double t,
+    const Trajectory<double>& traj, double t,
     int finite_state_machine_state) {
   // Update track_at_current_state_
   UpdateTrackingFlag(finite_state_machine_state);
@@ -52,9 +85,7 @@ bool OscTrackingData::Update(
   if (track_at_current_state_) {
     // Careful: must update y_des_ before calling UpdateYAndError()
     // Update desired output
-    y_des_ = traj.value(t);
-    ydot_des_ = traj.MakeDerivative(1)->value(t);
-    yddot_des_ = traj.MakeDerivative(2)->value(t);
+    EvalTrajectoryAndDerivatives(traj, t, &y_des_, &ydot_des_, &yddot_des_);
 
     // Update feedback output (Calling virtual methods)
     UpdateYAndError(x_w_spr, context_w_spr);
@@ -12,6 +12,15 @@ namespace dairlib {
 namespace systems {
 namespace controllers {
 
+/// Evaluates the value and the first two time derivatives of the column
+/// trajectory `traj` at time `t`. The derivatives of a PiecewisePolynomial
+/// are evaluated analytically on the active segment, without constructing the
+/// derivative trajectories, and the outputs are only reallocated when their
+/// size changes. Other trajectories fall back on MakeDerivative().
+void EvalTrajectoryAndDerivatives(
+    const drake::trajectories::Trajectory<double>& traj, double t,
+    Eigen::VectorXd* y, Eigen::VectorXd* ydot, Eigen::VectorXd* yddot);
+
 /// OscTrackingData is a virtual class
 
 /// Input of the constructor:
@@ -89,22 +98,27 @@ class OscTrackingData {
               const drake::trajectories::Trajectory<double>& traj, double t,
               int finite_state_machine_state);
 
-  // Getters for debugging
-  Eigen::VectorXd GetY() { return y_; }
-  Eigen::VectorXd GetYDes() { return y_des_; }
-  Eigen::VectorXd GetErrorY() { return error_y_; }
-  Eigen::VectorXd GetYdot() { return ydot_; }
-  Eigen::VectorXd GetYdotDes() { return ydot_des_; }
-  Eigen::VectorXd GetErrorYdot() { return error_ydot_; }
-  Eigen::VectorXd GetYddotDes() { return yddot_des_; }
-  Eigen::VectorXd GetYddotDesConverted() { return yddot_des_converted_; }
-  Eigen::VectorXd GetYddotCommandSol() { return yddot_command_sol_; }
+  // Getters for debugging, by reference so that OscDebugRecorder can copy
+  // them without allocating
+  const Eigen::VectorXd& GetY() const { return y_; }
+  const Eigen::VectorXd& GetYDes() const { return y_des_; }
+  const Eigen::VectorXd& GetErrorY() const { return error_y_; }
+  const Eigen::VectorXd& GetYdot() const { return ydot_; }
+  const Eigen::VectorXd& GetYdotDes() const { return ydot_des_; }
+  const Eigen::VectorXd& GetErrorYdot() const { return error_ydot_; }
+  const Eigen::VectorXd& GetYddotDes() const { return yddot_des_; }
+  const Eigen::VectorXd& GetYddotDesConverted() const {
+    return yddot_des_converted_;
+  }
+  const Eigen::VectorXd& GetYddotCommandSol() const {
+    return yddot_command_sol_;
+  }
 
   // Getters used by osc block
   Eigen::VectorXd GetOutput() { return y_; }
   Eigen::MatrixXd GetJ() { return J_; }
   Eigen::VectorXd GetJdotTimesV() { return JdotV_; }
-  Eigen::VectorXd GetYddotCommand() { return yddot_command_; }
+  const Eigen::VectorXd& GetYddotCommand() const { return yddot_command_; }
   Eigen::MatrixXd GetWeight() { return W_; }
 
   // Getters
@@ -0,0 +1,259 @@
+#include "systems/controllers/osc/osc_debug_recorder.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "drake/common/trajectories/piecewise_polynomial.h"
+#include "drake/lcm/drake_lcm.h"
+#include "drake/multibody/plant/multibody_plant.h"
+
+namespace dairlib {
+namespace systems {
+namespace controllers {
+namespace {
+
+using drake::multibody::MultibodyPlant;
+using drake::systems::Context;
+using drake::trajectories::PiecewisePolynomial;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using std::vector;
+
+TEST(OscDebugRecorderTest, EncodeDecode) {
+  const int sample_size = 4;
+  const double resolution = 1e-6;
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  vector<int64_t> utimes = {1000, 1500, 2000, 12000};
+  vector<double> values = {0, 1.0,   -2.5, 1e3,      //
+                           1, 1.001, -2.5, 1e3 + 1,  //
+                           1, -7.3,  100,  nan,      //
+                           3, 0,     0,    -0.12345678};
+  lcmt_osc_debug_batch batch;
+  EncodeOscDebugSamples(utimes, values, sample_size, resolution, &batch);
+  EXPECT_EQ(batch.num_samples, 4);
+  EXPECT_EQ(batch.first_utime, 1000);
+  EXPECT_EQ(batch.utime, 12000);
+  EXPECT_EQ(batch.num_bytes, static_cast<int>(batch.data.size()));
+  // Much smaller than the raw doubles
+  EXPECT_LT(batch.num_bytes, static_cast<int>(values.size() * 4));
+
+  vector<int64_t> decoded_utimes;
+  vector<double> decoded;
+  DecodeOscDebugSamples(batch, sample_size, resolution, &decoded_utimes,
+                        &decoded);
+  EXPECT_EQ(decoded_utimes, utimes);
+  ASSERT_EQ(decoded.size(), values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    if (std::isnan(values[i])) {
+      EXPECT_EQ(decoded[i], 0);
+    } else {
+      EXPECT_NEAR(decoded[i], values[i], resolution / 2 + 1e-12);
+    }
+  }
+
+  batch.data.pop_back();
+  EXPECT_THROW(DecodeOscDebugSamples(batch, sample_size, resolution,
+                                     &decoded_utimes, &decoded),
+               std::runtime_error);
+}
+
+// Tracking data whose fields are all the value of its (constant) desired
+// trajectory
+class ConstantTrackingData final : public OscTrackingData {
+ public:
+  ConstantTrackingData(const std::string& name, int n_r,
+                       const MultibodyPlant<double>* plant)
+      : OscTrackingData(name, n_r, MatrixXd::Zero(n_r, n_r),
+                        MatrixXd::Zero(n_r, n_r), MatrixXd::Zero(n_r, n_r),
+                        plant, plant) {}
+
+  void AddStateToTrack(int state) { AddState(state); }
+
+ private:
+  void UpdateYAndError(const VectorXd&, Context<double>&) final {
+    y_ = error_y_ = y_des_;
+  }
+  void UpdateYdotAndError(const VectorXd&, Context<double>&) final {
+    ydot_ = ydot_des_ = error_ydot_ = y_des_;
+  }
+  void UpdateYddotDes() final { yddot_des_converted_ = y_des_; }
+  void UpdateJ(const VectorXd&, Context<double>&) final {
+    J_ = MatrixXd::Zero(GetTrajDim(), 0);
+  }
+  void UpdateJdotV(const VectorXd&, Context<double>&) final {
+    JdotV_ = y_des_;
+  }
+  void CheckDerivedOscTrackingData() final {}
+};
+
+TEST(OscDebugRecorderTest, Record) {
+  drake::lcm::DrakeLcm lcm("memq://");
+  vector<lcmt_osc_debug_schema> schemas;
+  vector<lcmt_osc_debug_batch> batches;
+  auto schema_sub = lcm.Subscribe(
+      "OSC_DEBUG_SCHEMA", [&](const void* buffer, int size) {
+        schemas.emplace_back();
+        schemas.back().decode(buffer, 0, size);
+      });
+  auto batch_sub = lcm.Subscribe(
+      "OSC_DEBUG_BATCH", [&](const void* buffer, int size) {
+        batches.emplace_back();
+        batches.back().decode(buffer, 0, size);
+      });
+
+  MultibodyPlant<double> plant(0.0);
+  plant.Finalize();
+  auto plant_context = plant.CreateDefaultContext();
+  ConstantTrackingData com("com", 3, &plant);
+  // The toe is only active in the first half
+  ConstantTrackingData toe("toe", 1, &plant);
+  toe.AddStateToTrack(0);
+  // Not recorded
+  ConstantTrackingData pelvis("pelvis", 2, &plant);
+  vector<OscTrackingData*> tracking_data = {&com, &toe, &pelvis};
+
+  vector<OscDebugStream> streams = {{"com", 3, 1}, {"toe", 1, 2}};
+  const int num_inputs = 2;
+  OscDebugRecorder recorder(tracking_data, streams, num_inputs, &lcm);
+  auto context = recorder.CreateDefaultContext();
+  const int num_updates = 10;
+  for (int k = 0; k < num_updates; k++) {
+    // As done by the OSC when computing its output
+    const int fsm_state = k / 5;
+    const VectorXd x;
+    com.Update(x, *plant_context, x, *plant_context,
+               PiecewisePolynomial<double>(VectorXd::Constant(3, 0.1 * k)),
+               0, fsm_state);
+    toe.Update(x, *plant_context, x, *plant_context,
+               PiecewisePolynomial<double>(VectorXd::Constant(1, -k)), 0,
+               fsm_state);
+    pelvis.Update(x, *plant_context, x, *plant_context,
+                  PiecewisePolynomial<double>(VectorXd::Zero(2)), 0,
+                  fsm_state);
+    for (auto data : tracking_data) {
+      if (data->IsActive()) data->SaveYddotCommandSol(VectorXd(0));
+    }
+
+    TimestampedVector<double> osc_output(num_inputs);
+    osc_output.set_timestamp(1e-3 * k);
+    recorder.get_osc_output_input_port().FixValue(context.get(), osc_output);
+    recorder.get_fsm_input_port().FixValue(
+        context.get(), VectorXd::Constant(1, fsm_state));
+    recorder.Publish(*context);
+  }
+  recorder.Stop();
+  while (lcm.HandleSubscriptions(0) > 0) {
+  }
+
+  ASSERT_GE(schemas.size(), 1u);
+  const auto& schema = schemas.front();
+  EXPECT_EQ(schema.names, vector<std::string>({"com", "toe"}));
+  EXPECT_EQ(schema.y_dims, vector<int32_t>({3, 1}));
+  EXPECT_EQ(schema.decimations, vector<int32_t>({1, 2}));
+  EXPECT_EQ(schema.field_names, OscDebugFieldNames());
+
+  vector<vector<int64_t>> utimes(2);
+  vector<vector<double>> values(2);
+  for (const auto& batch : batches) {
+    EXPECT_EQ(batch.schema_id, schema.schema_id);
+    const int i = batch.stream_index;
+    const int sample_size = 1 + schema.num_fields * schema.y_dims[i];
+    vector<int64_t> batch_utimes;
+    vector<double> batch_values;
+    DecodeOscDebugSamples(batch, sample_size, schema.resolution,
+                          &batch_utimes, &batch_values);
+    utimes[i].insert(utimes[i].end(), batch_utimes.begin(),
+                     batch_utimes.end());
+    values[i].insert(values[i].end(), batch_values.begin(),
+                     batch_values.end());
+  }
+
+  // Every update of com, every other active update of toe
+  ASSERT_EQ(utimes[0].size(), 10u);
+  for (int k = 0; k < num_updates; k++) {
+    EXPECT_EQ(utimes[0][k], 1000 * k);
+    EXPECT_EQ(values[0][k * 28], k / 5);
+    EXPECT_NEAR(values[0][k * 28 + 27], 0.1 * k, 1e-6);
+  }
+  EXPECT_EQ(utimes[1], vector<int64_t>({0, 2000, 4000}));
+  EXPECT_NEAR(values[1][10 + 1], -2, 1e-6);
+  EXPECT_EQ(recorder.get_num_dropped(0), 0);
+}
+
+// Tracking data sharing a stream may be shorter than its y_dim, e.g. the same
+// task tracked in fewer dimensions in another fsm state
+TEST(OscDebugRecorderTest, ShorterFieldsArePadded) {
+  drake::lcm::DrakeLcm lcm("memq://");
+  vector<lcmt_osc_debug_batch> batches;
+  auto batch_sub = lcm.Subscribe(
+      "OSC_DEBUG_BATCH", [&](const void* buffer, int size) {
+        batches.emplace_back();
+        batches.back().decode(buffer, 0, size);
+      });
+
+  MultibodyPlant<double> plant(0.0);
+  plant.Finalize();
+  auto plant_context = plant.CreateDefaultContext();
+  ConstantTrackingData wide("foot", 2, &plant);
+  wide.AddStateToTrack(0);
+  ConstantTrackingData narrow("foot", 1, &plant);
+  narrow.AddStateToTrack(1);
+  vector<OscTrackingData*> tracking_data = {&wide, &narrow};
+
+  const int y_dim = 2;
+  OscDebugRecorder recorder(tracking_data, {{"foot", y_dim, 1}}, 1, &lcm);
+  auto context = recorder.CreateDefaultContext();
+  const int num_updates = 4;
+  for (int k = 0; k < num_updates; k++) {
+    const int fsm_state = k % 2;
+    const VectorXd x;
+    for (auto data : tracking_data) {
+      data->Update(x, *plant_context, x, *plant_context,
+                   PiecewisePolynomial<double>(
+                       VectorXd::Constant(data->GetTrajDim(), k + 1)),
+                   0, fsm_state);
+      if (data->IsActive()) data->SaveYddotCommandSol(VectorXd(0));
+    }
+
+    TimestampedVector<double> osc_output(1);
+    osc_output.set_timestamp(1e-3 * k);
+    recorder.get_osc_output_input_port().FixValue(context.get(), osc_output);
+    recorder.get_fsm_input_port().FixValue(
+        context.get(), VectorXd::Constant(1, fsm_state));
+    recorder.Publish(*context);
+  }
+  recorder.Stop();
+  while (lcm.HandleSubscriptions(0) > 0) {
+  }
+
+  const auto& schema = recorder.get_schema();
+  const int sample_size = 1 + schema.num_fields * y_dim;
+  vector<double> values;
+  for (const auto& batch : batches) {
+    vector<int64_t> batch_utimes;
+    vector<double> batch_values;
+    DecodeOscDebugSamples(batch, sample_size, schema.resolution,
+                          &batch_utimes, &batch_values);
+    values.insert(values.end(), batch_values.begin(), batch_values.end());
+  }
+
+  ASSERT_EQ(values.size(), static_cast<size_t>(num_updates * sample_size));
+  for (int k = 0; k < num_updates; k++) {
+    SCOPED_TRACE("k = " + std::to_string(k));
+    const double* sample = values.data() + k * sample_size;
+    for (int j = 0; j < schema.num_fields; j++) {
+      EXPECT_NEAR(sample[1 + j * y_dim], k + 1, 1e-6);
+      // The second value of the previous (wide) sample isn't repeated
+      EXPECT_NEAR(sample[1 + j * y_dim + 1], k % 2 == 0 ? k + 1 : 0, 1e-6);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace controllers
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,80 @@
+#include "systems/controllers/osc/osc_tracking_data.h"
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/common/trajectories/exponential_plus_piecewise_polynomial.h"
+#include "drake/common/trajectories/piecewise_polynomial.h"
+
+namespace dairlib {
+namespace systems {
+namespace controllers {
+namespace {
+
+using drake::CompareMatrices;
+using drake::trajectories::ExponentialPlusPiecewisePolynomial;
+using drake::trajectories::PiecewisePolynomial;
+using drake::trajectories::Trajectory;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+// Compares against the evaluation of the derivative trajectories
+void ExpectMatchesMakeDerivative(const Trajectory<double>& traj, double t) {
+  VectorXd y, ydot, yddot;
+  EvalTrajectoryAndDerivatives(traj, t, &y, &ydot, &yddot);
+  const double tol = 1e-10;
+  EXPECT_TRUE(CompareMatrices(y, traj.value(t), tol));
+  EXPECT_TRUE(CompareMatrices(ydot, traj.MakeDerivative(1)->value(t), tol));
+  EXPECT_TRUE(CompareMatrices(yddot, traj.MakeDerivative(2)->value(t), tol));
+}
+
+TEST(EvalTrajectoryAndDerivativesTest, PiecewisePolynomial) {
+  std::vector<double> breaks = {0, 0.3, 0.7, 1};
+  std::vector<MatrixXd> samples;
+  for (double t : breaks) {
+    samples.push_back((VectorXd(3) << t * t, std::sin(t), 1 - t).finished());
+  }
+  auto cubic =
+      PiecewisePolynomial<double>::CubicWithContinuousSecondDerivatives(
+          breaks, samples, VectorXd::Zero(3), VectorXd::Ones(3));
+  auto linear = PiecewisePolynomial<double>::FirstOrderHold(breaks, samples);
+  // Including the breaks and times outside of [start_time, end_time]
+  for (double t : {-0.5, 0.0, 0.1, 0.3, 0.5, 0.99, 1.0, 2.0}) {
+    ExpectMatchesMakeDerivative(cubic, t);
+    ExpectMatchesMakeDerivative(linear, t);
+  }
+}
+
+TEST(EvalTrajectoryAndDerivativesTest, Constant) {
+  PiecewisePolynomial<double> constant(VectorXd::LinSpaced(4, 1, 4));
+  for (double t : {-10.0, 0.0, 3.5}) {
+    ExpectMatchesMakeDerivative(constant, t);
+  }
+}
+
+TEST(EvalTrajectoryAndDerivativesTest, ExponentialPlusPiecewisePolynomial) {
+  std::vector<double> breaks = {0, 0.5};
+  std::vector<MatrixXd> samples = {VectorXd::Zero(2), VectorXd::Ones(2)};
+  auto pp_part = PiecewisePolynomial<double>::FirstOrderHold(breaks, samples);
+  MatrixXd K = MatrixXd::Identity(2, 2);
+  MatrixXd A = MatrixXd::Identity(2, 2) * 3;
+  MatrixXd alpha = MatrixXd::Ones(2, 1);
+  ExponentialPlusPiecewisePolynomial<double> traj(K, A, alpha, pp_part);
+  ExpectMatchesMakeDerivative(traj, 0.25);
+}
+
+TEST(EvalTrajectoryAndDerivativesTest, NoReallocation) {
+  PiecewisePolynomial<double> constant(VectorXd::Ones(3));
+  VectorXd y(3), ydot(3), yddot(3);
+  const double* data = y.data();
+  EvalTrajectoryAndDerivatives(constant, 0, &y, &ydot, &yddot);
+  EXPECT_EQ(y.data(), data);
+}
+
+}  // namespace
+}  // namespace controllers
+}  // namespace systems
+}  // namespace dairlib
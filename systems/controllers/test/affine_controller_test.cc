@@ -136,6 +136,42 @@ TEST_F(AffineControllerTest, TestAffineParams) {
   ASSERT_EQ(x_des_vec_, input_port_params_val_->get_desired_state());
 }
 
+TEST_F(AffineControllerTest, TestBatchEvaluator) {
+  VectorXd state(ns_);
+  state << positions_vec_, velocities_vec_;
+
+  // Batch larger than one GEMM block, with the test state in a few columns
+  const int num_samples = 2 * AffineBatchEvaluator::kBlockSize + 3;
+  MatrixXd states = MatrixXd::Random(ns_, num_samples);
+  for (int i : {0, AffineBatchEvaluator::kBlockSize, num_samples - 1}) {
+    states.col(i) = state;
+  }
+
+  const AffineBatchEvaluator from_params(*input_port_params_val_);
+  // Same parameters, without the timestamp
+  const VectorXd params = params_vec_.head(params_vec_.size() - 1);
+  const AffineBatchEvaluator from_vector(params, ns_, ne_);
+  for (const auto* evaluator : {&from_params, &from_vector}) {
+    const MatrixXd efforts = evaluator->Eval(states);
+    ASSERT_EQ(efforts.rows(), ne_);
+    ASSERT_EQ(efforts.cols(), num_samples);
+    for (int i = 0; i < num_samples; i++) {
+      const VectorXd expected = K_ * (x_des_vec_ - states.col(i)) + E_vec_;
+      ASSERT_LT((efforts.col(i) - expected).norm(), 1e-10);
+    }
+    ASSERT_LT((efforts.col(0) - expected_output_vec_).norm(), 1e-10);
+  }
+
+  // Timestamps are passed through
+  MatrixXd timestamped_states(ns_ + 1, num_samples);
+  timestamped_states << states,
+      VectorXd::LinSpaced(num_samples, 0, 1).transpose();
+  const MatrixXd timestamped_efforts =
+      from_params.EvalTimestamped(timestamped_states);
+  ASSERT_EQ(timestamped_efforts.topRows(ne_), from_params.Eval(states));
+  ASSERT_EQ(timestamped_efforts.row(ne_), timestamped_states.row(ns_));
+}
+
 }  // namespace
 }  // namespace systems
 }  // namespace dairlib
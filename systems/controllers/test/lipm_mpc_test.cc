@@ -0,0 +1,71 @@
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "systems/controllers/lipm_mpc.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+using Eigen::MatrixXd;
+using Eigen::Vector2d;
+using Eigen::Vector4d;
+
+// Walks the LIPM with the first planned footstep of each solve
+class LipmFootstepQpTest : public ::testing::Test {
+ protected:
+  // Returns the end-of-stance CoM state and the steps taken
+  void Walk(LipmFootstepQp* qp, const Vector2d& des_vel, int num_steps,
+            Vector4d* com_state, std::vector<Vector2d>* steps) {
+    Vector2d s_x(0, 0);
+    Vector2d s_y(0, 0);
+    Vector2d stance_foot(0, -0.1);
+    bool first_step_is_left = true;
+    for (int k = 0; k < num_steps; k++) {
+      const double T = qp->step_duration(1, first_step_is_left);
+      s_x = qp->Propagate(s_x, stance_foot(0), T);
+      s_y = qp->Propagate(s_y, stance_foot(1), T);
+      *com_state << s_x(0), s_y(0), s_x(1), s_y(1);
+      const MatrixXd footsteps =
+          qp->Solve(*com_state, stance_foot, des_vel, 0, first_step_is_left);
+      EXPECT_EQ(footsteps.cols(), qp->num_steps());
+      steps->push_back(footsteps.col(0) - stance_foot);
+      stance_foot = footsteps.col(0);
+      first_step_is_left = !first_step_is_left;
+    }
+  }
+
+  const std::vector<double> durations_{0.35, 0.35};
+};
+
+TEST_F(LipmFootstepQpTest, ReachesDesiredVelocity) {
+  LipmFootstepQp qp(0.89, durations_, 3, 0.2, 1.0);
+  Vector4d com_state;
+  std::vector<Vector2d> steps;
+  Walk(&qp, Vector2d(0.5, 0), 30, &com_state, &steps);
+
+  EXPECT_NEAR(com_state(2), 0.5, 1e-2);
+  // Periodic gait, with lateral steps alternating between the sides
+  const Vector2d& last = steps.back();
+  const Vector2d& second_last = steps[steps.size() - 2];
+  EXPECT_NEAR(last(0), second_last(0), 1e-3);
+  EXPECT_NEAR(last(1), -second_last(1), 1e-3);
+  EXPECT_LT(last(1) * second_last(1), 0);
+}
+
+TEST_F(LipmFootstepQpTest, StepBounds) {
+  const double max_step_deviation = 0.05;
+  LipmFootstepQp qp(0.89, durations_, 3, 0.2, max_step_deviation);
+  Vector4d com_state;
+  std::vector<Vector2d> steps;
+  // Too fast to be reached within the step bounds
+  Walk(&qp, Vector2d(2.0, 0), 10, &com_state, &steps);
+  for (const auto& step : steps) {
+    EXPECT_LE(std::abs(step(0) - 2.0 * 0.35), max_step_deviation + 1e-3);
+  }
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
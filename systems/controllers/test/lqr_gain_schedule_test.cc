@@ -0,0 +1,143 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "systems/controllers/lqr_gain_schedule.h"
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+using drake::CompareMatrices;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using std::vector;
+
+// A 2D schedule over x(0) (uniform breakpoints) and x(2) (nonuniform), whose
+// entries are affine in the grid coordinates, so that multilinear blending of
+// the controller inputs is exact for the K independent part.
+class LQRGainScheduleTest : public ::testing::Test {
+ protected:
+  LQRGainScheduleTest()
+      : schedule_({{0.5, 0.6, 0.7, 0.8}, {-1, 0, 2}}, {0, 2}, kNumStates,
+                  kNumInputs) {
+    for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 3; j++) {
+        const double s0 = schedule_.breakpoints()[0][i];
+        const double s1 = schedule_.breakpoints()[1][j];
+        schedule_.SetEntry(schedule_.EntryIndex({i, j}), Gain(s0, s1),
+                           Offset(s0, s1), VectorXd::Constant(kNumStates, s0));
+      }
+    }
+  }
+
+  static MatrixXd Gain(double s0, double s1) {
+    return MatrixXd::Constant(kNumInputs, kNumStates, 1 + s0 + 0.1 * s1);
+  }
+
+  static VectorXd Offset(double s0, double s1) {
+    VectorXd E(kNumInputs);
+    E << s0 + s1, s0 - s1;
+    return E;
+  }
+
+  static constexpr int kNumStates = 4;
+  static constexpr int kNumInputs = 2;
+  LQRGainSchedule schedule_;
+};
+
+TEST_F(LQRGainScheduleTest, GridPoints) {
+  EXPECT_EQ(schedule_.num_entries(), 12);
+  for (auto lookup : {LQRGainSchedule::Lookup::kInterpolate,
+                      LQRGainSchedule::Lookup::kNearest}) {
+    VectorXd x(kNumStates);
+    x << 0.7, 3, 0, -0.5;
+    const int entry = schedule_.EntryIndex({2, 1});
+    VectorXd u(kNumInputs);
+    schedule_.CalcInput(x, lookup, u);
+    const VectorXd expected = schedule_.K(entry) *
+                                  (schedule_.x_desired(entry) - x) +
+                              schedule_.E(entry);
+    EXPECT_TRUE(CompareMatrices(u, expected, 1e-12));
+  }
+}
+
+TEST_F(LQRGainScheduleTest, Interpolation) {
+  VectorXd x(kNumStates);
+  x << 0.63, -2, 0.5, 1;
+  int entries[1 << LQRGainSchedule::kMaxDimensions];
+  double weights[1 << LQRGainSchedule::kMaxDimensions];
+  const int num_corners = schedule_.CalcWeights(
+      x, LQRGainSchedule::Lookup::kInterpolate, entries, weights);
+  ASSERT_EQ(num_corners, 4);
+
+  // Blend of the inputs of the four corners of the cell
+  VectorXd expected = VectorXd::Zero(kNumInputs);
+  double total_weight = 0;
+  for (int i : {1, 2}) {
+    for (int j : {1, 2}) {
+      const double s0 = schedule_.breakpoints()[0][i];
+      const double s1 = schedule_.breakpoints()[1][j];
+      const double w = (1 - std::abs(x(0) - s0) / 0.1) *
+                       (1 - std::abs(x(2) - s1) / 2);
+      const VectorXd x_desired = VectorXd::Constant(kNumStates, s0);
+      expected += w * (Gain(s0, s1) * (x_desired - x) + Offset(s0, s1));
+      total_weight += w;
+    }
+  }
+  EXPECT_NEAR(total_weight, 1, 1e-12);
+
+  VectorXd u(kNumInputs);
+  schedule_.CalcInput(x, LQRGainSchedule::Lookup::kInterpolate, u);
+  EXPECT_TRUE(CompareMatrices(u, expected, 1e-12));
+}
+
+TEST_F(LQRGainScheduleTest, NearestAndClamping) {
+  VectorXd x(kNumStates);
+  x << 0.64, 0, 1.2, 0;
+  int entries[1 << LQRGainSchedule::kMaxDimensions];
+  double weights[1 << LQRGainSchedule::kMaxDimensions];
+  EXPECT_EQ(schedule_.CalcWeights(x, LQRGainSchedule::Lookup::kNearest,
+                                  entries, weights), 1);
+  EXPECT_EQ(entries[0], schedule_.EntryIndex({1, 2}));
+
+  // Outside of the grid, the boundary controllers are used
+  x << 2, 0, -5, 0;
+  EXPECT_EQ(schedule_.CalcWeights(x, LQRGainSchedule::Lookup::kInterpolate,
+                                  entries, weights), 1);
+  EXPECT_EQ(entries[0], schedule_.EntryIndex({3, 0}));
+  EXPECT_EQ(weights[0], 1);
+}
+
+TEST_F(LQRGainScheduleTest, SaveAndLoad) {
+  const std::string filepath = ::testing::TempDir() + "/gain_schedule.bin";
+  schedule_.Save(filepath);
+  const LQRGainSchedule loaded = LQRGainSchedule::Load(filepath);
+  std::remove(filepath.c_str());
+
+  EXPECT_EQ(loaded.breakpoints(), schedule_.breakpoints());
+  EXPECT_EQ(loaded.scheduling_indices(), schedule_.scheduling_indices());
+  ASSERT_EQ(loaded.num_entries(), schedule_.num_entries());
+  for (int i = 0; i < loaded.num_entries(); i++) {
+    EXPECT_TRUE(CompareMatrices(loaded.K(i), schedule_.K(i)));
+    EXPECT_TRUE(CompareMatrices(loaded.E(i), schedule_.E(i)));
+    EXPECT_TRUE(CompareMatrices(loaded.x_desired(i), schedule_.x_desired(i)));
+  }
+
+  VectorXd x(kNumStates);
+  x << 0.55, 1, 1.5, 2;
+  VectorXd u(kNumInputs);
+  VectorXd u_loaded(kNumInputs);
+  schedule_.CalcInput(x, LQRGainSchedule::Lookup::kInterpolate, u);
+  loaded.CalcInput(x, LQRGainSchedule::Lookup::kInterpolate, u_loaded);
+  EXPECT_TRUE(CompareMatrices(u, u_loaded));
+
+  EXPECT_THROW(LQRGainSchedule::Load(filepath), std::runtime_error);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -13,6 +14,8 @@
 #include "drake/systems/lcm/serializer.h"
 
 #include "dairlib/lcmt_controller_switch.hpp"
+#include "systems/framework/parallel_output_evaluator.h"
+#include "systems/framework/shared_memory_transport.h"
 
 namespace dairlib {
 namespace systems {
@@ -46,7 +49,8 @@ namespace systems {
 /// 1. construct LcmDrivenLoop
 /// 2. (if it's multi-input) the user can set the initial channel that
 ///    LcmDrivenLoop listens to by calling SetInitActiveChannel().
-/// 3. run Simulate()
+/// 3. run Simulate(), or call Step() for every input message (see
+///    LcmLogReplay)
 
 /// Note that we implement the class only in the header file because we don't
 /// know what MessageTypes are beforehand.
@@ -142,21 +146,85 @@ class LcmDrivenLoop {
                       std::vector<std::string>(1, input_channel), input_channel,
                       "", is_forced_publish){};
 
-  // Start simulating the diagram
-  void Simulate(double end_time = std::numeric_limits<double>::infinity()) {
-    // Get mutable contexts
+  /// Evaluates the stages of `evaluator` after each AdvanceTo(), before the
+  /// forced publish (see ParallelOutputEvaluator), and traces the publish.
+  /// `evaluator` must outlive the loop.
+  void SetOutputEvaluator(ParallelOutputEvaluator* evaluator) {
+    output_evaluator_ = evaluator;
+  }
+
+  /// Receives the input channel `channel` from `subscriber` instead of LCM
+  /// (see SharedMemoryPublisherSystem). While it is the active channel, the
+  /// loop waits on the shared memory and only polls the LCM subscriptions
+  /// (e.g. of the switch channel) in between. With `spin`, the wait is a busy
+  /// wait (see SharedMemorySlot::WaitForNewer). `subscriber` must outlive the
+  /// loop.
+  void SetSharedMemoryInput(
+      const std::string& channel,
+      SharedMemorySubscriber<InputMessageType>* subscriber,
+      bool spin = false) {
+    DRAKE_DEMAND(name_to_input_sub_map_.count(channel) == 1);
+    shared_memory_channel_ = channel;
+    shared_memory_message_ = &subscriber->message();
+    shared_memory_wait_ = [subscriber, spin](double timeout) {
+      return subscriber->WaitForMessage(timeout, spin);
+    };
+  }
+
+  /// Writes `message` into the first input port of lcm_parser, advances the
+  /// diagram to the time of `message` and publishes, as Simulate() does for
+  /// every message of the active channel. The first step starts at the time
+  /// of `message`. Step() lets a harness (e.g. LcmLogReplay) drive the loop
+  /// without LCM.
+  void Step(const InputMessageType& message) {
     auto& diagram_context = simulator_->get_mutable_context();
+    const double time = message.utime * 1e-6;
+    if (!is_started_) {
+      diagram_context.SetTime(time);
+      is_started_ = true;
+    }
 
-    // Wait for the first message.
-    drake::log()->info("Waiting for first lcm input message");
-    LcmHandleSubscriptionsUntil(drake_lcm_, [&]() {
-      return name_to_input_sub_map_.at(active_channel_).count() > 0;
-    });
+    // Write the InputMessageType message into the context if lcm_parser is
+    // provided
+    if (lcm_parser_ != nullptr) {
+      lcm_parser_->get_input_port(0).FixValue(
+          &(diagram_ptr_->GetMutableSubsystemContext(*lcm_parser_,
+                                                     &diagram_context)),
+          message);
+    }
+
+    // Check if we are very far ahead or behind
+    // (likely due to a restart of the driving clock)
+    if (time > simulator_->get_context().get_time() + 1.0 ||
+        time < simulator_->get_context().get_time()) {
+      std::cout << diagram_name_ + " time is "
+                << simulator_->get_context().get_time()
+                << ", but stepping to " << time << std::endl;
+      std::cout << "Difference is too large, resetting " + diagram_name_ +
+                       " time.\n";
+      simulator_->get_mutable_context().SetTime(time);
+    }
 
-    // Initialize the context time.
-    const double t0 =
-        name_to_input_sub_map_.at(active_channel_).message().utime * 1e-6;
-    diagram_context.SetTime(t0);
+    simulator_->AdvanceTo(time);
+    if (output_evaluator_ != nullptr) {
+      output_evaluator_->Evaluate(diagram_context);
+    }
+    if (is_forced_publish_) {
+      // Force-publish via the diagram
+      const auto start = ParallelOutputEvaluator::Clock::now();
+      diagram_ptr_->Publish(diagram_context);
+      if (output_evaluator_ != nullptr) {
+        output_evaluator_->RecordSpan("publish", start);
+      }
+    }
+  }
+
+  // Start simulating the diagram
+  void Simulate(double end_time = std::numeric_limits<double>::infinity()) {
+    // Wait for the first message. Step() initializes the context time with
+    // it.
+    drake::log()->info("Waiting for first lcm input message");
+    HandleSubscriptionsUntil([&]() { return InputCount() > 0; });
 
     // "Simulator" time
     double time = 0;  // initialize the current time with 0
@@ -186,8 +254,8 @@ class LcmDrivenLoop {
       // Wait for new InputMessageType messages and SwitchMessageType messages.
       bool is_new_input_message = false;
       bool is_new_switch_message = false;
-      LcmHandleSubscriptionsUntil(drake_lcm_, [&]() {
-        if (name_to_input_sub_map_.at(active_channel_).count() > 0) {
+      HandleSubscriptionsUntil([&]() {
+        if (InputCount() > 0) {
           is_new_input_message = true;
         }
         if (switch_sub_ != nullptr) {
@@ -200,38 +268,12 @@ class LcmDrivenLoop {
 
       // Update the diagram context when there is new input message
       if (is_new_input_message) {
-        // Write the InputMessageType message into the context if lcm_parser is
-        // provided
-        if (lcm_parser_ != nullptr) {
-          lcm_parser_->get_input_port(0).FixValue(
-              &(diagram_ptr_->GetMutableSubsystemContext(*lcm_parser_,
-                                                         &diagram_context)),
-              name_to_input_sub_map_.at(active_channel_).message());
-        }
-
         // Get message time from the active channel to advance
-        time = name_to_input_sub_map_.at(active_channel_).message().utime * 1e-6;
-
-        // Check if we are very far ahead or behind
-        // (likely due to a restart of the driving clock)
-        if (time > simulator_->get_context().get_time() + 1.0 ||
-            time < simulator_->get_context().get_time()) {
-          std::cout << diagram_name_ + " time is "
-                    << simulator_->get_context().get_time()
-                    << ", but stepping to " << time << std::endl;
-          std::cout << "Difference is too large, resetting " + diagram_name_ +
-                           " time.\n";
-          simulator_->get_mutable_context().SetTime(time);
-        }
-
-        simulator_->AdvanceTo(time);
-        if (is_forced_publish_) {
-          // Force-publish via the diagram
-          diagram_ptr_->Publish(diagram_context);
-        }
+        time = InputMessage().utime * 1e-6;
+        Step(InputMessage());
 
         // Clear messages in the current input channel
-        name_to_input_sub_map_.at(active_channel_).clear();
+        ClearInput();
       }
 
       // Update the name of the active channel if there are multiple inputs and
@@ -252,7 +294,7 @@ class LcmDrivenLoop {
         // Clear messages in the new input channel if we just switched input
         // channel in the current loop
         if (previous_active_channel_name.compare(active_channel_) != 0) {
-          name_to_input_sub_map_.at(active_channel_).clear();
+          ClearInput();
         }
       }
       previous_active_channel_name = active_channel_;
@@ -260,6 +302,47 @@ class LcmDrivenLoop {
   };
 
  private:
+  bool is_shared_memory_active() const {
+    return shared_memory_wait_ && active_channel_ == shared_memory_channel_;
+  }
+
+  int InputCount() const {
+    return is_shared_memory_active()
+               ? shared_memory_count_
+               : name_to_input_sub_map_.at(active_channel_).count();
+  }
+
+  const InputMessageType& InputMessage() const {
+    return is_shared_memory_active()
+               ? *shared_memory_message_
+               : name_to_input_sub_map_.at(active_channel_).message();
+  }
+
+  void ClearInput() {
+    if (is_shared_memory_active()) {
+      shared_memory_count_ = 0;
+    } else {
+      name_to_input_sub_map_.at(active_channel_).clear();
+    }
+  }
+
+  void HandleSubscriptionsUntil(const std::function<bool()>& finished) {
+    if (!is_shared_memory_active()) {
+      LcmHandleSubscriptionsUntil(drake_lcm_, finished);
+      return;
+    }
+    while (true) {
+      if (shared_memory_wait_(kSharedMemoryWaitTimeout)) {
+        shared_memory_count_++;
+      }
+      drake_lcm_->HandleSubscriptions(0);
+      if (finished()) return;
+    }
+  }
+
+  // Bounds the latency of the LCM messages while waiting on shared memory
+  static constexpr double kSharedMemoryWaitTimeout = 0.001;
+
   drake::lcm::DrakeLcm* drake_lcm_;
   drake::systems::Diagram<double>* diagram_ptr_;
   const drake::systems::LeafSystem<double>* lcm_parser_;
@@ -273,6 +356,13 @@ class LcmDrivenLoop {
       name_to_input_sub_map_;
 
   bool is_forced_publish_;
+  bool is_started_ = false;
+  ParallelOutputEvaluator* output_evaluator_ = nullptr;
+
+  std::string shared_memory_channel_;
+  const InputMessageType* shared_memory_message_ = nullptr;
+  std::function<bool(double)> shared_memory_wait_;
+  int shared_memory_count_ = 0;
 };
 
 }  // namespace systems
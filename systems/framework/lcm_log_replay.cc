@@ -0,0 +1,231 @@
+#include "systems/framework/lcm_log_replay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <utility>
+
+#include "lcm/lcm-cpp.hpp"
+
+#include "drake/common/drake_assert.h"
+
+namespace dairlib {
+namespace systems {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+std::unique_ptr<lcm::LogFile> OpenLog(const string& path,
+                                      const string& mode) {
+  auto log = std::make_unique<lcm::LogFile>(path, mode);
+  if (!log->good()) {
+    throw std::runtime_error("Could not open file: " + path);
+  }
+  return log;
+}
+
+void PrintStatistics(const string& name, const TickTimeStatistics& stats) {
+  std::cout << name << ": " << stats.num_ticks << " ticks, mean "
+            << stats.mean * 1e6 << " us, median " << stats.median * 1e6
+            << " us, p99 " << stats.p99 * 1e6 << " us, max "
+            << stats.max * 1e6 << " us" << std::endl;
+}
+
+}  // namespace
+
+LcmLogReplay::LcmLogReplay(drake::lcm::DrakeLcm* lcm,
+                           LcmLogReplayOptions options)
+    : lcm_(lcm), options_(std::move(options)) {
+  DRAKE_DEMAND(!options_.input_log.empty());
+  DRAKE_DEMAND(!options_.input_channel.empty());
+  DRAKE_DEMAND(options_.max_slowdown > 0);
+  for (const auto& channel : options_.output_channels) {
+    subscriptions_.push_back(
+        lcm_->Subscribe(channel, [this, channel](const void* data, int size) {
+          const uint8_t* bytes = static_cast<const uint8_t*>(data);
+          recorded_messages_.push_back({tick_, timestamp_, channel,
+                                        vector<uint8_t>(bytes, bytes + size)});
+        }));
+  }
+}
+
+bool LcmLogReplay::is_forwarded(const string& channel) const {
+  return std::find(options_.forwarded_channels.begin(),
+                   options_.forwarded_channels.end(),
+                   channel) != options_.forwarded_channels.end();
+}
+
+void LcmLogReplay::HandleSubscriptions() {
+  while (lcm_->HandleSubscriptions(0) > 0) {
+  }
+}
+
+int LcmLogReplay::Replay(const TickFunction& tick) {
+  auto log = OpenLog(options_.input_log, "r");
+  for (const lcm::LogEvent* event = log->readNextEvent(); event != nullptr;
+       event = log->readNextEvent()) {
+    if (options_.max_ticks >= 0 && tick_ >= options_.max_ticks) {
+      break;
+    }
+    if (event->channel == options_.input_channel) {
+      timestamp_ = event->timestamp;
+      const auto start = std::chrono::steady_clock::now();
+      tick(event->data, event->datalen);
+      const std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      tick_times_.push_back(elapsed.count());
+      // Record what the tick published, out of the timed section
+      HandleSubscriptions();
+      tick_++;
+    } else if (is_forwarded(event->channel)) {
+      lcm_->Publish(event->channel, event->data, event->datalen,
+                    std::nullopt);
+      HandleSubscriptions();
+    }
+  }
+  return tick_;
+}
+
+vector<ChannelDiff> LcmLogReplay::CompareWith(const string& golden_log) const {
+  std::map<string, vector<vector<uint8_t>>> golden_messages;
+  for (const auto& channel : options_.output_channels) {
+    golden_messages[channel];
+  }
+  auto log = OpenLog(golden_log, "r");
+  for (const lcm::LogEvent* event = log->readNextEvent(); event != nullptr;
+       event = log->readNextEvent()) {
+    auto it = golden_messages.find(event->channel);
+    if (it != golden_messages.end()) {
+      const uint8_t* bytes = static_cast<const uint8_t*>(event->data);
+      it->second.emplace_back(bytes, bytes + event->datalen);
+    }
+  }
+
+  std::map<string, ChannelDiff> diffs;
+  for (const auto& [channel, messages] : golden_messages) {
+    diffs[channel].channel = channel;
+    diffs[channel].num_golden = messages.size();
+  }
+  for (const auto& message : recorded_messages_) {
+    ChannelDiff& diff = diffs.at(message.channel);
+    const auto& golden = golden_messages.at(message.channel);
+    const int i = diff.num_recorded++;
+    if (i < static_cast<int>(golden.size()) && golden[i] != message.data) {
+      if (diff.num_different++ == 0) {
+        diff.first_different_tick = message.tick;
+      }
+    }
+  }
+
+  vector<ChannelDiff> result;
+  for (const auto& channel : options_.output_channels) {
+    result.push_back(diffs.at(channel));
+  }
+  return result;
+}
+
+void LcmLogReplay::WriteOutputLog(const string& path) const {
+  auto log = OpenLog(path, "w");
+  for (const auto& message : recorded_messages_) {
+    lcm::LogEvent event;
+    event.timestamp = message.timestamp;
+    event.channel = message.channel;
+    event.datalen = message.data.size();
+    event.data = const_cast<uint8_t*>(message.data.data());
+    log->writeEvent(&event);
+  }
+}
+
+void LcmLogReplay::WriteTickTimes(const string& path) const {
+  std::ofstream file(path);
+  if (!file) {
+    throw std::runtime_error("Could not open file: " + path);
+  }
+  file.precision(9);
+  for (double time : tick_times_) {
+    file << time << "\n";
+  }
+}
+
+vector<double> LcmLogReplay::ReadTickTimes(const string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Could not open file: " + path);
+  }
+  vector<double> times;
+  double time;
+  while (file >> time) {
+    times.push_back(time);
+  }
+  return times;
+}
+
+TickTimeStatistics LcmLogReplay::CalcStatistics(vector<double> times) {
+  TickTimeStatistics stats;
+  stats.num_ticks = times.size();
+  if (times.empty()) return stats;
+  std::sort(times.begin(), times.end());
+  // Nearest-rank percentiles
+  auto percentile = [&times](double p) {
+    const int rank = std::ceil(p * times.size());
+    return times[std::max(rank, 1) - 1];
+  };
+  stats.mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+  stats.median = percentile(0.5);
+  stats.p99 = percentile(0.99);
+  stats.max = times.back();
+  return stats;
+}
+
+bool LcmLogReplay::Report() const {
+  bool passed = true;
+  if (!options_.output_log.empty()) {
+    WriteOutputLog(options_.output_log);
+  }
+  if (!options_.tick_times.empty()) {
+    WriteTickTimes(options_.tick_times);
+  }
+
+  const TickTimeStatistics stats = CalcStatistics(tick_times_);
+  PrintStatistics("Replay", stats);
+
+  if (!options_.golden_log.empty()) {
+    for (const auto& diff : CompareWith(options_.golden_log)) {
+      std::cout << diff.channel << ": " << diff.num_recorded
+                << " messages recorded, " << diff.num_golden << " in "
+                << options_.golden_log;
+      if (diff.num_different > 0) {
+        std::cout << ", " << diff.num_different
+                  << " differ from tick " << diff.first_different_tick;
+      }
+      std::cout << (diff.matches() ? " (match)" : " (MISMATCH)") << std::endl;
+      passed = passed && diff.matches();
+    }
+  }
+
+  if (!options_.baseline_tick_times.empty()) {
+    const TickTimeStatistics baseline =
+        CalcStatistics(ReadTickTimes(options_.baseline_tick_times));
+    PrintStatistics("Baseline", baseline);
+    const double median_ratio = stats.median / baseline.median;
+    const double p99_ratio = stats.p99 / baseline.p99;
+    std::cout << "Median " << median_ratio << "x, p99 " << p99_ratio
+              << "x of the baseline" << std::endl;
+    if (median_ratio > options_.max_slowdown ||
+        p99_ratio > options_.max_slowdown) {
+      std::cout << "Timing regression: more than " << options_.max_slowdown
+                << "x of the baseline" << std::endl;
+      passed = false;
+    }
+  }
+  return passed;
+}
+
+}  // namespace systems
+}  // namespace dairlib
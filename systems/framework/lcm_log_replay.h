@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "drake/common/drake_copyable.h"
+#include "drake/lcm/drake_lcm.h"
+
+namespace dairlib {
+namespace systems {
+
+/// The settings of LcmLogReplay. Only input_log and input_channel are
+/// required; the files are skipped when their name is empty.
+struct LcmLogReplayOptions {
+  /// The LCM log that is replayed
+  std::string input_log;
+  /// The channel of input_log of which every message is one tick
+  std::string input_channel;
+  /// Other channels of input_log (e.g. the radio), which are published in log
+  /// order between the ticks
+  std::vector<std::string> forwarded_channels;
+  /// The channels published by the diagram that are recorded
+  std::vector<std::string> output_channels;
+  /// The LCM log the recorded messages are written to
+  std::string output_log;
+  /// An LCM log (e.g. the output_log of an earlier run) the recorded messages
+  /// are compared with
+  std::string golden_log;
+  /// The text file the compute time (s) of every tick is written to
+  std::string tick_times;
+  /// The tick_times of an earlier run on the same machine, the compute times
+  /// are compared with
+  std::string baseline_tick_times;
+  /// Ratio of the median or the 99th percentile of the compute times over
+  /// those of the baseline, above which the timing is a regression
+  double max_slowdown = 1.2;
+  /// Number of ticks replayed, or -1 for the whole log
+  int max_ticks = -1;
+};
+
+/// Statistics of the compute times (s) of the ticks
+struct TickTimeStatistics {
+  int num_ticks = 0;
+  double mean = 0;
+  double median = 0;
+  double p99 = 0;
+  double max = 0;
+};
+
+/// The differences between the recorded messages of a channel and those of a
+/// golden log. The i-th recorded message is compared with the i-th golden
+/// message, byte for byte.
+struct ChannelDiff {
+  std::string channel;
+  int num_recorded = 0;
+  int num_golden = 0;
+  int num_different = 0;
+  /// The tick of the first message that differs, or -1
+  int first_different_tick = -1;
+
+  bool matches() const {
+    return num_different == 0 && num_recorded == num_golden;
+  }
+};
+
+/// LcmLogReplay feeds the messages of a recorded LCM log to a diagram in the
+/// same process, as fast as possible, instead of replaying the log in real
+/// time with lcm-logplayer while the diagram runs freely. Every message of the
+/// input channel is one tick: it is passed to a TickFunction (e.g. one that
+/// calls LcmDrivenLoop::Step()), which is timed. After each tick, the
+/// messages the diagram published on the output channels are recorded, with
+/// the log timestamp of the input message.
+///
+/// The diagram must publish on the DrakeLcm given to LcmLogReplay, which
+/// should be "memq://" so that nothing leaves the process. Since the ticks
+/// only depend on the log, two replays of the same diagram publish the same
+/// bytes, and Report() can diff the recorded messages against a golden log
+/// and the compute times against a baseline.
+class LcmLogReplay {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(LcmLogReplay)
+
+  /// Handles one encoded message of the input channel
+  using TickFunction = std::function<void(const void* data, int size)>;
+
+  /// A recorded message
+  struct Message {
+    int tick;
+    int64_t timestamp;
+    std::string channel;
+    std::vector<uint8_t> data;
+  };
+
+  ///     @param lcm The LCM the diagram publishes on
+  ///     @param options The settings
+  LcmLogReplay(drake::lcm::DrakeLcm* lcm, LcmLogReplayOptions options);
+
+  /// Replays the input log and returns the number of ticks
+  int Replay(const TickFunction& tick);
+
+  /// Writes the output log and the tick times, and prints the timing and the
+  /// comparisons with the golden log and the baseline. Returns false if the
+  /// recorded messages differ from the golden log or if the timing regressed.
+  bool Report() const;
+
+  /// The messages of the output channels, in the order they were published
+  const std::vector<Message>& recorded_messages() const {
+    return recorded_messages_;
+  }
+
+  /// The compute time (s) of every tick
+  const std::vector<double>& tick_times() const { return tick_times_; }
+
+  /// Compares the recorded messages with those of `golden_log`, for every
+  /// output channel
+  std::vector<ChannelDiff> CompareWith(const std::string& golden_log) const;
+
+  void WriteOutputLog(const std::string& path) const;
+  void WriteTickTimes(const std::string& path) const;
+  static std::vector<double> ReadTickTimes(const std::string& path);
+  static TickTimeStatistics CalcStatistics(std::vector<double> times);
+
+ private:
+  bool is_forwarded(const std::string& channel) const;
+  void HandleSubscriptions();
+
+  drake::lcm::DrakeLcm* lcm_;
+  const LcmLogReplayOptions options_;
+  std::vector<std::shared_ptr<drake::lcm::DrakeSubscriptionInterface>>
+      subscriptions_;
+
+  int tick_ = 0;
+  int64_t timestamp_ = 0;
+  std::vector<Message> recorded_messages_;
+  std::vector<double> tick_times_;
+};
+
+/// Makes a TickFunction that decodes the messages into one MessageType and
+/// passes it to `step`, e.g. LcmDrivenLoop::Step()
+template <typename MessageType>
+LcmLogReplay::TickFunction MakeTickFunction(
+    std::function<void(const MessageType&)> step) {
+  auto message = std::make_shared<MessageType>();
+  return [message, step](const void* data, int size) {
+    if (message->decode(data, 0, size) != size) {
+      throw std::runtime_error("Could not decode the input message");
+    }
+    step(*message);
+  };
+}
+
+}  // namespace systems
+}  // namespace dairlib
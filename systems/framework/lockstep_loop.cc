@@ -0,0 +1,140 @@
+#include "systems/framework/lockstep_loop.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace dairlib {
+namespace systems {
+
+using drake::multibody::MultibodyPlant;
+using drake::systems::BasicVector;
+using drake::systems::Diagram;
+using drake::systems::InputPort;
+using drake::systems::OutputPort;
+using drake::systems::Simulator;
+using Eigen::VectorXd;
+
+namespace {
+// Tolerance on the comparison of tick and effort application times
+const double kTimeTolerance = 1e-12;
+}  // namespace
+
+LockstepLoop::LockstepLoop(std::unique_ptr<Diagram<double>> plant_diagram,
+                           const MultibodyPlant<double>& plant,
+                           std::unique_ptr<Diagram<double>> controller_diagram,
+                           const InputPort<double>& controller_state_port,
+                           const OutputPort<double>& controller_control_port,
+                           double controller_period)
+    : plant_(plant),
+      controller_diagram_(controller_diagram.get()),
+      controller_state_port_(controller_state_port),
+      controller_control_port_(controller_control_port),
+      period_(controller_period) {
+  DRAKE_DEMAND(controller_period > 0);
+  DRAKE_DEMAND(&controller_state_port.get_system() == controller_diagram_);
+  DRAKE_DEMAND(&controller_control_port.get_system() == controller_diagram_);
+  const int nu = plant.num_actuators();
+  DRAKE_DEMAND(controller_state_port.size() ==
+               OutputVector<double>(plant.num_positions(),
+                                    plant.num_velocities(), nu)
+                   .size());
+  DRAKE_DEMAND(controller_control_port.size() == nu + 1);
+
+  auto& plant_diagram_ref = *plant_diagram;
+  plant_simulator_ =
+      std::make_unique<Simulator<double>>(std::move(plant_diagram));
+  controller_simulator_ =
+      std::make_unique<Simulator<double>>(std::move(controller_diagram));
+  plant_simulator_->set_publish_every_time_step(false);
+  plant_simulator_->set_publish_at_initialization(false);
+  plant_context_ = &plant_diagram_ref.GetMutableSubsystemContext(
+      plant, &plant_simulator_->get_mutable_context());
+
+  applied_efforts_ = VectorXd::Zero(nu);
+  actuation_ = &plant.get_actuation_input_port().FixValue(plant_context_,
+                                                          applied_efforts_);
+  robot_output_ = &controller_state_port.FixValue(
+      &controller_simulator_->get_mutable_context(),
+      OutputVector<double>(plant.num_positions(), plant.num_velocities(), nu));
+  DRAKE_DEMAND(dynamic_cast<OutputVector<double>*>(
+                   robot_output_->GetMutableVectorData<double>()) != nullptr);
+}
+
+void LockstepLoop::SetDelay(double min_delay, double max_delay,
+                            uint32_t seed) {
+  DRAKE_DEMAND(0 <= min_delay && min_delay <= max_delay);
+  min_delay_ = min_delay;
+  max_delay_ = max_delay;
+  generator_.seed(seed);
+}
+
+void LockstepLoop::Initialize() {
+  start_time_ = plant_context_->get_time();
+  num_ticks_ = 0;
+  pending_efforts_.clear();
+  controller_simulator_->get_mutable_context().SetTime(start_time_);
+  plant_simulator_->Initialize();
+  controller_simulator_->Initialize();
+}
+
+double LockstepLoop::Tick() {
+  const double time = plant_context_->get_time();
+
+  // Measure the plant, with the efforts applied over the last period.
+  // GetMutableVectorData() invalidates the dependents of the input.
+  auto robot_output = static_cast<OutputVector<double>*>(
+      robot_output_->GetMutableVectorData<double>());
+  robot_output->SetPositions(plant_.GetPositions(*plant_context_));
+  robot_output->SetVelocities(plant_.GetVelocities(*plant_context_));
+  robot_output->SetEfforts(applied_efforts_);
+  robot_output->SetIMUAccelerations(Eigen::Vector3d::Zero());
+  robot_output->set_timestamp(time);
+
+  // Run the controller
+  auto start = std::chrono::steady_clock::now();
+  controller_simulator_->AdvanceTo(time);
+  const auto& control = controller_control_port_.Eval<BasicVector<double>>(
+      controller_simulator_->get_context());
+  VectorXd efforts = control.get_value().head(plant_.num_actuators());
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  double delay = min_delay_;
+  if (max_delay_ > min_delay_) {
+    delay = std::uniform_real_distribution<double>(min_delay_,
+                                                   max_delay_)(generator_);
+  }
+  double apply_time = time + delay;
+  if (!pending_efforts_.empty()) {
+    apply_time = std::max(apply_time, pending_efforts_.back().first);
+  }
+  pending_efforts_.emplace_back(apply_time, std::move(efforts));
+
+  // Simulate to the next tick, applying the efforts which are due and
+  // holding each of them until the next one
+  num_ticks_++;
+  const double end_time = start_time_ + num_ticks_ * period_;
+  while (!pending_efforts_.empty() &&
+         pending_efforts_.front().first <= end_time + kTimeTolerance) {
+    if (pending_efforts_.front().first > plant_context_->get_time()) {
+      plant_simulator_->AdvanceTo(
+          std::min(pending_efforts_.front().first, end_time));
+    }
+    applied_efforts_ = std::move(pending_efforts_.front().second);
+    actuation_->GetMutableVectorData<double>()->SetFromVector(
+        applied_efforts_);
+    pending_efforts_.pop_front();
+  }
+  plant_simulator_->AdvanceTo(end_time);
+  return elapsed.count();
+}
+
+void LockstepLoop::AdvanceTo(double end_time) {
+  while (start_time_ + (num_ticks_ + 1) * period_ <=
+         end_time + kTimeTolerance) {
+    Tick();
+  }
+}
+
+}  // namespace systems
+}  // namespace dairlib
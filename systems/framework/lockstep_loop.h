@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+#include <utility>
+
+#include "systems/framework/output_vector.h"
+
+#include "drake/common/drake_copyable.h"
+#include "drake/multibody/plant/multibody_plant.h"
+#include "drake/systems/analysis/simulator.h"
+#include "drake/systems/framework/diagram.h"
+
+namespace dairlib {
+namespace systems {
+
+/// LockstepLoop runs a controller diagram against a simulated
+/// MultibodyPlant in the same process, without LCM. It replaces the pair of
+/// a simulator publishing lcmt_robot_output and a controller driven by
+/// LcmDrivenLoop: every controller period, the plant state is written into
+/// the OutputVector input of the controller, the controller diagram is
+/// advanced to the current time (so that its per-step events fire once per
+/// state, as with LcmDrivenLoop), and its TimestampedVector output is held
+/// on the plant actuation input until the next period.
+///
+/// The efforts computed from the state at time t can be applied to the plant
+/// with a delay, to emulate the transport and computation latency of the
+/// hardware loop (see SetDelay()). Delays longer than the period are queued,
+/// so the plant may still be driven by the efforts of an earlier state.
+///
+/// The plant and the controller each have their own Simulator. Input values
+/// are fixed once and updated in place, tick times are computed from the tick
+/// count and random delays are drawn from a seeded generator, so runs are
+/// bit-for-bit reproducible.
+class LockstepLoop {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(LockstepLoop)
+
+  ///     @param plant_diagram A diagram containing the plant (and its
+  ///     SceneGraph). The actuation input port of the plant must not be
+  ///     connected.
+  ///     @param plant The simulated plant
+  ///     @param controller_diagram The controller
+  ///     @param controller_state_port The OutputVector input port of
+  ///     controller_diagram, sized for plant
+  ///     @param controller_control_port The TimestampedVector output port of
+  ///     controller_diagram, with the actuator efforts of plant
+  ///     @param controller_period The period of the controller updates
+  LockstepLoop(
+      std::unique_ptr<drake::systems::Diagram<double>> plant_diagram,
+      const drake::multibody::MultibodyPlant<double>& plant,
+      std::unique_ptr<drake::systems::Diagram<double>> controller_diagram,
+      const drake::systems::InputPort<double>& controller_state_port,
+      const drake::systems::OutputPort<double>& controller_control_port,
+      double controller_period);
+
+  /// The context of the plant, e.g. to set the initial state before
+  /// Initialize() or to apply disturbances between ticks
+  drake::systems::Context<double>& get_mutable_plant_context() {
+    return *plant_context_;
+  }
+  const drake::systems::Context<double>& get_plant_context() const {
+    return *plant_context_;
+  }
+  const drake::systems::Context<double>& get_controller_context() const {
+    return controller_simulator_->get_context();
+  }
+  drake::systems::Simulator<double>& get_mutable_plant_simulator() {
+    return *plant_simulator_;
+  }
+  drake::systems::Simulator<double>& get_mutable_controller_simulator() {
+    return *controller_simulator_;
+  }
+  const drake::systems::Diagram<double>& get_controller_diagram() const {
+    return *controller_diagram_;
+  }
+
+  /// The efforts currently applied to the plant (zero until the first
+  /// efforts are applied)
+  const Eigen::VectorXd& get_applied_efforts() const {
+    return applied_efforts_;
+  }
+
+  double get_time() const { return plant_context_->get_time(); }
+  double get_controller_period() const { return period_; }
+
+  /// Applies the efforts computed from the state at time t at t + delay,
+  /// with delay uniform in [min_delay, max_delay] (a fixed delay if they are
+  /// equal). Efforts are applied in the order of the states they are
+  /// computed from, so a random delay shorter than the one of the previous
+  /// tick is extended to keep that order. Default: no delay.
+  void SetDelay(double min_delay, double max_delay, uint32_t seed = 0);
+
+  /// Initializes both simulators at the current time of the plant context
+  void Initialize();
+
+  /// Runs the controller on the current plant state, and simulates the plant
+  /// over one controller period, applying the resulting efforts after the
+  /// delay.
+  /// @return the wall-clock time spent in the controller (seconds)
+  double Tick();
+
+  /// Ticks until the plant reaches end_time
+  void AdvanceTo(double end_time);
+
+ private:
+  const drake::multibody::MultibodyPlant<double>& plant_;
+  drake::systems::Diagram<double>* controller_diagram_;
+  const drake::systems::InputPort<double>& controller_state_port_;
+  const drake::systems::OutputPort<double>& controller_control_port_;
+  const double period_;
+
+  std::unique_ptr<drake::systems::Simulator<double>> plant_simulator_;
+  std::unique_ptr<drake::systems::Simulator<double>> controller_simulator_;
+  drake::systems::Context<double>* plant_context_;
+
+  // Fixed values of the controller state input and plant actuation input,
+  // which are updated in place
+  drake::systems::FixedInputPortValue* robot_output_;
+  drake::systems::FixedInputPortValue* actuation_;
+  Eigen::VectorXd applied_efforts_;
+
+  double min_delay_ = 0;
+  double max_delay_ = 0;
+  std::mt19937 generator_;
+  // Efforts waiting to be applied, with their application time
+  std::deque<std::pair<double, Eigen::VectorXd>> pending_efforts_;
+
+  double start_time_ = 0;
+  int64_t num_ticks_ = 0;
+};
+
+}  // namespace systems
+}  // namespace dairlib
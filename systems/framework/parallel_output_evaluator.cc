@@ -0,0 +1,291 @@
+#include "systems/framework/parallel_output_evaluator.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "drake/common/text_logging.h"
+
+namespace dairlib {
+namespace systems {
+
+using drake::systems::Context;
+using drake::systems::OutputPort;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Workers spin for this long before blocking, since the stages of a tick
+// follow each other within microseconds
+const auto kSpinTime = std::chrono::microseconds(50);
+
+// Room for the spans added with RecordSpan() in each tick
+const int kMaxRecordedSpansPerTick = 8;
+
+// The value of next_task_ for the task index of a generation
+uint64_t ClaimValue(int64_t generation, int index) {
+  return (static_cast<uint64_t>(generation) << 32) |
+         static_cast<uint32_t>(index);
+}
+
+double ToMicroseconds(ParallelOutputEvaluator::Clock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+}  // namespace
+
+ParallelOutputEvaluator::ParallelOutputEvaluator(int num_threads,
+                                                 const vector<int>& cpus) {
+  DRAKE_DEMAND(num_threads >= 0);
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back(&ParallelOutputEvaluator::RunWorker, this, i + 1);
+    if (!cpus.empty()) {
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      CPU_SET(cpus[i % cpus.size()], &cpu_set);
+      if (pthread_setaffinity_np(workers_.back().native_handle(),
+                                 sizeof(cpu_set), &cpu_set) != 0) {
+        drake::log()->warn("Could not pin worker thread {} to cpu {}", i + 1,
+                           cpus[i % cpus.size()]);
+      }
+    }
+  }
+}
+
+ParallelOutputEvaluator::~ParallelOutputEvaluator() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ParallelOutputEvaluator::AddStage(
+    const vector<const OutputPort<double>*>& ports) {
+  DRAKE_DEMAND(!ports.empty());
+  vector<Task> stage;
+  for (const auto port : ports) {
+    DRAKE_DEMAND(port != nullptr);
+    // Two ports of the same system could share its scratch data
+    for (const auto& task : stage) {
+      DRAKE_DEMAND(&task.port->get_system() != &port->get_system());
+    }
+    stage.push_back(
+        {port, GetNameIndex(port->get_system().get_name() + "/" +
+                            port->get_name())});
+  }
+  stages_.push_back(stage);
+}
+
+int ParallelOutputEvaluator::GetNameIndex(const string& name) {
+  auto it = std::find(names_.begin(), names_.end(), name);
+  if (it != names_.end()) {
+    return it - names_.begin();
+  }
+  names_.push_back(name);
+  return names_.size() - 1;
+}
+
+void ParallelOutputEvaluator::Evaluate(const Context<double>& root_context) {
+  if (max_ticks_ > 0 && tick_ < max_ticks_) {
+    tick_++;
+    if (tick_ == max_ticks_ && !trace_filename_.empty()) {
+      WriteTrace(trace_filename_);
+      drake::log()->info("Wrote {}\n{}", trace_filename_,
+                         CriticalPathSummary());
+    }
+  }
+  root_context_ = &root_context;
+  for (const auto& stage : stages_) {
+    int64_t generation;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stage_ = &stage;
+      generation = ++generation_;
+      next_task_ = ClaimValue(generation, 0);
+      num_remaining_ = stage.size();
+    }
+    if (workers_.empty()) {
+      RunTasks(0, stage, generation);
+    } else {
+      start_cv_.notify_all();
+      RunTasks(0, stage, generation);
+      // Wait for the other tasks, and for the workers to leave the stage
+      // before it is replaced by the next one
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_cv_.wait(lock,
+                    [this] { return num_remaining_ == 0 && num_busy_ == 0; });
+    }
+    if (exception_) {
+      std::exception_ptr exception = exception_;
+      exception_ = nullptr;
+      std::rethrow_exception(exception);
+    }
+  }
+}
+
+void ParallelOutputEvaluator::RunWorker(int thread) {
+  int64_t seen_generation = 0;
+  const vector<Task>* stage = nullptr;
+  while (true) {
+    const auto spin_end = Clock::now() + kSpinTime;
+    while (generation_.load() == seen_generation && Clock::now() < spin_end) {
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_cv_.wait(lock, [&] {
+        return stop_ || generation_.load() != seen_generation;
+      });
+      if (stop_) return;
+      // The stage of this generation, which the caller doesn't replace until
+      // num_busy_ is back to 0
+      seen_generation = generation_.load();
+      stage = stage_;
+      num_busy_++;
+    }
+    RunTasks(thread, *stage, seen_generation);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      num_busy_--;
+    }
+    done_cv_.notify_one();
+  }
+}
+
+bool ParallelOutputEvaluator::ClaimTask(int64_t generation, int num_tasks,
+                                        int* index) {
+  const uint64_t first = ClaimValue(generation, 0);
+  uint64_t claim = next_task_.load();
+  do {
+    if (claim < first || claim >= first + num_tasks) {
+      return false;
+    }
+  } while (!next_task_.compare_exchange_weak(claim, claim + 1));
+  *index = claim - first;
+  return true;
+}
+
+void ParallelOutputEvaluator::RunTasks(int thread, const vector<Task>& stage,
+                                       int64_t generation) {
+  int i;
+  while (ClaimTask(generation, stage.size(), &i)) {
+    const Task& task = stage[i];
+    const auto start = Clock::now();
+    try {
+      task.port->EvalAbstract(
+          task.port->get_system().GetMyContextFromRoot(*root_context_));
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!exception_) {
+        exception_ = std::current_exception();
+      }
+    }
+    Record(task.name_index, thread, start);
+    if (--num_remaining_ == 0 && thread != 0) {
+      // Synchronize with the caller, which checks the count under the lock
+      { std::lock_guard<std::mutex> lock(mutex_); }
+      done_cv_.notify_one();
+    }
+  }
+}
+
+void ParallelOutputEvaluator::StartTrace(int max_ticks,
+                                         const string& filename) {
+  DRAKE_DEMAND(max_ticks > 0);
+  int num_tasks = 0;
+  for (const auto& stage : stages_) {
+    num_tasks += stage.size();
+  }
+  spans_.resize(max_ticks * (num_tasks + kMaxRecordedSpansPerTick));
+  num_spans_ = 0;
+  max_ticks_ = max_ticks;
+  tick_ = -1;
+  trace_start_ = Clock::now();
+  trace_filename_ = filename;
+}
+
+void ParallelOutputEvaluator::RecordSpan(const string& name,
+                                         Clock::time_point start) {
+  if (tick_ < 0 || tick_ >= max_ticks_) return;
+  Record(GetNameIndex(name), 0, start);
+}
+
+void ParallelOutputEvaluator::Record(int name_index, int thread,
+                                     Clock::time_point start) {
+  if (tick_ < 0 || tick_ >= max_ticks_) return;
+  const int i = num_spans_++;
+  if (i < static_cast<int>(spans_.size())) {
+    spans_[i] = {tick_, name_index, thread, start, Clock::now()};
+  }
+}
+
+void ParallelOutputEvaluator::WriteTrace(const string& filename) const {
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("Could not open file: " + filename);
+  }
+  file << "{\"traceEvents\": [\n";
+  for (int thread = 0; thread <= num_threads(); thread++) {
+    const string name =
+        thread == 0 ? "caller" : "worker " + std::to_string(thread);
+    file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, "
+         << "\"tid\": " << thread << ", \"args\": {\"name\": \"" << name
+         << "\"}},\n";
+  }
+  const int num_spans = std::min<int>(num_spans_, spans_.size());
+  for (int i = 0; i < num_spans; i++) {
+    const Span& span = spans_[i];
+    file << "{\"name\": \"" << names_[span.name_index]
+         << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << span.thread
+         << ", \"ts\": " << ToMicroseconds(span.start - trace_start_)
+         << ", \"dur\": " << ToMicroseconds(span.end - span.start)
+         << ", \"args\": {\"tick\": " << span.tick << "}}"
+         << (i + 1 < num_spans ? ",\n" : "\n");
+  }
+  file << "]}\n";
+}
+
+string ParallelOutputEvaluator::CriticalPathSummary() const {
+  const int num_ticks = std::min(tick_ + 1, max_ticks_);
+  const int num_spans = std::min<int>(num_spans_, spans_.size());
+  if (num_ticks <= 0 || num_spans == 0) {
+    return "No recorded tick\n";
+  }
+  vector<Clock::time_point> tick_start(num_ticks, Clock::time_point::max());
+  vector<Clock::time_point> tick_end(num_ticks, Clock::time_point::min());
+  double serial = 0;
+  vector<double> per_name(names_.size(), 0);
+  for (int i = 0; i < num_spans; i++) {
+    const Span& span = spans_[i];
+    tick_start[span.tick] = std::min(tick_start[span.tick], span.start);
+    tick_end[span.tick] = std::max(tick_end[span.tick], span.end);
+    serial += ToMicroseconds(span.end - span.start);
+    per_name[span.name_index] += ToMicroseconds(span.end - span.start);
+  }
+  double critical_path = 0;
+  for (int k = 0; k < num_ticks; k++) {
+    if (tick_end[k] > tick_start[k]) {
+      critical_path += ToMicroseconds(tick_end[k] - tick_start[k]);
+    }
+  }
+
+  std::stringstream summary;
+  summary << "Mean over " << num_ticks << " ticks with " << num_threads()
+          << " worker threads (us):\n";
+  summary << "  critical path: " << critical_path / num_ticks << "\n";
+  summary << "  serial cost: " << serial / num_ticks << "\n";
+  for (size_t i = 0; i < names_.size(); i++) {
+    summary << "  " << names_[i] << ": " << per_name[i] / num_ticks << "\n";
+  }
+  return summary.str();
+}
+
+}  // namespace systems
+}  // namespace dairlib
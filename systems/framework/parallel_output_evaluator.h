@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "drake/common/drake_copyable.h"
+#include "drake/systems/framework/context.h"
+#include "drake/systems/framework/output_port.h"
+
+namespace dairlib {
+namespace systems {
+
+/// ParallelOutputEvaluator evaluates output ports of a diagram concurrently
+/// on a persistent pool of worker threads, so that the systems downstream of
+/// them (e.g. the OSC) find the values in the cache.
+///
+/// The ports are grouped into stages, which are evaluated one after the
+/// other. The ports of a stage are evaluated concurrently and must therefore
+/// belong to different leaf systems which don't depend on each other, and
+/// everything they depend on must have been evaluated by a previous stage.
+/// This includes the ports that several tasks of a stage read (e.g. the
+/// receiver of the state): Drake's cache is not thread-safe, so an upstream
+/// port that is out of date would be calculated by several threads at once.
+/// Such a port gets a stage of its own.
+/// Each leaf system keeps its own cache entries in its own subcontext, and
+/// the upstream values are only read, so that the evaluation of a stage
+/// doesn't race.
+///
+/// The calling thread takes part in the evaluation. With no worker thread,
+/// the ports are evaluated one after the other on the calling thread, which
+/// is the serial baseline of the trace.
+///
+/// When tracing, the start and end times of each evaluation, and of the spans
+/// added with RecordSpan() (e.g. the publish of the diagram which solves the
+/// QP), are recorded in a preallocated buffer. WriteTrace() writes them in the
+/// Chrome trace event format (chrome://tracing or https://ui.perfetto.dev),
+/// one row per thread, and CriticalPathSummary() compares the critical path
+/// of the ticks to their serial cost.
+class ParallelOutputEvaluator {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// @param num_threads the number of worker threads, in addition to the
+  /// calling thread
+  /// @param cpus the cpus the worker threads are pinned to, in turn. Empty
+  /// for no pinning.
+  explicit ParallelOutputEvaluator(int num_threads,
+                                   const std::vector<int>& cpus = {});
+
+  ~ParallelOutputEvaluator();
+
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(ParallelOutputEvaluator)
+
+  /// Adds a stage of ports evaluated concurrently, after the previous stages
+  void AddStage(
+      const std::vector<const drake::systems::OutputPort<double>*>& ports);
+
+  /// Evaluates the stages in the context of the root diagram (the context of
+  /// the Simulator)
+  void Evaluate(const drake::systems::Context<double>& root_context);
+
+  /// Records up to max_ticks ticks. A tick starts at each Evaluate(). If
+  /// filename is not empty, the trace is written to it and the summary is
+  /// logged once max_ticks ticks are recorded.
+  void StartTrace(int max_ticks, const std::string& filename = "");
+
+  /// Records a span of the current tick on the calling thread, from start to
+  /// now, e.g. the evaluation of the downstream systems after Evaluate()
+  void RecordSpan(const std::string& name, Clock::time_point start);
+
+  /// Writes the recorded ticks in the Chrome trace event format.
+  /// Throws std::runtime_error if the file cannot be opened.
+  void WriteTrace(const std::string& filename) const;
+
+  /// Mean over the recorded ticks of their duration (the critical path), of
+  /// the sum of their spans (the serial cost) and of each span
+  std::string CriticalPathSummary() const;
+
+  int num_threads() const { return workers_.size(); }
+
+ private:
+  struct Task {
+    const drake::systems::OutputPort<double>* port;
+    int name_index;
+  };
+
+  struct Span {
+    int tick;
+    int name_index;
+    int thread;
+    Clock::time_point start;
+    Clock::time_point end;
+  };
+
+  void RunWorker(int thread);
+  // Claims the next task of generation into *index
+  // @return false if there is none left, or if the generation is over
+  bool ClaimTask(int64_t generation, int num_tasks, int* index);
+  // Evaluates the tasks of stage, the stage of generation, until there is
+  // none left or the generation is over
+  void RunTasks(int thread, const std::vector<Task>& stage,
+                int64_t generation);
+  void Record(int name_index, int thread, Clock::time_point start);
+  int GetNameIndex(const std::string& name);
+
+  std::vector<std::vector<Task>> stages_;
+  std::vector<std::string> names_;
+
+  // State of the stage being evaluated. The workers read stage_ and
+  // generation_ under the mutex, and claim the tasks through next_task_,
+  // which holds the generation in its high 32 bits and the index of the next
+  // task in its low 32 bits, so that a worker late for a stage can't claim a
+  // task of the next one.
+  const drake::systems::Context<double>* root_context_ = nullptr;
+  const std::vector<Task>* stage_ = nullptr;
+  std::atomic<uint64_t> next_task_{0};
+  std::atomic<int> num_remaining_{0};
+  std::exception_ptr exception_;
+
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  // Incremented, under the mutex, for each stage
+  std::atomic<int64_t> generation_{0};
+  // Number of workers evaluating the current stage
+  int num_busy_ = 0;
+  bool stop_ = false;
+  std::vector<std::thread> workers_;
+
+  // Trace. Each span takes the next index of the preallocated buffer.
+  std::vector<Span> spans_;
+  std::atomic<int> num_spans_{0};
+  int max_ticks_ = 0;
+  int tick_ = -1;
+  Clock::time_point trace_start_;
+  std::string trace_filename_;
+};
+
+}  // namespace systems
+}  // namespace dairlib
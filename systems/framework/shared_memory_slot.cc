@@ -0,0 +1,213 @@
+#include "systems/framework/shared_memory_slot.h"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include "drake/common/drake_assert.h"
+
+namespace dairlib {
+namespace systems {
+
+// The first cache line of the region. The data follows on the next one.
+struct alignas(64) SharedMemorySlot::Header {
+  // Set last by the process creating the region
+  std::atomic<uint64_t> magic;
+  uint64_t capacity;
+  // Odd while the value is being written
+  std::atomic<uint64_t> sequence;
+  std::atomic<uint32_t> size;
+  // Incremented after each write, the futex word of the waiting readers
+  std::atomic<uint32_t> futex;
+  std::atomic<uint32_t> num_waiters;
+};
+
+namespace {
+
+const uint64_t kMagic = 0x31306d7372696164;  // "dairsm01"
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "The futex word must be a plain 32 bit integer");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "The slot is shared between processes");
+
+// Longer than any live write of the value, after which a reader gives up
+const auto kMaxWriteTime = std::chrono::milliseconds(10);
+
+std::string MakePath(const std::string& name) { return "/dairlib_" + name; }
+
+long Futex(std::atomic<uint32_t>* word, int op, uint32_t value,
+           const timespec* timeout) {
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value,
+                 timeout, nullptr, 0);
+}
+
+}  // namespace
+
+SharedMemorySlot::SharedMemorySlot(const std::string& name, int capacity)
+    : path_(MakePath(name)), capacity_(capacity) {
+  DRAKE_DEMAND(capacity > 0);
+  region_size_ = sizeof(Header) + capacity;
+
+  // The process creating the region sizes and initializes it. The others wait
+  // for the magic number.
+  bool created = true;
+  int fd = shm_open(path_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+  if (fd < 0 && errno == EEXIST) {
+    created = false;
+    fd = shm_open(path_.c_str(), O_RDWR, 0666);
+  }
+  if (fd < 0) {
+    throw std::runtime_error("Could not open shared memory " + path_ + ": " +
+                             std::strerror(errno));
+  }
+  if (created && ftruncate(fd, region_size_) != 0) {
+    close(fd);
+    throw std::runtime_error("Could not size shared memory " + path_);
+  }
+  if (!created) {
+    struct stat status;
+    for (int i = 0; fstat(fd, &status) == 0 &&
+                    status.st_size < static_cast<off_t>(sizeof(Header));
+         i++) {
+      if (i == 1000) {
+        close(fd);
+        throw std::runtime_error("Shared memory " + path_ +
+                                 " was never initialized");
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (status.st_size != static_cast<off_t>(region_size_)) {
+      close(fd);
+      throw std::runtime_error("Shared memory " + path_ +
+                               " has a different capacity, unlink it first");
+    }
+  }
+  void* region = mmap(nullptr, region_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+  close(fd);
+  if (region == MAP_FAILED) {
+    throw std::runtime_error("Could not map shared memory " + path_);
+  }
+  // ftruncate zero fills the region, which is a valid state of the atomics
+  header_ = static_cast<Header*>(region);
+  data_ = static_cast<uint8_t*>(region) + sizeof(Header);
+  if (created) {
+    header_->capacity = capacity;
+    header_->magic.store(kMagic);
+  } else {
+    for (int i = 0; header_->magic.load() != kMagic; i++) {
+      if (i == 1000) {
+        munmap(region, region_size_);
+        throw std::runtime_error("Shared memory " + path_ +
+                                 " was never initialized");
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    DRAKE_DEMAND(header_->capacity == static_cast<uint64_t>(capacity));
+  }
+}
+
+SharedMemorySlot::~SharedMemorySlot() { munmap(header_, region_size_); }
+
+void SharedMemorySlot::Unlink(const std::string& name) {
+  shm_unlink(MakePath(name).c_str());
+}
+
+void SharedMemorySlot::Write(const void* data, int size) {
+  DRAKE_DEMAND(size >= 0 && size <= capacity_);
+  // Odd if a previous writer died in the middle of a write
+  const uint64_t sequence =
+      header_->sequence.load(std::memory_order_relaxed) & ~uint64_t(1);
+  header_->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(data_, data, size);
+  header_->size.store(size, std::memory_order_relaxed);
+  header_->sequence.store(sequence + 2, std::memory_order_release);
+
+  header_->futex.fetch_add(1);
+  if (header_->num_waiters.load() > 0) {
+    Futex(&header_->futex, FUTEX_WAKE, INT_MAX, nullptr);
+  }
+}
+
+int SharedMemorySlot::Read(uint64_t* sequence, void* data) const {
+  std::chrono::steady_clock::time_point write_start;
+  bool is_written = false;
+  while (true) {
+    const uint64_t before = header_->sequence.load(std::memory_order_acquire);
+    if (before == *sequence) {
+      return -1;
+    }
+    if (before & 1) {
+      // Being written, or the writer died in the middle of a write, in which
+      // case the value is only valid again after the next one
+      const auto now = std::chrono::steady_clock::now();
+      if (!is_written) {
+        write_start = now;
+        is_written = true;
+      } else if (now - write_start > kMaxWriteTime) {
+        return -1;
+      }
+      continue;
+    }
+    const int size = header_->size.load(std::memory_order_relaxed);
+    std::memcpy(data, data_, size);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header_->sequence.load(std::memory_order_relaxed) == before) {
+      *sequence = before;
+      return size;
+    }
+  }
+}
+
+bool SharedMemorySlot::WaitForNewer(uint64_t sequence, double timeout,
+                                    bool spin) const {
+  const auto end = std::chrono::steady_clock::now() +
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::duration<double>(timeout));
+  while (true) {
+    // A write in progress is newer too
+    const uint32_t futex = header_->futex.load();
+    if (header_->sequence.load() != sequence) {
+      return true;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= end) {
+      return false;
+    }
+    if (spin) {
+      continue;
+    }
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - now);
+    timespec relative;
+    relative.tv_sec = remaining.count() / 1000000000;
+    relative.tv_nsec = remaining.count() % 1000000000;
+    // The writer wakes the waiters after incrementing the futex word, so a
+    // write after the load above either changes the word (and FUTEX_WAIT
+    // returns immediately) or sees the waiter
+    header_->num_waiters.fetch_add(1);
+    Futex(&header_->futex, FUTEX_WAIT, futex, &relative);
+    header_->num_waiters.fetch_sub(1);
+  }
+}
+
+uint64_t SharedMemorySlot::sequence() const {
+  return header_->sequence.load(std::memory_order_acquire) & ~uint64_t(1);
+}
+
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+namespace systems {
+
+/// SharedMemorySlot holds the latest value written to a named POSIX shared
+/// memory region (/dev/shm/dairlib_<name>), for processes on the same host.
+///
+/// The value is protected by a seqlock: the writer never blocks, and a reader
+/// copies the value and retries if it was overwritten meanwhile. There must be
+/// a single writer per slot, and any number of readers. Readers can wait for
+/// a new value by spinning or on a futex, which the writer only wakes when a
+/// reader is waiting.
+///
+/// The region is created by the first process opening it and is left in
+/// /dev/shm when the processes exit, so that either side can restart. Opening
+/// a slot with a different capacity than the existing region throws
+/// std::runtime_error (see Unlink()).
+///
+/// A writer which dies in the middle of a write leaves the sequence odd.
+/// Read() then returns -1 (after waiting for the write to finish for a few
+/// milliseconds) until the restarted writer writes the next value.
+class SharedMemorySlot {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(SharedMemorySlot)
+
+  /// @param name the name of the slot, e.g. the LCM channel it replaces
+  /// @param capacity the largest value, in bytes
+  SharedMemorySlot(const std::string& name, int capacity);
+
+  ~SharedMemorySlot();
+
+  /// Removes the region of the slot name from /dev/shm. The processes which
+  /// opened it keep their mapping.
+  static void Unlink(const std::string& name);
+
+  /// Writes a value of size bytes (at most the capacity)
+  void Write(const void* data, int size);
+
+  /// Copies the latest value into data (of at least capacity bytes) if it is
+  /// newer than *sequence, and updates *sequence.
+  /// @return the size of the value, or -1 if there is no newer value
+  int Read(uint64_t* sequence, void* data) const;
+
+  /// Blocks until a value newer than sequence is written, or for timeout
+  /// seconds. With spin, busy waits instead of sleeping on the futex, which
+  /// has a lower latency on an isolated cpu.
+  /// @return true if there is a newer value
+  bool WaitForNewer(uint64_t sequence, double timeout,
+                    bool spin = false) const;
+
+  /// The sequence number of the latest value, 0 if none was written. It
+  /// increases by 2 with each value.
+  uint64_t sequence() const;
+
+  int capacity() const { return capacity_; }
+
+ private:
+  struct Header;
+
+  const std::string path_;
+  const int capacity_;
+  size_t region_size_;
+  Header* header_;
+  uint8_t* data_;
+};
+
+}  // namespace systems
+}  // namespace dairlib
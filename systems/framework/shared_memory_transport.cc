@@ -0,0 +1,294 @@
+#include "systems/framework/shared_memory_transport.h"
+
+#include <cstring>
+
+#include "drake/lcm/drake_lcm_interface.h"
+
+namespace dairlib {
+namespace systems {
+
+using drake::systems::Context;
+using drake::systems::EventStatus;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Appends values to a buffer, and remembers if it overflowed
+class Packer {
+ public:
+  Packer(uint8_t* buffer, int capacity)
+      : buffer_(buffer), capacity_(capacity) {}
+
+  template <typename T>
+  void Add(const T& value) {
+    AddBytes(&value, sizeof(T));
+  }
+
+  void Add(const vector<double>& values) {
+    AddBytes(values.data(), values.size() * sizeof(double));
+  }
+
+  // Null terminated
+  void Add(const vector<string>& names) {
+    for (const auto& name : names) {
+      AddBytes(name.c_str(), name.size() + 1);
+    }
+  }
+
+  int size() const { return overflow_ ? -1 : size_; }
+
+ private:
+  void AddBytes(const void* bytes, int size) {
+    if (overflow_ || size_ + size > capacity_) {
+      overflow_ = true;
+      return;
+    }
+    std::memcpy(buffer_ + size_, bytes, size);
+    size_ += size;
+  }
+
+  uint8_t* buffer_;
+  const int capacity_;
+  int size_ = 0;
+  bool overflow_ = false;
+};
+
+class Unpacker {
+ public:
+  Unpacker(const uint8_t* buffer, int size) : buffer_(buffer), size_(size) {}
+
+  template <typename T>
+  void Get(T* value) {
+    GetBytes(value, sizeof(T));
+  }
+
+  void Get(int count, vector<double>* values) {
+    if (count < 0) {
+      count = 0;
+      error_ = true;
+    }
+    values->resize(count);
+    GetBytes(values->data(), count * sizeof(double));
+  }
+
+  void Get(int count, vector<string>* names) {
+    if (count < 0) {
+      count = 0;
+      error_ = true;
+    }
+    names->resize(count);
+    for (auto& name : *names) {
+      const void* end =
+          error_ ? nullptr : std::memchr(buffer_ + index_, 0, size_ - index_);
+      if (end == nullptr) {
+        error_ = true;
+        return;
+      }
+      const int length = static_cast<const uint8_t*>(end) - buffer_ - index_;
+      // Assigning an equal or shorter string keeps the allocation
+      name.assign(reinterpret_cast<const char*>(buffer_ + index_), length);
+      index_ += length + 1;
+    }
+  }
+
+  bool ok() const { return !error_ && index_ == size_; }
+
+ private:
+  void GetBytes(void* bytes, int size) {
+    if (error_ || index_ + size > size_) {
+      error_ = true;
+      return;
+    }
+    std::memcpy(bytes, buffer_ + index_, size);
+    index_ += size;
+  }
+
+  const uint8_t* buffer_;
+  const int size_;
+  int index_ = 0;
+  bool error_ = false;
+};
+
+}  // namespace
+
+int PackMessage(const lcmt_robot_output& message, uint8_t* buffer,
+                int capacity) {
+  DRAKE_DEMAND(message.num_positions ==
+               static_cast<int>(message.position.size()));
+  DRAKE_DEMAND(message.num_positions ==
+               static_cast<int>(message.position_names.size()));
+  DRAKE_DEMAND(message.num_velocities ==
+               static_cast<int>(message.velocity.size()));
+  DRAKE_DEMAND(message.num_velocities ==
+               static_cast<int>(message.velocity_names.size()));
+  DRAKE_DEMAND(message.num_efforts ==
+               static_cast<int>(message.effort.size()));
+  DRAKE_DEMAND(message.num_efforts ==
+               static_cast<int>(message.effort_names.size()));
+  Packer packer(buffer, capacity);
+  packer.Add(message.utime);
+  packer.Add(message.num_positions);
+  packer.Add(message.num_velocities);
+  packer.Add(message.num_efforts);
+  packer.Add(message.imu_accel);
+  packer.Add(message.position);
+  packer.Add(message.velocity);
+  packer.Add(message.effort);
+  packer.Add(message.position_names);
+  packer.Add(message.velocity_names);
+  packer.Add(message.effort_names);
+  return packer.size();
+}
+
+int PackMessage(const lcmt_robot_input& message, uint8_t* buffer,
+                int capacity) {
+  DRAKE_DEMAND(message.num_efforts ==
+               static_cast<int>(message.efforts.size()));
+  DRAKE_DEMAND(message.num_efforts ==
+               static_cast<int>(message.effort_names.size()));
+  Packer packer(buffer, capacity);
+  packer.Add(message.utime);
+  packer.Add(message.num_efforts);
+  packer.Add(message.efforts);
+  packer.Add(message.effort_names);
+  return packer.size();
+}
+
+bool UnpackMessage(const uint8_t* buffer, int size,
+                   lcmt_robot_output* message) {
+  Unpacker unpacker(buffer, size);
+  unpacker.Get(&message->utime);
+  unpacker.Get(&message->num_positions);
+  unpacker.Get(&message->num_velocities);
+  unpacker.Get(&message->num_efforts);
+  unpacker.Get(&message->imu_accel);
+  unpacker.Get(message->num_positions, &message->position);
+  unpacker.Get(message->num_velocities, &message->velocity);
+  unpacker.Get(message->num_efforts, &message->effort);
+  unpacker.Get(message->num_positions, &message->position_names);
+  unpacker.Get(message->num_velocities, &message->velocity_names);
+  unpacker.Get(message->num_efforts, &message->effort_names);
+  return unpacker.ok();
+}
+
+bool UnpackMessage(const uint8_t* buffer, int size,
+                   lcmt_robot_input* message) {
+  Unpacker unpacker(buffer, size);
+  unpacker.Get(&message->utime);
+  unpacker.Get(&message->num_efforts);
+  unpacker.Get(message->num_efforts, &message->efforts);
+  unpacker.Get(message->num_efforts, &message->effort_names);
+  return unpacker.ok();
+}
+
+template <typename MessageType>
+SharedMemoryPublisherSystem<MessageType>::SharedMemoryPublisherSystem(
+    const string& channel, drake::lcm::DrakeLcmInterface* mirror_lcm,
+    double mirror_period)
+    : channel_(channel),
+      slot_(channel, kSharedMemoryCapacity),
+      buffer_(kSharedMemoryCapacity),
+      mirror_lcm_(mirror_lcm),
+      mirror_period_(mirror_period),
+      mirror_buffer_(kSharedMemoryCapacity) {
+  this->DeclareAbstractInputPort(channel, drake::Value<MessageType>{});
+  this->DeclareForcedPublishEvent(
+      &SharedMemoryPublisherSystem<MessageType>::WriteMessage);
+  this->set_name("SharedMemoryPublisherSystem(" + channel + ")");
+  if (mirror_lcm_ != nullptr) {
+    mirror_thread_ =
+        std::thread(&SharedMemoryPublisherSystem<MessageType>::RunMirror, this);
+  }
+}
+
+template <typename MessageType>
+SharedMemoryPublisherSystem<MessageType>::~SharedMemoryPublisherSystem() {
+  if (mirror_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mirror_mutex_);
+      stop_mirror_ = true;
+    }
+    mirror_cv_.notify_one();
+    mirror_thread_.join();
+  }
+}
+
+template <typename MessageType>
+EventStatus SharedMemoryPublisherSystem<MessageType>::WriteMessage(
+    const Context<double>& context) const {
+  const auto& message = get_input_port().template Eval<MessageType>(context);
+  const int size = PackMessage(message, buffer_.data(), buffer_.size());
+  if (size < 0) {
+    return EventStatus::Failed(this, "The message exceeds the capacity of " +
+                                         channel_);
+  }
+  slot_.Write(buffer_.data(), size);
+
+  // Hand the message to the mirror thread, unless it is still publishing
+  if (mirror_lcm_ != nullptr &&
+      context.get_time() - last_mirror_time_ >= mirror_period_) {
+    std::unique_lock<std::mutex> lock(mirror_mutex_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      std::memcpy(mirror_buffer_.data(), buffer_.data(), size);
+      mirror_size_ = size;
+      last_mirror_time_ = context.get_time();
+      lock.unlock();
+      mirror_cv_.notify_one();
+    }
+  }
+  return EventStatus::Succeeded();
+}
+
+template <typename MessageType>
+void SharedMemoryPublisherSystem<MessageType>::RunMirror() {
+  vector<uint8_t> buffer(kSharedMemoryCapacity);
+  MessageType message;
+  while (true) {
+    int size;
+    {
+      std::unique_lock<std::mutex> lock(mirror_mutex_);
+      mirror_cv_.wait(lock, [this] { return stop_mirror_ || mirror_size_; });
+      if (stop_mirror_) return;
+      size = mirror_size_;
+      std::memcpy(buffer.data(), mirror_buffer_.data(), size);
+      mirror_size_ = 0;
+    }
+    if (UnpackMessage(buffer.data(), size, &message)) {
+      drake::lcm::Publish(mirror_lcm_, channel_, message);
+    }
+  }
+}
+
+template <typename MessageType>
+SharedMemorySubscriber<MessageType>::SharedMemorySubscriber(
+    const string& channel)
+    : slot_(channel, kSharedMemoryCapacity), buffer_(kSharedMemoryCapacity) {
+  // The slot outlives its processes: skip what was published before, which
+  // may come from a publisher that has since stopped
+  sequence_ = slot_.sequence();
+}
+
+template <typename MessageType>
+bool SharedMemorySubscriber<MessageType>::Poll() {
+  const int size = slot_.Read(&sequence_, buffer_.data());
+  if (size < 0 || !UnpackMessage(buffer_.data(), size, &message_)) {
+    return false;
+  }
+  count_++;
+  return true;
+}
+
+template <typename MessageType>
+bool SharedMemorySubscriber<MessageType>::WaitForMessage(double timeout,
+                                                         bool spin) {
+  return slot_.WaitForNewer(sequence_, timeout, spin) && Poll();
+}
+
+template class SharedMemoryPublisherSystem<lcmt_robot_output>;
+template class SharedMemoryPublisherSystem<lcmt_robot_input>;
+template class SharedMemorySubscriber<lcmt_robot_output>;
+template class SharedMemorySubscriber<lcmt_robot_input>;
+
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dairlib/lcmt_robot_input.hpp"
+#include "dairlib/lcmt_robot_output.hpp"
+#include "systems/framework/shared_memory_slot.h"
+
+#include "drake/lcm/drake_lcm_interface.h"
+#include "drake/systems/framework/leaf_system.h"
+
+namespace dairlib {
+namespace systems {
+
+/// Capacity of the slots of SharedMemoryPublisherSystem and
+/// SharedMemorySubscriber, in bytes
+constexpr int kSharedMemoryCapacity = 16384;
+
+/// Flat, native-endian layout of the robot messages in a SharedMemorySlot,
+/// instead of the LCM encoding.
+/// @return the packed size, or -1 if it exceeds capacity
+int PackMessage(const lcmt_robot_output& message, uint8_t* buffer,
+                int capacity);
+int PackMessage(const lcmt_robot_input& message, uint8_t* buffer,
+                int capacity);
+
+/// Inverse of PackMessage. The strings and vectors of message are reused, so
+/// that unpacking doesn't allocate once their sizes are stable.
+/// @return false if the data is malformed
+bool UnpackMessage(const uint8_t* buffer, int size,
+                   lcmt_robot_output* message);
+bool UnpackMessage(const uint8_t* buffer, int size, lcmt_robot_input* message);
+
+/// SharedMemoryPublisherSystem writes its input message to the
+/// SharedMemorySlot named after channel on each forced publish, in place of
+/// an LcmPublisherSystem with TriggerType::kForced, for processes on the same
+/// host.
+///
+/// The messages can be mirrored on the LCM channel (e.g. for lcm-logger) by
+/// a background thread, so that the LCM encoding and send are off the
+/// critical path. The publish only hands the packed message to the thread if
+/// it is idle, and at most every mirror_period seconds.
+///
+/// Instantiated for lcmt_robot_output and lcmt_robot_input.
+template <typename MessageType>
+class SharedMemoryPublisherSystem : public drake::systems::LeafSystem<double> {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(SharedMemoryPublisherSystem)
+
+  /// @param channel the name of the slot and of the mirrored LCM channel
+  /// @param mirror_lcm the lcm to mirror the messages on, nullptr for none
+  /// @param mirror_period the minimum period of the mirrored messages
+  SharedMemoryPublisherSystem(const std::string& channel,
+                              drake::lcm::DrakeLcmInterface* mirror_lcm,
+                              double mirror_period = 0);
+
+  ~SharedMemoryPublisherSystem() override;
+
+  const drake::systems::InputPort<double>& get_input_port() const {
+    return drake::systems::LeafSystem<double>::get_input_port(0);
+  }
+
+ private:
+  drake::systems::EventStatus WriteMessage(
+      const drake::systems::Context<double>& context) const;
+
+  void RunMirror();
+
+  const std::string channel_;
+  SharedMemorySlot slot_;
+  // Only touched by the thread publishing the diagram
+  mutable std::vector<uint8_t> buffer_;
+
+  drake::lcm::DrakeLcmInterface* mirror_lcm_;
+  const double mirror_period_;
+  mutable double last_mirror_time_ = -1;
+  mutable std::mutex mirror_mutex_;
+  mutable std::condition_variable mirror_cv_;
+  mutable std::vector<uint8_t> mirror_buffer_;
+  mutable int mirror_size_ = 0;
+  bool stop_mirror_ = false;
+  std::thread mirror_thread_;
+};
+
+/// SharedMemorySubscriber receives the messages of a
+/// SharedMemoryPublisherSystem, with the interface of
+/// drake::lcm::Subscriber (message(), count(), clear()), but polled or waited
+/// for rather than dispatched by HandleSubscriptions. Only the latest message
+/// is kept, and only messages published after construction are received.
+///
+/// Instantiated for lcmt_robot_output and lcmt_robot_input.
+template <typename MessageType>
+class SharedMemorySubscriber {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(SharedMemorySubscriber)
+
+  explicit SharedMemorySubscriber(const std::string& channel);
+
+  /// Copies the latest message if it is newer than the previous one
+  /// @return true if there was a new message
+  bool Poll();
+
+  /// Blocks until there is a new message, or for timeout seconds, and polls
+  /// it (see SharedMemorySlot::WaitForNewer)
+  bool WaitForMessage(double timeout, bool spin = false);
+
+  const MessageType& message() const { return message_; }
+
+  /// The number of messages received since the last clear()
+  int count() const { return count_; }
+
+  void clear() { count_ = 0; }
+
+ private:
+  SharedMemorySlot slot_;
+  std::vector<uint8_t> buffer_;
+  uint64_t sequence_ = 0;
+  MessageType message_;
+  int count_ = 0;
+};
+
+}  // namespace systems
+}  // namespace dairlib
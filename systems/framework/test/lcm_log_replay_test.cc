@@ -0,0 +1,190 @@
+#include "systems/framework/lcm_log_replay.h"
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "lcm/lcm-cpp.hpp"
+
+#include "dairlib/lcmt_robot_input.hpp"
+#include "dairlib/lcmt_robot_output.hpp"
+#include "systems/framework/lcm_driven_loop.h"
+
+#include "drake/common/temp_directory.h"
+#include "drake/systems/framework/diagram_builder.h"
+#include "drake/systems/framework/leaf_system.h"
+#include "drake/systems/lcm/lcm_publisher_system.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+using drake::systems::Context;
+using drake::systems::DiagramBuilder;
+using drake::systems::LeafSystem;
+using drake::systems::TriggerType;
+using drake::systems::lcm::LcmPublisherSystem;
+using std::string;
+using std::vector;
+
+// Controller that outputs `gain` times the first imu acceleration
+class TestController : public LeafSystem<double> {
+ public:
+  explicit TestController(double gain) : gain_(gain) {
+    this->DeclareAbstractInputPort("lcmt_robot_output",
+                                   drake::Value<lcmt_robot_output>{});
+    this->DeclareAbstractOutputPort(&TestController::CalcInput);
+  }
+
+ private:
+  void CalcInput(const Context<double>& context,
+                 lcmt_robot_input* input) const {
+    const auto& output =
+        this->get_input_port(0).Eval<lcmt_robot_output>(context);
+    input->utime = output.utime;
+    input->num_efforts = 1;
+    input->effort_names = {"u"};
+    input->efforts = {gain_ * output.imu_accel[0]};
+  }
+
+  const double gain_;
+};
+
+class LcmLogReplayTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    input_log_ = drake::temp_directory() + "/input.log";
+    lcm::LogFile log(input_log_, "w");
+    ASSERT_TRUE(log.good());
+    for (int i = 0; i < kNumTicks; i++) {
+      lcmt_robot_output state{};
+      state.utime = 1000000 + 1000 * i;
+      state.imu_accel[0] = 0.1 * i;
+      WriteEvent(&log, "STATE", state);
+      // Messages of the other channels are skipped
+      WriteEvent(&log, "OTHER", state);
+    }
+  }
+
+  template <typename MessageType>
+  void WriteEvent(lcm::LogFile* log, const string& channel,
+                  const MessageType& message) {
+    vector<uint8_t> bytes(message.getEncodedSize());
+    message.encode(bytes.data(), 0, bytes.size());
+    lcm::LogEvent event;
+    event.timestamp = message.utime;
+    event.channel = channel;
+    event.datalen = bytes.size();
+    event.data = bytes.data();
+    log->writeEvent(&event);
+  }
+
+  // Replays the input log through a LcmDrivenLoop of a TestController, and
+  // runs `check` on the results. Returns the result of Report().
+  bool Replay(double gain, LcmLogReplayOptions options,
+              const std::function<void(const LcmLogReplay&)>& check =
+                  [](const LcmLogReplay&) {}) {
+    drake::lcm::DrakeLcm lcm("memq://");
+    DiagramBuilder<double> builder;
+    auto controller = builder.AddSystem<TestController>(gain);
+    auto publisher = builder.AddSystem(
+        LcmPublisherSystem::Make<lcmt_robot_input>(
+            "INPUT", &lcm, {TriggerType::kForced}));
+    builder.Connect(*controller, *publisher);
+    LcmDrivenLoop<lcmt_robot_output> loop(&lcm, builder.Build(), controller,
+                                          "STATE", true);
+
+    options.input_log = input_log_;
+    options.input_channel = "STATE";
+    options.output_channels = {"INPUT"};
+    LcmLogReplay replay(&lcm, std::move(options));
+    EXPECT_EQ(replay.Replay(MakeTickFunction<lcmt_robot_output>(
+                  [&loop](const lcmt_robot_output& state) {
+                    loop.Step(state);
+                  })),
+              kNumTicks);
+    check(replay);
+    return replay.Report();
+  }
+
+  static constexpr int kNumTicks = 20;
+  string input_log_;
+};
+
+TEST_F(LcmLogReplayTest, RecordTest) {
+  Replay(2, {}, [](const LcmLogReplay& replay) {
+    ASSERT_EQ(static_cast<int>(replay.recorded_messages().size()), kNumTicks);
+    EXPECT_EQ(static_cast<int>(replay.tick_times().size()), kNumTicks);
+    for (int i = 0; i < kNumTicks; i++) {
+      const auto& message = replay.recorded_messages()[i];
+      EXPECT_EQ(message.tick, i);
+      EXPECT_EQ(message.channel, "INPUT");
+      EXPECT_EQ(message.timestamp, 1000000 + 1000 * i);
+      lcmt_robot_input input;
+      input.decode(message.data.data(), 0, message.data.size());
+      EXPECT_EQ(input.utime, 1000000 + 1000 * i);
+      EXPECT_DOUBLE_EQ(input.efforts[0], 0.2 * i);
+    }
+  });
+}
+
+TEST_F(LcmLogReplayTest, GoldenLogTest) {
+  LcmLogReplayOptions options;
+  options.output_log = drake::temp_directory() + "/golden.log";
+  options.tick_times = drake::temp_directory() + "/tick_times.txt";
+  EXPECT_TRUE(Replay(2, options));
+  EXPECT_EQ(
+      static_cast<int>(LcmLogReplay::ReadTickTimes(options.tick_times).size()),
+      kNumTicks);
+
+  // The same diagram publishes the same bytes
+  Replay(2, {}, [&](const LcmLogReplay& replay) {
+    const vector<ChannelDiff> diffs = replay.CompareWith(options.output_log);
+    ASSERT_EQ(diffs.size(), 1u);
+    EXPECT_EQ(diffs[0].channel, "INPUT");
+    EXPECT_EQ(diffs[0].num_recorded, kNumTicks);
+    EXPECT_EQ(diffs[0].num_golden, kNumTicks);
+    EXPECT_TRUE(diffs[0].matches());
+  });
+
+  // A change of the controller is caught from the first nonzero effort
+  LcmLogReplayOptions golden_options;
+  golden_options.golden_log = options.output_log;
+  EXPECT_FALSE(Replay(3, golden_options, [&](const LcmLogReplay& replay) {
+    const vector<ChannelDiff> diffs = replay.CompareWith(options.output_log);
+    EXPECT_FALSE(diffs[0].matches());
+    EXPECT_EQ(diffs[0].num_different, kNumTicks - 1);
+    EXPECT_EQ(diffs[0].first_different_tick, 1);
+  }));
+}
+
+TEST_F(LcmLogReplayTest, MaxTicksTest) {
+  LcmLogReplayOptions options;
+  options.max_ticks = 5;
+  drake::lcm::DrakeLcm lcm("memq://");
+  options.input_log = input_log_;
+  options.input_channel = "STATE";
+  LcmLogReplay replay(&lcm, options);
+  int num_calls = 0;
+  EXPECT_EQ(replay.Replay([&](const void*, int) { num_calls++; }), 5);
+  EXPECT_EQ(num_calls, 5);
+}
+
+TEST(TickTimeStatisticsTest, StatisticsTest) {
+  vector<double> times;
+  for (int i = 100; i >= 1; i--) {
+    times.push_back(i * 1e-6);
+  }
+  const TickTimeStatistics stats = LcmLogReplay::CalcStatistics(times);
+  EXPECT_EQ(stats.num_ticks, 100);
+  EXPECT_NEAR(stats.mean, 50.5e-6, 1e-12);
+  EXPECT_NEAR(stats.median, 50e-6, 1e-12);
+  EXPECT_NEAR(stats.p99, 99e-6, 1e-12);
+  EXPECT_NEAR(stats.max, 100e-6, 1e-12);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,123 @@
+#include "systems/framework/lockstep_loop.h"
+
+#include <memory>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "drake/multibody/tree/prismatic_joint.h"
+#include "drake/systems/framework/diagram_builder.h"
+#include "drake/systems/framework/leaf_system.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+using drake::multibody::MultibodyPlant;
+using drake::multibody::PrismaticJoint;
+using drake::multibody::SpatialInertia;
+using drake::multibody::UnitInertia;
+using drake::systems::Context;
+using drake::systems::Diagram;
+using drake::systems::DiagramBuilder;
+using drake::systems::LeafSystem;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+
+// Controller of a one dof plant, which outputs either a PD law toward q = 1
+// or the timestamp of its input
+class TestController : public LeafSystem<double> {
+ public:
+  explicit TestController(bool output_timestamp)
+      : output_timestamp_(output_timestamp) {
+    this->DeclareVectorInputPort(OutputVector<double>(1, 1, 1));
+    this->DeclareVectorOutputPort(TimestampedVector<double>(1),
+                                  &TestController::CalcControl);
+  }
+
+ private:
+  void CalcControl(const Context<double>& context,
+                   TimestampedVector<double>* control) const {
+    const OutputVector<double>* state =
+        (OutputVector<double>*)this->EvalVectorInput(context, 0);
+    VectorXd u(1);
+    if (output_timestamp_) {
+      u << state->get_timestamp();
+    } else {
+      u << 100 * (1 - state->GetPositions()(0)) -
+               20 * state->GetVelocities()(0);
+    }
+    control->SetDataVector(u);
+    control->set_timestamp(state->get_timestamp());
+  }
+
+  const bool output_timestamp_;
+};
+
+// A unit mass on a prismatic joint, with a time step of 1 ms
+std::unique_ptr<LockstepLoop> MakeLoop(bool output_timestamp, double period) {
+  DiagramBuilder<double> plant_builder;
+  auto plant = plant_builder.AddSystem<MultibodyPlant<double>>(1e-3);
+  const auto& body = plant->AddRigidBody(
+      "body", SpatialInertia<double>(1, Vector3d::Zero(),
+                                     UnitInertia<double>::SolidSphere(0.1)));
+  const auto& joint = plant->AddJoint<PrismaticJoint>(
+      "x", plant->world_body(), std::nullopt, body, std::nullopt,
+      Vector3d::UnitX());
+  plant->AddJointActuator("u", joint);
+  plant->Finalize();
+
+  DiagramBuilder<double> controller_builder;
+  auto controller =
+      controller_builder.AddSystem<TestController>(output_timestamp);
+  controller_builder.ExportInput(controller->get_input_port(0));
+  controller_builder.ExportOutput(controller->get_output_port(0));
+  std::unique_ptr<Diagram<double>> controller_diagram =
+      controller_builder.Build();
+  const auto& state_port = controller_diagram->get_input_port(0);
+  const auto& control_port = controller_diagram->get_output_port(0);
+
+  return std::make_unique<LockstepLoop>(plant_builder.Build(), *plant,
+                                        std::move(controller_diagram),
+                                        state_port, control_port, period);
+}
+
+TEST(LockstepLoopTest, Delay) {
+  const double period = 0.01;
+  for (double delay : {0.0, 0.025}) {
+    auto loop = MakeLoop(true, period);
+    loop->SetDelay(delay, delay);
+    loop->Initialize();
+    for (int k = 0; k < 10; k++) {
+      loop->Tick();
+      EXPECT_NEAR(loop->get_time(), (k + 1) * period, 1e-12);
+      // The efforts are the time of the state they are computed from, which
+      // is the current tick without delay and two ticks before with a delay
+      // of 2.5 periods
+      double expected = k * period;
+      if (delay > 0) {
+        expected = k >= 2 ? (k - 2) * period : 0;
+      }
+      EXPECT_NEAR(loop->get_applied_efforts()(0), expected, 1e-12);
+    }
+  }
+}
+
+TEST(LockstepLoopTest, Reproducible) {
+  VectorXd final_state[2];
+  for (int i = 0; i < 2; i++) {
+    auto loop = MakeLoop(false, 0.005);
+    loop->SetDelay(0, 0.01, 5);
+    loop->Initialize();
+    loop->AdvanceTo(1);
+    EXPECT_NEAR(loop->get_time(), 1, 1e-12);
+    final_state[i] =
+        loop->get_plant_context().get_discrete_state_vector().CopyToVector();
+  }
+  EXPECT_GT(final_state[0](0), 0.5);
+  EXPECT_EQ(final_state[0], final_state[1]);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,214 @@
+#include "systems/framework/parallel_output_evaluator.h"
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "drake/systems/framework/diagram_builder.h"
+#include "drake/systems/framework/leaf_system.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+using drake::systems::BasicVector;
+using drake::systems::Context;
+using drake::systems::Diagram;
+using drake::systems::DiagramBuilder;
+using drake::systems::LeafSystem;
+
+// Outputs the sum of its inputs plus an offset, slowly, and counts its output
+// calculations
+class SlowAdder : public LeafSystem<double> {
+ public:
+  SlowAdder(int num_inputs, double offset, bool throws = false)
+      : offset_(offset), throws_(throws) {
+    for (int i = 0; i < num_inputs; i++) {
+      this->DeclareVectorInputPort(BasicVector<double>(1));
+    }
+    this->DeclareVectorOutputPort(BasicVector<double>(1),
+                                  &SlowAdder::CalcSum);
+  }
+
+  int num_calcs() const { return num_calcs_; }
+
+ private:
+  void CalcSum(const Context<double>& context,
+               BasicVector<double>* output) const {
+    num_calcs_++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    if (throws_) {
+      throw std::runtime_error("SlowAdder failed");
+    }
+    double sum = offset_;
+    for (int i = 0; i < this->num_input_ports(); i++) {
+      sum += this->EvalVectorInput(context, i)->GetAtIndex(0);
+    }
+    output->SetAtIndex(0, sum);
+  }
+
+  const double offset_;
+  const bool throws_;
+  mutable std::atomic<int> num_calcs_{0};
+};
+
+// Counts its output calculations, with no input
+class Counter : public LeafSystem<double> {
+ public:
+  Counter() {
+    this->DeclareVectorOutputPort(BasicVector<double>(1), &Counter::CalcCount);
+  }
+
+  int num_calcs() const { return num_calcs_; }
+
+ private:
+  void CalcCount(const Context<double>&, BasicVector<double>* output) const {
+    output->SetAtIndex(0, ++num_calcs_);
+  }
+
+  mutable std::atomic<int> num_calcs_{0};
+};
+
+// source -> (left, right) -> sum
+class ParallelOutputEvaluatorTest : public ::testing::Test {
+ protected:
+  void Build(bool right_throws = false) {
+    DiagramBuilder<double> builder;
+    source_ = builder.AddSystem<SlowAdder>(0, 1);
+    left_ = builder.AddSystem<SlowAdder>(1, 10);
+    right_ = builder.AddSystem<SlowAdder>(1, 100, right_throws);
+    sum_ = builder.AddSystem<SlowAdder>(2, 0);
+    builder.Connect(source_->get_output_port(0), left_->get_input_port(0));
+    builder.Connect(source_->get_output_port(0), right_->get_input_port(0));
+    builder.Connect(left_->get_output_port(0), sum_->get_input_port(0));
+    builder.Connect(right_->get_output_port(0), sum_->get_input_port(1));
+    builder.ExportOutput(sum_->get_output_port(0));
+    diagram_ = builder.Build();
+    context_ = diagram_->CreateDefaultContext();
+  }
+
+  SlowAdder* source_;
+  SlowAdder* left_;
+  SlowAdder* right_;
+  SlowAdder* sum_;
+  std::unique_ptr<Diagram<double>> diagram_;
+  std::unique_ptr<Context<double>> context_;
+};
+
+TEST_F(ParallelOutputEvaluatorTest, Cached) {
+  for (int num_threads : {0, 1, 3}) {
+    Build();
+    ParallelOutputEvaluator evaluator(num_threads);
+    evaluator.AddStage({&source_->get_output_port(0)});
+    evaluator.AddStage(
+        {&left_->get_output_port(0), &right_->get_output_port(0)});
+    for (int k = 0; k < 3; k++) {
+      // Invalidates the cache, as the input messages of LcmDrivenLoop
+      context_->SetTime(k);
+      evaluator.Evaluate(*context_);
+      EXPECT_EQ(left_->num_calcs(), k + 1);
+      EXPECT_EQ(right_->num_calcs(), k + 1);
+      EXPECT_EQ(sum_->num_calcs(), k);
+      // The downstream system finds its inputs in the cache
+      EXPECT_EQ(diagram_->get_output_port(0).Eval(*context_)(0), 112);
+      EXPECT_EQ(source_->num_calcs(), k + 1);
+      EXPECT_EQ(left_->num_calcs(), k + 1);
+      EXPECT_EQ(right_->num_calcs(), k + 1);
+    }
+  }
+}
+
+// Many short stages, so that the workers are often late for a stage when the
+// next one starts
+TEST(ParallelOutputEvaluatorStressTest, ShortStages) {
+  const int kNumStages = 50;
+  const int kNumTicks = 200;
+  for (int num_threads : {1, 3, 7}) {
+    DiagramBuilder<double> builder;
+    std::vector<std::vector<Counter*>> counters(kNumStages);
+    for (int i = 0; i < kNumStages; i++) {
+      // One to four tasks per stage
+      for (int j = 0; j <= i % 4; j++) {
+        counters[i].push_back(builder.AddSystem<Counter>());
+      }
+    }
+    auto diagram = builder.Build();
+    auto context = diagram->CreateDefaultContext();
+
+    ParallelOutputEvaluator evaluator(num_threads);
+    for (const auto& stage : counters) {
+      std::vector<const drake::systems::OutputPort<double>*> ports;
+      for (const auto counter : stage) {
+        ports.push_back(&counter->get_output_port(0));
+      }
+      evaluator.AddStage(ports);
+    }
+    for (int k = 0; k < kNumTicks; k++) {
+      context->SetTime(k);
+      evaluator.Evaluate(*context);
+    }
+    // Every task of every stage ran once per tick
+    for (const auto& stage : counters) {
+      for (const auto counter : stage) {
+        EXPECT_EQ(counter->num_calcs(), kNumTicks);
+      }
+    }
+  }
+}
+
+TEST_F(ParallelOutputEvaluatorTest, Exception) {
+  Build(true);
+  ParallelOutputEvaluator evaluator(2);
+  evaluator.AddStage({&source_->get_output_port(0)});
+  evaluator.AddStage({&left_->get_output_port(0), &right_->get_output_port(0)});
+  EXPECT_THROW(evaluator.Evaluate(*context_), std::runtime_error);
+  // The pool is still usable
+  context_->SetTime(1);
+  EXPECT_THROW(evaluator.Evaluate(*context_), std::runtime_error);
+  EXPECT_EQ(left_->num_calcs(), 2);
+}
+
+TEST_F(ParallelOutputEvaluatorTest, Trace) {
+  Build();
+  ParallelOutputEvaluator evaluator(1);
+  evaluator.AddStage({&source_->get_output_port(0)});
+  evaluator.AddStage({&left_->get_output_port(0), &right_->get_output_port(0)});
+  evaluator.StartTrace(2);
+  for (int k = 0; k < 3; k++) {
+    context_->SetTime(k);
+    evaluator.Evaluate(*context_);
+    const auto start = ParallelOutputEvaluator::Clock::now();
+    diagram_->get_output_port(0).Eval(*context_);
+    evaluator.RecordSpan("sum", start);
+  }
+
+  const std::string summary = evaluator.CriticalPathSummary();
+  EXPECT_NE(summary.find("Mean over 2 ticks"), std::string::npos);
+  EXPECT_NE(summary.find("sum"), std::string::npos);
+
+  const std::string filename =
+      ::testing::TempDir() + "/parallel_output_evaluator_trace.json";
+  evaluator.WriteTrace(filename);
+  std::ifstream file(filename);
+  std::stringstream trace;
+  trace << file.rdbuf();
+  // Two ticks of three evaluations and the downstream span
+  int num_spans = 0;
+  for (size_t i = trace.str().find("\"ph\": \"X\""); i != std::string::npos;
+       i = trace.str().find("\"ph\": \"X\"", i + 1)) {
+    num_spans++;
+  }
+  EXPECT_EQ(num_spans, 8);
+  EXPECT_NE(trace.str().find("worker 1"), std::string::npos);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
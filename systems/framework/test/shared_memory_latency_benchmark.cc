@@ -0,0 +1,169 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "dairlib/lcmt_robot_output.hpp"
+#include "systems/framework/shared_memory_transport.h"
+
+#include "drake/lcm/drake_lcm.h"
+
+DEFINE_int32(num_reps, 10000, "Number of round trips per transport");
+DEFINE_int32(num_positions, 23, "Size of the message (Cassie's by default)");
+DEFINE_string(lcm_url, "udpm://239.255.76.67:7667?ttl=0",
+              "LCM url of the LCM round trips");
+
+namespace dairlib {
+namespace {
+
+typedef std::chrono::steady_clock my_clock;
+
+using systems::kSharedMemoryCapacity;
+using systems::SharedMemorySlot;
+
+lcmt_robot_output MakeMessage() {
+  lcmt_robot_output message;
+  message.num_positions = FLAGS_num_positions;
+  message.num_velocities = FLAGS_num_positions - 1;
+  message.num_efforts = 10;
+  for (int i = 0; i < message.num_positions; i++) {
+    message.position.push_back(i);
+    message.position_names.push_back("position_" + std::to_string(i));
+  }
+  for (int i = 0; i < message.num_velocities; i++) {
+    message.velocity.push_back(i);
+    message.velocity_names.push_back("velocity_" + std::to_string(i));
+  }
+  for (int i = 0; i < message.num_efforts; i++) {
+    message.effort.push_back(i);
+    message.effort_names.push_back("effort_" + std::to_string(i));
+  }
+  return message;
+}
+
+void PrintLatencies(const std::string& name, std::vector<double> latencies) {
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << name << " round trip: median "
+            << latencies[latencies.size() / 2] << " us, p99 "
+            << latencies[latencies.size() * 99 / 100] << " us, max "
+            << latencies.back() << " us" << std::endl;
+}
+
+// Sends the message to an echo thread, which sends it back after decoding and
+// encoding it, as the dispatcher and the controller do
+std::vector<double> SharedMemoryRoundTrips(lcmt_robot_output message,
+                                           bool spin) {
+  const std::string ping = "latency_benchmark_ping_" + std::to_string(getpid());
+  const std::string pong = "latency_benchmark_pong_" + std::to_string(getpid());
+  SharedMemorySlot ping_slot(ping, kSharedMemoryCapacity);
+  SharedMemorySlot pong_slot(pong, kSharedMemoryCapacity);
+  std::atomic<bool> keep_running(true);
+
+  std::thread echo([&]() {
+    std::vector<uint8_t> buffer(kSharedMemoryCapacity);
+    lcmt_robot_output echo_message;
+    uint64_t sequence = 0;
+    while (keep_running) {
+      if (!ping_slot.WaitForNewer(sequence, 0.01, spin)) continue;
+      const int size = ping_slot.Read(&sequence, buffer.data());
+      systems::UnpackMessage(buffer.data(), size, &echo_message);
+      pong_slot.Write(buffer.data(),
+                      systems::PackMessage(echo_message, buffer.data(),
+                                           buffer.size()));
+    }
+  });
+
+  std::vector<uint8_t> buffer(kSharedMemoryCapacity);
+  std::vector<double> latencies;
+  uint64_t sequence = 0;
+  for (int i = 0; i < FLAGS_num_reps; i++) {
+    message.utime = i;
+    const auto start = my_clock::now();
+    ping_slot.Write(buffer.data(), systems::PackMessage(message, buffer.data(),
+                                                        buffer.size()));
+    while (!pong_slot.WaitForNewer(sequence, 1, spin)) {
+    }
+    const int size = pong_slot.Read(&sequence, buffer.data());
+    systems::UnpackMessage(buffer.data(), size, &message);
+    std::chrono::duration<double, std::micro> latency =
+        my_clock::now() - start;
+    latencies.push_back(latency.count());
+  }
+  keep_running = false;
+  echo.join();
+  SharedMemorySlot::Unlink(ping);
+  SharedMemorySlot::Unlink(pong);
+  return latencies;
+}
+
+std::vector<double> LcmRoundTrips(lcmt_robot_output message) {
+  const std::string ping = "LATENCY_BENCHMARK_PING";
+  const std::string pong = "LATENCY_BENCHMARK_PONG";
+  drake::lcm::DrakeLcm lcm(FLAGS_lcm_url);
+  drake::lcm::Subscriber<lcmt_robot_output> pong_sub(&lcm, pong);
+  std::atomic<bool> keep_running(true);
+
+  std::thread echo([&]() {
+    drake::lcm::DrakeLcm echo_lcm(FLAGS_lcm_url);
+    drake::lcm::Subscriber<lcmt_robot_output> ping_sub(&echo_lcm, ping);
+    while (keep_running) {
+      echo_lcm.HandleSubscriptions(10);
+      if (ping_sub.count() > 0) {
+        drake::lcm::Publish(&echo_lcm, pong, ping_sub.message());
+        ping_sub.clear();
+      }
+    }
+  });
+  // Let the echo thread subscribe
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::vector<double> latencies;
+  for (int i = 0; i < FLAGS_num_reps; i++) {
+    message.utime = i;
+    const auto start = my_clock::now();
+    drake::lcm::Publish(&lcm, ping, message);
+    drake::lcm::LcmHandleSubscriptionsUntil(&lcm, [&]() {
+      return pong_sub.count() > 0 && pong_sub.message().utime == i;
+    });
+    std::chrono::duration<double, std::micro> latency =
+        my_clock::now() - start;
+    latencies.push_back(latency.count());
+    pong_sub.clear();
+  }
+  keep_running = false;
+  echo.join();
+  return latencies;
+}
+
+// Compares the round trip latency of a robot output message over LCM and over
+// shared memory (see SharedMemorySlot), both within the process. Pin the
+// process (e.g. taskset -c 2,3) for stable results.
+int do_main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  const lcmt_robot_output message = MakeMessage();
+  std::vector<uint8_t> buffer(kSharedMemoryCapacity);
+  std::cout << "message of " << message.num_positions << " positions, "
+            << systems::PackMessage(message, buffer.data(), buffer.size())
+            << " bytes packed, " << message.getEncodedSize()
+            << " bytes LCM encoded" << std::endl;
+
+  PrintLatencies("LCM (" + FLAGS_lcm_url + ")", LcmRoundTrips(message));
+  PrintLatencies("shared memory (futex)",
+                 SharedMemoryRoundTrips(message, false));
+  PrintLatencies("shared memory (spin)", SharedMemoryRoundTrips(message, true));
+
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::do_main(argc, argv); }
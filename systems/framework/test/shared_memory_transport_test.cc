@@ -0,0 +1,221 @@
+#include "systems/framework/shared_memory_transport.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "drake/lcm/drake_lcm.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+using std::string;
+using std::vector;
+
+lcmt_robot_output MakeRobotOutput(int64_t utime) {
+  lcmt_robot_output message;
+  message.utime = utime;
+  message.num_positions = 3;
+  message.num_velocities = 2;
+  message.num_efforts = 1;
+  message.position = {1, 2, 3};
+  message.position_names = {"base_x", "hip_roll_left", ""};
+  message.velocity = {4, 5};
+  message.velocity_names = {"base_vx", "hip_roll_leftdot"};
+  message.effort = {6};
+  message.effort_names = {"hip_roll_left_motor"};
+  message.imu_accel[0] = 7;
+  message.imu_accel[1] = 8;
+  message.imu_accel[2] = 9.81;
+  return message;
+}
+
+void ExpectEqual(const lcmt_robot_output& a, const lcmt_robot_output& b) {
+  EXPECT_EQ(a.utime, b.utime);
+  EXPECT_EQ(a.num_positions, b.num_positions);
+  EXPECT_EQ(a.num_velocities, b.num_velocities);
+  EXPECT_EQ(a.num_efforts, b.num_efforts);
+  EXPECT_EQ(a.position, b.position);
+  EXPECT_EQ(a.position_names, b.position_names);
+  EXPECT_EQ(a.velocity, b.velocity);
+  EXPECT_EQ(a.velocity_names, b.velocity_names);
+  EXPECT_EQ(a.effort, b.effort);
+  EXPECT_EQ(a.effort_names, b.effort_names);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(a.imu_accel[i], b.imu_accel[i]);
+  }
+}
+
+class SharedMemoryTransportTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    channel_ = "shared_memory_transport_test_" + std::to_string(getpid());
+    SharedMemorySlot::Unlink(channel_);
+  }
+
+  void TearDown() override { SharedMemorySlot::Unlink(channel_); }
+
+  string channel_;
+};
+
+TEST_F(SharedMemoryTransportTest, SlotTest) {
+  SharedMemorySlot writer(channel_, 16);
+  SharedMemorySlot reader(channel_, 16);
+  vector<uint8_t> data(16);
+  uint64_t sequence = 0;
+  EXPECT_EQ(reader.Read(&sequence, data.data()), -1);
+  EXPECT_FALSE(reader.WaitForNewer(sequence, 0.001));
+
+  writer.Write("abc", 4);
+  EXPECT_TRUE(reader.WaitForNewer(sequence, 0.001));
+  EXPECT_EQ(reader.Read(&sequence, data.data()), 4);
+  EXPECT_EQ(string(reinterpret_cast<char*>(data.data())), "abc");
+  EXPECT_EQ(sequence, 2u);
+  EXPECT_EQ(reader.Read(&sequence, data.data()), -1);
+
+  // Only the latest value is kept
+  writer.Write("de", 3);
+  writer.Write("f", 2);
+  EXPECT_EQ(reader.Read(&sequence, data.data()), 2);
+  EXPECT_EQ(string(reinterpret_cast<char*>(data.data())), "f");
+  EXPECT_EQ(sequence, reader.sequence());
+
+  EXPECT_THROW(SharedMemorySlot(channel_, 32), std::runtime_error);
+}
+
+// A writer killed in the middle of a write
+TEST_F(SharedMemoryTransportTest, DeadWriterTest) {
+  vector<uint8_t> data(8);
+  uint64_t sequence = 0;
+  SharedMemorySlot reader(channel_, 8);
+  {
+    SharedMemorySlot writer(channel_, 8);
+    writer.Write("a", 2);
+    EXPECT_EQ(reader.Read(&sequence, data.data()), 2);
+
+    // Leaves the sequence, after the magic number and the capacity in the
+    // header, odd
+    const int fd =
+        shm_open(("/dairlib_" + channel_).c_str(), O_RDWR, 0666);
+    ASSERT_GE(fd, 0);
+    void* region =
+        mmap(nullptr, 64, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    ASSERT_NE(region, MAP_FAILED);
+    auto* shared_sequence = reinterpret_cast<std::atomic<uint64_t>*>(
+        static_cast<uint8_t*>(region) + 16);
+    shared_sequence->fetch_add(1);
+    munmap(region, 64);
+  }
+  EXPECT_EQ(reader.Read(&sequence, data.data()), -1);
+  EXPECT_EQ(sequence, 2u);
+
+  SharedMemorySlot writer(channel_, 8);
+  writer.Write("b", 2);
+  EXPECT_EQ(reader.Read(&sequence, data.data()), 2);
+  EXPECT_EQ(string(reinterpret_cast<char*>(data.data())), "b");
+  EXPECT_EQ(sequence, 4u);
+}
+
+TEST_F(SharedMemoryTransportTest, WaitTest) {
+  SharedMemorySlot writer(channel_, 8);
+  SharedMemorySlot reader(channel_, 8);
+  std::thread thread([&writer]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    writer.Write("a", 2);
+  });
+  EXPECT_TRUE(reader.WaitForNewer(0, 1));
+  thread.join();
+}
+
+TEST_F(SharedMemoryTransportTest, PackTest) {
+  vector<uint8_t> buffer(kSharedMemoryCapacity);
+  const lcmt_robot_output output = MakeRobotOutput(1234);
+  const int size = PackMessage(output, buffer.data(), buffer.size());
+  ASSERT_GT(size, 0);
+
+  lcmt_robot_output unpacked;
+  ASSERT_TRUE(UnpackMessage(buffer.data(), size, &unpacked));
+  ExpectEqual(unpacked, output);
+  EXPECT_FALSE(UnpackMessage(buffer.data(), size - 1, &unpacked));
+  EXPECT_EQ(PackMessage(output, buffer.data(), size - 1), -1);
+
+  lcmt_robot_input input;
+  input.utime = 5678;
+  input.num_efforts = 2;
+  input.efforts = {1, -1};
+  input.effort_names = {"hip_roll_left_motor", "hip_roll_right_motor"};
+  const int input_size = PackMessage(input, buffer.data(), buffer.size());
+  lcmt_robot_input unpacked_input;
+  ASSERT_TRUE(UnpackMessage(buffer.data(), input_size, &unpacked_input));
+  EXPECT_EQ(unpacked_input.utime, input.utime);
+  EXPECT_EQ(unpacked_input.num_efforts, input.num_efforts);
+  EXPECT_EQ(unpacked_input.efforts, input.efforts);
+  EXPECT_EQ(unpacked_input.effort_names, input.effort_names);
+}
+
+TEST_F(SharedMemoryTransportTest, PublishTest) {
+  drake::lcm::DrakeLcm lcm("memq://");
+  drake::lcm::Subscriber<lcmt_robot_output> mirror(&lcm, channel_);
+
+  SharedMemoryPublisherSystem<lcmt_robot_output> publisher(channel_, &lcm);
+  SharedMemorySubscriber<lcmt_robot_output> subscriber(channel_);
+  EXPECT_FALSE(subscriber.Poll());
+
+  auto context = publisher.CreateDefaultContext();
+  const lcmt_robot_output message = MakeRobotOutput(1000);
+  publisher.get_input_port().FixValue(context.get(), message);
+  publisher.Publish(*context);
+
+  EXPECT_TRUE(subscriber.WaitForMessage(1));
+  EXPECT_EQ(subscriber.count(), 1);
+  ExpectEqual(subscriber.message(), message);
+  subscriber.clear();
+  EXPECT_FALSE(subscriber.Poll());
+  EXPECT_EQ(subscriber.count(), 0);
+
+  // The mirror thread publishes on LCM
+  drake::lcm::LcmHandleSubscriptionsUntil(
+      &lcm, [&]() { return mirror.count() > 0; }, 10);
+  ExpectEqual(mirror.message(), message);
+}
+
+TEST_F(SharedMemoryTransportTest, StaleMessageTest) {
+  drake::lcm::DrakeLcm lcm("memq://");
+  {
+    // A publisher that stops, leaving its last message in the slot
+    SharedMemoryPublisherSystem<lcmt_robot_output> publisher(channel_, &lcm);
+    auto publisher_context = publisher.CreateDefaultContext();
+    publisher.get_input_port().FixValue(publisher_context.get(),
+                                        MakeRobotOutput(1000));
+    publisher.Publish(*publisher_context);
+  }
+
+  // A subscriber started afterwards doesn't receive it
+  SharedMemorySubscriber<lcmt_robot_output> subscriber(channel_);
+  EXPECT_FALSE(subscriber.Poll());
+  EXPECT_FALSE(subscriber.WaitForMessage(0.001));
+
+  // but receives the messages of the next publisher
+  SharedMemoryPublisherSystem<lcmt_robot_output> publisher(channel_, &lcm);
+  auto publisher_context = publisher.CreateDefaultContext();
+  const lcmt_robot_output message = MakeRobotOutput(2000);
+  publisher.get_input_port().FixValue(publisher_context.get(), message);
+  publisher.Publish(*publisher_context);
+  EXPECT_TRUE(subscriber.Poll());
+  ExpectEqual(subscriber.message(), message);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
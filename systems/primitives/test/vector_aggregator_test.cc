@@ -0,0 +1,82 @@
+#include "systems/primitives/vector_aggregator.h"
+
+#include <cstdio>
+#include <memory>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "drake/systems/framework/fixed_input_port_value.h"
+
+using drake::systems::Context;
+using Eigen::MatrixXd;
+using Eigen::Vector2d;
+using Eigen::VectorXd;
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+class VectorAggregatorTest : public ::testing::Test {
+ protected:
+  void Receive(VectorAggregator* aggregator, Context<double>* context,
+               double timestamp) {
+    auto input = std::make_unique<TimestampedVector<double>>(
+        Vector2d(timestamp, -timestamp));
+    input->set_timestamp(timestamp);
+    context->FixInputPort(0, std::move(input));
+    aggregator->Publish(*context);
+  }
+
+  void ReceiveAll(VectorAggregator* aggregator) {
+    auto context = aggregator->CreateDefaultContext();
+    // The repeated timestamp is rejected
+    for (double timestamp : {1.0, 2.0, 2.0, 3.0, 4.0, 5.0}) {
+      Receive(aggregator, context.get(), timestamp);
+    }
+  }
+};
+
+TEST_F(VectorAggregatorTest, Grow) {
+  VectorAggregator aggregator(2, 2);
+  ReceiveAll(&aggregator);
+  VectorXd expected_timestamps(5);
+  expected_timestamps << 1, 2, 3, 4, 5;
+  EXPECT_EQ(aggregator.BuildTimestampVector(), expected_timestamps);
+  EXPECT_EQ(aggregator.BuildMatrixFromVectors().row(1),
+            -expected_timestamps.transpose());
+  EXPECT_EQ(aggregator.get_received_vectors().size(), 5);
+}
+
+TEST_F(VectorAggregatorTest, RingBuffer) {
+  VectorAggregator aggregator(2, 3, AggregatorOverflowPolicy::kRingBuffer);
+  ReceiveAll(&aggregator);
+  EXPECT_EQ(aggregator.num_stored(), 3);
+  EXPECT_EQ(aggregator.num_evicted(), 2);
+  // The view is oldest first, even though the buffer wrapped around
+  auto view = aggregator.get_data_view();
+  MatrixXd expected_data(2, 3);
+  expected_data << 3, 4, 5, -3, -4, -5;
+  EXPECT_EQ(MatrixXd(view), expected_data);
+  EXPECT_EQ(aggregator.get_timestamp_view()(0), 3);
+}
+
+TEST_F(VectorAggregatorTest, SpillToDiskWithDecimation) {
+  const char filepath[] = "vector_aggregator_test_spill";
+  VectorAggregator aggregator(2, 1, AggregatorOverflowPolicy::kSpillToDisk, 2,
+                              filepath);
+  ReceiveAll(&aggregator);
+  // Every other new sample is kept, one in memory and the rest on disk
+  EXPECT_EQ(aggregator.num_stored(), 1);
+  EXPECT_EQ(aggregator.num_evicted(), 2);
+  VectorXd expected_timestamps(3);
+  expected_timestamps << 1, 3, 5;
+  EXPECT_EQ(aggregator.BuildTimestampVector(), expected_timestamps);
+  EXPECT_EQ(aggregator.BuildMatrixFromVectors().row(0),
+            expected_timestamps.transpose());
+  std::remove(filepath);
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,192 @@
+#include "systems/primitives/vector_aggregator.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace dairlib {
+namespace systems {
+
+using drake::systems::Context;
+using drake::systems::PublishEvent;
+using Eigen::Map;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using std::string;
+using std::vector;
+
+VectorAggregator::VectorAggregator(int vector_length, int capacity,
+                                   AggregatorOverflowPolicy overflow_policy,
+                                   int decimation, const string& spill_filepath)
+    : vector_length_(vector_length),
+      overflow_policy_(overflow_policy),
+      decimation_(decimation),
+      spill_filepath_(spill_filepath),
+      data_(vector_length, capacity),
+      timestamps_(capacity) {
+  DRAKE_DEMAND(capacity > 0);
+  DRAKE_DEMAND(decimation > 0);
+  DeclareVectorInputPort(TimestampedVector<double>(vector_length));
+  DeclarePerStepEvent<PublishEvent<double>>(PublishEvent<double>(
+      drake::systems::Event<double>::TriggerType::kPerStep));
+
+  if (overflow_policy_ == AggregatorOverflowPolicy::kSpillToDisk) {
+    DRAKE_DEMAND(!spill_filepath_.empty());
+    std::ofstream fout(spill_filepath_,
+                       std::ios_base::binary | std::ios_base::trunc);
+    if (!fout) {
+      throw std::runtime_error("Could not open file: " + spill_filepath_);
+    }
+  }
+}
+
+void VectorAggregator::DoPublish(
+    const Context<double>& context,
+    const vector<const PublishEvent<double>*>& events) const {
+  const TimestampedVector<double>* input =
+      dynamic_cast<const TimestampedVector<double>*>(
+          EvalVectorInput(context, 0));
+
+  bool is_new_input = false;
+  if (!has_received_ && input->get_timestamp() != 0) is_new_input = true;
+  if (has_received_ && (input->get_timestamp() != last_timestamp_)) {
+    is_new_input = true;
+  }
+
+  if (is_new_input) {
+    if (num_new_inputs_++ % decimation_ == 0) {
+      Store(input->get_timestamp(),
+            input->get_value().head(vector_length_));
+    }
+    has_received_ = true;
+    last_timestamp_ = input->get_timestamp();
+  }
+}
+
+void VectorAggregator::Store(double timestamp,
+                             const Eigen::Ref<const VectorXd>& vector) const {
+  int capacity = data_.cols();
+  if (num_stored_ == capacity) {
+    switch (overflow_policy_) {
+      case AggregatorOverflowPolicy::kGrow:
+        Linearize();
+        data_.conservativeResize(Eigen::NoChange, 2 * capacity);
+        timestamps_.conservativeResize(2 * capacity);
+        capacity *= 2;
+        break;
+      case AggregatorOverflowPolicy::kRingBuffer:
+        // Overwrite the oldest sample
+        data_.col(head_) = vector;
+        timestamps_(head_) = timestamp;
+        head_ = (head_ + 1) % capacity;
+        num_evicted_++;
+        return;
+      case AggregatorOverflowPolicy::kSpillToDisk:
+        Spill();
+        break;
+    }
+  }
+  int index = (head_ + num_stored_) % capacity;
+  data_.col(index) = vector;
+  timestamps_(index) = timestamp;
+  num_stored_++;
+}
+
+void VectorAggregator::Spill() const {
+  std::ofstream fout(spill_filepath_,
+                     std::ios_base::binary | std::ios_base::app);
+  if (!fout) {
+    throw std::runtime_error("Could not open file: " + spill_filepath_);
+  }
+  for (int i = 0; i < num_stored_; ++i) {
+    fout.write(reinterpret_cast<const char*>(&timestamps_(i)), sizeof(double));
+    fout.write(reinterpret_cast<const char*>(data_.col(i).data()),
+               sizeof(double) * vector_length_);
+  }
+  num_evicted_ += num_stored_;
+  num_stored_ = 0;
+}
+
+void VectorAggregator::Linearize() const {
+  if (head_ == 0) return;
+  std::rotate(data_.data(), data_.data() + head_ * vector_length_,
+              data_.data() + data_.size());
+  std::rotate(timestamps_.data(), timestamps_.data() + head_,
+              timestamps_.data() + timestamps_.size());
+  head_ = 0;
+}
+
+Map<const MatrixXd> VectorAggregator::get_data_view() const {
+  Linearize();
+  return Map<const MatrixXd>(data_.data(), vector_length_, num_stored_);
+}
+
+Map<const VectorXd> VectorAggregator::get_timestamp_view() const {
+  Linearize();
+  return Map<const VectorXd>(timestamps_.data(), num_stored_);
+}
+
+vector<VectorXd> VectorAggregator::get_received_vectors() const {
+  MatrixXd data = BuildMatrixFromVectors();
+  vector<VectorXd> received_vectors;
+  received_vectors.reserve(data.cols());
+  for (int i = 0; i < data.cols(); i++) {
+    received_vectors.push_back(data.col(i));
+  }
+  return received_vectors;
+}
+
+const vector<double> VectorAggregator::get_received_timestamps() const {
+  VectorXd timestamps = BuildTimestampVector();
+  return vector<double>(timestamps.data(),
+                        timestamps.data() + timestamps.size());
+}
+
+VectorXd VectorAggregator::BuildTimestampVector() const {
+  if (overflow_policy_ != AggregatorOverflowPolicy::kSpillToDisk ||
+      num_evicted_ == 0) {
+    return get_timestamp_view();
+  }
+  VectorXd spilled_timestamps;
+  MatrixXd spilled_data;
+  LoadSpillFile(spill_filepath_, vector_length_, &spilled_timestamps,
+                &spilled_data);
+  VectorXd timestamps(spilled_timestamps.size() + num_stored_);
+  timestamps << spilled_timestamps, get_timestamp_view();
+  return timestamps;
+}
+
+MatrixXd VectorAggregator::BuildMatrixFromVectors() const {
+  if (overflow_policy_ != AggregatorOverflowPolicy::kSpillToDisk ||
+      num_evicted_ == 0) {
+    return get_data_view();
+  }
+  VectorXd spilled_timestamps;
+  MatrixXd spilled_data;
+  LoadSpillFile(spill_filepath_, vector_length_, &spilled_timestamps,
+                &spilled_data);
+  MatrixXd data(vector_length_, spilled_data.cols() + num_stored_);
+  data << spilled_data, get_data_view();
+  return data;
+}
+
+void VectorAggregator::LoadSpillFile(const string& filepath,
+                                     int vector_length, VectorXd* timestamps,
+                                     MatrixXd* data) {
+  std::ifstream fin(filepath, std::ios_base::binary | std::ios_base::ate);
+  if (!fin) {
+    throw std::runtime_error("Could not open file: " + filepath);
+  }
+  const int64_t sample_size = sizeof(double) * (vector_length + 1);
+  const int64_t num_samples = fin.tellg() / sample_size;
+  fin.seekg(0);
+
+  // Each sample is stored as the timestamp followed by the vector
+  MatrixXd samples(vector_length + 1, num_samples);
+  fin.read(reinterpret_cast<char*>(samples.data()),
+           num_samples * sample_size);
+  *timestamps = samples.row(0).transpose();
+  *data = samples.bottomRows(vector_length);
+}
+
+}  // namespace systems
+}  // namespace dairlib
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "drake/systems/analysis/simulator.h"
 #include "drake/systems/framework/diagram_builder.h"
@@ -10,81 +11,95 @@
 namespace dairlib {
 namespace systems {
 
+/// What VectorAggregator does once its preallocated storage is full
+///  - kGrow: double the capacity (amortized, one allocation per doubling)
+///  - kRingBuffer: overwrite the oldest samples, keeping memory bounded
+///  - kSpillToDisk: append the full block to spill_filepath and start over,
+///    keeping memory bounded while still retaining every sample
+enum class AggregatorOverflowPolicy { kGrow, kRingBuffer, kSpillToDisk };
+
 /// VectorAggregator collects a list of TimeStampedVector objects
 /// Assumes that the vectors come in order, and adds them to a std::vector
 /// Uses the timestamp field to determine uniqueness--this will reject
 /// any timestamp that exactly matches the previous timestamp. However,
 /// this class does NOT check for ordering of timestmaps.
+///
+/// Samples are written into a preallocated, contiguous column-major block
+/// (one column per sample), so no allocation happens per sample. The capacity
+/// and the behavior once the block is full are set by the constructor, and
+/// optionally only every decimation-th new sample is kept.
 class VectorAggregator : public drake::systems::LeafSystem<double> {
  public:
   DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(VectorAggregator)
 
   /// @param vector_length is the length of the input TimestampedVector
-  VectorAggregator(int vector_length) {
-    DeclareVectorInputPort(
-      TimestampedVector<double>(vector_length));
-    DeclarePerStepEvent<drake::systems::PublishEvent<double>>(
-        drake::systems::PublishEvent<double>(
-            drake::systems::Event<double>::TriggerType::kPerStep));
-    vector_length_ = vector_length;
-  }
+  /// @param capacity is the number of samples to preallocate storage for
+  /// @param overflow_policy is the behavior once capacity samples are stored
+  /// @param decimation keeps only every decimation-th new sample
+  /// @param spill_filepath is the file used by kSpillToDisk. Any existing
+  /// file is truncated.
+  explicit VectorAggregator(
+      int vector_length, int capacity = 1000,
+      AggregatorOverflowPolicy overflow_policy =
+          AggregatorOverflowPolicy::kGrow,
+      int decimation = 1, const std::string& spill_filepath = "");
 
   /// Return the list of received vectors in raw form
-  const std::vector<Eigen::VectorXd>& get_received_vectors() const {
-    return received_vectors_;
-  }
+  std::vector<Eigen::VectorXd> get_received_vectors() const;
 
   /// Return the list of received timestamps in raw form
-  const std::vector<double> get_received_timestamps() const {
-    return std::vector<double>(received_timestamp_.begin(),
-                               received_timestamp_.end());
-  }
+  const std::vector<double> get_received_timestamps() const;
 
   /// Build an Eigen vector out of the timestamps
-  Eigen::VectorXd BuildTimestampVector() const {
-    Eigen::VectorXd timestamp;
-    timestamp = Eigen::Map<Eigen::VectorXd>(received_timestamp_.data(),
-                                            received_timestamp_.size());
-
-    return timestamp;
-  }
+  Eigen::VectorXd BuildTimestampVector() const;
 
   /// Build an Eigen Matrix out of the received vectors
   /// The ith column of the matrix is the ith received vectors
-  Eigen::MatrixXd BuildMatrixFromVectors() const {
-    Eigen::MatrixXd data(vector_length_, received_vectors_.size());
-    for (uint i = 0; i < received_vectors_.size(); i++) {
-      data.col(i) = received_vectors_[i];
-    }
+  /// With kSpillToDisk, this includes the samples spilled to disk.
+  Eigen::MatrixXd BuildMatrixFromVectors() const;
+
+  /// Returns a view of the samples currently held in memory, oldest first,
+  /// without copying. With kRingBuffer, a wrapped buffer is first rotated in
+  /// place. The view is invalidated by the next received sample.
+  Eigen::Map<const Eigen::MatrixXd> get_data_view() const;
+
+  /// Timestamps matching the columns of get_data_view()
+  Eigen::Map<const Eigen::VectorXd> get_timestamp_view() const;
 
-    return data;
-  }
+  /// Number of samples currently held in memory
+  int num_stored() const { return num_stored_; }
+
+  /// Number of samples dropped by kRingBuffer or written out by kSpillToDisk
+  int64_t num_evicted() const { return num_evicted_; }
+
+  /// Reads a file written by kSpillToDisk
+  static void LoadSpillFile(const std::string& filepath, int vector_length,
+                            Eigen::VectorXd* timestamps, Eigen::MatrixXd* data);
 
  private:
   void DoPublish(const drake::systems::Context<double>& context,
                  const std::vector<const drake::systems::PublishEvent<double>*>&
-                     events) const override {
-    const TimestampedVector<double>* input =
-      dynamic_cast<const TimestampedVector<double>*>(
-        EvalVectorInput(context, 0));
-
-    bool is_new_input = false;
-    if (received_vectors_.empty() && input->get_timestamp() != 0)
-      is_new_input = true;
-    if (!received_vectors_.empty() &&
-        (input->get_timestamp() != received_timestamp_.back())) {
-      is_new_input = true;
-    }
-
-    if (is_new_input) {
-      received_vectors_.push_back(input->CopyVectorNoTimestamp());
-      received_timestamp_.push_back(input->get_timestamp());
-    }
-  }
+                     events) const override;
+
+  void Store(double timestamp,
+             const Eigen::Ref<const Eigen::VectorXd>& vector) const;
+  void Spill() const;
+  // Rotates a wrapped ring buffer so the oldest sample is in column 0
+  void Linearize() const;
 
   int vector_length_;
-  mutable std::vector<Eigen::VectorXd> received_vectors_;
-  mutable std::vector<double> received_timestamp_;
+  AggregatorOverflowPolicy overflow_policy_;
+  int decimation_;
+  std::string spill_filepath_;
+
+  mutable Eigen::MatrixXd data_;
+  mutable Eigen::VectorXd timestamps_;
+  mutable int head_ = 0;
+  mutable int num_stored_ = 0;
+  mutable int64_t num_evicted_ = 0;
+  mutable int64_t num_new_inputs_ = 0;
+  mutable bool has_received_ = false;
+  mutable double last_timestamp_ = 0;
 };
 
 }  // namespace systems
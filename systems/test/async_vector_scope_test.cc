@@ -0,0 +1,152 @@
+#include "systems/async_vector_scope.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dairlib/lcmt_scope_batch.hpp"
+#include "drake/lcm/drake_lcm.h"
+#include "drake/systems/analysis/simulator.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+using drake::systems::Context;
+using drake::systems::Simulator;
+using Eigen::Vector2d;
+using Eigen::VectorXd;
+using std::string;
+using std::vector;
+
+TEST(SampleQueueTest, Overflow) {
+  SampleQueue queue(3, 2);
+  int64_t utime;
+  Vector2d sample;
+  EXPECT_FALSE(queue.Pop(&utime, sample.data()));
+
+  EXPECT_TRUE(queue.Push(0, Vector2d(0, 1)));
+  EXPECT_TRUE(queue.Push(1, Vector2d(2, 3)));
+  EXPECT_TRUE(queue.Push(2, Vector2d(4, 5)));
+  // Full, the sample is dropped
+  EXPECT_FALSE(queue.Push(3, Vector2d(6, 7)));
+
+  ASSERT_TRUE(queue.Pop(&utime, sample.data()));
+  EXPECT_EQ(utime, 0);
+  EXPECT_EQ(sample, Vector2d(0, 1));
+  // Wraps around once there is room
+  EXPECT_TRUE(queue.Push(4, Vector2d(8, 9)));
+  EXPECT_FALSE(queue.Push(5, Vector2d(10, 11)));
+
+  for (int expected : {1, 2, 4}) {
+    ASSERT_TRUE(queue.Pop(&utime, sample.data()));
+    EXPECT_EQ(utime, expected);
+    EXPECT_EQ(sample, Vector2d(2 * expected, 2 * expected + 1));
+  }
+  EXPECT_FALSE(queue.Pop(&utime, sample.data()));
+}
+
+// Collects the batches published on SCOPE_<name>
+class ScopeBatchCollector {
+ public:
+  ScopeBatchCollector(drake::lcm::DrakeLcm* lcm, const string& name)
+      : subscription_(lcm->Subscribe(
+            "SCOPE_" + name, [this](const void* buffer, int size) {
+              batches_.emplace_back();
+              batches_.back().decode(buffer, 0, size);
+            })) {}
+
+  const vector<lcmt_scope_batch>& batches() const { return batches_; }
+
+  vector<int64_t> utimes() const {
+    vector<int64_t> utimes;
+    for (const auto& batch : batches_) {
+      utimes.insert(utimes.end(), batch.sample_utime.begin(),
+                    batch.sample_utime.end());
+    }
+    return utimes;
+  }
+
+ private:
+  vector<lcmt_scope_batch> batches_;
+  std::shared_ptr<drake::lcm::DrakeSubscriptionInterface> subscription_;
+};
+
+std::unique_ptr<Context<double>> MakeContext(const AsyncVectorScope& scope) {
+  auto context = scope.CreateDefaultContext();
+  scope.get_input_port(0).FixValue(context.get(), Vector2d(1, 2));
+  scope.get_input_port(1).FixValue(context.get(), VectorXd::Constant(1, 3));
+  return context;
+}
+
+TEST(AsyncVectorScopeTest, Decimation) {
+  drake::lcm::DrakeLcm lcm("memq://");
+  ScopeBatchCollector a_batches(&lcm, "a");
+  ScopeBatchCollector b_batches(&lcm, "b");
+  AsyncVectorScope scope({{"a", 2, 1, {"x", "y"}}, {"b", 1, 3}}, 0.01, &lcm);
+
+  // Sample events at 0, 0.01, ..., 0.09
+  Simulator<double> simulator(scope, MakeContext(scope));
+  simulator.AdvanceTo(0.095);
+  // The decimation restarts with a new context
+  Simulator<double> restarted(scope, MakeContext(scope));
+  restarted.AdvanceTo(0.015);
+  scope.Stop();
+  while (lcm.HandleSubscriptions(0) > 0) {
+  }
+
+  vector<int64_t> expected_a;
+  for (int k = 0; k < 10; k++) {
+    expected_a.push_back(10000 * k);
+  }
+  expected_a.push_back(0);
+  expected_a.push_back(10000);
+  EXPECT_EQ(a_batches.utimes(), expected_a);
+  EXPECT_EQ(b_batches.utimes(),
+            vector<int64_t>({0, 30000, 60000, 90000, 0}));
+
+  ASSERT_FALSE(a_batches.batches().empty());
+  for (const auto& batch : a_batches.batches()) {
+    EXPECT_EQ(batch.name, "a");
+    EXPECT_EQ(batch.vector_length, 2);
+    EXPECT_EQ(batch.num_samples, static_cast<int>(batch.samples.size()));
+    EXPECT_EQ(batch.element_names, vector<string>({"x", "y"}));
+    EXPECT_EQ(batch.latest, vector<double>({1, 2}));
+    for (const auto& sample : batch.samples) {
+      EXPECT_EQ(sample, vector<double>({1, 2}));
+    }
+    EXPECT_EQ(batch.dropped_samples, 0);
+  }
+  EXPECT_EQ(b_batches.batches().back().latest, vector<double>({3}));
+  EXPECT_EQ(scope.get_num_dropped(0), 0);
+  EXPECT_EQ(scope.get_num_dropped(1), 0);
+}
+
+TEST(AsyncVectorScopeTest, Drop) {
+  drake::lcm::DrakeLcm lcm("memq://");
+  ScopeBatchCollector a_batches(&lcm, "a");
+  // The queues hold two samples and are only drained after a second, so the
+  // last three of the five sample events are dropped
+  AsyncVectorScope scope({{"a", 2}, {"b", 1}}, 0.01, &lcm, "", 2, 1.0);
+  Simulator<double> simulator(scope, MakeContext(scope));
+  simulator.AdvanceTo(0.045);
+  EXPECT_EQ(scope.get_num_dropped(0), 3);
+  EXPECT_EQ(scope.get_num_dropped(1), 3);
+  scope.Stop();
+  while (lcm.HandleSubscriptions(0) > 0) {
+  }
+
+  ASSERT_EQ(a_batches.batches().size(), 1u);
+  const lcmt_scope_batch& batch = a_batches.batches().front();
+  EXPECT_EQ(batch.sample_utime, vector<int64_t>({0, 10000}));
+  EXPECT_EQ(batch.utime, 10000);
+  EXPECT_EQ(batch.dropped_samples, 3);
+  // Unnamed elements
+  EXPECT_EQ(batch.element_names, vector<string>(2));
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
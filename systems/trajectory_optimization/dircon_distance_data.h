@@ -20,6 +20,10 @@ class DirconDistanceData : public DirconKinematicData<T> {
       const double distance);
   ~DirconDistanceData();
 
+  std::unique_ptr<DirconKinematicData<T>> Clone() const override {
+    return std::make_unique<DirconDistanceData<T>>(*this);
+  }
+
   // The workhorse function, updates and caches everything needed by the
   // outside world
   void updateConstraint(const drake::systems::Context<T>& context);
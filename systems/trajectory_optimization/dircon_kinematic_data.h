@@ -13,7 +13,11 @@ class DirconKinematicData {
  public:
     DirconKinematicData(const drake::multibody::MultibodyPlant<T>& plant,
                         int length);
-    ~DirconKinematicData();
+    virtual ~DirconKinematicData();
+
+    // Copy of the constraint, with its own cached values, e.g. for another
+    // thread to evaluate
+    virtual std::unique_ptr<DirconKinematicData<T>> Clone() const = 0;
 
     // The workhorse function, updates and caches everything needed by the
     // outside world
@@ -23,6 +23,7 @@ DirconKinematicDataSet<T>::DirconKinematicDataSet(
     vector<int> skip_constraint_inds) :
     plant_(plant),
     constraints_(constraints),
+    skip_constraint_inds_(skip_constraint_inds),
     num_positions_(plant.num_positions()),
     num_velocities_(plant.num_velocities()),
     cache_(500) {
@@ -61,6 +62,21 @@ DirconKinematicDataSet<T>::DirconKinematicDataSet(
   right_hand_side_ = VectorX<T>(num_velocities_);
 }
 
+template <typename T>
+std::unique_ptr<DirconKinematicDataSet<T>> DirconKinematicDataSet<T>::Clone()
+    const {
+  auto constraints = std::make_unique<vector<DirconKinematicData<T>*>>();
+  vector<std::unique_ptr<DirconKinematicData<T>>> owned_constraints;
+  for (const auto* constraint : *constraints_) {
+    owned_constraints.push_back(constraint->Clone());
+    constraints->push_back(owned_constraints.back().get());
+  }
+  auto clone = std::make_unique<DirconKinematicDataSet<T>>(
+      plant_, constraints.get(), skip_constraint_inds_);
+  clone->owned_constraint_list_ = std::move(constraints);
+  clone->owned_constraints_ = std::move(owned_constraints);
+  return clone;
+}
 
 template <typename T>
 void DirconKinematicDataSet<T>::updateData(const Context<T>& context,
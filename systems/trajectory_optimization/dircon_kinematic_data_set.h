@@ -16,6 +16,11 @@ class DirconKinematicDataSet {
       std::vector<DirconKinematicData<T>*>* constraints,
       std::vector<int> skip_constraint_inds = std::vector<int>());
 
+  // Copy of the set which owns copies of the constraints, so that it can be
+  // updated concurrently with this set (e.g. by another thread). The cache
+  // starts empty.
+  std::unique_ptr<DirconKinematicDataSet<T>> Clone() const;
+
   void updateData(const drake::systems::Context<T>& context,
                   const drake::VectorX<T>& forces);
 
@@ -143,6 +148,10 @@ class DirconKinematicDataSet {
 
   const drake::multibody::MultibodyPlant<T>& plant_;
   std::vector<DirconKinematicData<T>*>* constraints_;
+  std::vector<int> skip_constraint_inds_;
+  // Only set for a clone, which owns its constraints
+  std::unique_ptr<std::vector<DirconKinematicData<T>*>> owned_constraint_list_;
+  std::vector<std::unique_ptr<DirconKinematicData<T>>> owned_constraints_;
   int num_positions_;
   int num_velocities_;
   int constraint_count_;
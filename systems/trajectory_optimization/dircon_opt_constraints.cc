@@ -5,6 +5,7 @@
 
 #include "common/file_utils.h"
 #include "multibody/multibody_utils.h"
+#include "multibody/quaternion_integration.h"
 
 #include "drake/math/autodiff.h"
 #include "drake/math/autodiff_gradient.h"
@@ -16,6 +17,7 @@ namespace trajectory_optimization {
 using drake::AutoDiffVecXd;
 using drake::AutoDiffXd;
 using drake::MatrixX;
+using drake::Vector3;
 using drake::VectorX;
 using drake::math::autoDiffToGradientMatrix;
 using drake::math::autoDiffToValueMatrix;
@@ -47,11 +49,12 @@ void QuaternionNormConstraint<T>::EvaluateConstraint(
 template <typename T>
 DirconDynamicConstraint<T>::DirconDynamicConstraint(
     const MultibodyPlant<T>& plant, DirconKinematicDataSet<T>& constraints,
-    bool is_quaternion)
-    : DirconDynamicConstraint(plant, constraints, plant.num_positions(),
-                              plant.num_velocities(), plant.num_actuators(),
-                              constraints.countConstraintsWithoutSkipping(),
-                              (is_quaternion) ? 1 : 0) {
+    bool is_quaternion, bool quaternion_exp_map)
+    : DirconDynamicConstraint(
+          plant, constraints, plant.num_positions(), plant.num_velocities(),
+          plant.num_actuators(), constraints.countConstraintsWithoutSkipping(),
+          (is_quaternion && !quaternion_exp_map) ? 1 : 0,
+          is_quaternion && quaternion_exp_map) {
   // If the MBP is in quaternion floating-base, demand that the quaternion
   // is located at the first four element of the generalized position
   if (is_quaternion) {
@@ -61,13 +64,23 @@ DirconDynamicConstraint<T>::DirconDynamicConstraint(
     DRAKE_DEMAND(positions_map.at("base_qy") == 2);
     DRAKE_DEMAND(positions_map.at("base_qz") == 3);
   }
+  // and, for the exponential map, that the angular velocity of the base is
+  // located at the first three elements of the generalized velocity
+  if (quaternion_exp_map_) {
+    map<string, int> velocities_map =
+        multibody::makeNameToVelocitiesMap(plant);
+    DRAKE_DEMAND(velocities_map.at("base_wx") == 0);
+    DRAKE_DEMAND(velocities_map.at("base_wy") == 1);
+    DRAKE_DEMAND(velocities_map.at("base_wz") == 2);
+  }
 }
 
 template <typename T>
 DirconDynamicConstraint<T>::DirconDynamicConstraint(
     const MultibodyPlant<T>& plant, DirconKinematicDataSet<T>& constraints,
     int num_positions, int num_velocities, int num_inputs,
-    int num_kinematic_constraints_wo_skipping, int num_quat_slack)
+    int num_kinematic_constraints_wo_skipping, int num_quat_slack,
+    bool quaternion_exp_map)
     : solvers::NonlinearConstraint<T>(
           num_positions + num_velocities,
           1 + 2 * (num_positions + num_velocities) + (2 * num_inputs) +
@@ -76,7 +89,6 @@ DirconDynamicConstraint<T>::DirconDynamicConstraint(
           Eigen::VectorXd::Zero(num_positions + num_velocities),
           "dynamics_constraint"),
       plant_(plant),
-      constraints_(&constraints),
       num_states_{num_positions + num_velocities},
       num_inputs_{num_inputs},
       num_kinematic_constraints_wo_skipping_{
@@ -84,7 +96,8 @@ DirconDynamicConstraint<T>::DirconDynamicConstraint(
       num_positions_{num_positions},
       num_velocities_{num_velocities},
       num_quat_slack_{num_quat_slack},
-      context_(plant_.CreateDefaultContext()) {}
+      quaternion_exp_map_{quaternion_exp_map},
+      context_(plant_, &constraints) {}
 
 // The format of the input to the eval() function is the
 // tuple { timestep, state 0, state 1, input 0, input 1, force 0, force 1},
@@ -122,26 +135,38 @@ void DirconDynamicConstraint<T>::EvaluateConstraint(
                 num_kinematic_constraints_wo_skipping_);
   const VectorX<T> gamma = x.tail(num_quat_slack_);
 
+  DirconKinematicDataSet<T>* constraints = context_.constraints();
   multibody::setContext(plant_, x0, u0, context_.get());
-  constraints_->updateData(*context_, l0);
-  const VectorX<T> xdot0 = constraints_->getXDot();
+  constraints->updateData(*context_, l0);
+  const VectorX<T> xdot0 = constraints->getXDot();
 
   multibody::setContext(plant_, x1, u1, context_.get());
-  constraints_->updateData(*context_, l1);
-  const VectorX<T> xdot1 = constraints_->getXDot();
+  constraints->updateData(*context_, l1);
+  const VectorX<T> xdot1 = constraints->getXDot();
 
   // Cubic interpolation to get xcol and xdotcol.
-  const VectorX<T> xcol = 0.5 * (x0 + x1) + h / 8 * (xdot0 - xdot1);
+  VectorX<T> xcol = 0.5 * (x0 + x1) + h / 8 * (xdot0 - xdot1);
   const VectorX<T> xdotcol = -1.5 * (x0 - x1) / h - .25 * (xdot0 + xdot1);
   const VectorX<T> ucol = 0.5 * (u0 + u1);
 
+  // The angular velocity of the base is quadratic over the interval, which
+  // integrates to h/24 (5 w0 + 8 wcol - w1) over the first half.
+  Vector3<T> w0, w1, wcol;
+  if (quaternion_exp_map_) {
+    w0 = x0.template segment<3>(num_positions_);
+    w1 = x1.template segment<3>(num_positions_);
+    wcol = xcol.template segment<3>(num_positions_);
+    xcol.head(4) = multibody::IntegrateQuaternion<T>(
+        x0.head(4), h / 24 * (5 * w0 + 8 * wcol - w1));
+  }
+
   multibody::setContext(plant_, xcol, ucol, context_.get());
-  constraints_->updateData(*context_, lc);
-  auto g = constraints_->getXDot();
+  constraints->updateData(*context_, lc);
+  auto g = constraints->getXDot();
+  const VectorX<T> vc_in_v_space =
+      constraints->getJWithoutSkipping().transpose() * vc;
   VectorX<T> vc_in_qdot_space(num_positions_);
-  plant_.MapVelocityToQDot(*context_,
-                           constraints_->getJWithoutSkipping().transpose() * vc,
-                           &vc_in_qdot_space);
+  plant_.MapVelocityToQDot(*context_, vc_in_v_space, &vc_in_qdot_space);
   g.head(num_positions_) += vc_in_qdot_space;
 
   // The slack variable allows the quaternion to stay on a unit sphere.
@@ -150,6 +175,14 @@ void DirconDynamicConstraint<T>::EvaluateConstraint(
   }
 
   *y = xdotcol - g;
+
+  // Simpson quadrature of the angular velocity over the full interval
+  if (quaternion_exp_map_) {
+    const Vector3<T> phi = h / 6 * (w0 + 4 * wcol + w1) +
+                           h * vc_in_v_space.template head<3>();
+    y->head(4) =
+        (x1.head(4) - multibody::IntegrateQuaternion<T>(x0.head(4), phi)) / h;
+  }
 }
 
 template <typename T>
@@ -221,7 +254,6 @@ DirconKinematicConstraint<T>::DirconKinematicConstraint(
           VectorXd::Zero(type * num_kinematic_constraints),
           "kinematics_constraint"),
       plant_(plant),
-      constraints_(&constraints),
       num_states_{num_positions + num_velocities},
       num_inputs_{num_inputs},
       num_kinematic_constraints_{num_kinematic_constraints},
@@ -234,7 +266,7 @@ DirconKinematicConstraint<T>::DirconKinematicConstraint(
       n_relative_{
           static_cast<int>(std::count(is_constraint_relative.begin(),
                                       is_constraint_relative.end(), true))},
-      context_(plant_.CreateDefaultContext()) {
+      context_(plant_, &constraints) {
   // Set sparsity pattern and relative map
   std::vector<std::pair<int, int>> sparsity;
   // Acceleration constraints are dense in decision variables
@@ -297,21 +329,22 @@ void DirconKinematicConstraint<T>::EvaluateConstraint(
   const VectorX<T> offset = x.segment(
       num_states_ + num_inputs_ + num_kinematic_constraints_wo_skipping_,
       n_relative_);
+  DirconKinematicDataSet<T>* constraints = context_.constraints();
   multibody::setContext(plant_, state, input, context_.get());
-  constraints_->updateData(*context_, force);
+  constraints->updateData(*context_, force);
   switch (type_) {
     case kAll:
       *y = VectorX<T>(3 * num_kinematic_constraints_);
-      *y << constraints_->getCDDot(), constraints_->getCDot(),
-          constraints_->getC() + relative_map_ * offset;
+      *y << constraints->getCDDot(), constraints->getCDot(),
+          constraints->getC() + relative_map_ * offset;
       break;
     case kAccelAndVel:
       *y = VectorX<T>(2 * num_kinematic_constraints_);
-      *y << constraints_->getCDDot(), constraints_->getCDot();
+      *y << constraints->getCDDot(), constraints->getCDot();
       break;
     case kAccelOnly:
       *y = VectorX<T>(1 * num_kinematic_constraints_);
-      *y << constraints_->getCDDot();
+      *y << constraints->getCDDot();
       break;
   }
 }
@@ -335,13 +368,12 @@ DirconImpactConstraint<T>::DirconImpactConstraint(
                                   VectorXd::Zero(num_velocities),
                                   "impact_constraint"),
       plant_(plant),
-      constraints_(&constraints),
       num_states_{num_positions + num_velocities},
       num_kinematic_constraints_wo_skipping_{
           num_kinematic_constraints_wo_skipping},
       num_positions_{num_positions},
       num_velocities_{num_velocities},
-      context_(plant_.CreateDefaultContext()) {}
+      context_(plant_, &constraints) {}
 
 // The format of the input to the eval() function is the
 // tuple { state 0, impulse, velocity 1},
@@ -367,15 +399,16 @@ void DirconImpactConstraint<T>::EvaluateConstraint(
   const VectorX<T> u =
       VectorXd::Zero(plant_.num_actuators()).template cast<T>();
 
+  DirconKinematicDataSet<T>* constraints = context_.constraints();
   multibody::setContext(plant_, x0, u, context_.get());
 
-  constraints_->updateData(*context_, impulse);
+  constraints->updateData(*context_, impulse);
 
   MatrixX<T> M(num_velocities_, num_velocities_);
   plant_.CalcMassMatrix(*context_, &M);
 
   *y =
-      M * (v1 - v0) - constraints_->getJWithoutSkipping().transpose() * impulse;
+      M * (v1 - v0) - constraints->getJWithoutSkipping().transpose() * impulse;
 }
 
 template <typename T>
@@ -400,7 +433,7 @@ PointPositionConstraint<T>::PointPositionConstraint(
       body_(plant.GetBodyByName(body_name)),
       point_wrt_body_(point_wrt_body.template cast<T>()),
       dir_(dir.template cast<T>()),
-      context_(plant_.CreateDefaultContext()) {}
+      context_(plant_) {}
 
 template <typename T>
 void PointPositionConstraint<T>::EvaluateConstraint(
@@ -435,7 +468,7 @@ PointVelocityConstraint<T>::PointVelocityConstraint(
       body_(plant.GetBodyByName(body_name)),
       point_wrt_body_(point_wrt_body.template cast<T>()),
       dir_(dir.template cast<T>()),
-      context_(plant_.CreateDefaultContext()) {}
+      context_(plant_) {}
 
 template <typename T>
 void PointVelocityConstraint<T>::EvaluateConstraint(
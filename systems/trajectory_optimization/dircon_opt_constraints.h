@@ -1,6 +1,11 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 #include <memory.h>
@@ -18,6 +23,91 @@ namespace trajectory_optimization {
 
 enum DirconKinConstraintType { kAll = 3, kAccelAndVel = 2, kAccelOnly = 1 };
 
+/// Plant context and kinematic data of a constraint evaluator, allocated on
+/// first use by each evaluating thread. Constructing a program then allocates
+/// no contexts, and a shared evaluator never hands the same context or
+/// kinematic data to two threads: DirconKinematicDataSet::updateData writes
+/// to the set, so each thread updates its own clone of it.
+///
+/// get() only locks the first time a thread uses an instance: each thread
+/// keeps a small cache of its contexts, keyed on a unique id of the instance
+/// (rather than its address, which may be reused by a later instance).
+template <typename T>
+class PerThreadContext {
+ public:
+  /// @param constraints the kinematic constraints to clone for each thread,
+  /// or null if the evaluator has none. They must outlive this object.
+  explicit PerThreadContext(
+      const drake::multibody::MultibodyPlant<T>& plant,
+      const DirconKinematicDataSet<T>* constraints = nullptr)
+      : plant_(plant), constraints_(constraints), id_(NextId()) {}
+
+  drake::systems::Context<T>* get() const {
+    return GetThreadData()->context.get();
+  }
+
+  drake::systems::Context<T>& operator*() const { return *get(); }
+
+  /// The calling thread's clone of the kinematic constraints
+  DirconKinematicDataSet<T>* constraints() const {
+    return GetThreadData()->constraints.get();
+  }
+
+  /// Number of threads which have used this instance
+  int num_threads() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return thread_data_.size();
+  }
+
+ private:
+  struct ThreadData {
+    std::unique_ptr<drake::systems::Context<T>> context;
+    std::unique_ptr<DirconKinematicDataSet<T>> constraints;
+  };
+
+  struct CacheEntry {
+    uint64_t id{0};
+    ThreadData* data{nullptr};
+  };
+  static constexpr int kCacheSize = 64;
+
+  // Ids start at 1, so that they never match an empty cache entry
+  static uint64_t NextId() {
+    static std::atomic<uint64_t> next_id{1};
+    return next_id++;
+  }
+
+  ThreadData* GetThreadData() const {
+    // Direct-mapped, so that the constraints of a program, which have
+    // consecutive ids, don't evict each other
+    thread_local std::array<CacheEntry, kCacheSize> cache;
+    CacheEntry& entry = cache[id_ % kCacheSize];
+    if (entry.id != id_) {
+      entry.id = id_;
+      entry.data = GetLocked();
+    }
+    return entry.data;
+  }
+
+  ThreadData* GetLocked() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& data = thread_data_[std::this_thread::get_id()];
+    if (!data) {
+      data = std::make_unique<ThreadData>();
+      data->context = plant_.CreateDefaultContext();
+      if (constraints_) data->constraints = constraints_->Clone();
+    }
+    return data.get();
+  }
+
+  const drake::multibody::MultibodyPlant<T>& plant_;
+  const DirconKinematicDataSet<T>* constraints_;
+  const uint64_t id_;
+  mutable std::mutex mutex_;
+  mutable std::unordered_map<std::thread::id, std::unique_ptr<ThreadData>>
+      thread_data_;
+};
+
 /// Unit-norm quaternion constraint
 template <typename T>
 class QuaternionNormConstraint : public solvers::NonlinearConstraint<T> {
@@ -33,6 +123,18 @@ class QuaternionNormConstraint : public solvers::NonlinearConstraint<T> {
 /// the input and a cubic polynomial representation of the state trajectories.
 /// This class is based on the similar constraint used by DirectCollocation,
 /// but incorporates the effect of constraint forces
+///
+/// For a quaternion floating base, the quaternion is handled in one of two
+/// ways:
+///  - by default, with a slack variable gamma which scales the quaternion
+///    rate, so that the quaternion can stay on the unit sphere (together with
+///    QuaternionNormConstraint at every knot).
+///  - with quaternion_exp_map, on the unit sphere. The quaternion rows of the
+///    defect are (q1 - exp(phi) q0) / h, where phi is the Simpson quadrature
+///    of the base angular velocity over the interval (plus the collocation
+///    slack). The quaternion at the collocation point is propagated from q0 in
+///    the same way. There is no slack variable, and the quaternion norm is
+///    preserved from knot to knot.
 
 template <typename T>
 class DirconDynamicConstraint : public solvers::NonlinearConstraint<T> {
@@ -42,7 +144,8 @@ class DirconDynamicConstraint : public solvers::NonlinearConstraint<T> {
  public:
   DirconDynamicConstraint(const drake::multibody::MultibodyPlant<T>& plant,
                           DirconKinematicDataSet<T>& constraints,
-                          bool is_quaternion = false);
+                          bool is_quaternion = false,
+                          bool quaternion_exp_map = false);
 
   ~DirconDynamicConstraint() override = default;
 
@@ -66,17 +169,17 @@ class DirconDynamicConstraint : public solvers::NonlinearConstraint<T> {
                           DirconKinematicDataSet<T>& constraints,
                           int num_positions, int num_velocities, int num_inputs,
                           int num_kinematic_constraints_wo_skipping,
-                          int num_quat_slack);
+                          int num_quat_slack, bool quaternion_exp_map);
 
   const drake::multibody::MultibodyPlant<T>& plant_;
-  DirconKinematicDataSet<T>* constraints_;
   const int num_states_{0};
   const int num_inputs_{0};
   const int num_kinematic_constraints_wo_skipping_{0};
   const int num_positions_{0};
   const int num_velocities_{0};
   const int num_quat_slack_{0};
-  std::unique_ptr<drake::systems::Context<T>> context_;
+  const bool quaternion_exp_map_{false};
+  PerThreadContext<T> context_;
 };
 
 /// Implements the kinematic constraints used by Dircon
@@ -128,7 +231,6 @@ class DirconKinematicConstraint : public solvers::NonlinearConstraint<T> {
                             int num_kinematic_constraints_wo_skipping);
 
   const drake::multibody::MultibodyPlant<T>& plant_;
-  DirconKinematicDataSet<T>* constraints_;
 
   const int num_states_{0};
   const int num_inputs_{0};
@@ -140,7 +242,7 @@ class DirconKinematicConstraint : public solvers::NonlinearConstraint<T> {
   const std::vector<bool> is_constraint_relative_;
   const int n_relative_;
   Eigen::MatrixXd relative_map_;
-  std::unique_ptr<drake::systems::Context<T>> context_;
+  PerThreadContext<T> context_;
 };
 
 /// Helper method to add a DirconDynamicConstraint to the @p prog,
@@ -189,13 +291,12 @@ class DirconImpactConstraint : public solvers::NonlinearConstraint<T> {
                          int num_kinematic_constraints_wo_skipping);
 
   const drake::multibody::MultibodyPlant<T>& plant_;
-  DirconKinematicDataSet<T>* constraints_;
 
   const int num_states_{0};
   const int num_kinematic_constraints_wo_skipping_{0};
   const int num_positions_{0};
   const int num_velocities_{0};
-  std::unique_ptr<drake::systems::Context<T>> context_;
+  PerThreadContext<T> context_;
 };
 
 // Position constraint of a point in the directions `dir` with respect to the
@@ -227,7 +328,7 @@ class PointPositionConstraint : public solvers::NonlinearConstraint<T> {
   const drake::multibody::Body<T>& body_;
   const drake::Vector3<T> point_wrt_body_;
   const Eigen::Matrix<T, Eigen::Dynamic, 3> dir_;
-  std::unique_ptr<drake::systems::Context<T>> context_;
+  PerThreadContext<T> context_;
 };
 
 // Velocity constraint of a point in the directions `dir` with respect to the
@@ -259,7 +360,7 @@ class PointVelocityConstraint : public solvers::NonlinearConstraint<T> {
   const drake::multibody::Body<T>& body_;
   const drake::Vector3<T> point_wrt_body_;
   const Eigen::Matrix<T, Eigen::Dynamic, 3> dir_;
-  std::unique_ptr<drake::systems::Context<T>> context_;
+  PerThreadContext<T> context_;
 };
 
 }  // namespace trajectory_optimization
@@ -13,6 +13,7 @@ DirconOptions::DirconOptions(int n_kin_constraints) {
   start_constraint_type_ = DirconKinConstraintType::kAll;
   end_constraint_type_ = DirconKinConstraintType::kAll;
   force_cost_ = 1.0e-4;
+  quaternion_exp_map_ = false;
 }
 DirconOptions::DirconOptions(
     int n_constraints, const drake::multibody::MultibodyPlant<double>& plant)
@@ -157,6 +158,12 @@ DirconKinConstraintType DirconOptions::getEndType() {
 
 double DirconOptions::getForceCost() { return force_cost_; }
 
+void DirconOptions::setQuaternionExpMap(bool use_exp_map) {
+  quaternion_exp_map_ = use_exp_map;
+}
+
+bool DirconOptions::getQuaternionExpMap() { return quaternion_exp_map_; }
+
 int DirconOptions::getNumRelative() {
   return static_cast<int>(std::count(is_constraints_relative_.begin(),
                                      is_constraints_relative_.end(), true));
@@ -52,6 +52,13 @@ class DirconOptions {
   void setForceCost(double force_cost);
   double getForceCost();
 
+  /// Integrate the floating base quaternion with the exponential map in the
+  /// dynamic constraints (see DirconDynamicConstraint), instead of using
+  /// quaternion slack variables and unit norm constraints at every knot.
+  /// Must be the same for all modes.
+  void setQuaternionExpMap(bool use_exp_map);
+  bool getQuaternionExpMap();
+
  private:
   // methods for constraint scaling
   static void addConstraintScaling(std::unordered_map<int, double>* list,
@@ -74,6 +81,8 @@ class DirconOptions {
 
   // Force cost
   double force_cost_;
+
+  bool quaternion_exp_map_;
 };
 
 }  // namespace trajectory_optimization
@@ -2,6 +2,7 @@
 #include <vector>
 
 #include "systems/trajectory_optimization/dircon_position_data.h"
+#include "multibody/kinematic/world_point_evaluator.h"
 #include "drake/math/orthonormal_basis.h"
 
 namespace dairlib {
@@ -46,7 +47,6 @@ DirconPositionData<T>::~DirconPositionData() {
 template <typename T>
 void DirconPositionData<T>::updateConstraint(const Context<T>& context) {
   VectorX<T> pt_transform(3);
-  MatrixX<T> J3d(3, this->plant_.num_velocities());
   const auto x = dynamic_cast<const drake::systems::BasicVector<T>&>(
       context.get_continuous_state_vector()).get_value();
   const auto v = x.tail(this->plant_.num_velocities());
@@ -56,23 +56,27 @@ void DirconPositionData<T>::updateConstraint(const Context<T>& context) {
 
   this->plant_.CalcPointsPositions(context, body_.body_frame(), pt_cast,
                                    world, &pt_transform);
-  this->plant_.CalcJacobianTranslationalVelocity(
-      context, drake::multibody::JacobianWrtVariable::kV,
-      body_.body_frame(), pt_cast, world, world, &J3d);
-
-  MatrixX<T> J3d_times_v = this->plant_.CalcBiasSpatialAcceleration(
-      context, drake::multibody::JacobianWrtVariable::kV,
-      body_.body_frame(), pt_cast,
-      world, world).translational();
 
+  // The fixed-size kernels of WorldPointEvaluator write J and Jdotv in place
+  const int n_rows = isXZ_ ? 2 : 3;
+  this->J_.resize(n_rows, this->plant_.num_velocities());
+  this->Jdotv_.resize(n_rows);
   if (isXZ_) {
     this->c_ = TXZ_and_ground_incline_ * pt_transform;
-    this->J_ = TXZ_and_ground_incline_ * J3d;
-    this->Jdotv_ = TXZ_and_ground_incline_ * J3d_times_v;
+    multibody::CalcWorldPointJacobian<T, 2>(
+        this->plant_, context, body_.body_frame(), pt_,
+        TXZ_and_ground_incline_, this->J_, &J_WQ_);
+    multibody::CalcWorldPointJacobianDotTimesV<T, 2>(
+        this->plant_, context, body_.body_frame(), pt_,
+        TXZ_and_ground_incline_, this->Jdotv_);
   } else {
     this->c_ = T_ground_incline_ * pt_transform;
-    this->J_ = T_ground_incline_ * J3d;
-    this->Jdotv_ = T_ground_incline_ * J3d_times_v;
+    multibody::CalcWorldPointJacobian<T, 3>(this->plant_, context,
+                                            body_.body_frame(), pt_,
+                                            T_ground_incline_, this->J_);
+    multibody::CalcWorldPointJacobianDotTimesV<T, 3>(
+        this->plant_, context, body_.body_frame(), pt_, T_ground_incline_,
+        this->Jdotv_);
   }
   this->cdot_ = this->J_ * v;
 }
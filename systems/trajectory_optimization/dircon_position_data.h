@@ -17,6 +17,10 @@ class DirconPositionData : public DirconKinematicData<T> {
     Eigen::Vector3d surface_normal = Eigen::Vector3d(0,0,1));
   ~DirconPositionData();
 
+  std::unique_ptr<DirconKinematicData<T>> Clone() const override {
+    return std::make_unique<DirconPositionData<T>>(*this);
+  }
+
   // The workhorse function, updates and caches everything needed by the
   // outside world
   void updateConstraint(const drake::systems::Context<T>& context);
@@ -30,5 +34,7 @@ class DirconPositionData : public DirconKinematicData<T> {
     Eigen::Matrix<double, 2, 3> TXZ_;
     Eigen::Matrix3d T_ground_incline_;
     Eigen::Matrix<double, 2, 3> TXZ_and_ground_incline_;
+    // Scratch space of the xz Jacobian, reused between updates
+    drake::MatrixX<T> J_WQ_;
 };
 }  // namespace dairlib
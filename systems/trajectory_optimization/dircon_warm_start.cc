@@ -0,0 +1,393 @@
+#include "systems/trajectory_optimization/dircon_warm_start.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+using drake::solvers::MathematicalProgramResult;
+using drake::solvers::VectorXDecisionVariable;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Phases in [0, 1] of the knot points (or of the collocation points) of a
+// mode with the given number of knot points
+VectorXd KnotPhases(int mode_length) {
+  if (mode_length == 1) return VectorXd::Zero(1);
+  return VectorXd::LinSpaced(mode_length, 0, 1);
+}
+
+VectorXd CollocationPhases(int mode_length) {
+  if (mode_length <= 1) return VectorXd(0);
+  return (VectorXd::LinSpaced(mode_length - 1, 0, mode_length - 2).array() +
+          0.5) /
+         (mode_length - 1);
+}
+
+// Linear interpolation between the columns of data, sampled at phases,
+// clamped at both ends
+VectorXd InterpolateColumns(const MatrixXd& data, const VectorXd& phases,
+                            double phase) {
+  DRAKE_DEMAND(data.cols() == phases.size() && data.cols() > 0);
+  if (phase <= phases(0)) return data.col(0);
+  for (int i = 1; i < phases.size(); ++i) {
+    if (phase <= phases(i)) {
+      double s = (phase - phases(i - 1)) / (phases(i) - phases(i - 1));
+      return (1 - s) * data.col(i - 1) + s * data.col(i);
+    }
+  }
+  return data.col(data.cols() - 1);
+}
+
+// Stacks the solution values of the variables as a rows x cols matrix, one
+// column per knot (or collocation) point
+MatrixXd StackSolution(const MathematicalProgramResult& result,
+                       const VectorXDecisionVariable& vars, int rows,
+                       int cols) {
+  DRAKE_DEMAND(vars.size() == rows * cols);
+  VectorXd values = result.GetSolution(vars);
+  return Eigen::Map<MatrixXd>(values.data(), rows, cols);
+}
+
+LcmTrajectory::Trajectory MakeTrajectory(const string& name,
+                                         const VectorXd& time_vector,
+                                         const MatrixXd& datapoints,
+                                         const string& datatype_prefix) {
+  LcmTrajectory::Trajectory traj;
+  traj.traj_name = name;
+  traj.time_vector = time_vector;
+  traj.datapoints = datapoints;
+  for (int i = 0; i < datapoints.rows(); ++i) {
+    traj.datatypes.push_back(datatype_prefix + "[" + std::to_string(i) + "]");
+  }
+  return traj;
+}
+
+string ModeName(const string& name, int mode) {
+  return name + "[" + std::to_string(mode) + "]";
+}
+
+// A name for a new entry of key: the mode sequence followed by a hash of the
+// key and of a random number, so that the runs which append to the same
+// library, even with the same key, don't collide
+string EntryName(const DirconProblemKey& key) {
+  std::stringstream key_string;
+  key_string.precision(17);
+  key_string << key.mode_sequence;
+  for (int length : key.mode_lengths) {
+    key_string << "," << length;
+  }
+  for (int i = 0; i < key.parameters.size(); ++i) {
+    key_string << "," << key.parameter_names[i] << "=" << key.parameters(i);
+  }
+  key_string << "," << std::random_device()();
+  std::stringstream name;
+  name << key.mode_sequence << "_" << std::hex << std::setw(16)
+       << std::setfill('0') << std::hash<string>()(key_string.str());
+  return name.str();
+}
+
+}  // namespace
+
+DirconWarmStartLibrary::DirconWarmStartLibrary(
+    const string& filepath, const VectorXd& parameter_scales)
+    : filepath_(filepath), parameter_scales_(parameter_scales) {
+  Refresh();
+}
+
+void DirconWarmStartLibrary::Refresh() {
+  if (!reader_) {
+    if (!std::ifstream(filepath_)) return;
+    reader_ = std::make_unique<LcmTrajectoryContainerReader>(filepath_);
+  } else {
+    reader_->Refresh();
+  }
+
+  const auto& entry_names = reader_->GetEntryNames();
+  for (size_t i = keys_.size(); i < entry_names.size(); ++i) {
+    const string& entry_name = entry_names[i];
+    DirconProblemKey key;
+    key.mode_sequence = reader_->GetMetadata(entry_name).name;
+    auto key_traj = reader_->ReadTrajectory(entry_name, "key");
+    key.parameter_names = key_traj.datatypes;
+    key.parameters = key_traj.datapoints.col(0);
+    auto lengths_traj = reader_->ReadTrajectory(entry_name, "mode_lengths");
+    for (int j = 0; j < lengths_traj.datapoints.rows(); ++j) {
+      key.mode_lengths.push_back(std::round(lengths_traj.datapoints(j, 0)));
+    }
+    keys_.emplace_back(entry_name, key);
+  }
+}
+
+void DirconWarmStartLibrary::Add(const DirconProblemKey& key,
+                                 const HybridDircon<double>& trajopt,
+                                 const MathematicalProgramResult& result) {
+  DRAKE_DEMAND(static_cast<int>(key.parameter_names.size()) ==
+               key.parameters.size());
+  DRAKE_DEMAND(static_cast<int>(key.mode_lengths.size()) ==
+               trajopt.num_modes());
+
+  vector<LcmTrajectory::Trajectory> trajectories;
+  LcmTrajectory::Trajectory key_traj;
+  key_traj.traj_name = "key";
+  key_traj.time_vector = VectorXd::Zero(1);
+  key_traj.datapoints = key.parameters;
+  key_traj.datatypes = key.parameter_names;
+  trajectories.push_back(key_traj);
+
+  VectorXd mode_lengths(trajopt.num_modes());
+  for (int i = 0; i < trajopt.num_modes(); ++i) {
+    mode_lengths(i) = trajopt.mode_length(i);
+  }
+  trajectories.push_back(MakeTrajectory("mode_lengths", VectorXd::Zero(1),
+                                        mode_lengths, "mode_length"));
+
+  VectorXd z = result.GetSolution(trajopt.decision_variables());
+  trajectories.push_back(
+      MakeTrajectory("decision_variables",
+                     VectorXd::LinSpaced(z.size(), 0, z.size() - 1),
+                     z.transpose(), "z"));
+
+  VectorXd times = trajopt.GetSampleTimes(result);
+  int mode_start = 0;
+  for (int i = 0; i < trajopt.num_modes(); ++i) {
+    const int length = trajopt.mode_length(i);
+    const int num_lambda = trajopt.num_kinematic_constraints_wo_skipping(i);
+    VectorXd knot_times = times.segment(mode_start, length);
+    VectorXd collocation_times =
+        (knot_times.head(length - 1) + knot_times.tail(length - 1)) / 2;
+
+    MatrixXd states(trajopt.num_states(), length);
+    MatrixXd inputs(trajopt.num_inputs(), length);
+    for (int j = 0; j < length; ++j) {
+      states.col(j) = result.GetSolution(trajopt.state_vars_by_mode(i, j));
+      inputs.col(j) = result.GetSolution(trajopt.input(mode_start + j));
+    }
+    VectorXd constants(trajopt.offset_vars(i).size() +
+                       (i > 0 ? trajopt.impulse_vars(i - 1).size() : 0));
+    constants.head(trajopt.offset_vars(i).size()) =
+        result.GetSolution(trajopt.offset_vars(i));
+    if (i > 0) {
+      constants.tail(trajopt.impulse_vars(i - 1).size()) =
+          result.GetSolution(trajopt.impulse_vars(i - 1));
+    }
+
+    trajectories.push_back(
+        MakeTrajectory(ModeName("state", i), knot_times, states, "x"));
+    trajectories.push_back(
+        MakeTrajectory(ModeName("input", i), knot_times, inputs, "u"));
+    trajectories.push_back(MakeTrajectory(
+        ModeName("force", i), knot_times,
+        StackSolution(result, trajopt.force_vars(i), num_lambda, length),
+        "lambda"));
+    trajectories.push_back(MakeTrajectory(
+        ModeName("collocation_force", i), collocation_times,
+        StackSolution(result, trajopt.collocation_force_vars(i), num_lambda,
+                      length - 1),
+        "lambda_c"));
+    trajectories.push_back(MakeTrajectory(
+        ModeName("collocation_slack", i), collocation_times,
+        StackSolution(result, trajopt.collocation_slack_vars(i), num_lambda,
+                      length - 1),
+        "v_c"));
+    trajectories.push_back(MakeTrajectory(
+        ModeName("quaternion_slack", i), collocation_times,
+        StackSolution(result, trajopt.quaternion_slack_vars(i),
+                      trajopt.quaternion_slack_vars(i).size() > 0 ? 1 : 0,
+                      length - 1),
+        "gamma"));
+    trajectories.push_back(MakeTrajectory(ModeName("constants", i),
+                                          VectorXd::Zero(1), constants, "c"));
+    mode_start += length - 1;
+  }
+
+  vector<string> trajectory_names;
+  for (const auto& traj : trajectories) {
+    trajectory_names.push_back(traj.traj_name);
+  }
+  LcmTrajectory lcm_traj(trajectories, trajectory_names, key.mode_sequence,
+                         "DIRCON warm start");
+  Refresh();
+  string entry_name = EntryName(key);
+  while (reader_ && reader_->HasEntry(entry_name)) {
+    entry_name = EntryName(key);
+  }
+  lcm_traj.appendToContainer(filepath_, entry_name);
+  Refresh();
+}
+
+vector<pair<string, double>> DirconWarmStartLibrary::FindNearest(
+    const DirconProblemKey& key, int k) const {
+  vector<pair<string, double>> neighbors;
+  for (const auto& [entry_name, stored] : keys_) {
+    if (stored.mode_sequence != key.mode_sequence ||
+        stored.mode_lengths.size() != key.mode_lengths.size() ||
+        stored.parameter_names != key.parameter_names) {
+      continue;
+    }
+    VectorXd difference = stored.parameters - key.parameters;
+    if (parameter_scales_.size() > 0) {
+      difference = difference.cwiseQuotient(parameter_scales_);
+    }
+    neighbors.emplace_back(entry_name, difference.norm());
+  }
+  std::sort(neighbors.begin(), neighbors.end(),
+            [](const auto& a, const auto& b) { return a.second < b.second; });
+  if (static_cast<int>(neighbors.size()) > k) neighbors.resize(k);
+  return neighbors;
+}
+
+bool DirconWarmStartLibrary::SetInitialGuess(const DirconProblemKey& key,
+                                             HybridDircon<double>* trajopt,
+                                             int k) {
+  Refresh();
+  auto neighbors = FindNearest(key, k);
+  if (neighbors.empty()) return false;
+
+  // Inverse distance weights, an exact match takes all the weight
+  VectorXd weights(neighbors.size());
+  for (size_t i = 0; i < neighbors.size(); ++i) {
+    if (neighbors[i].second == 0) {
+      neighbors = {neighbors[i]};
+      weights = VectorXd::Ones(1);
+      break;
+    }
+    weights(i) = 1.0 / neighbors[i].second;
+  }
+  weights /= weights.sum();
+
+  vector<int> mode_lengths;
+  for (int i = 0; i < trajopt->num_modes(); ++i) {
+    mode_lengths.push_back(trajopt->mode_length(i));
+  }
+
+  VectorXd z = VectorXd::Zero(trajopt->num_vars());
+  for (size_t i = 0; i < neighbors.size(); ++i) {
+    const string& entry_name = neighbors[i].first;
+    const auto& stored = std::find_if(keys_.begin(), keys_.end(),
+                                      [&](const auto& stored_key) {
+                                        return stored_key.first == entry_name;
+                                      })->second;
+    VectorXd z_i;
+    if (stored.mode_lengths == mode_lengths) {
+      z_i = reader_->ReadTrajectory(entry_name, "decision_variables")
+                .datapoints.row(0)
+                .transpose();
+    }
+    if (z_i.size() != trajopt->num_vars()) {
+      z_i = ResampleEntry(entry_name, *trajopt);
+    }
+    z += weights(i) * z_i;
+  }
+  trajopt->SetInitialGuessForAllVariables(z);
+  return true;
+}
+
+VectorXd DirconWarmStartLibrary::ResampleEntry(
+    const string& entry_name, const HybridDircon<double>& trajopt) {
+  // Variables without a stored counterpart keep their current guess
+  VectorXd z = trajopt.initial_guess().unaryExpr(
+      [](double value) { return std::isnan(value) ? 0 : value; });
+  auto set = [&](const VectorXDecisionVariable& vars, const VectorXd& value) {
+    DRAKE_DEMAND(vars.size() == value.size());
+    for (int i = 0; i < vars.size(); ++i) {
+      z(trajopt.FindDecisionVariableIndex(vars(i))) = value(i);
+    }
+  };
+
+  int mode_start = 0;
+  for (int i = 0; i < trajopt.num_modes(); ++i) {
+    const int length = trajopt.mode_length(i);
+    const int num_lambda = trajopt.num_kinematic_constraints_wo_skipping(i);
+    auto states = reader_->ReadTrajectory(entry_name, ModeName("state", i));
+    auto inputs = reader_->ReadTrajectory(entry_name, ModeName("input", i));
+    auto forces = reader_->ReadTrajectory(entry_name, ModeName("force", i));
+    auto collocation_forces =
+        reader_->ReadTrajectory(entry_name, ModeName("collocation_force", i));
+    auto collocation_slacks =
+        reader_->ReadTrajectory(entry_name, ModeName("collocation_slack", i));
+    auto quaternion_slacks =
+        reader_->ReadTrajectory(entry_name, ModeName("quaternion_slack", i));
+    auto constants =
+        reader_->ReadTrajectory(entry_name, ModeName("constants", i));
+
+    const int stored_length = states.time_vector.size();
+    const VectorXd stored_knots = KnotPhases(stored_length);
+    const VectorXd stored_collocation = CollocationPhases(stored_length);
+    const VectorXd knots = KnotPhases(length);
+    const VectorXd collocation = CollocationPhases(length);
+
+    for (int j = 0; j < length; ++j) {
+      VectorXd x = InterpolateColumns(states.datapoints, stored_knots,
+                                      knots(j));
+      // The first state of mode i > 0 is split between the shared knot
+      // position and the post-impact velocity
+      if (i > 0 && j == 0) {
+        const auto v_post = trajopt.v_post_impact_vars_by_mode(i - 1);
+        const int n_q = trajopt.num_states() - v_post.size();
+        set(trajopt.state(mode_start).head(n_q), x.head(n_q));
+        set(v_post, x.tail(v_post.size()));
+      } else {
+        set(trajopt.state(mode_start + j), x);
+      }
+      set(trajopt.input(mode_start + j),
+          InterpolateColumns(inputs.datapoints, stored_knots, knots(j)));
+      if (num_lambda > 0) {
+        set(trajopt.force(i, j),
+            InterpolateColumns(forces.datapoints, stored_knots, knots(j)));
+      }
+    }
+    for (int j = 0; j < length - 1; ++j) {
+      if (stored_length > 1 && num_lambda > 0) {
+        set(trajopt.collocation_force(i, j),
+            InterpolateColumns(collocation_forces.datapoints,
+                               stored_collocation, collocation(j)));
+        set(trajopt.collocation_slack_vars(i).segment(j * num_lambda,
+                                                      num_lambda),
+            InterpolateColumns(collocation_slacks.datapoints,
+                               stored_collocation, collocation(j)));
+      }
+      if (stored_length > 1 && trajopt.quaternion_slack_vars(i).size() > 0 &&
+          quaternion_slacks.datapoints.rows() > 0) {
+        set(trajopt.quaternion_slack_vars(i).segment(j, 1),
+            InterpolateColumns(quaternion_slacks.datapoints,
+                               stored_collocation, collocation(j)));
+      }
+      // Keep the mode duration, spread evenly over the new knot points
+      const double duration =
+          states.time_vector.tail(1)(0) - states.time_vector(0);
+      if (duration > 0) {
+        set(trajopt.timestep(mode_start + j),
+            VectorXd::Constant(1, duration / (length - 1)));
+      }
+    }
+    if (constants.datapoints.rows() ==
+        trajopt.offset_vars(i).size() +
+            (i > 0 ? trajopt.impulse_vars(i - 1).size() : 0)) {
+      VectorXd c = constants.datapoints.col(0);
+      set(trajopt.offset_vars(i), c.head(trajopt.offset_vars(i).size()));
+      if (i > 0) {
+        set(trajopt.impulse_vars(i - 1),
+            c.tail(trajopt.impulse_vars(i - 1).size()));
+      }
+    }
+    mode_start += length - 1;
+  }
+  return z;
+}
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
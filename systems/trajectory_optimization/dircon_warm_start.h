@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lcm/lcm_trajectory_container.h"
+#include "systems/trajectory_optimization/hybrid_dircon.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+/// Identifies a HybridDircon problem in a DirconWarmStartLibrary
+/// @param mode_sequence a name for the sequence of contact modes, e.g.
+///    "walking_left_stance". Only problems with the same mode sequence are
+///    ever used to warm start each other.
+/// @param mode_lengths the number of knot points in each mode
+/// @param parameter_names the names of the continuous problem parameters,
+///    e.g. {"stride_length", "duration"}
+/// @param parameters the continuous problem parameters (boundary conditions,
+///    stride length, speed, ...), used to find the nearest solved problems.
+///    Every parameter which changes the problem must be in the key (a binary
+///    option as 0 or 1), since a stored solution at distance 0 is used as is.
+struct DirconProblemKey {
+  std::string mode_sequence;
+  std::vector<int> mode_lengths;
+  std::vector<std::string> parameter_names;
+  Eigen::VectorXd parameters;
+};
+
+/// A library of solved HybridDircon problems, used to warm start new problems
+/// in parameter sweeps.
+///
+/// Solutions are appended to a trajectory container file (see
+/// lcm_trajectory_container.h), one LcmTrajectory per solution, holding the
+/// key, the raw decision variables and the per-mode state, input, force and
+/// slack trajectories at the knot and collocation points. Each entry is named
+/// after its mode sequence and a hash of its key and of a random number, so
+/// that several runs can append to the same library.
+///
+/// SetInitialGuess() finds the nearest compatible solutions (same mode
+/// sequence and parameter names, nearest in scaled parameter space) and
+/// blends them with inverse distance weights. If a neighbor has exactly the
+/// same knot counts, its decision variables are used as is. Otherwise, each
+/// mode is resampled in phase to the new knot counts.
+class DirconWarmStartLibrary {
+ public:
+  /// @param filepath the trajectory container holding the library. Created
+  ///    on the first Add() if it does not exist yet.
+  /// @param parameter_scales the distance between keys is computed on
+  ///    parameters ./ parameter_scales. Empty for unit scales.
+  explicit DirconWarmStartLibrary(
+      const std::string& filepath,
+      const Eigen::VectorXd& parameter_scales = Eigen::VectorXd());
+
+  /// Stores the solution of trajopt under key
+  void Add(const DirconProblemKey& key, const HybridDircon<double>& trajopt,
+           const drake::solvers::MathematicalProgramResult& result);
+
+  /// Returns up to k (entry name, distance) pairs of the stored solutions
+  /// compatible with key, nearest first
+  std::vector<std::pair<std::string, double>> FindNearest(
+      const DirconProblemKey& key, int k) const;
+
+  /// Sets the initial guess for all decision variables of trajopt from the k
+  /// nearest stored solutions.
+  /// @return false, leaving trajopt untouched, if there is no compatible
+  ///    solution
+  bool SetInitialGuess(const DirconProblemKey& key,
+                       HybridDircon<double>* trajopt, int k = 2);
+
+  int size() const { return keys_.size(); }
+
+ private:
+  void Refresh();
+  // The initial guess for all of trajopt's variables built from one entry
+  Eigen::VectorXd ResampleEntry(const std::string& entry_name,
+                                const HybridDircon<double>& trajopt);
+
+  const std::string filepath_;
+  Eigen::VectorXd parameter_scales_;
+  std::unique_ptr<LcmTrajectoryContainerReader> reader_;
+  std::vector<std::pair<std::string, DirconProblemKey>> keys_;
+};
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
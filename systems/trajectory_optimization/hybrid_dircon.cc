@@ -53,21 +53,35 @@ HybridDircon<T>::HybridDircon(const MultibodyPlant<T>& plant,
   DRAKE_ASSERT(options.size() == num_modes_);
 
   bool is_quaternion = multibody::isQuaternion(plant);
+  const bool quaternion_exp_map =
+      is_quaternion && options[0].getQuaternionExpMap();
+  for (int i = 1; i < num_modes_; i++) {
+    DRAKE_DEMAND(options[i].getQuaternionExpMap() ==
+                 options[0].getQuaternionExpMap());
+  }
 
   // Initialization is looped over the modes
   int counter = 0;
   for (int i = 0; i < num_modes_; i++) {
     mode_start_.push_back(counter);
 
-    // set timestep bounds
-    for (int j = 0; j < mode_lengths_[i] - 1; j++) {
-      AddBoundingBoxConstraint(minimum_timestep[i], maximum_timestep[i],
-                               timestep(mode_start_[i] + j));
+    // set timestep bounds, one binding for all timesteps of the mode
+    if (mode_lengths_[i] > 1) {
+      AddBoundingBoxConstraint(
+          minimum_timestep[i], maximum_timestep[i],
+          h_vars().segment(mode_start_[i], mode_lengths_[i] - 1));
     }
-    for (int j = 0; j < mode_lengths_[i] - 2; j++) {
-      // all timesteps must be equal
-      AddLinearConstraint(timestep(mode_start_[i] + j) ==
-                          timestep(mode_start_[i] + j + 1));
+    if (mode_lengths_[i] > 2) {
+      // all timesteps must be equal, h_j - h_{j+1} = 0
+      MatrixXd A_equal_h = MatrixXd::Zero(mode_lengths_[i] - 2,
+                                          mode_lengths_[i] - 1);
+      for (int j = 0; j < mode_lengths_[i] - 2; j++) {
+        A_equal_h(j, j) = 1;
+        A_equal_h(j, j + 1) = -1;
+      }
+      AddLinearEqualityConstraint(
+          A_equal_h, VectorXd::Zero(mode_lengths_[i] - 2),
+          h_vars().segment(mode_start_[i], mode_lengths_[i] - 1));
     }
 
     // initialize constraint lengths
@@ -91,7 +105,7 @@ HybridDircon<T>::HybridDircon(const MultibodyPlant<T>& plant,
         "v_c[" + std::to_string(i) + "]"));
     // quaternion_slack_vars_ (slack variables used to scale quaternion norm to
     // 1 in the dynamic constraints)
-    if (is_quaternion) {
+    if (is_quaternion && !quaternion_exp_map) {
       quaternion_slack_vars_.push_back(NewContinuousVariables(
           num_time_samples[i] - 1, "gamma_" + std::to_string(i)));
     } else {
@@ -113,20 +127,23 @@ HybridDircon<T>::HybridDircon(const MultibodyPlant<T>& plant,
     // next.
 
     // Adding quaternion norm constraint
-    if (is_quaternion) {
+    // With the exponential map, the dynamic constraints preserve the norm, so
+    // it is only imposed at the very first knot.
+    if (is_quaternion && (!quaternion_exp_map || i == 0)) {
       auto quat_norm_constraint =
           std::make_shared<QuaternionNormConstraint<T>>();
       // If the current mode is not the first mode, start with the first knot.
       // Otherwise, start with the second knot in order to avoid imposing the
       // same constraint twice.
-      for (int j = (i == 0) ? 0 : 1; j < mode_lengths_[i]; j++) {
+      const int last_knot = quaternion_exp_map ? 1 : mode_lengths_[i];
+      for (int j = (i == 0) ? 0 : 1; j < last_knot; j++) {
         AddConstraint(quat_norm_constraint, state_vars_by_mode(i, j).head(4));
       }
     }
 
     // Adding dynamic constraints
     auto dynamic_constraint = std::make_shared<DirconDynamicConstraint<T>>(
-        plant_, *constraints_[i], is_quaternion);
+        plant_, *constraints_[i], is_quaternion, quaternion_exp_map);
     DRAKE_ASSERT(static_cast<int>(dynamic_constraint->num_constraints()) ==
                  num_states());
     dynamic_constraint->SetConstraintScaling(
@@ -146,8 +163,9 @@ HybridDircon<T>::HybridDircon(const MultibodyPlant<T>& plant,
            collocation_slack_vars(i).segment(
                j * num_kinematic_constraints_wo_skipping(i),
                num_kinematic_constraints_wo_skipping(i)),
-           (is_quaternion) ? quaternion_slack_vars(i).segment(j, 1)
-                           : quaternion_slack_vars(i).segment(0, 0)});
+           (dynamic_constraint->num_quat_slack() > 0)
+               ? quaternion_slack_vars(i).segment(j, 1)
+               : quaternion_slack_vars(i).segment(0, 0)});
     }
 
     // Adding kinematic constraints (interior nodes of the mode)
@@ -220,13 +238,15 @@ HybridDircon<T>::HybridDircon(const MultibodyPlant<T>& plant,
 
     // Add force to cost function
     if (options[i].getForceCost() != 0) {
-      auto A = options[i].getForceCost() *
-               MatrixXd::Identity(num_kinematic_constraints_wo_skipping(i),
-                                  num_kinematic_constraints_wo_skipping(i));
-      auto b = MatrixXd::Zero(num_kinematic_constraints_wo_skipping(i), 1);
+      // || A lambda ||^2 with A = force_cost * I, one evaluator shared by all
+      // the knot points of the mode
+      const int n_lambda = num_kinematic_constraints_wo_skipping(i);
+      auto force_cost = std::make_shared<drake::solvers::QuadraticCost>(
+          2 * options[i].getForceCost() * options[i].getForceCost() *
+              MatrixXd::Identity(n_lambda, n_lambda),
+          VectorXd::Zero(n_lambda));
       for (int j = 0; j < mode_lengths_[i]; j++) {
-        // Add || Ax - b ||^2
-        AddL2NormCost(A, b, force(i, j));
+        AddCost(force_cost, force(i, j));
       }
     }
 
@@ -436,7 +456,8 @@ template <typename T>
 void HybridDircon<T>::ScaleQuaternionSlackVariables(double scale) {
   DRAKE_DEMAND(multibody::isQuaternion(plant_));
   for (size_t mode = 0; mode < mode_lengths_.size(); mode++) {
-    for (int j = 0; j < mode_lengths_[mode] - 1; j++) {
+    // No slack variables with the exponential map
+    for (int j = 0; j < quaternion_slack_vars_[mode].size(); j++) {
       this->SetVariableScaling(quaternion_slack_vars_[mode](j), scale);
     }
   }
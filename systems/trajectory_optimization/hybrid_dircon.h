@@ -109,6 +109,10 @@ class HybridDircon
       const drake::trajectories::PiecewisePolynomial<double>& traj_init_lc,
       const drake::trajectories::PiecewisePolynomial<double>& traj_init_vc);
 
+  int num_modes() const { return num_modes_; }
+
+  int mode_length(int mode) const { return mode_lengths_[mode]; }
+
   int num_kinematic_constraints(int mode) const {
     return num_kinematic_constraints_[mode];
   }
@@ -0,0 +1,532 @@
+#include "systems/trajectory_optimization/hybrid_multiple_shooting.h"
+
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "multibody/multibody_utils.h"
+#include "multibody/quaternion_integration.h"
+#include "drake/math/autodiff.h"
+#include "drake/math/autodiff_gradient.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+using drake::AutoDiffVecXd;
+using drake::AutoDiffXd;
+using drake::MatrixX;
+using drake::Vector3;
+using drake::VectorX;
+using drake::multibody::MultibodyPlant;
+using drake::solvers::MathematicalProgramResult;
+using drake::solvers::VectorXDecisionVariable;
+using drake::systems::trajectory_optimization::MultipleShooting;
+using drake::trajectories::PiecewisePolynomial;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using std::vector;
+
+template <typename T>
+ShootingDefectConstraint<T>::ShootingDefectConstraint(
+    const MultibodyPlant<T>& plant, DirconKinematicDataSet<T>& constraints,
+    bool is_quaternion, int num_substeps)
+    : solvers::NonlinearConstraint<T>(
+          plant.num_positions() + plant.num_velocities(),
+          1 + 2 * (plant.num_positions() + plant.num_velocities()) +
+              2 * plant.num_actuators(),
+          VectorXd::Zero(plant.num_positions() + plant.num_velocities()),
+          VectorXd::Zero(plant.num_positions() + plant.num_velocities()),
+          "shooting_defect_constraint"),
+      plant_(plant),
+      num_states_(plant.num_positions() + plant.num_velocities()),
+      num_inputs_(plant.num_actuators()),
+      is_quaternion_(is_quaternion),
+      num_substeps_(num_substeps),
+      context_(plant_, &constraints) {
+  DRAKE_DEMAND(num_substeps > 0);
+  // The quaternion and angular velocity of the base lead the generalized
+  // positions and velocities
+  if (is_quaternion) {
+    DRAKE_DEMAND(multibody::QuaternionStartIndex(plant) == 0);
+    DRAKE_DEMAND(multibody::makeNameToVelocitiesMap(plant).at("base_wx") == 0);
+  }
+}
+
+template <typename T>
+VectorX<T> ShootingDefectConstraint<T>::CalcConstrainedDynamics(
+    const VectorX<T>& x, const VectorX<T>& u) const {
+  DirconKinematicDataSet<T>* constraints = context_.constraints();
+  const int n_v = plant_.num_velocities();
+  const int n_l = constraints->countConstraintsWithoutSkipping();
+
+  multibody::setContext(plant_, x, u, context_.get());
+  constraints->updateData(*context_, VectorX<T>::Zero(n_l));
+  VectorX<T> xdot = constraints->getXDot();
+  if (constraints->countConstraints() == 0) {
+    return xdot;
+  }
+
+  // Unforced accelerations are vdot_0. With forces lambda on the non-skipped
+  // constraints, vdot = vdot_0 + M^{-1} J^T lambda, and lambda is chosen so
+  // that cddot = cddot_0 + J M^{-1} J^T lambda = 0
+  const MatrixX<T> map = constraints->getConstraintMap().template cast<T>();
+  const MatrixX<T> J = map * constraints->getJWithoutSkipping();
+  const VectorX<T> cddot = map * constraints->getCDDot();
+  MatrixX<T> M(n_v, n_v);
+  plant_.CalcMassMatrix(*context_, &M);
+  const MatrixX<T> MinvJT = M.llt().solve(J.transpose());
+  const VectorX<T> lambda = (J * MinvJT).ldlt().solve(-cddot);
+  xdot.tail(n_v) += MinvJT * lambda;
+  return xdot;
+}
+
+template <typename T>
+void ShootingDefectConstraint<T>::EvaluateConstraint(
+    const Eigen::Ref<const VectorX<T>>& x, VectorX<T>* y) const {
+  const T h = x(0);
+  const VectorX<T> x0 = x.segment(1, num_states_);
+  const VectorX<T> x1 = x.segment(1 + num_states_, num_states_);
+  const VectorX<T> u0 = x.segment(1 + 2 * num_states_, num_inputs_);
+  const VectorX<T> u1 =
+      x.segment(1 + 2 * num_states_ + num_inputs_, num_inputs_);
+
+  // Fixed step RK4, with the input linearly interpolated in phase s.
+  // The base quaternion is kept on the unit sphere by rotating it with the
+  // exponential map, using the stage angular velocities in place of the stage
+  // quaternion rates.
+  const int n_q = plant_.num_positions();
+  const T dt = h / num_substeps_;
+  auto input = [&](double s) -> VectorX<T> { return u0 + s * (u1 - u0); };
+  auto omega = [&](const VectorX<T>& x_s) -> Vector3<T> {
+    return x_s.template segment<3>(n_q);
+  };
+  auto advance = [&](const VectorX<T>& x_k, const T& a, const VectorX<T>& k_s,
+                     const Vector3<T>& w_s) -> VectorX<T> {
+    VectorX<T> x_next = x_k + a * k_s;
+    if (is_quaternion_) {
+      x_next.head(4) = multibody::IntegrateQuaternion<T>(x_k.head(4), a * w_s);
+    }
+    return x_next;
+  };
+  VectorX<T> x_k = x0;
+  for (int k = 0; k < num_substeps_; k++) {
+    const double s = static_cast<double>(k) / num_substeps_;
+    const double ds = 1.0 / num_substeps_;
+    const VectorX<T> k1 = CalcConstrainedDynamics(x_k, input(s));
+    const VectorX<T> x2 = advance(x_k, dt / 2, k1, omega(x_k));
+    const VectorX<T> k2 = CalcConstrainedDynamics(x2, input(s + ds / 2));
+    const VectorX<T> x3 = advance(x_k, dt / 2, k2, omega(x2));
+    const VectorX<T> k3 = CalcConstrainedDynamics(x3, input(s + ds / 2));
+    const VectorX<T> x4 = advance(x_k, dt, k3, omega(x3));
+    const VectorX<T> k4 = CalcConstrainedDynamics(x4, input(s + ds));
+    if (is_quaternion_) {
+      x_k = advance(x_k, dt, (k1 + 2 * k2 + 2 * k3 + k4) / 6,
+                    (omega(x_k) + 2 * omega(x2) + 2 * omega(x3) + omega(x4)) /
+                        6);
+    } else {
+      x_k += dt / 6 * (k1 + 2 * k2 + 2 * k3 + k4);
+    }
+  }
+  *y = x1 - x_k;
+}
+
+template <typename T>
+ModeShootingDefectConstraint<T>::ModeShootingDefectConstraint(
+    std::shared_ptr<ShootingDefectConstraint<T>> segment, int num_segments,
+    std::shared_ptr<WorkerPool> pool)
+    : Constraint(num_segments * segment->num_constraints(),
+                 num_segments + (num_segments + 1) *
+                                    (segment->num_states() +
+                                     segment->num_inputs()),
+                 VectorXd::Zero(num_segments * segment->num_constraints()),
+                 VectorXd::Zero(num_segments * segment->num_constraints()),
+                 "shooting_defect_constraint"),
+      segment_(segment),
+      num_segments_(num_segments),
+      pool_(pool) {
+  const int n_x = segment->num_states();
+  const int n_u = segment->num_inputs();
+  const int states_start = num_segments;
+  const int inputs_start = states_start + (num_segments + 1) * n_x;
+  std::vector<std::pair<int, int>> sparsity;
+  for (int j = 0; j < num_segments; j++) {
+    // {timestep, state j, state j + 1, input j, input j + 1}
+    std::vector<int> vars{j};
+    for (int k = 0; k < 2 * n_x; k++) {
+      vars.push_back(states_start + j * n_x + k);
+    }
+    for (int k = 0; k < 2 * n_u; k++) {
+      vars.push_back(inputs_start + j * n_u + k);
+    }
+    for (int row = 0; row < segment->num_constraints(); row++) {
+      for (int var : vars) {
+        sparsity.emplace_back(j * segment->num_constraints() + row, var);
+      }
+    }
+    segment_vars_.push_back(vars);
+  }
+  SetGradientSparsityPattern(sparsity);
+}
+
+template <typename T>
+void ModeShootingDefectConstraint<T>::ForEachSegment(
+    const std::function<void(int)>& segment_task) const {
+  if (pool_) {
+    pool_->ParallelFor(num_segments_, [&](int j, int) { segment_task(j); });
+  } else {
+    for (int j = 0; j < num_segments_; j++) {
+      segment_task(j);
+    }
+  }
+}
+
+template <typename T>
+void ModeShootingDefectConstraint<T>::DoEval(
+    const Eigen::Ref<const VectorXd>& x, VectorXd* y) const {
+  const int n_y = segment_->num_constraints();
+  y->resize(num_constraints());
+  // Each segment writes its own rows
+  ForEachSegment([&](int j) {
+    VectorXd x_j(segment_vars_[j].size());
+    for (int k = 0; k < x_j.size(); k++) {
+      x_j(k) = x(segment_vars_[j][k]);
+    }
+    VectorXd y_j;
+    segment_->Eval(x_j, &y_j);
+    y->segment(j * n_y, n_y) = y_j;
+  });
+}
+
+template <typename T>
+void ModeShootingDefectConstraint<T>::DoEval(
+    const Eigen::Ref<const AutoDiffVecXd>& x, AutoDiffVecXd* y) const {
+  const int n_y = segment_->num_constraints();
+  const VectorXd x_val = drake::math::autoDiffToValueMatrix(x);
+  const MatrixXd x_grad = drake::math::autoDiffToGradientMatrix(x);
+  // The solvers typically pass x with an identity gradient, in which case the
+  // segment gradients are copied rather than multiplied
+  const bool identity_grad =
+      x_grad.rows() == x_grad.cols() && x_grad.isIdentity(0);
+  VectorXd y_val(num_constraints());
+  MatrixXd y_grad = MatrixXd::Zero(num_constraints(), x_grad.cols());
+
+  // Each segment is differentiated with respect to its own variables only
+  ForEachSegment([&](int j) {
+    const std::vector<int>& vars = segment_vars_[j];
+    VectorXd x_j(vars.size());
+    for (int k = 0; k < x_j.size(); k++) {
+      x_j(k) = x_val(vars[k]);
+    }
+    AutoDiffVecXd y_j;
+    segment_->Eval(drake::math::initializeAutoDiff(x_j), &y_j);
+    y_val.segment(j * n_y, n_y) = drake::math::autoDiffToValueMatrix(y_j);
+    const MatrixXd dy_j = drake::math::autoDiffToGradientMatrix(y_j);
+    for (int k = 0; k < dy_j.cols(); k++) {
+      if (identity_grad) {
+        y_grad.block(j * n_y, vars[k], n_y, 1) += dy_j.col(k);
+      } else {
+        y_grad.middleRows(j * n_y, n_y) += dy_j.col(k) * x_grad.row(vars[k]);
+      }
+    }
+  });
+  drake::math::initializeAutoDiffGivenGradientMatrix(y_val, y_grad, *y);
+}
+
+template <typename T>
+void ModeShootingDefectConstraint<T>::DoEval(
+    const Eigen::Ref<const VectorX<drake::symbolic::Variable>>& x,
+    VectorX<drake::symbolic::Expression>* y) const {
+  throw std::logic_error(
+      "ModeShootingDefectConstraint does not support symbolic evaluation.");
+}
+
+template <typename T>
+HybridMultipleShooting<T>::HybridMultipleShooting(
+    const MultibodyPlant<T>& plant, vector<int> num_time_samples,
+    vector<double> minimum_timestep, vector<double> maximum_timestep,
+    vector<DirconKinematicDataSet<T>*> constraints,
+    vector<DirconOptions> options, int num_substeps, int num_threads)
+    : MultipleShooting(
+          plant.num_actuators(), plant.num_positions() + plant.num_velocities(),
+          std::accumulate(num_time_samples.begin(), num_time_samples.end(), 0) -
+              num_time_samples.size() + 1,
+          1e-8, 1e8),
+      plant_(plant),
+      constraints_(constraints),
+      num_modes_(num_time_samples.size()),
+      mode_lengths_(num_time_samples),
+      v_post_impact_vars_(NewContinuousVariables(
+          plant.num_velocities() * (num_time_samples.size() - 1), "v_p")) {
+  DRAKE_ASSERT(minimum_timestep.size() == num_modes_);
+  DRAKE_ASSERT(maximum_timestep.size() == num_modes_);
+  DRAKE_ASSERT(constraints.size() == num_modes_);
+  DRAKE_ASSERT(options.size() == num_modes_);
+
+  bool is_quaternion = multibody::isQuaternion(plant);
+  // One pool for the defects of all the modes, since the solver evaluates
+  // them one after the other
+  std::shared_ptr<WorkerPool> pool;
+  if (num_threads > 1) {
+    pool = std::make_shared<WorkerPool>(num_threads);
+  }
+
+  int counter = 0;
+  for (int i = 0; i < num_modes_; i++) {
+    mode_start_.push_back(counter);
+    const int n_lambda = constraints_[i]->countConstraintsWithoutSkipping();
+    num_kinematic_constraints_wo_skipping_.push_back(n_lambda);
+
+    force_vars_.push_back(NewContinuousVariables(
+        n_lambda * mode_lengths_[i], "lambda[" + std::to_string(i) + "]"));
+    offset_vars_.push_back(NewContinuousVariables(
+        options[i].getNumRelative(), "offset[" + std::to_string(i) + "]"));
+    if (i > 0) {
+      impulse_vars_.push_back(NewContinuousVariables(
+          n_lambda, "impulse[" + std::to_string(i) + "]"));
+    }
+
+    // Segment durations, equal within a mode
+    if (mode_lengths_[i] > 1) {
+      AddBoundingBoxConstraint(
+          minimum_timestep[i], maximum_timestep[i],
+          h_vars().segment(mode_start_[i], mode_lengths_[i] - 1));
+    }
+    if (mode_lengths_[i] > 2) {
+      MatrixXd A_equal_h =
+          MatrixXd::Zero(mode_lengths_[i] - 2, mode_lengths_[i] - 1);
+      for (int j = 0; j < mode_lengths_[i] - 2; j++) {
+        A_equal_h(j, j) = 1;
+        A_equal_h(j, j + 1) = -1;
+      }
+      AddLinearEqualityConstraint(
+          A_equal_h, VectorXd::Zero(mode_lengths_[i] - 2),
+          h_vars().segment(mode_start_[i], mode_lengths_[i] - 1));
+    }
+
+    // The integrator preserves the quaternion norm, so it only needs to be
+    // constrained at the very first knot
+    if (is_quaternion && i == 0) {
+      AddConstraint(std::make_shared<QuaternionNormConstraint<T>>(),
+                    state_vars_by_mode(0, 0).head(4));
+    }
+
+    // Shooting defects, integrated concurrently over the segments of the mode
+    if (mode_lengths_[i] > 1) {
+      const int num_segments = mode_lengths_[i] - 1;
+      auto segment_constraint = std::make_shared<ShootingDefectConstraint<T>>(
+          plant_, *constraints_[i], is_quaternion, num_substeps);
+      segment_constraint->SetConstraintScaling(
+          options[i].getDynConstraintScaling());
+      VectorXDecisionVariable mode_states(mode_lengths_[i] * num_states());
+      for (int j = 0; j < mode_lengths_[i]; j++) {
+        mode_states.segment(j * num_states(), num_states()) =
+            state_vars_by_mode(i, j);
+      }
+      AddConstraint(
+          std::make_shared<ModeShootingDefectConstraint<T>>(
+              segment_constraint, num_segments, pool),
+          {h_vars().segment(mode_start_[i], num_segments), mode_states,
+           u_vars().segment(mode_start_[i] * num_inputs(),
+                            mode_lengths_[i] * num_inputs())});
+    }
+
+    // Kinematic constraints at the knot points, as in HybridDircon
+    auto kinematic_constraint = std::make_shared<DirconKinematicConstraint<T>>(
+        plant_, *constraints_[i], options[i].getConstraintsRelative());
+    kinematic_constraint->SetConstraintScaling(
+        options[i].getKinConstraintScaling());
+    auto kinematic_constraint_start =
+        std::make_shared<DirconKinematicConstraint<T>>(
+            plant_, *constraints_[i], options[i].getConstraintsRelative(),
+            options[i].getStartType());
+    kinematic_constraint_start->SetConstraintScaling(
+        options[i].getKinConstraintScalingStart());
+    auto kinematic_constraint_end =
+        std::make_shared<DirconKinematicConstraint<T>>(
+            plant_, *constraints_[i], options[i].getConstraintsRelative(),
+            options[i].getEndType());
+    kinematic_constraint_end->SetConstraintScaling(
+        options[i].getKinConstraintScalingEnd());
+    for (int j = 0; j < mode_lengths_[i]; j++) {
+      auto constraint = kinematic_constraint;
+      if (j == 0) {
+        constraint = kinematic_constraint_start;
+      } else if (j == mode_lengths_[i] - 1) {
+        constraint = kinematic_constraint_end;
+      }
+      AddConstraint(constraint,
+                    {state_vars_by_mode(i, j), input(mode_start_[i] + j),
+                     force(i, j), offset_vars(i)});
+    }
+
+    // Constraints on the forces (e.g. friction cones)
+    for (int l = 0; l < mode_lengths_[i]; l++) {
+      int start_index = l * n_lambda;
+      for (int j = 0; j < constraints_[i]->getNumConstraintObjects(); j++) {
+        DirconKinematicData<T>* constraint_j =
+            constraints_[i]->getConstraint(j);
+        for (int k = 0; k < constraint_j->numForceConstraints(); k++) {
+          AddConstraint(
+              constraint_j->getForceConstraint(k),
+              force_vars(i).segment(start_index, constraint_j->getLength()));
+        }
+        start_index += constraint_j->getLength();
+      }
+    }
+
+    if (options[i].getForceCost() != 0 && n_lambda > 0) {
+      auto force_cost = std::make_shared<drake::solvers::QuadraticCost>(
+          2 * options[i].getForceCost() * options[i].getForceCost() *
+              MatrixXd::Identity(n_lambda, n_lambda),
+          VectorXd::Zero(n_lambda));
+      for (int j = 0; j < mode_lengths_[i]; j++) {
+        AddCost(force_cost, force(i, j));
+      }
+    }
+
+    if (i > 0) {
+      if (n_lambda > 0) {
+        auto impact_constraint = std::make_shared<DirconImpactConstraint<T>>(
+            plant_, *constraints_[i]);
+        impact_constraint->SetConstraintScaling(
+            options[i].getImpConstraintScaling());
+        AddConstraint(impact_constraint,
+                      {state_vars_by_mode(i - 1, mode_lengths_[i - 1] - 1),
+                       impulse_vars(i - 1), v_post_impact_vars_by_mode(i - 1)});
+
+        int start_index = 0;
+        for (int j = 0; j < constraints_[i]->getNumConstraintObjects(); j++) {
+          DirconKinematicData<T>* constraint_j =
+              constraints_[i]->getConstraint(j);
+          for (int k = 0; k < constraint_j->numForceConstraints(); k++) {
+            AddConstraint(constraint_j->getForceConstraint(k),
+                          impulse_vars(i - 1).segment(
+                              start_index, constraint_j->getLength()));
+          }
+          start_index += constraint_j->getLength();
+        }
+      } else {
+        auto x_vars_prev = state_vars_by_mode(i - 1, mode_lengths_[i - 1] - 1);
+        AddConstraint(v_post_impact_vars_by_mode(i - 1) ==
+                      x_vars_prev.tail(plant.num_velocities()));
+      }
+    }
+
+    counter += mode_lengths_[i] - 1;
+  }
+}
+
+template <typename T>
+const Eigen::VectorBlock<const VectorXDecisionVariable>
+HybridMultipleShooting<T>::v_post_impact_vars_by_mode(int mode) const {
+  return v_post_impact_vars_.segment(mode * plant_.num_velocities(),
+                                     plant_.num_velocities());
+}
+
+template <typename T>
+VectorXDecisionVariable HybridMultipleShooting<T>::state_vars_by_mode(
+    int mode, int time_index) const {
+  if (time_index == 0 && mode > 0) {
+    VectorXDecisionVariable ret(num_states());
+    ret << x_vars().segment(mode_start_[mode] * num_states(),
+                            plant_.num_positions()),
+        v_post_impact_vars_by_mode(mode - 1);
+    return ret;
+  }
+  return x_vars().segment((mode_start_[mode] + time_index) * num_states(),
+                          num_states());
+}
+
+template <typename T>
+void HybridMultipleShooting<T>::DoAddRunningCost(
+    const drake::symbolic::Expression& g) {
+  // Trapezoidal integration, as in HybridDircon
+  AddCost(MultipleShooting::SubstitutePlaceholderVariables(g, 0) * h_vars()(0) /
+          2);
+  for (int i = 1; i <= N() - 2; i++) {
+    AddCost(MultipleShooting::SubstitutePlaceholderVariables(g, i) *
+            (h_vars()(i - 1) + h_vars()(i)) / 2);
+  }
+  AddCost(MultipleShooting::SubstitutePlaceholderVariables(g, N() - 1) *
+          h_vars()(N() - 2) / 2);
+}
+
+template <typename T>
+PiecewisePolynomial<double>
+HybridMultipleShooting<T>::ReconstructInputTrajectory(
+    const MathematicalProgramResult& result) const {
+  Eigen::VectorXd times = GetSampleTimes(result);
+  vector<double> times_vec(N());
+  vector<Eigen::MatrixXd> inputs(N());
+  for (int i = 0; i < N(); i++) {
+    times_vec[i] = times(i);
+    inputs[i] = result.GetSolution(input(i));
+  }
+  return PiecewisePolynomial<double>::FirstOrderHold(times_vec, inputs);
+}
+
+template <typename T>
+PiecewisePolynomial<double>
+HybridMultipleShooting<T>::ReconstructStateTrajectory(
+    const MathematicalProgramResult& result) const {
+  VectorXd times_all(GetSampleTimes(result));
+  VectorXd times(N() + num_modes_ - 1);
+  MatrixXd states(num_states(), N() + num_modes_ - 1);
+  MatrixXd derivatives(num_states(), N() + num_modes_ - 1);
+
+  for (int i = 0; i < num_modes_; i++) {
+    for (int j = 0; j < mode_lengths_[i]; j++) {
+      int k = mode_start_[i] + j + i;
+      int k_data = mode_start_[i] + j;
+      times(k) = times_all(k_data);
+
+      // False timestep to match velocities
+      if (i > 0 && j == 0) {
+        times(k) += +1e-6;
+      }
+      VectorX<T> xk = result.GetSolution(state_vars_by_mode(i, j));
+      VectorX<T> uk = result.GetSolution(input(k_data));
+      states.col(k) = drake::math::DiscardGradient(xk);
+      auto context = multibody::createContext(plant_, xk, uk);
+      constraints_[i]->updateData(*context, result.GetSolution(force(i, j)));
+      derivatives.col(k) =
+          drake::math::DiscardGradient(constraints_[i]->getXDot());
+    }
+  }
+  return PiecewisePolynomial<double>::CubicHermite(times, states, derivatives);
+}
+
+template <typename T>
+void HybridMultipleShooting<T>::SetInitialForceTrajectory(
+    int mode, const PiecewisePolynomial<double>& traj_init_l) {
+  double h;
+  if (timesteps_are_decision_variables())
+    h = GetInitialGuess(h_vars()[0]);
+  else
+    h = fixed_timestep();
+
+  VectorXd guess_force(force_vars_[mode].size());
+  if (traj_init_l.empty()) {
+    guess_force.fill(0);  // Start with 0
+  } else {
+    for (int i = 0; i < mode_lengths_[mode]; ++i) {
+      guess_force.segment(num_kinematic_constraints_wo_skipping_[mode] * i,
+                          num_kinematic_constraints_wo_skipping_[mode]) =
+          traj_init_l.value(i * h);
+    }
+  }
+  SetInitialGuess(force_vars_[mode], guess_force);
+}
+
+template class ShootingDefectConstraint<double>;
+template class ShootingDefectConstraint<AutoDiffXd>;
+template class ModeShootingDefectConstraint<double>;
+template class ModeShootingDefectConstraint<AutoDiffXd>;
+template class HybridMultipleShooting<double>;
+template class HybridMultipleShooting<AutoDiffXd>;
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
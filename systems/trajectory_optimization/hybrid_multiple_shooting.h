@@ -0,0 +1,217 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <memory.h>
+
+#include "drake/common/drake_copyable.h"
+#include "drake/common/symbolic.h"
+#include "drake/common/trajectories/piecewise_polynomial.h"
+#include "drake/solvers/constraint.h"
+#include "drake/systems/trajectory_optimization/multiple_shooting.h"
+
+#include "common/worker_pool.h"
+#include "solvers/nonlinear_constraint.h"
+#include "systems/trajectory_optimization/dircon_kinematic_data_set.h"
+#include "systems/trajectory_optimization/dircon_opt_constraints.h"
+#include "systems/trajectory_optimization/dircon_options.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+/// Defect of one multiple shooting segment, x1 - Phi(h, x0, u0, u1), where Phi
+/// integrates the constrained dynamics over the timestep h with num_substeps
+/// fixed RK4 steps and a first-order hold on the input.
+///
+/// The constraint forces are the ones which keep the accelerations of the
+/// (non-skipped) kinematic constraints at zero, so they are not decision
+/// variables of the segment. A quaternion floating base is integrated with the
+/// exponential map (see quaternion_integration.h) and stays on the unit sphere.
+///
+/// Each evaluating thread uses its own plant context and copy of the kinematic
+/// data set (see PerThreadContext), so segments can be evaluated concurrently.
+template <typename T>
+class ShootingDefectConstraint : public solvers::NonlinearConstraint<T> {
+ public:
+  ShootingDefectConstraint(const drake::multibody::MultibodyPlant<T>& plant,
+                           DirconKinematicDataSet<T>& constraints,
+                           bool is_quaternion, int num_substeps);
+
+  ~ShootingDefectConstraint() override = default;
+
+  int num_states() const { return num_states_; }
+  int num_inputs() const { return num_inputs_; }
+
+  /// The input is {timestep, state 0, state 1, input 0, input 1}
+  void EvaluateConstraint(const Eigen::Ref<const drake::VectorX<T>>& x,
+                          drake::VectorX<T>* y) const override;
+
+  /// Time derivative of the state under the constrained dynamics
+  drake::VectorX<T> CalcConstrainedDynamics(const drake::VectorX<T>& x,
+                                            const drake::VectorX<T>& u) const;
+
+ private:
+  const drake::multibody::MultibodyPlant<T>& plant_;
+  const int num_states_;
+  const int num_inputs_;
+  const bool is_quaternion_;
+  const int num_substeps_;
+  PerThreadContext<T> context_;
+};
+
+/// Defects of all the segments of a mode, evaluated concurrently on a
+/// WorkerPool. Row block j is the (scaled) output of the segment evaluator on
+/// segment j, and its gradient only depends on the variables of that segment.
+///
+/// The input is {timesteps, states, inputs} of the mode, with num_segments
+/// timesteps and num_segments + 1 states and inputs.
+template <typename T>
+class ModeShootingDefectConstraint : public drake::solvers::Constraint {
+ public:
+  /// @param segment evaluator of one segment
+  /// @param pool threads evaluating the segments, or null to evaluate them on
+  /// the calling thread
+  ModeShootingDefectConstraint(
+      std::shared_ptr<ShootingDefectConstraint<T>> segment, int num_segments,
+      std::shared_ptr<WorkerPool> pool);
+
+  ~ModeShootingDefectConstraint() override = default;
+
+ private:
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x,
+              Eigen::VectorXd* y) const override;
+
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override;
+
+  void DoEval(
+      const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>&,
+      drake::VectorX<drake::symbolic::Expression>*) const override;
+
+  // Runs segment_task(j) for every segment
+  void ForEachSegment(const std::function<void(int)>& segment_task) const;
+
+  const std::shared_ptr<ShootingDefectConstraint<T>> segment_;
+  const int num_segments_;
+  const std::shared_ptr<WorkerPool> pool_;
+  // Indices of the variables of each segment in the input, in the order of
+  // the segment evaluator
+  std::vector<std::vector<int>> segment_vars_;
+};
+
+/// Multiple shooting counterpart of HybridDircon for long-horizon problems.
+///
+/// Uses the same mode sequences, DirconKinematicDataSet and DirconOptions as
+/// HybridDircon, but each mode is split into num_time_samples[i] - 1 segments
+/// which are integrated by ShootingDefectConstraint instead of being
+/// collocated. There are no collocation forces, collocation slack or
+/// quaternion slack variables, so the program is smaller and segments can be
+/// much longer than DIRCON intervals.
+///
+/// The forces at the knot points are kept as decision variables and subject to
+/// the same kinematic, friction cone and impact constraints as in HybridDircon,
+/// which ties them to the forces of the integrated dynamics.
+///
+/// With T = AutoDiffXd, the defect gradients are the sensitivities obtained by
+/// differentiating through the integrator (the discrete variational
+/// equations). With T = double they are finite differenced.
+///
+/// The defects of a mode are one ModeShootingDefectConstraint, which
+/// integrates its segments on num_threads threads.
+template <typename T>
+class HybridMultipleShooting
+    : public drake::systems::trajectory_optimization::MultipleShooting {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(HybridMultipleShooting)
+
+  /// @param plant The MultibodyPlant describing the plant and kinematics
+  /// @param num_time_samples The number of knot points in each mode
+  /// @param minimum_timestep Minimum segment duration, per mode
+  /// @param maximum_timestep Maximum segment duration, per mode
+  /// @param constraints The set of kinematic constraints of each mode
+  /// @param options (see DirconOptions)
+  /// @param num_substeps The number of RK4 steps per segment
+  /// @param num_threads The number of threads integrating the segments
+  HybridMultipleShooting(const drake::multibody::MultibodyPlant<T>& plant,
+                         std::vector<int> num_time_samples,
+                         std::vector<double> minimum_timestep,
+                         std::vector<double> maximum_timestep,
+                         std::vector<DirconKinematicDataSet<T>*> constraints,
+                         std::vector<DirconOptions> options,
+                         int num_substeps = 4, int num_threads = 1);
+
+  ~HybridMultipleShooting() override {}
+
+  drake::trajectories::PiecewisePolynomial<double> ReconstructInputTrajectory(
+      const drake::solvers::MathematicalProgramResult& result) const override;
+
+  drake::trajectories::PiecewisePolynomial<double> ReconstructStateTrajectory(
+      const drake::solvers::MathematicalProgramResult& result) const override;
+
+  /// Set the initial guess for the force variables for a specific mode
+  /// @param mode the mode index
+  /// @param traj_init_l contact forces lambda (interpreted at knot points)
+  void SetInitialForceTrajectory(
+      int mode,
+      const drake::trajectories::PiecewisePolynomial<double>& traj_init_l);
+
+  int num_modes() const { return num_modes_; }
+
+  int mode_length(int mode) const { return mode_lengths_[mode]; }
+
+  int num_kinematic_constraints_wo_skipping(int mode) const {
+    return num_kinematic_constraints_wo_skipping_[mode];
+  }
+
+  const drake::solvers::VectorXDecisionVariable& force_vars(int mode) const {
+    return force_vars_[mode];
+  }
+
+  const drake::solvers::VectorXDecisionVariable& offset_vars(int mode) const {
+    return offset_vars_[mode];
+  }
+
+  const drake::solvers::VectorXDecisionVariable& v_post_impact_vars() const {
+    return v_post_impact_vars_;
+  }
+
+  const drake::solvers::VectorXDecisionVariable& impulse_vars(int mode) const {
+    return impulse_vars_[mode];
+  }
+
+  const Eigen::VectorBlock<const drake::solvers::VectorXDecisionVariable>
+  v_post_impact_vars_by_mode(int mode) const;
+
+  /// See HybridDircon::state_vars_by_mode
+  drake::solvers::VectorXDecisionVariable state_vars_by_mode(
+      int mode, int time_index) const;
+
+  Eigen::VectorBlock<const drake::solvers::VectorXDecisionVariable> force(
+      int mode, int index) const {
+    DRAKE_DEMAND(index < mode_lengths_[mode]);
+    return force_vars_[mode].segment(
+        index * num_kinematic_constraints_wo_skipping_[mode],
+        num_kinematic_constraints_wo_skipping_[mode]);
+  }
+
+ private:
+  // Implements a running cost at all timesteps using trapezoidal integration.
+  void DoAddRunningCost(const drake::symbolic::Expression& e) override;
+
+  const drake::multibody::MultibodyPlant<T>& plant_;
+  std::vector<DirconKinematicDataSet<T>*> constraints_;
+  const int num_modes_;
+  const std::vector<int> mode_lengths_;
+  std::vector<int> mode_start_;
+  const drake::solvers::VectorXDecisionVariable v_post_impact_vars_;
+  std::vector<drake::solvers::VectorXDecisionVariable> force_vars_;
+  std::vector<drake::solvers::VectorXDecisionVariable> offset_vars_;
+  std::vector<drake::solvers::VectorXDecisionVariable> impulse_vars_;
+  std::vector<int> num_kinematic_constraints_wo_skipping_;
+};
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,134 @@
+#include "systems/trajectory_optimization/dircon_opt_constraints.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "systems/trajectory_optimization/dircon_distance_data.h"
+#include "systems/trajectory_optimization/dircon_kinematic_data_set.h"
+
+#include "drake/common/find_resource.h"
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/multibody/parsing/parser.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using drake::CompareMatrices;
+using drake::multibody::MultibodyPlant;
+using drake::systems::Context;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+using std::vector;
+
+// The constrained acrobot of passive_constrained_pendulum_dircon.cc
+class DirconOptConstraintsTest : public ::testing::Test {
+ protected:
+  DirconOptConstraintsTest() : plant_(0.0) {
+    drake::multibody::Parser parser(&plant_);
+    parser.AddModelFromFile(
+        drake::FindResourceOrThrow("drake/examples/acrobot/Acrobot.urdf"));
+    plant_.WeldFrames(plant_.world_frame(), plant_.GetFrameByName("base_link"),
+                      drake::math::RigidTransform<double>());
+    plant_.Finalize();
+
+    distance_ = std::make_unique<DirconDistanceData<double>>(
+        plant_, plant_.GetBodyByName("base_link"), Vector3d::Zero(),
+        plant_.GetBodyByName("lower_link"), Vector3d(-1, 0, 0), 0.7);
+    constraints_ = {distance_.get()};
+    constraint_set_ = std::make_unique<DirconKinematicDataSet<double>>(
+        plant_, &constraints_);
+  }
+
+  MultibodyPlant<double> plant_;
+  std::unique_ptr<DirconDistanceData<double>> distance_;
+  vector<DirconKinematicData<double>*> constraints_;
+  std::unique_ptr<DirconKinematicDataSet<double>> constraint_set_;
+};
+
+TEST_F(DirconOptConstraintsTest, CloneMatchesOriginal) {
+  auto clone = constraint_set_->Clone();
+  EXPECT_EQ(clone->countConstraints(), constraint_set_->countConstraints());
+  EXPECT_NE(clone->getConstraint(0), constraint_set_->getConstraint(0));
+
+  auto context = plant_.CreateDefaultContext();
+  plant_.SetPositionsAndVelocities(context.get(),
+                                   VectorXd::LinSpaced(4, 0.3, 1.2));
+  const VectorXd force = VectorXd::Constant(1, 0.5);
+  constraint_set_->updateData(*context, force);
+  clone->updateData(*context, force);
+  EXPECT_TRUE(CompareMatrices(clone->getC(), constraint_set_->getC()));
+  EXPECT_TRUE(CompareMatrices(clone->getJ(), constraint_set_->getJ()));
+  EXPECT_TRUE(CompareMatrices(clone->getXDot(), constraint_set_->getXDot()));
+}
+
+TEST_F(DirconOptConstraintsTest, PerThreadContext) {
+  PerThreadContext<double> context(plant_, constraint_set_.get());
+  // Nothing is allocated until a thread uses it
+  EXPECT_EQ(context.num_threads(), 0);
+
+  Context<double>* main_context = context.get();
+  DirconKinematicDataSet<double>* main_constraints = context.constraints();
+  EXPECT_EQ(context.get(), main_context);
+  EXPECT_EQ(&*context, main_context);
+  EXPECT_EQ(context.constraints(), main_constraints);
+  EXPECT_NE(main_constraints, constraint_set_.get());
+  EXPECT_EQ(context.num_threads(), 1);
+
+  Context<double>* other_context = nullptr;
+  DirconKinematicDataSet<double>* other_constraints = nullptr;
+  std::thread thread([&] {
+    other_context = context.get();
+    other_constraints = context.constraints();
+  });
+  thread.join();
+  EXPECT_NE(other_context, main_context);
+  EXPECT_NE(other_constraints, main_constraints);
+  EXPECT_EQ(context.num_threads(), 2);
+
+  // Without kinematic constraints
+  PerThreadContext<double> plant_only(plant_);
+  EXPECT_NE(plant_only.get(), nullptr);
+  EXPECT_EQ(plant_only.constraints(), nullptr);
+}
+
+TEST_F(DirconOptConstraintsTest, ConcurrentEvaluation) {
+  DirconKinematicConstraint<double> constraint(plant_, *constraint_set_);
+  const int num_points = 64;
+  vector<VectorXd> x(num_points);
+  vector<VectorXd> expected(num_points);
+  for (int i = 0; i < num_points; i++) {
+    x[i] = VectorXd::Random(constraint.num_vars());
+    constraint.Eval(x[i], &expected[i]);
+  }
+
+  // Each thread updates its own kinematic data, so the values match the
+  // sequential ones
+  const int num_threads = 4;
+  vector<VectorXd> y(num_points);
+  vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int repeat = 0; repeat < 10; repeat++) {
+        for (int i = t; i < num_points; i += num_threads) {
+          constraint.Eval(x[i], &y[i]);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < num_points; i++) {
+    EXPECT_TRUE(CompareMatrices(y[i], expected[i]));
+  }
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
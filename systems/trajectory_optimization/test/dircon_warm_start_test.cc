@@ -0,0 +1,148 @@
+#include "systems/trajectory_optimization/dircon_warm_start.h"
+
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "systems/trajectory_optimization/dircon_distance_data.h"
+#include "systems/trajectory_optimization/dircon_kinematic_data_set.h"
+
+#include "drake/common/find_resource.h"
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/multibody/parsing/parser.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using drake::CompareMatrices;
+using drake::multibody::MultibodyPlant;
+using drake::solvers::MathematicalProgramResult;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+using std::string;
+using std::vector;
+
+// The passive pendulum of passive_constrained_pendulum_dircon.cc, with a few
+// knot points
+class DirconWarmStartTest : public ::testing::Test {
+ protected:
+  DirconWarmStartTest() : plant_(0.0) {
+    drake::multibody::Parser parser(&plant_);
+    parser.AddModelFromFile(
+        drake::FindResourceOrThrow("drake/examples/acrobot/Acrobot.urdf"));
+    plant_.WeldFrames(plant_.world_frame(), plant_.GetFrameByName("base_link"),
+                      drake::math::RigidTransform<double>());
+    plant_.Finalize();
+
+    distance_ = std::make_unique<DirconDistanceData<double>>(
+        plant_, plant_.GetBodyByName("base_link"), Vector3d::Zero(),
+        plant_.GetBodyByName("lower_link"), Vector3d(-1, 0, 0), 0.7);
+    constraints_ = {distance_.get()};
+    constraint_set_ = std::make_unique<DirconKinematicDataSet<double>>(
+        plant_, &constraints_);
+    trajopt_ = std::make_unique<HybridDircon<double>>(
+        plant_, vector<int>{5}, vector<double>{0.1}, vector<double>{0.1},
+        vector<DirconKinematicDataSet<double>*>{constraint_set_.get()},
+        vector<DirconOptions>{DirconOptions(1)});
+
+    filepath_ = ::testing::TempDir() + "/dircon_warm_start.bin";
+    std::remove(filepath_.c_str());
+  }
+
+  ~DirconWarmStartTest() override { std::remove(filepath_.c_str()); }
+
+  DirconProblemKey Key(double stride_length,
+                       const string& mode_sequence = "swing") const {
+    return {mode_sequence, {5}, {"stride_length"},
+            VectorXd::Constant(1, stride_length)};
+  }
+
+  // A result whose decision variables are all value
+  MathematicalProgramResult Result(double value) const {
+    MathematicalProgramResult result;
+    result.set_decision_variable_index(trajopt_->decision_variable_index());
+    result.set_x_val(VectorXd::Constant(trajopt_->num_vars(), value));
+    return result;
+  }
+
+  MultibodyPlant<double> plant_;
+  std::unique_ptr<DirconDistanceData<double>> distance_;
+  vector<DirconKinematicData<double>*> constraints_;
+  std::unique_ptr<DirconKinematicDataSet<double>> constraint_set_;
+  std::unique_ptr<HybridDircon<double>> trajopt_;
+  string filepath_;
+};
+
+TEST_F(DirconWarmStartTest, FindNearest) {
+  DirconWarmStartLibrary library(filepath_);
+  EXPECT_EQ(library.size(), 0);
+  EXPECT_FALSE(library.SetInitialGuess(Key(0.2), trajopt_.get()));
+
+  library.Add(Key(0.1), *trajopt_, Result(1));
+  library.Add(Key(0.2), *trajopt_, Result(2));
+  library.Add(Key(0.4), *trajopt_, Result(4));
+  EXPECT_EQ(library.size(), 3);
+
+  const auto neighbors = library.FindNearest(Key(0.25), 2);
+  ASSERT_EQ(neighbors.size(), 2u);
+  EXPECT_NEAR(neighbors[0].second, 0.05, 1e-12);
+  EXPECT_NEAR(neighbors[1].second, 0.15, 1e-12);
+  EXPECT_NE(neighbors[0].first, neighbors[1].first);
+
+  // Only the same mode sequence and parameter names are compatible
+  EXPECT_TRUE(library.FindNearest(Key(0.2, "stance"), 2).empty());
+  DirconProblemKey other_parameters = Key(0.2);
+  other_parameters.parameter_names = {"speed"};
+  EXPECT_TRUE(library.FindNearest(other_parameters, 2).empty());
+
+  // An exact match is used as is
+  ASSERT_TRUE(library.SetInitialGuess(Key(0.2), trajopt_.get()));
+  EXPECT_TRUE(CompareMatrices(trajopt_->initial_guess(),
+                              VectorXd::Constant(trajopt_->num_vars(), 2)));
+
+  // Otherwise, the neighbors are blended with inverse distance weights
+  ASSERT_TRUE(library.SetInitialGuess(Key(0.25), trajopt_.get()));
+  EXPECT_TRUE(CompareMatrices(
+      trajopt_->initial_guess(),
+      VectorXd::Constant(trajopt_->num_vars(), 0.75 * 2 + 0.25 * 1), 1e-12));
+}
+
+TEST_F(DirconWarmStartTest, SaveAndLoad) {
+  {
+    DirconWarmStartLibrary library(filepath_);
+    library.Add(Key(0.1), *trajopt_, Result(1));
+  }
+  // Two runs that append to the same library, with the same key
+  DirconWarmStartLibrary first(filepath_);
+  DirconWarmStartLibrary second(filepath_);
+  first.Add(Key(0.3), *trajopt_, Result(3));
+  second.Add(Key(0.3), *trajopt_, Result(3));
+
+  DirconWarmStartLibrary loaded(filepath_);
+  ASSERT_EQ(loaded.size(), 3);
+  const auto neighbors = loaded.FindNearest(Key(0.3), 3);
+  ASSERT_EQ(neighbors.size(), 3u);
+  std::set<string> names;
+  for (const auto& neighbor : neighbors) {
+    names.insert(neighbor.first);
+    EXPECT_EQ(neighbor.first.rfind("swing_", 0), 0u);
+  }
+  EXPECT_EQ(names.size(), 3u);
+  EXPECT_EQ(neighbors[0].second, 0);
+  EXPECT_EQ(neighbors[1].second, 0);
+
+  ASSERT_TRUE(loaded.SetInitialGuess(Key(0.1), trajopt_.get(), 1));
+  EXPECT_TRUE(CompareMatrices(trajopt_->initial_guess(),
+                              VectorXd::Constant(trajopt_->num_vars(), 1)));
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,228 @@
+#include "systems/trajectory_optimization/hybrid_multiple_shooting.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "systems/trajectory_optimization/dircon_distance_data.h"
+#include "systems/trajectory_optimization/dircon_kinematic_data_set.h"
+
+#include "drake/common/find_resource.h"
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/math/autodiff.h"
+#include "drake/math/autodiff_gradient.h"
+#include "drake/multibody/parsing/parser.h"
+#include "drake/systems/analysis/runge_kutta2_integrator.h"
+#include "drake/systems/analysis/simulator.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using drake::AutoDiffVecXd;
+using drake::CompareMatrices;
+using drake::multibody::MultibodyPlant;
+using drake::multibody::SpatialInertia;
+using drake::multibody::UnitInertia;
+using Eigen::MatrixXd;
+using Eigen::Quaterniond;
+using Eigen::Vector3d;
+using Eigen::Vector4d;
+using Eigen::VectorXd;
+using std::vector;
+
+// Input of ShootingDefectConstraint for a plant without actuators
+VectorXd SegmentInput(double h, const VectorXd& x0, const VectorXd& x1) {
+  VectorXd x(1 + x0.size() + x1.size());
+  x << h, x0, x1;
+  return x;
+}
+
+std::unique_ptr<MultibodyPlant<double>> MakeAcrobot() {
+  auto plant = std::make_unique<MultibodyPlant<double>>(0.0);
+  drake::multibody::Parser parser(plant.get());
+  parser.AddModelFromFile(
+      drake::FindResourceOrThrow("drake/examples/acrobot/Acrobot.urdf"));
+  plant->WeldFrames(plant->world_frame(), plant->GetFrameByName("base_link"),
+                    drake::math::RigidTransform<double>());
+  plant->Finalize();
+  return plant;
+}
+
+// A free sphere spins at a constant angular velocity and falls, which RK4 and
+// the exponential map integrate exactly
+TEST(ShootingDefectConstraintTest, FreeSphereMatchesAnalytic) {
+  MultibodyPlant<double> plant(0.0);
+  plant.AddRigidBody("base",
+                     SpatialInertia<double>(2.0, Vector3d::Zero(),
+                                            UnitInertia<double>::SolidSphere(
+                                                0.3)));
+  plant.Finalize();
+  vector<DirconKinematicData<double>*> no_constraints;
+  DirconKinematicDataSet<double> constraint_set(plant, &no_constraints);
+  ShootingDefectConstraint<double> defect(plant, constraint_set, true, 3);
+
+  const double h = 0.3;
+  const Vector4d q0 = Vector4d(1, 0.2, -0.3, 0.1).normalized();
+  const Vector3d p0(0.1, 0.2, 1);
+  const Vector3d w(1, -2, 3);
+  const Vector3d v0(0.5, 0, 1);
+  const Vector3d g = plant.gravity_field().gravity_vector();
+  const Quaterniond q1 =
+      Quaterniond(Eigen::AngleAxisd(h * w.norm(), w.normalized())) *
+      Quaterniond(q0(0), q0(1), q0(2), q0(3));
+  VectorXd x0(13), x1(13);
+  x0 << q0, p0, w, v0;
+  x1 << q1.w(), q1.x(), q1.y(), q1.z(), p0 + h * v0 + 0.5 * h * h * g, w,
+      v0 + h * g;
+
+  VectorXd y;
+  defect.Eval(SegmentInput(h, x0, x1), &y);
+  EXPECT_TRUE(CompareMatrices(y, VectorXd::Zero(13), 1e-12));
+}
+
+// With an asymmetric inertia the angular velocity varies, and the integrated
+// quaternion still has a unit norm
+TEST(ShootingDefectConstraintTest, QuaternionNorm) {
+  MultibodyPlant<double> plant(0.0);
+  plant.AddRigidBody("base",
+                     SpatialInertia<double>(2.0, Vector3d::Zero(),
+                                            UnitInertia<double>::SolidBox(
+                                                0.1, 0.4, 0.9)));
+  plant.Finalize();
+  vector<DirconKinematicData<double>*> no_constraints;
+  DirconKinematicDataSet<double> constraint_set(plant, &no_constraints);
+
+  VectorXd x0(13);
+  x0 << Vector4d(0.3, -0.5, 0.7, 0.1).normalized(), 0, 0, 1, 4, -6, 5, 0, 0,
+      0;
+  for (int num_substeps : {1, 4}) {
+    ShootingDefectConstraint<double> defect(plant, constraint_set, true,
+                                            num_substeps);
+    VectorXd y;
+    defect.Eval(SegmentInput(0.5, x0, x0), &y);
+    // The defect is x1 - Phi(h, x0), and x1 = x0
+    const VectorXd x_h = x0 - y;
+    EXPECT_NEAR(x_h.head(4).norm(), 1, 1e-12);
+    EXPECT_GT((x_h.head(4) - x0.head(4)).norm(), 0.1);
+  }
+}
+
+// The defect of the unconstrained acrobot against a fine simulation
+TEST(ShootingDefectConstraintTest, AcrobotMatchesSimulation) {
+  auto plant = MakeAcrobot();
+  vector<DirconKinematicData<double>*> no_constraints;
+  DirconKinematicDataSet<double> constraint_set(*plant, &no_constraints);
+
+  const double h = 0.2;
+  const VectorXd x0 = Eigen::Vector4d(0.4, -0.3, 1.5, -2);
+  const VectorXd u = VectorXd::Constant(1, 0.5);
+  drake::systems::Simulator<double> simulator(*plant);
+  plant->SetPositionsAndVelocities(&simulator.get_mutable_context(), x0);
+  plant->get_actuation_input_port().FixValue(&simulator.get_mutable_context(),
+                                             u);
+  simulator.reset_integrator<drake::systems::RungeKutta2Integrator<double>>(
+      1e-5);
+  simulator.AdvanceTo(h);
+  const VectorXd x1 =
+      plant->GetPositionsAndVelocities(simulator.get_context());
+
+  VectorXd x(1 + 2 * 4 + 2);
+  x << h, x0, x1, u, u;
+  VectorXd y_coarse, y_fine;
+  ShootingDefectConstraint<double>(*plant, constraint_set, false, 1)
+      .Eval(x, &y_coarse);
+  ShootingDefectConstraint<double>(*plant, constraint_set, false, 10)
+      .Eval(x, &y_fine);
+  EXPECT_LT(y_fine.norm(), 1e-6);
+  EXPECT_LT(y_fine.norm(), y_coarse.norm());
+}
+
+// The closed acrobot of passive_constrained_pendulum_dircon.cc
+class ModeShootingDefectConstraintTest : public ::testing::Test {
+ protected:
+  ModeShootingDefectConstraintTest() : plant_(MakeAcrobot()) {
+    distance_ = std::make_unique<DirconDistanceData<double>>(
+        *plant_, plant_->GetBodyByName("base_link"), Vector3d::Zero(),
+        plant_->GetBodyByName("lower_link"), Vector3d(-1, 0, 0), 0.7);
+    constraints_ = {distance_.get()};
+    constraint_set_ = std::make_unique<DirconKinematicDataSet<double>>(
+        *plant_, &constraints_);
+    segment_ = std::make_shared<ShootingDefectConstraint<double>>(
+        *plant_, *constraint_set_, false, 2);
+  }
+
+  std::unique_ptr<MultibodyPlant<double>> plant_;
+  std::unique_ptr<DirconDistanceData<double>> distance_;
+  vector<DirconKinematicData<double>*> constraints_;
+  std::unique_ptr<DirconKinematicDataSet<double>> constraint_set_;
+  std::shared_ptr<ShootingDefectConstraint<double>> segment_;
+};
+
+TEST_F(ModeShootingDefectConstraintTest, ParallelMatchesSerial) {
+  const int num_segments = 6;
+  const int n_x = 4;
+  const int n_u = 1;
+  ModeShootingDefectConstraint<double> serial(segment_, num_segments, nullptr);
+  ModeShootingDefectConstraint<double> parallel(
+      segment_, num_segments, std::make_shared<WorkerPool>(4));
+  ASSERT_EQ(serial.num_vars(), num_segments + (num_segments + 1) * (n_x + n_u));
+  ASSERT_EQ(serial.num_constraints(), num_segments * n_x);
+
+  VectorXd x = 0.5 * VectorXd::Random(serial.num_vars());
+  x.head(num_segments).setConstant(0.05);
+
+  // Row block j is the defect of segment j
+  VectorXd y;
+  serial.Eval(x, &y);
+  for (int j = 0; j < num_segments; j++) {
+    VectorXd x_j(1 + 2 * n_x + 2 * n_u), y_j;
+    x_j << x(j), x.segment(num_segments + j * n_x, 2 * n_x),
+        x.segment(num_segments + (num_segments + 1) * n_x + j * n_u, 2 * n_u);
+    segment_->Eval(x_j, &y_j);
+    EXPECT_TRUE(CompareMatrices(y.segment(j * n_x, n_x), y_j));
+  }
+
+  // The solvers evaluate the same values and gradients several times
+  for (int repeat = 0; repeat < 3; repeat++) {
+    VectorXd y_parallel;
+    parallel.Eval(x, &y_parallel);
+    EXPECT_TRUE(CompareMatrices(y_parallel, y));
+
+    AutoDiffVecXd y_serial_ad, y_parallel_ad;
+    serial.Eval(drake::math::initializeAutoDiff(x), &y_serial_ad);
+    parallel.Eval(drake::math::initializeAutoDiff(x), &y_parallel_ad);
+    EXPECT_TRUE(CompareMatrices(drake::math::autoDiffToValueMatrix(y_serial_ad),
+                                y));
+    EXPECT_TRUE(
+        CompareMatrices(drake::math::autoDiffToGradientMatrix(y_parallel_ad),
+                        drake::math::autoDiffToGradientMatrix(y_serial_ad)));
+  }
+}
+
+TEST_F(ModeShootingDefectConstraintTest, ChainRule) {
+  const int num_segments = 3;
+  ModeShootingDefectConstraint<double> constraint(
+      segment_, num_segments, std::make_shared<WorkerPool>(2));
+  VectorXd x = 0.5 * VectorXd::Random(constraint.num_vars());
+  x.head(num_segments).setConstant(0.05);
+
+  AutoDiffVecXd y;
+  constraint.Eval(drake::math::initializeAutoDiff(x), &y);
+  const MatrixXd dy_dx = drake::math::autoDiffToGradientMatrix(y);
+
+  const MatrixXd x_grad = MatrixXd::Random(x.size(), 3);
+  AutoDiffVecXd x_ad;
+  drake::math::initializeAutoDiffGivenGradientMatrix(x, x_grad, x_ad);
+  AutoDiffVecXd y_chain;
+  constraint.Eval(x_ad, &y_chain);
+  EXPECT_TRUE(CompareMatrices(drake::math::autoDiffToGradientMatrix(y_chain),
+                              dy_dx * x_grad, 1e-10));
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib